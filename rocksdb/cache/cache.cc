@@ -15,6 +15,12 @@
 
 namespace ROCKSDB_NAMESPACE {
 #ifndef ROCKSDB_LITE
+static std::unordered_map<std::string, CacheAdmissionPolicy>
+    cache_admission_policy_string_map = {
+        {"kAdmitAll", kAdmitAll},
+        {"kAdmitByFrequency", kAdmitByFrequency},
+};
+
 static std::unordered_map<std::string, OptionTypeInfo>
     lru_cache_options_type_info = {
         {"capacity",
@@ -31,6 +37,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct LRUCacheOptions, high_pri_pool_ratio),
           OptionType::kDouble, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"admission_policy",
+         OptionTypeInfo::Enum<CacheAdmissionPolicy>(
+             offsetof(struct LRUCacheOptions, admission_policy),
+             &cache_admission_policy_string_map)},
 };
 #endif  // ROCKSDB_LITE
 
@@ -13,13 +13,17 @@ int main() {
 
 #include <stdio.h>
 #include <sys/types.h>
+#include <algorithm>
 #include <cinttypes>
 #include <limits>
+#include <thread>
 
+#include "monitoring/histogram.h"
 #include "port/port.h"
 #include "rocksdb/cache.h"
 #include "rocksdb/db.h"
 #include "rocksdb/env.h"
+#include "rocksdb/memory_allocator.h"
 #include "util/coding.h"
 #include "util/gflags_compat.h"
 #include "util/hash.h"
@@ -32,7 +36,8 @@ static constexpr uint32_t KiB = uint32_t{1} << 10;
 static constexpr uint32_t MiB = KiB << 10;
 static constexpr uint64_t GiB = MiB << 10;
 
-DEFINE_uint32(threads, 16, "Number of concurrent threads to run.");
+DEFINE_uint32(threads, 16,
+              "Number of concurrent threads to run. 0 means one per core.");
 DEFINE_uint64(cache_size, 1 * GiB,
               "Number of bytes to use as a cache of uncompressed data.");
 DEFINE_uint32(num_shard_bits, 6, "shard_bits.");
@@ -58,6 +63,17 @@ DEFINE_uint32(erase_percent, 1,
 
 DEFINE_bool(use_clock_cache, false, "");
 
+DEFINE_bool(scale_threads, false,
+            "Run the benchmark with 1, 2, 4, ... and finally --threads "
+            "threads, to see how the cache scales with concurrency.");
+
+DEFINE_bool(use_hugepage_slab_allocator, false,
+            "Allocate the cached values with NewHugePageSlabAllocator(), "
+            "backed by huge pages on the NUMA node of the inserting thread.");
+
+DEFINE_bool(histogram, false,
+            "Report the latency of lookups, including reading the value.");
+
 namespace ROCKSDB_NAMESPACE {
 
 class CacheBench;
@@ -82,6 +98,9 @@ class SharedState {
     return &cv_;
   }
 
+  // REQUIRES: mutex held
+  HistogramImpl* GetLookupHistogram() { return &lookup_hist_; }
+
   CacheBench* GetCacheBench() const {
     return cache_bench_;
   }
@@ -115,6 +134,8 @@ class SharedState {
   uint64_t num_done_;
 
   CacheBench* cache_bench_;
+
+  HistogramImpl lookup_hist_;
 };
 
 // Per-thread state for concurrent executions of the same benchmark.
@@ -122,6 +143,7 @@ struct ThreadState {
   uint32_t tid;
   Random64 rnd;
   SharedState* shared;
+  HistogramImpl lookup_hist;
 
   ThreadState(uint32_t index, SharedState* _shared)
       : tid(index), rnd(1000 + index), shared(_shared) {}
@@ -149,8 +171,13 @@ struct KeyGen {
   }
 };
 
+// Set with --use_hugepage_slab_allocator
+std::shared_ptr<MemoryAllocator> value_allocator;
+
 char* createValue(Random64& rnd) {
-  char* rv = new char[FLAGS_value_bytes];
+  char* rv = value_allocator ? static_cast<char*>(value_allocator->Allocate(
+                                   FLAGS_value_bytes))
+                             : new char[FLAGS_value_bytes];
   // Fill with some filler data, and take some CPU time
   for (uint32_t i = 0; i < FLAGS_value_bytes; i += 8) {
     EncodeFixed64(rv + i, rnd.Next());
@@ -159,7 +186,11 @@ char* createValue(Random64& rnd) {
 }
 
 void deleter(const Slice& /*key*/, void* value) {
-  delete[] static_cast<char*>(value);
+  if (value_allocator) {
+    value_allocator->Deallocate(value);
+  } else {
+    delete[] static_cast<char*>(value);
+  }
 }
 }  // namespace
 
@@ -183,6 +214,14 @@ class CacheBench {
       fprintf(stderr, "Percentages must add to 100.\n");
       exit(1);
     }
+    if (FLAGS_use_hugepage_slab_allocator) {
+      Status s = NewHugePageSlabAllocator(HugePageSlabAllocatorOptions(),
+                                          &value_allocator);
+      if (!s.ok()) {
+        fprintf(stderr, "%s\n", s.ToString().c_str());
+        exit(1);
+      }
+    }
     if (FLAGS_use_clock_cache) {
       cache_ = NewClockCache(FLAGS_cache_size, FLAGS_num_shard_bits);
       if (!cache_) {
@@ -241,6 +280,10 @@ class CacheBench {
       uint32_t qps = static_cast<uint32_t>(
           static_cast<double>(FLAGS_threads * FLAGS_ops_per_thread) / elapsed);
       fprintf(stdout, "Complete in %.3f s; QPS = %u\n", elapsed, qps);
+      if (FLAGS_histogram) {
+        fprintf(stdout, "Lookup latency (ns):\n%s",
+                shared.GetLookupHistogram()->ToString().c_str());
+      }
     }
     return true;
   }
@@ -272,6 +315,7 @@ class CacheBench {
 
     {
       MutexLock l(shared->GetMutex());
+      shared->GetLookupHistogram()->Merge(thread->lookup_hist);
       shared->IncDone();
       if (shared->AllDone()) {
         shared->GetCondVar()->SignalAll();
@@ -280,6 +324,7 @@ class CacheBench {
   }
 
   void OperateCache(ThreadState* thread) {
+    Env* clock = Env::Default();
     // To use looked-up values
     uint64_t result = 0;
     // To hold handles for a non-trivial amount of time
@@ -294,11 +339,15 @@ class CacheBench {
           handle = nullptr;
         }
         // do lookup
+        const uint64_t start_nanos = FLAGS_histogram ? clock->NowNanos() : 0;
         handle = cache_->Lookup(key);
         if (handle) {
           // do something with the data
           result += NPHash64(static_cast<char*>(cache_->Value(handle)),
                              FLAGS_value_bytes);
+          if (FLAGS_histogram) {
+            thread->lookup_hist.Add(clock->NowNanos() - start_nanos);
+          }
         } else {
           // do insert
           cache_->Insert(key, createValue(thread->rnd), FLAGS_value_bytes,
@@ -318,11 +367,15 @@ class CacheBench {
           handle = nullptr;
         }
         // do lookup
+        const uint64_t start_nanos = FLAGS_histogram ? clock->NowNanos() : 0;
         handle = cache_->Lookup(key);
         if (handle) {
           // do something with the data
           result += NPHash64(static_cast<char*>(cache_->Value(handle)),
                              FLAGS_value_bytes);
+          if (FLAGS_histogram) {
+            thread->lookup_hist.Add(clock->NowNanos() - start_nanos);
+          }
         }
       } else if (random_op < erase_threshold_) {
         // do erase
@@ -352,6 +405,8 @@ class CacheBench {
     printf("Insert percentage   : %u%%\n", FLAGS_insert_percent);
     printf("Lookup percentage   : %u%%\n", FLAGS_lookup_percent);
     printf("Erase percentage    : %u%%\n", FLAGS_erase_percent);
+    printf("Value allocator     : %s\n",
+           value_allocator ? value_allocator->Name() : "new[]");
     printf("----------------------------\n");
   }
 };
@@ -360,6 +415,9 @@ class CacheBench {
 int main(int argc, char** argv) {
   ParseCommandLineFlags(&argc, &argv, true);
 
+  if (FLAGS_threads == 0) {
+    FLAGS_threads = std::thread::hardware_concurrency();
+  }
   if (FLAGS_threads <= 0) {
     fprintf(stderr, "threads number <= 0\n");
     exit(1);
@@ -371,6 +429,18 @@ int main(int argc, char** argv) {
     printf("Population complete\n");
     printf("----------------------------\n");
   }
+  if (FLAGS_scale_threads) {
+    const uint32_t max_threads = FLAGS_threads;
+    for (uint32_t threads = 1;; threads = std::min(2 * threads, max_threads)) {
+      FLAGS_threads = threads;
+      if (!bench.Run()) {
+        return 1;
+      }
+      if (threads == max_threads) {
+        return 0;
+      }
+    }
+  }
   if (bench.Run()) {
     return 0;
   } else {
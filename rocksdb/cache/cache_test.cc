@@ -9,6 +9,7 @@
 
 #include "rocksdb/cache.h"
 
+#include <atomic>
 #include <forward_list>
 #include <functional>
 #include <iostream>
@@ -16,8 +17,10 @@
 #include <vector>
 #include "cache/clock_cache.h"
 #include "cache/lru_cache.h"
+#include "port/port.h"
 #include "test_util/testharness.h"
 #include "util/coding.h"
+#include "util/random.h"
 #include "util/string_util.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -660,6 +663,32 @@ TEST_P(LRUCacheTest, SetStrictCapacityLimit) {
   for (size_t i = 0; i < 5; i++) {
     cache2->Release(handles[i]);
   }
+
+  // test4: an insert that the admission policy rejects fails the same way,
+  // even though the cache could make room for it.
+  LRUCacheOptions co;
+  co.capacity = 5;
+  co.num_shard_bits = 0;
+  co.strict_capacity_limit = true;
+  co.metadata_charge_policy = kDontChargeCacheMetadata;
+  co.admission_policy = kAdmitByFrequency;
+  std::shared_ptr<Cache> cache3 = NewLRUCache(co);
+  for (size_t i = 0; i < 5; i++) {
+    std::string key = ToString(i + 1);
+    ASSERT_OK(cache3->Insert(key, new Value(i + 1), 1, &deleter));
+    for (int j = 0; j < 2; j++) {
+      cache3->Release(cache3->Lookup(key));
+    }
+  }
+  extra_value = new Value(0);
+  s = cache3->Insert(extra_key, extra_value, 1, &deleter, &handle);
+  ASSERT_TRUE(s.IsIncomplete());
+  ASSERT_EQ(nullptr, handle);
+  ASSERT_EQ(5, cache3->GetUsage());
+  s = cache3->Insert(extra_key, extra_value, 1, &deleter);
+  ASSERT_OK(s);
+  ASSERT_EQ(5, cache3->GetUsage());
+  ASSERT_EQ(nullptr, cache3->Lookup(extra_key));
 }
 
 TEST_P(CacheTest, OverCapacity) {
@@ -733,6 +762,28 @@ TEST_P(CacheTest, ApplyToAllCacheEntiresTest) {
   ASSERT_TRUE(inserted == callback_state);
 }
 
+TEST_P(LRUCacheTest, ApplyToAllCacheKeysTest) {
+  for (int i = 0; i < 10; ++i) {
+    Insert(i, i * 2);
+  }
+  ASSERT_EQ(4, Lookup(2));
+  ASSERT_EQ(10, Lookup(5));
+
+  std::vector<std::pair<int, bool>> visited;
+  cache_->ApplyToAllCacheKeys(
+      [&](const Slice& key, bool hit) {
+        visited.push_back({DecodeKey(key), hit});
+      },
+      true);
+
+  std::sort(visited.begin(), visited.end());
+  ASSERT_EQ(10U, visited.size());
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_EQ(i, visited[i].first);
+    ASSERT_EQ(i == 2 || i == 5, visited[i].second);
+  }
+}
+
 TEST_P(CacheTest, DefaultShardBits) {
   // test1: set the flag to false. Insert more keys than capacity. See if they
   // all go through.
@@ -757,6 +808,48 @@ TEST_P(CacheTest, GetCharge) {
   cache_->Release(h1);
 }
 
+TEST_P(CacheTest, ConcurrentLookupAndInsert) {
+  // Lookups racing with inserts that evict, erase and reuse entries must only
+  // ever return the value inserted for the key looked up.
+  std::shared_ptr<Cache> cache = NewCache(kCacheSize, 1, false);
+  const int kNumKeys = 4 * kCacheSize;
+  const int kNumReaders = 4;
+  std::atomic<bool> stop(false);
+  std::atomic<int> mismatches(0);
+  std::vector<port::Thread> readers;
+  for (int t = 0; t < kNumReaders; t++) {
+    readers.emplace_back([&, t]() {
+      Random rnd(301 + t);
+      while (!stop.load(std::memory_order_relaxed)) {
+        const int key = static_cast<int>(rnd.Uniform(kNumKeys));
+        Cache::Handle* h = cache->Lookup(EncodeKey(key));
+        if (h != nullptr) {
+          if (DecodeValue(cache->Value(h)) != key + kNumKeys) {
+            mismatches.fetch_add(1, std::memory_order_relaxed);
+          }
+          cache->Release(h);
+        }
+      }
+    });
+  }
+  Random rnd(17);
+  for (int i = 0; i < 20 * kNumKeys; i++) {
+    const int key = static_cast<int>(rnd.Uniform(kNumKeys));
+    if (rnd.OneIn(10)) {
+      cache->Erase(EncodeKey(key));
+    } else {
+      ASSERT_OK(cache->Insert(EncodeKey(key), EncodeValue(key + kNumKeys), 1,
+                              &dumbDeleter));
+    }
+  }
+  stop.store(true, std::memory_order_relaxed);
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  ASSERT_EQ(0, mismatches.load());
+  ASSERT_LE(cache->GetUsage(), static_cast<size_t>(kCacheSize));
+}
+
 #ifdef SUPPORT_CLOCK_CACHE
 std::shared_ptr<Cache> (*new_clock_cache_func)(
     size_t, int, bool, CacheMetadataChargePolicy) = NewClockCache;
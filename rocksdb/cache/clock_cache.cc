@@ -28,12 +28,8 @@ std::shared_ptr<Cache> NewClockCache(
 #include <atomic>
 #include <deque>
 
-// "tbb/concurrent_hash_map.h" requires RTTI if exception is enabled.
-// Disable it so users can chooose to disable RTTI.
-#ifndef ROCKSDB_USE_RTTI
-#define TBB_USE_EXCEPTIONS 0
-#endif
-#include "tbb/concurrent_hash_map.h"
+#include <memory>
+#include <vector>
 
 #include "cache/sharded_cache.h"
 #include "port/malloc.h"
@@ -61,9 +57,10 @@ namespace {
 // to be re-use. This is to avoid memory dealocation, which is hard to deal
 // with in concurrent environment.
 //
-// The cache also maintains a concurrent hash map for lookup. Any concurrent
-// hash map implementation should do the work. We currently use
-// tbb::concurrent_hash_map because it supports concurrent erase.
+// The cache also maintains a concurrent hash map for lookup. We use
+// ClockHandleTable below, a chained hash table threaded through the cache
+// handles. Since handles are never freed, readers can walk the chains without
+// any lock while the (mutex protected) writer modifies them.
 //
 // Each cache handle has the following flags and counters, which are squeeze
 // in an atomic interger, to make sure the handle always be in a consistent
@@ -139,7 +136,9 @@ namespace {
 // We additionally require that modifying the hash map needs to hold the mutex.
 // As such, Modifying the cache (such as Insert() and Erase()) require to
 // hold the mutex. Lookup() only access the hash map and the flags associated
-// with each handle, and don't require explicit locking. Release() has to
+// with each handle, and don't require explicit locking, except for a lookup
+// that misses while the hash map is concurrently being restructured; such a
+// lookup is retried under the mutex to avoid false misses. Release() has to
 // acquire the mutex only when it releases the last reference to the entry and
 // the entry has been erased from cache explicitly. A future improvement could
 // be to remove the mutex completely.
@@ -176,7 +175,8 @@ namespace {
 // Cache entry meta data.
 struct CacheHandle {
   Slice key;
-  uint32_t hash;
+  // Read by lock-free lookups while the handle might be reused by the writer
+  std::atomic<uint32_t> hash;
   void* value;
   size_t charge;
   void (*deleter)(const Slice&, void* value);
@@ -189,6 +189,9 @@ struct CacheHandle {
   // to 0 is responsible to put the handle back to recycle_ and cleanup memory.
   std::atomic<uint32_t> flags;
 
+  // Next handle in the same ClockHandleTable bucket.
+  std::atomic<CacheHandle*> next_hash;
+
   CacheHandle() = default;
 
   CacheHandle(const CacheHandle& a) { *this = a; }
@@ -227,25 +230,180 @@ struct CacheHandle {
   }
 };
 
-// Key of hash map. We store hash value with the key for convenience.
-struct CacheKey {
-  Slice key;
-  uint32_t hash_value;
+// Hash table from key to cache handle, with chaining through
+// CacheHandle::next_hash. Modifications have to be serialized by the caller.
+// Readers can traverse the table concurrently without locking:
+//
+//   * New handles are published at the head of a bucket with release
+//     semantics, after their next_hash and hash are set.
+//   * Removing a handle only redirects its predecessor, so a reader positioned
+//     on the removed handle still reaches the rest of the chain.
+//   * Bucket arrays replaced by Grow() are retired rather than freed, since
+//     readers might still be scanning them. The array grows geometrically so
+//     the retired arrays take less memory than the live one.
+//
+// Reusing a removed handle, growing and clearing the table can make a
+// concurrent reader skip entries. These operations are wrapped in BeginChange()
+// and EndChange(), which make a seqlock style version odd while the change is
+// in progress; a reader that missed checks Changed() to tell a real miss from
+// a possibly false one.
+//
+// A reader only gets candidates matching the hash. The handle key must only be
+// read after a reference on the handle is held, and the handle has to be
+// checked again at that point, as it might have been reused for another key.
+class ClockHandleTable {
+ public:
+  ClockHandleTable() : array_(new BucketArray(kInitialLengthBits)), elems_(0) {
+    retired_.emplace_back(array_.load(std::memory_order_relaxed));
+  }
+
+  // Version to be passed to Changed() after a lock-free lookup.
+  uint64_t version() const { return version_.load(std::memory_order_acquire); }
+
+  // Return true if the table might have been restructured since `version`
+  // was read. Part of the lock-free read path.
+  bool Changed(uint64_t version) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return (version & 1) != 0 ||
+           version_.load(std::memory_order_relaxed) != version;
+  }
 
-  CacheKey() = default;
+  // First handle at or after `handle` (inclusive) whose hash is `hash`, or
+  // nullptr. Pass nullptr to start from the head of the bucket. Part of the
+  // lock-free read path.
+  CacheHandle* FindNext(uint32_t hash, CacheHandle* handle) const {
+    if (handle == nullptr) {
+      const BucketArray* array = array_.load(std::memory_order_acquire);
+      handle = array->heads[hash & array->mask].load(std::memory_order_acquire);
+    }
+    while (handle != nullptr &&
+           handle->hash.load(std::memory_order_relaxed) != hash) {
+      handle = handle->next_hash.load(std::memory_order_acquire);
+    }
+    return handle;
+  }
+
+  // Handle for the key, or nullptr. Requires that the table is not modified
+  // concurrently.
+  CacheHandle* Find(const Slice& key, uint32_t hash) const {
+    for (CacheHandle* h = FindNext(hash, nullptr); h != nullptr;
+         h = FindNext(hash, h->next_hash.load(std::memory_order_relaxed))) {
+      if (h->key == key) {
+        return h;
+      }
+    }
+    return nullptr;
+  }
+
+  // Add a handle whose key is not in the table. The handle must not be in the
+  // table and must have its hash set.
+  void Insert(CacheHandle* handle) {
+    BucketArray* array = array_.load(std::memory_order_relaxed);
+    std::atomic<CacheHandle*>& head =
+        array->heads[handle->hash.load(std::memory_order_relaxed) &
+                     array->mask];
+    handle->next_hash.store(head.load(std::memory_order_relaxed),
+                            std::memory_order_relaxed);
+    head.store(handle, std::memory_order_release);
+    if (++elems_ > array->mask + 1) {
+      Grow();
+    }
+  }
+
+  // Remove a handle that is in the table.
+  void Remove(CacheHandle* handle) {
+    BucketArray* array = array_.load(std::memory_order_relaxed);
+    std::atomic<CacheHandle*>* ptr =
+        &array->heads[handle->hash.load(std::memory_order_relaxed) &
+                      array->mask];
+    while (ptr->load(std::memory_order_relaxed) != handle) {
+      assert(ptr->load(std::memory_order_relaxed) != nullptr);
+      ptr = &ptr->load(std::memory_order_relaxed)->next_hash;
+    }
+    ptr->store(handle->next_hash.load(std::memory_order_relaxed),
+               std::memory_order_release);
+    --elems_;
+  }
 
-  CacheKey(const Slice& k, uint32_t h) {
-    key = k;
-    hash_value = h;
+  // Remove all handles.
+  void Clear() {
+    BeginChange();
+    BucketArray* array = array_.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i <= array->mask; i++) {
+      array->heads[i].store(nullptr, std::memory_order_relaxed);
+    }
+    elems_ = 0;
+    EndChange();
   }
 
-  static bool equal(const CacheKey& a, const CacheKey& b) {
-    return a.hash_value == b.hash_value && a.key == b.key;
+  // Bracket modifications that may send concurrent readers off their chain,
+  // such as reusing a handle that used to be in the table. Can be nested.
+  void BeginChange() {
+    if (change_depth_++ == 0) {
+      version_.store(version_.load(std::memory_order_relaxed) + 1,
+                     std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+    }
+  }
+  void EndChange() {
+    assert(change_depth_ > 0);
+    if (--change_depth_ == 0) {
+      version_.store(version_.load(std::memory_order_relaxed) + 1,
+                     std::memory_order_release);
+    }
   }
 
-  static size_t hash(const CacheKey& a) {
-    return static_cast<size_t>(a.hash_value);
+ private:
+  static const uint32_t kInitialLengthBits = 4;
+
+  struct BucketArray {
+    explicit BucketArray(uint32_t length_bits)
+        : mask((uint32_t{1} << length_bits) - 1),
+          heads(new std::atomic<CacheHandle*>[mask + 1]) {
+      for (uint32_t i = 0; i <= mask; i++) {
+        heads[i].store(nullptr, std::memory_order_relaxed);
+      }
+    }
+    const uint32_t mask;
+    std::unique_ptr<std::atomic<CacheHandle*>[]> heads;
+  };
+
+  void Grow() {
+    BucketArray* old_array = array_.load(std::memory_order_relaxed);
+    uint32_t length_bits = 0;
+    while ((uint32_t{1} << length_bits) <= old_array->mask) {
+      length_bits++;
+    }
+    if (length_bits >= 31) {
+      return;
+    }
+    BucketArray* new_array = new BucketArray(length_bits + 1);
+    retired_.emplace_back(new_array);
+    BeginChange();
+    for (uint32_t i = 0; i <= old_array->mask; i++) {
+      CacheHandle* h = old_array->heads[i].load(std::memory_order_relaxed);
+      while (h != nullptr) {
+        CacheHandle* next = h->next_hash.load(std::memory_order_relaxed);
+        std::atomic<CacheHandle*>& head =
+            new_array->heads[h->hash.load(std::memory_order_relaxed) &
+                             new_array->mask];
+        h->next_hash.store(head.load(std::memory_order_relaxed),
+                           std::memory_order_release);
+        head.store(h, std::memory_order_relaxed);
+        h = next;
+      }
+    }
+    array_.store(new_array, std::memory_order_release);
+    EndChange();
   }
+
+  std::atomic<BucketArray*> array_;
+  // Owns the current and all previous bucket arrays.
+  std::vector<std::unique_ptr<BucketArray>> retired_;
+  size_t elems_;
+  // Odd while a change started by BeginChange() is in progress.
+  std::atomic<uint64_t> version_{0};
+  int change_depth_ = 0;
 };
 
 struct CleanupContext {
@@ -259,9 +417,6 @@ struct CleanupContext {
 // A cache shard which maintains its own CLOCK cache.
 class ClockCacheShard final : public CacheShard {
  public:
-  // Hash map type.
-  typedef tbb::concurrent_hash_map<CacheKey, CacheHandle*, CacheKey> HashTable;
-
   ClockCacheShard();
   ~ClockCacheShard() override;
 
@@ -377,8 +532,8 @@ class ClockCacheShard final : public CacheShard {
   // Whether allow insert into cache if cache is full.
   std::atomic<bool> strict_capacity_limit_;
 
-  // Hash table (tbb::concurrent_hash_map) for lookup.
-  HashTable table_;
+  // Hash table for lookup. Modifications have to hold mutex_.
+  ClockHandleTable table_;
 };
 
 ClockCacheShard::ClockCacheShard()
@@ -470,7 +625,9 @@ bool ClockCacheShard::Ref(Cache::Handle* h) {
 
 bool ClockCacheShard::Unref(CacheHandle* handle, bool set_usage,
                             CleanupContext* context) {
-  if (set_usage) {
+  // Avoid a read-modify-write on a hot entry whose usage bit is already set.
+  if (set_usage &&
+      !HasUsage(handle->flags.load(std::memory_order_relaxed))) {
     handle->flags.fetch_or(kUsageBit, std::memory_order_relaxed);
   }
   // Use acquire-release semantics as previous operations on the cache entry
@@ -511,9 +668,10 @@ bool ClockCacheShard::TryEvict(CacheHandle* handle, CleanupContext* context) {
   uint32_t flags = kInCacheBit;
   if (handle->flags.compare_exchange_strong(flags, 0, std::memory_order_acquire,
                                             std::memory_order_relaxed)) {
-    bool erased __attribute__((__unused__)) =
-        table_.erase(CacheKey(handle->key, handle->hash));
-    assert(erased);
+    assert(table_.Find(handle->key,
+                       handle->hash.load(std::memory_order_relaxed)) ==
+           handle);
+    table_.Remove(handle);
     RecycleHandle(handle, context);
     return true;
   }
@@ -582,29 +740,37 @@ CacheHandle* ClockCacheShard::Insert(
   // Grab available handle from recycle bin. If recycle bin is empty, create
   // and append new handle to end of circular list.
   CacheHandle* handle = nullptr;
+  bool reused = false;
   if (!recycle_.empty()) {
     handle = recycle_.back();
     recycle_.pop_back();
+    // Lock-free readers might still be walking the chain through the handle.
+    reused = true;
+    table_.BeginChange();
   } else {
     list_.emplace_back();
     handle = &list_.back();
   }
   // Fill handle.
   handle->key = key;
-  handle->hash = hash;
+  handle->hash.store(hash, std::memory_order_relaxed);
   handle->value = value;
   handle->charge = charge;
   handle->deleter = deleter;
+  // Use release semantics so that a lookup which manages to reference the
+  // handle sees the fields above.
   uint32_t flags = hold_reference ? kInCacheBit + kOneRef : kInCacheBit;
-  handle->flags.store(flags, std::memory_order_relaxed);
-  HashTable::accessor accessor;
-  if (table_.find(accessor, CacheKey(key, hash))) {
+  handle->flags.store(flags, std::memory_order_release);
+  CacheHandle* existing_handle = table_.Find(key, hash);
+  if (existing_handle != nullptr) {
     *overwritten = true;
-    CacheHandle* existing_handle = accessor->second;
-    table_.erase(accessor);
+    table_.Remove(existing_handle);
     UnsetInCache(existing_handle, context);
   }
-  table_.insert(HashTable::value_type(CacheKey(key, hash), handle));
+  table_.Insert(handle);
+  if (reused) {
+    table_.EndChange();
+  }
   if (hold_reference) {
     pinned_usage_.fetch_add(total_charge, std::memory_order_relaxed);
   }
@@ -618,7 +784,6 @@ Status ClockCacheShard::Insert(const Slice& key, uint32_t hash, void* value,
                                Cache::Handle** out_handle,
                                Cache::Priority /*priority*/) {
   CleanupContext context;
-  HashTable::accessor accessor;
   char* key_data = new char[key.size()];
   memcpy(key_data, key.data(), key.size());
   Slice key_copy(key_data, key.size());
@@ -642,25 +807,35 @@ Status ClockCacheShard::Insert(const Slice& key, uint32_t hash, void* value,
 }
 
 Cache::Handle* ClockCacheShard::Lookup(const Slice& key, uint32_t hash) {
-  HashTable::const_accessor accessor;
-  if (!table_.find(accessor, CacheKey(key, hash))) {
-    return nullptr;
-  }
-  CacheHandle* handle = accessor->second;
-  accessor.release();
-  // Ref() could fail if another thread sneak in and evict/erase the cache
-  // entry before we are able to hold reference.
-  if (!Ref(reinterpret_cast<Cache::Handle*>(handle))) {
-    return nullptr;
-  }
-  // Double check the key since the handle may now representing another key
-  // if other threads sneak in, evict/erase the entry and re-used the handle
-  // for another cache entry.
-  if (hash != handle->hash || key != handle->key) {
+  const uint64_t version = table_.version();
+  for (CacheHandle* handle = table_.FindNext(hash, nullptr); handle != nullptr;
+       handle = table_.FindNext(
+           hash, handle->next_hash.load(std::memory_order_acquire))) {
+    // Ref() could fail if another thread sneak in and evict/erase the cache
+    // entry before we are able to hold reference.
+    if (!Ref(reinterpret_cast<Cache::Handle*>(handle))) {
+      continue;
+    }
+    // Double check the key since the handle may now representing another key
+    // if other threads sneak in, evict/erase the entry and re-used the handle
+    // for another cache entry.
+    if (hash == handle->hash.load(std::memory_order_relaxed) &&
+        key == handle->key) {
+      return reinterpret_cast<Cache::Handle*>(handle);
+    }
     CleanupContext context;
     Unref(handle, false, &context);
     // It is possible Unref() delete the entry, so we need to cleanup.
     Cleanup(context);
+  }
+  if (!table_.Changed(version)) {
+    return nullptr;
+  }
+  // The table was restructured under us, so the miss might be a false one.
+  // Look again while the table is stable.
+  MutexLock l(&mutex_);
+  CacheHandle* handle = table_.Find(key, hash);
+  if (handle == nullptr || !Ref(reinterpret_cast<Cache::Handle*>(handle))) {
     return nullptr;
   }
   return reinterpret_cast<Cache::Handle*>(handle);
@@ -671,7 +846,9 @@ bool ClockCacheShard::Release(Cache::Handle* h, bool force_erase) {
   CacheHandle* handle = reinterpret_cast<CacheHandle*>(h);
   bool erased = Unref(handle, true, &context);
   if (force_erase && !erased) {
-    erased = EraseAndConfirm(handle->key, handle->hash, &context);
+    erased = EraseAndConfirm(handle->key,
+                             handle->hash.load(std::memory_order_relaxed),
+                             &context);
   }
   Cleanup(context);
   return erased;
@@ -686,11 +863,10 @@ void ClockCacheShard::Erase(const Slice& key, uint32_t hash) {
 bool ClockCacheShard::EraseAndConfirm(const Slice& key, uint32_t hash,
                                       CleanupContext* context) {
   MutexLock l(&mutex_);
-  HashTable::accessor accessor;
   bool erased = false;
-  if (table_.find(accessor, CacheKey(key, hash))) {
-    CacheHandle* handle = accessor->second;
-    table_.erase(accessor);
+  CacheHandle* handle = table_.Find(key, hash);
+  if (handle != nullptr) {
+    table_.Remove(handle);
     erased = UnsetInCache(handle, context);
   }
   return erased;
@@ -700,7 +876,7 @@ void ClockCacheShard::EraseUnRefEntries() {
   CleanupContext context;
   {
     MutexLock l(&mutex_);
-    table_.clear();
+    table_.Clear();
     for (auto& handle : list_) {
       UnsetInCache(&handle, &context);
     }
@@ -743,7 +919,8 @@ class ClockCache final : public ShardedCache {
   }
 
   uint32_t GetHash(Handle* handle) const override {
-    return reinterpret_cast<const CacheHandle*>(handle)->hash;
+    return reinterpret_cast<const CacheHandle*>(handle)->hash.load(
+        std::memory_order_relaxed);
   }
 
   void DisownData() override { shards_ = nullptr; }
@@ -11,6 +11,6 @@
 
 #include "rocksdb/cache.h"
 
-#if defined(TBB) && !defined(ROCKSDB_LITE)
+#ifndef ROCKSDB_LITE
 #define SUPPORT_CLOCK_CACHE
 #endif
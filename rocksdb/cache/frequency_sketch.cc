@@ -0,0 +1,98 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/frequency_sketch.h"
+
+#include <algorithm>
+
+#include "util/math.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// Odd multipliers deriving one word index per sketch row from the key hash
+const uint64_t kSeeds[4] = {0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL,
+                            0x9ae16a3b2f90404fULL, 0xcbf29ce484222325ULL};
+// Clears the bit shifted into the top of each counter when halving
+const uint64_t kResetMask = 0x7777777777777777ULL;
+// Lowest bit of each counter
+const uint64_t kOneMask = 0x1111111111111111ULL;
+// Smallest sketch, in words
+const size_t kMinWidth = 16;
+}  // namespace
+
+void FrequencySketch::EnsureCapacity(size_t num_entries) {
+  size_t width = kMinWidth;
+  while (width < num_entries) {
+    width <<= 1;
+  }
+  if (width <= table_.size()) {
+    return;
+  }
+  table_.assign(width, 0);
+  mask_ = width - 1;
+  sample_size_ = 10 * width;
+  additions_ = 0;
+}
+
+size_t FrequencySketch::IndexOf(uint32_t hash, int row) const {
+  uint64_t h = (uint64_t{hash} + kSeeds[row]) * kSeeds[row];
+  h += h >> 32;
+  return static_cast<size_t>(h) & mask_;
+}
+
+bool FrequencySketch::IncrementAt(size_t index, int slot) {
+  const int offset = slot << 2;
+  const uint64_t mask = uint64_t{0xf} << offset;
+  if ((table_[index] & mask) != mask) {
+    table_[index] += uint64_t{1} << offset;
+    return true;
+  }
+  return false;
+}
+
+void FrequencySketch::Increment(uint32_t hash) {
+  if (table_.empty()) {
+    return;
+  }
+  // Each row uses a different one of the 16 counters of its word, and the
+  // low bits of the hash pick which group of four counters the key uses.
+  const int start = static_cast<int>(hash & 3) << 2;
+  bool added = false;
+  for (int row = 0; row < 4; row++) {
+    added |= IncrementAt(IndexOf(hash, row), start + row);
+  }
+  if (added && ++additions_ >= sample_size_) {
+    Reset();
+  }
+}
+
+uint32_t FrequencySketch::Estimate(uint32_t hash) const {
+  if (table_.empty()) {
+    return 0;
+  }
+  const int start = static_cast<int>(hash & 3) << 2;
+  uint64_t frequency = 0xf;
+  for (int row = 0; row < 4; row++) {
+    const uint64_t count =
+        (table_[IndexOf(hash, row)] >> ((start + row) << 2)) & 0xf;
+    frequency = std::min(frequency, count);
+  }
+  return static_cast<uint32_t>(frequency);
+}
+
+void FrequencySketch::Reset() {
+  // Odd counters lose half an increment each; account for that so the next
+  // reset happens after a full sample again.
+  size_t odd = 0;
+  for (uint64_t& word : table_) {
+    odd += BitsSetToOne(word & kOneMask);
+    word = (word >> 1) & kResetMask;
+  }
+  const size_t lost = odd >> 2;
+  additions_ = (additions_ >> 1) > lost ? (additions_ >> 1) - lost : 0;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
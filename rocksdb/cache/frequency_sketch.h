@@ -0,0 +1,60 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "rocksdb/rocksdb_namespace.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// FrequencySketch estimates how often each cache key was accessed recently,
+// as needed by the TinyLFU cache admission policy. It is a count-min sketch
+// with four rows of 4-bit counters; the four counters of a key are packed in
+// four different 64-bit words so an update touches at most four cache lines.
+// Keys are identified by their 32-bit hash only.
+//
+// To keep the estimates about recent accesses, all counters are halved every
+// time the number of increments reaches ten times the sketch width.
+//
+// Not thread-safe.
+class FrequencySketch {
+ public:
+  FrequencySketch() = default;
+
+  // Grow the sketch so that it can tell apart about `num_entries` distinct
+  // keys. The counts recorded so far are dropped if the sketch is resized.
+  void EnsureCapacity(size_t num_entries);
+
+  // Record an access to the key.
+  void Increment(uint32_t hash);
+
+  // Estimated number of recent accesses to the key, at most 15.
+  uint32_t Estimate(uint32_t hash) const;
+
+  // Number of 64-bit words, each holding 16 counters.
+  size_t width() const { return table_.size(); }
+
+ private:
+  size_t IndexOf(uint32_t hash, int row) const;
+
+  // Increment counter `slot` of the word at `index` unless it saturated.
+  // Return true if the counter was incremented.
+  bool IncrementAt(size_t index, int slot);
+
+  // Halve all counters.
+  void Reset();
+
+  std::vector<uint64_t> table_;
+  size_t mask_ = 0;
+  size_t sample_size_ = 0;
+  size_t additions_ = 0;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -13,6 +13,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "util/mutexlock.h"
 
@@ -98,16 +100,21 @@ void LRUHandleTable::Resize() {
 LRUCacheShard::LRUCacheShard(size_t capacity, bool strict_capacity_limit,
                              double high_pri_pool_ratio,
                              bool use_adaptive_mutex,
-                             CacheMetadataChargePolicy metadata_charge_policy)
+                             CacheMetadataChargePolicy metadata_charge_policy,
+                             CacheAdmissionPolicy admission_policy)
     : capacity_(0),
       high_pri_pool_usage_(0),
       strict_capacity_limit_(strict_capacity_limit),
       high_pri_pool_ratio_(high_pri_pool_ratio),
       high_pri_pool_capacity_(0),
+      admission_policy_(admission_policy),
       usage_(0),
       lru_usage_(0),
       mutex_(use_adaptive_mutex) {
   set_metadata_charge_policy(metadata_charge_policy);
+  if (admission_policy_ == kAdmitByFrequency) {
+    sketch_.EnsureCapacity(0);
+  }
   // Make empty circular linked list
   lru_.next = &lru_;
   lru_.prev = &lru_;
@@ -153,6 +160,30 @@ void LRUCacheShard::ApplyToAllCacheEntries(void (*callback)(void*, size_t),
   }
 }
 
+void LRUCacheShard::ApplyToAllCacheKeys(
+    const std::function<void(const Slice& key, bool hit)>& callback,
+    bool thread_safe) {
+  // The keys are copied so that the callback runs without the shard mutex,
+  // which lookups and inserts would otherwise wait for
+  std::vector<std::pair<std::string, bool>> keys;
+  const auto collectKeys = [&]() {
+    keys.reserve(table_.GetNumElements());
+    table_.ApplyToAllCacheEntries([&keys](LRUHandle* h) {
+      keys.emplace_back(h->key().ToString(), h->HasHit());
+    });
+  };
+
+  if (thread_safe) {
+    MutexLock l(&mutex_);
+    collectKeys();
+  } else {
+    collectKeys();
+  }
+  for (const auto& key : keys) {
+    callback(key.first, key.second);
+  }
+}
+
 void LRUCacheShard::TEST_GetLRUList(LRUHandle** lru, LRUHandle** lru_low_pri) {
   MutexLock l(&mutex_);
   *lru = &lru_;
@@ -248,6 +279,35 @@ void LRUCacheShard::EvictFromLRU(size_t charge,
   }
 }
 
+bool LRUCacheShard::Admit(uint32_t hash, size_t total_charge,
+                          Cache::Priority priority) {
+  if (admission_policy_ != kAdmitByFrequency) {
+    return true;
+  }
+  // Grow the sketch along with the number of entries while the cache fills
+  sketch_.EnsureCapacity(table_.GetNumElements() + 1);
+  if (priority == Cache::Priority::HIGH || usage_ + total_charge <= capacity_ ||
+      lru_.next == &lru_) {
+    return true;
+  }
+  // Admit if the entry is hotter than all the entries LRU eviction would
+  // drop to make room for it together. Ties go to the victims, so that a key
+  // seen for the first time can't push out another key seen only once.
+  const uint32_t candidate = sketch_.Estimate(hash);
+  uint64_t victims = 0;
+  size_t freed = 0;
+  for (LRUHandle* old = lru_.next;
+       old != &lru_ && usage_ - freed + total_charge > capacity_;
+       old = old->next) {
+    victims += sketch_.Estimate(old->hash);
+    if (victims >= candidate) {
+      return false;
+    }
+    freed += old->CalcTotalCharge(metadata_charge_policy_);
+  }
+  return true;
+}
+
 void LRUCacheShard::SetCapacity(size_t capacity) {
   autovector<LRUHandle*> last_reference_list;
   {
@@ -270,6 +330,9 @@ void LRUCacheShard::SetStrictCapacityLimit(bool strict_capacity_limit) {
 
 Cache::Handle* LRUCacheShard::Lookup(const Slice& key, uint32_t hash) {
   MutexLock l(&mutex_);
+  if (admission_policy_ == kAdmitByFrequency) {
+    sketch_.Increment(hash);
+  }
   LRUHandle* e = table_.Lookup(key, hash);
   if (e != nullptr) {
     assert(e->InCache());
@@ -322,7 +385,7 @@ bool LRUCacheShard::Release(Cache::Handle* handle, bool force_erase) {
         last_reference = false;
       }
     }
-    if (last_reference) {
+    if (last_reference && !e->IsDetached()) {
       size_t total_charge = e->CalcTotalCharge(metadata_charge_policy_);
       assert(usage_ >= total_charge);
       usage_ -= total_charge;
@@ -364,17 +427,33 @@ Status LRUCacheShard::Insert(const Slice& key, uint32_t hash, void* value,
   {
     MutexLock l(&mutex_);
 
+    // An entry that is not admitted is handled like one that does not fit
+    // into a full cache, except that a requested handle is still returned.
+    // The entry is then neither in the cache nor charged to it, and goes
+    // away with its last reference.
+    const bool admitted = Admit(hash, total_charge, priority) ||
+                          table_.Lookup(key, hash) != nullptr;
+
     // Free the space following strict LRU policy until enough space
     // is freed or the lru list is empty
-    EvictFromLRU(total_charge, &last_reference_list);
+    if (admitted) {
+      EvictFromLRU(total_charge, &last_reference_list);
+    }
 
-    if ((usage_ + total_charge) > capacity_ &&
-        (strict_capacity_limit_ || handle == nullptr)) {
+    if (!admitted || ((usage_ + total_charge) > capacity_ &&
+                      (strict_capacity_limit_ || handle == nullptr))) {
       if (handle == nullptr) {
         // Don't insert the entry but still return ok, as if the entry inserted
         // into cache and get evicted immediately.
         e->SetInCache(false);
         last_reference_list.push_back(e);
+      } else if (!admitted && !strict_capacity_limit_) {
+        // The caller owns the memory of a detached entry; charging it would
+        // push usage_ past capacity_ for an entry the cache does not hold.
+        e->SetInCache(false);
+        e->SetDetached();
+        e->Ref();
+        *handle = reinterpret_cast<Cache::Handle*>(e);
       } else {
         delete[] reinterpret_cast<char*>(e);
         *handle = nullptr;
@@ -459,8 +538,12 @@ std::string LRUCacheShard::GetPrintableOptions() const {
   char buffer[kBufferSize];
   {
     MutexLock l(&mutex_);
-    snprintf(buffer, kBufferSize, "    high_pri_pool_ratio: %.3lf\n",
-             high_pri_pool_ratio_);
+    snprintf(buffer, kBufferSize,
+             "    high_pri_pool_ratio: %.3lf\n"
+             "    admission_policy: %s\n",
+             high_pri_pool_ratio_,
+             admission_policy_ == kAdmitByFrequency ? "kAdmitByFrequency"
+                                                    : "kAdmitAll");
   }
   return std::string(buffer);
 }
@@ -469,7 +552,8 @@ LRUCache::LRUCache(size_t capacity, int num_shard_bits,
                    bool strict_capacity_limit, double high_pri_pool_ratio,
                    std::shared_ptr<MemoryAllocator> allocator,
                    bool use_adaptive_mutex,
-                   CacheMetadataChargePolicy metadata_charge_policy)
+                   CacheMetadataChargePolicy metadata_charge_policy,
+                   CacheAdmissionPolicy admission_policy)
     : ShardedCache(capacity, num_shard_bits, strict_capacity_limit,
                    std::move(allocator)) {
   num_shards_ = 1 << num_shard_bits;
@@ -479,7 +563,8 @@ LRUCache::LRUCache(size_t capacity, int num_shard_bits,
   for (int i = 0; i < num_shards_; i++) {
     new (&shards_[i])
         LRUCacheShard(per_shard, strict_capacity_limit, high_pri_pool_ratio,
-                      use_adaptive_mutex, metadata_charge_policy);
+                      use_adaptive_mutex, metadata_charge_policy,
+                      admission_policy);
   }
 }
 
@@ -545,31 +630,33 @@ double LRUCache::GetHighPriPoolRatio() {
 }
 
 std::shared_ptr<Cache> NewLRUCache(const LRUCacheOptions& cache_opts) {
-  return NewLRUCache(cache_opts.capacity, cache_opts.num_shard_bits,
-                     cache_opts.strict_capacity_limit,
-                     cache_opts.high_pri_pool_ratio,
-                     cache_opts.memory_allocator, cache_opts.use_adaptive_mutex,
-                     cache_opts.metadata_charge_policy);
-}
-
-std::shared_ptr<Cache> NewLRUCache(
-    size_t capacity, int num_shard_bits, bool strict_capacity_limit,
-    double high_pri_pool_ratio,
-    std::shared_ptr<MemoryAllocator> memory_allocator, bool use_adaptive_mutex,
-    CacheMetadataChargePolicy metadata_charge_policy) {
+  int num_shard_bits = cache_opts.num_shard_bits;
   if (num_shard_bits >= 20) {
     return nullptr;  // the cache cannot be sharded into too many fine pieces
   }
-  if (high_pri_pool_ratio < 0.0 || high_pri_pool_ratio > 1.0) {
+  if (cache_opts.high_pri_pool_ratio < 0.0 ||
+      cache_opts.high_pri_pool_ratio > 1.0) {
     // invalid high_pri_pool_ratio
     return nullptr;
   }
   if (num_shard_bits < 0) {
-    num_shard_bits = GetDefaultCacheShardBits(capacity);
+    num_shard_bits = GetDefaultCacheShardBits(cache_opts.capacity);
   }
   return std::make_shared<LRUCache>(
+      cache_opts.capacity, num_shard_bits, cache_opts.strict_capacity_limit,
+      cache_opts.high_pri_pool_ratio, cache_opts.memory_allocator,
+      cache_opts.use_adaptive_mutex, cache_opts.metadata_charge_policy,
+      cache_opts.admission_policy);
+}
+
+std::shared_ptr<Cache> NewLRUCache(
+    size_t capacity, int num_shard_bits, bool strict_capacity_limit,
+    double high_pri_pool_ratio,
+    std::shared_ptr<MemoryAllocator> memory_allocator, bool use_adaptive_mutex,
+    CacheMetadataChargePolicy metadata_charge_policy) {
+  return NewLRUCache(LRUCacheOptions(
       capacity, num_shard_bits, strict_capacity_limit, high_pri_pool_ratio,
-      std::move(memory_allocator), use_adaptive_mutex, metadata_charge_policy);
+      std::move(memory_allocator), use_adaptive_mutex, metadata_charge_policy));
 }
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -10,6 +10,7 @@
 
 #include <string>
 
+#include "cache/frequency_sketch.h"
 #include "cache/sharded_cache.h"
 
 #include "port/malloc.h"
@@ -69,6 +70,9 @@ struct LRUHandle {
     IN_HIGH_PRI_POOL = (1 << 2),
     // Wwhether this entry has had any lookups (hits).
     HAS_HIT = (1 << 3),
+    // Whether this entry was handed out without being admitted, and so is
+    // neither in the cache nor charged to its usage.
+    IS_DETACHED = (1 << 4),
   };
 
   uint8_t flags;
@@ -95,6 +99,7 @@ struct LRUHandle {
   bool IsHighPri() const { return flags & IS_HIGH_PRI; }
   bool InHighPriPool() const { return flags & IN_HIGH_PRI_POOL; }
   bool HasHit() const { return flags & HAS_HIT; }
+  bool IsDetached() const { return flags & IS_DETACHED; }
 
   void SetInCache(bool in_cache) {
     if (in_cache) {
@@ -122,6 +127,8 @@ struct LRUHandle {
 
   void SetHit() { flags |= HAS_HIT; }
 
+  void SetDetached() { flags |= IS_DETACHED; }
+
   void Free() {
     assert(refs == 0);
     if (deleter) {
@@ -160,6 +167,8 @@ class LRUHandleTable {
   LRUHandle* Insert(LRUHandle* h);
   LRUHandle* Remove(const Slice& key, uint32_t hash);
 
+  uint32_t GetNumElements() const { return elems_; }
+
   template <typename T>
   void ApplyToAllCacheEntries(T func) {
     for (uint32_t i = 0; i < length_; i++) {
@@ -193,7 +202,8 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShard {
  public:
   LRUCacheShard(size_t capacity, bool strict_capacity_limit,
                 double high_pri_pool_ratio, bool use_adaptive_mutex,
-                CacheMetadataChargePolicy metadata_charge_policy);
+                CacheMetadataChargePolicy metadata_charge_policy,
+                CacheAdmissionPolicy admission_policy = kAdmitAll);
   virtual ~LRUCacheShard() override = default;
 
   // Separate from constructor so caller can easily make an array of LRUCache
@@ -229,6 +239,10 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShard {
   virtual void ApplyToAllCacheEntries(void (*callback)(void*, size_t),
                                       bool thread_safe) override;
 
+  virtual void ApplyToAllCacheKeys(
+      const std::function<void(const Slice& key, bool hit)>& callback,
+      bool thread_safe) override;
+
   virtual void EraseUnRefEntries() override;
 
   virtual std::string GetPrintableOptions() const override;
@@ -256,6 +270,11 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShard {
   // holding the mutex_
   void EvictFromLRU(size_t charge, autovector<LRUHandle*>* deleted);
 
+  // Whether a new entry with the given hash and priority may be inserted,
+  // evicting entries if needed. Always true unless the admission policy is
+  // kAdmitByFrequency. Requires mutex_ held.
+  bool Admit(uint32_t hash, size_t total_charge, Cache::Priority priority);
+
   // Initialized before use.
   size_t capacity_;
 
@@ -272,6 +291,8 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShard {
   // Remember the value to avoid recomputing each time.
   double high_pri_pool_capacity_;
 
+  CacheAdmissionPolicy admission_policy_;
+
   // Dummy head of LRU list.
   // lru.prev is newest entry, lru.next is oldest entry.
   // LRU contains items which can be evicted, ie reference only by cache
@@ -299,6 +320,10 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShard {
   // Memory size for entries residing only in the LRU list
   size_t lru_usage_;
 
+  // Recent lookup frequencies, used when admission_policy_ is
+  // kAdmitByFrequency.
+  FrequencySketch sketch_;
+
   // mutex_ protects the following state.
   // We don't count mutex_ as the cache's internal state so semantically we
   // don't mind mutex_ invoking the non-const actions.
@@ -316,7 +341,8 @@ class LRUCache
            std::shared_ptr<MemoryAllocator> memory_allocator = nullptr,
            bool use_adaptive_mutex = kDefaultToAdaptiveMutex,
            CacheMetadataChargePolicy metadata_charge_policy =
-               kDontChargeCacheMetadata);
+               kDontChargeCacheMetadata,
+           CacheAdmissionPolicy admission_policy = kAdmitAll);
   virtual ~LRUCache();
   virtual const char* Name() const override { return "LRUCache"; }
   virtual CacheShard* GetShard(int shard) override;
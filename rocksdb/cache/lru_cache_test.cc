@@ -9,6 +9,7 @@
 #include <vector>
 #include "port/port.h"
 #include "test_util/testharness.h"
+#include "util/hash.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -26,13 +27,42 @@ class LRUCacheTest : public testing::Test {
   }
 
   void NewCache(size_t capacity, double high_pri_pool_ratio = 0.0,
-                bool use_adaptive_mutex = kDefaultToAdaptiveMutex) {
+                bool use_adaptive_mutex = kDefaultToAdaptiveMutex,
+                CacheAdmissionPolicy admission_policy = kAdmitAll) {
     DeleteCache();
     cache_ = reinterpret_cast<LRUCacheShard*>(
         port::cacheline_aligned_alloc(sizeof(LRUCacheShard)));
     new (cache_) LRUCacheShard(capacity, false /*strict_capcity_limit*/,
                                high_pri_pool_ratio, use_adaptive_mutex,
-                               kDontChargeCacheMetadata);
+                               kDontChargeCacheMetadata, admission_policy);
+  }
+
+  // Like Insert() and Lookup(), but with distinct hashes per key as needed
+  // by the frequency sketch.
+  Status InsertHashed(const std::string& key,
+                      Cache::Handle** handle = nullptr, size_t charge = 1) {
+    return cache_->Insert(key, GetSliceHash(key), nullptr /*value*/, charge,
+                          nullptr /*deleter*/, handle, Cache::Priority::LOW);
+  }
+
+  bool LookupHashed(const std::string& key) {
+    auto handle = cache_->Lookup(key, GetSliceHash(key));
+    if (handle) {
+      cache_->Release(handle);
+      return true;
+    }
+    return false;
+  }
+
+  void Release(Cache::Handle* handle) { cache_->Release(handle); }
+
+  size_t GetUsage() { return cache_->GetUsage(); }
+
+  // Look up the key and insert it on a miss, like a block cache read.
+  void Read(const std::string& key) {
+    if (!LookupHashed(key)) {
+      ASSERT_OK(InsertHashed(key));
+    }
   }
 
   void Insert(const std::string& key,
@@ -191,6 +221,71 @@ TEST_F(LRUCacheTest, EntriesWithPriority) {
   ValidateLRUList({"e", "f", "g", "Z", "d"}, 2);
 }
 
+TEST_F(LRUCacheTest, FrequencyAdmission) {
+  const std::vector<std::string> hot = {"a", "b", "c", "d", "e"};
+  for (CacheAdmissionPolicy policy : {kAdmitAll, kAdmitByFrequency}) {
+    NewCache(hot.size(), 0.0, kDefaultToAdaptiveMutex, policy);
+    for (int round = 0; round < 4; round++) {
+      for (const auto& key : hot) {
+        Read(key);
+      }
+    }
+    // A scan over keys read once
+    for (char c = 'f'; c <= 'z'; c++) {
+      Read(std::string(1, c));
+    }
+    for (const auto& key : hot) {
+      ASSERT_EQ(policy == kAdmitByFrequency, LookupHashed(key));
+    }
+  }
+
+  NewCache(hot.size(), 0.0, kDefaultToAdaptiveMutex, kAdmitByFrequency);
+  for (int round = 0; round < 2; round++) {
+    for (const auto& key : hot) {
+      Read(key);
+    }
+  }
+  // A key that is not admitted can still be pinned by the caller, but it is
+  // neither kept in the cache nor charged to it.
+  Cache::Handle* handle = nullptr;
+  ASSERT_FALSE(LookupHashed("x"));
+  ASSERT_OK(InsertHashed("x", &handle));
+  ASSERT_NE(nullptr, handle);
+  ASSERT_EQ(hot.size(), GetUsage());
+  ASSERT_FALSE(LookupHashed("x"));
+  Release(handle);
+  ASSERT_EQ(hot.size(), GetUsage());
+
+  // Once it is read more often than the eviction candidate, it is admitted.
+  for (int i = 0; i < 4; i++) {
+    ASSERT_FALSE(LookupHashed("x"));
+  }
+  ASSERT_OK(InsertHashed("x"));
+  ASSERT_TRUE(LookupHashed("x"));
+  ASSERT_EQ(hot.size(), GetUsage());
+
+  // A large entry has to be hotter than all the entries it would push out
+  // together, not just the first of them.
+  NewCache(2, 0.0, kDefaultToAdaptiveMutex, kAdmitByFrequency);
+  for (int round = 0; round < 3; round++) {
+    Read("a");
+    Read("b");
+  }
+  for (int i = 0; i < 4; i++) {
+    ASSERT_FALSE(LookupHashed("big"));
+  }
+  ASSERT_OK(InsertHashed("big", nullptr, 2 /*charge*/));
+  ASSERT_FALSE(LookupHashed("big"));
+  ASSERT_TRUE(LookupHashed("a"));
+  ASSERT_TRUE(LookupHashed("b"));
+  for (int i = 0; i < 4; i++) {
+    ASSERT_FALSE(LookupHashed("big"));
+  }
+  ASSERT_OK(InsertHashed("big", nullptr, 2 /*charge*/));
+  ASSERT_TRUE(LookupHashed("big"));
+  ASSERT_EQ(2U, GetUsage());
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
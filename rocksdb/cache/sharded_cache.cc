@@ -117,6 +117,15 @@ void ShardedCache::ApplyToAllCacheEntries(void (*callback)(void*, size_t),
   }
 }
 
+void ShardedCache::ApplyToAllCacheKeys(
+    const std::function<void(const Slice& key, bool hit)>& callback,
+    bool thread_safe) {
+  int num_shards = 1 << num_shard_bits_;
+  for (int s = 0; s < num_shards; s++) {
+    GetShard(s)->ApplyToAllCacheKeys(callback, thread_safe);
+  }
+}
+
 void ShardedCache::EraseUnRefEntries() {
   int num_shards = 1 << num_shard_bits_;
   for (int s = 0; s < num_shards; s++) {
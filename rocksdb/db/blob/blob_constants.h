@@ -13,4 +13,8 @@ namespace ROCKSDB_NAMESPACE {
 
 constexpr uint64_t kInvalidBlobFileNumber = 0;
 
+// Blob files store each blob AES-256-GCM encrypted, like the blocks of table
+// files, followed by its authentication tag
+constexpr uint64_t kBlobEncryptionTagSize = 16;
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,151 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cassert>
+#include <string>
+
+#include "db/blob/blob_garbage_meter.h"
+#include "rocksdb/comparator.h"
+#include "rocksdb/rocksdb_namespace.h"
+#include "rocksdb/status.h"
+#include "table/internal_iterator.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// An internal iterator that passes each entry it is positioned at to
+// BlobGarbageMeter::ProcessInFlow(). Entries that a Seek() jumps over are not
+// counted, so the garbage measured is never more than the actual garbage.
+// Only forward iteration is supported.
+class BlobCountingIterator : public InternalIterator {
+ public:
+  // iter must outlive this iterator. Entries with a user key at or after
+  // *end, if end is given, are not counted: a compaction stops before them
+  // and leaves them to the next subcompaction.
+  BlobCountingIterator(InternalIterator* iter,
+                       BlobGarbageMeter* blob_garbage_meter,
+                       const Comparator* ucmp, const Slice* end)
+      : iter_(iter),
+        blob_garbage_meter_(blob_garbage_meter),
+        ucmp_(ucmp),
+        end_(end) {
+    assert(iter_);
+    assert(blob_garbage_meter_);
+    assert(ucmp_ || !end_);
+
+    UpdateAndCountBlobIfNeeded();
+  }
+
+  bool Valid() const override { return iter_->Valid() && status_.ok(); }
+
+  void SeekToFirst() override {
+    iter_->SeekToFirst();
+    UpdateAndCountBlobIfNeeded();
+  }
+
+  void SeekToLast() override {
+    status_ = Status::NotSupported("BlobCountingIterator::SeekToLast");
+  }
+
+  void Seek(const Slice& target) override {
+    iter_->Seek(target);
+    UpdateAndCountBlobIfNeeded();
+  }
+
+  void SeekForPrev(const Slice& /*target*/) override {
+    status_ = Status::NotSupported("BlobCountingIterator::SeekForPrev");
+  }
+
+  void Next() override {
+    assert(Valid());
+
+    iter_->Next();
+    UpdateAndCountBlobIfNeeded();
+  }
+
+  void Prev() override {
+    status_ = Status::NotSupported("BlobCountingIterator::Prev");
+  }
+
+  Slice key() const override {
+    assert(Valid());
+    return iter_->key();
+  }
+
+  Slice user_key() const override {
+    assert(Valid());
+    return iter_->user_key();
+  }
+
+  Slice value() const override {
+    assert(Valid());
+    return iter_->value();
+  }
+
+  Status status() const override { return status_; }
+
+  bool PrepareValue() override {
+    assert(Valid());
+    return iter_->PrepareValue();
+  }
+
+  bool MayBeOutOfLowerBound() override {
+    assert(Valid());
+    return iter_->MayBeOutOfLowerBound();
+  }
+
+  IterBoundCheck UpperBoundCheckResult() override {
+    assert(Valid());
+    return iter_->UpperBoundCheckResult();
+  }
+
+  void SetPinnedItersMgr(PinnedIteratorsManager* pinned_iters_mgr) override {
+    iter_->SetPinnedItersMgr(pinned_iters_mgr);
+  }
+
+  bool IsKeyPinned() const override {
+    assert(Valid());
+    return iter_->IsKeyPinned();
+  }
+
+  bool IsValuePinned() const override {
+    assert(Valid());
+    return iter_->IsValuePinned();
+  }
+
+  Status GetProperty(std::string prop_name, std::string* prop) override {
+    return iter_->GetProperty(prop_name, prop);
+  }
+
+  bool GetDataBlockPosition(DataBlockPosition* pos) const override {
+    return iter_->GetDataBlockPosition(pos);
+  }
+
+ private:
+  void UpdateAndCountBlobIfNeeded() {
+    assert(!iter_->Valid() || iter_->status().ok());
+
+    if (!iter_->Valid()) {
+      status_ = iter_->status();
+      return;
+    }
+
+    if (end_ && ucmp_->Compare(iter_->user_key(), *end_) >= 0) {
+      status_ = Status::OK();
+      return;
+    }
+
+    status_ = blob_garbage_meter_->ProcessInFlow(iter_->key(), iter_->value());
+  }
+
+  InternalIterator* const iter_;
+  BlobGarbageMeter* const blob_garbage_meter_;
+  const Comparator* const ucmp_;
+  const Slice* const end_;
+  Status status_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
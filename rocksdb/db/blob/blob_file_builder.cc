@@ -7,6 +7,7 @@
 
 #include <cassert>
 
+#include "db/blob/blob_constants.h"
 #include "db/blob/blob_file_addition.h"
 #include "db/blob/blob_index.h"
 #include "db/blob/blob_log_format.h"
@@ -19,6 +20,7 @@
 #include "options/cf_options.h"
 #include "rocksdb/slice.h"
 #include "rocksdb/status.h"
+#include "table/block_based/block.h"
 #include "test_util/sync_point.h"
 #include "util/compression.h"
 
@@ -104,6 +106,9 @@ Status BlobFileBuilder::Add(const Slice& key, const Slice& value,
     }
   }
 
+  std::string encrypted_blob;
+  EncryptBlob(&blob, &encrypted_blob);
+
   uint64_t blob_file_number = 0;
   uint64_t blob_offset = 0;
 
@@ -193,6 +198,7 @@ Status BlobFileBuilder::OpenBlobFileIfNeeded() {
 
   BlobLogHeader header(column_family_id_, blob_compression_type_, has_ttl,
                        expiration_range);
+  header.is_encrypted = true;
 
   {
     TEST_SYNC_POINT("BlobFileBuilder::OpenBlobFileIfNeeded:WriteHeader");
@@ -238,6 +244,23 @@ Status BlobFileBuilder::CompressBlobIfNeeded(
   return Status::OK();
 }
 
+void BlobFileBuilder::EncryptBlob(Slice* blob,
+                                  std::string* encrypted_blob) const {
+  assert(blob);
+  assert(encrypted_blob);
+  assert(encrypted_blob->empty());
+
+  encrypted_blob->reserve(blob->size() + kBlobEncryptionTagSize);
+  encrypted_blob->assign(blob->data(), blob->size());
+
+  unsigned char tag[kBlobEncryptionTagSize];
+  Encryption(Slice(*encrypted_blob), sst_key, gcm_iv, gcm_aad, tag);
+  encrypted_blob->append(reinterpret_cast<const char*>(tag),
+                         kBlobEncryptionTagSize);
+
+  *blob = Slice(*encrypted_blob);
+}
+
 Status BlobFileBuilder::WriteBlobToFile(const Slice& key, const Slice& blob,
                                         uint64_t* blob_file_number,
                                         uint64_t* blob_offset) {
@@ -63,6 +63,7 @@ class BlobFileBuilder {
   bool IsBlobFileOpen() const;
   Status OpenBlobFileIfNeeded();
   Status CompressBlobIfNeeded(Slice* blob, std::string* compressed_blob) const;
+  void EncryptBlob(Slice* blob, std::string* encrypted_blob) const;
   Status WriteBlobToFile(const Slice& key, const Slice& blob,
                          uint64_t* blob_file_number, uint64_t* blob_offset);
   Status CloseBlobFile();
@@ -11,6 +11,7 @@
 #include <utility>
 #include <vector>
 
+#include "db/blob/blob_constants.h"
 #include "db/blob/blob_file_addition.h"
 #include "db/blob/blob_index.h"
 #include "db/blob/blob_log_format.h"
@@ -23,6 +24,7 @@
 #include "rocksdb/env.h"
 #include "rocksdb/file_checksum.h"
 #include "rocksdb/options.h"
+#include "table/block_based/block.h"
 #include "test_util/sync_point.h"
 #include "test_util/testharness.h"
 #include "util/compression.h"
@@ -69,6 +71,7 @@ class BlobFileBuilderTest : public testing::Test {
     ASSERT_EQ(header.version, kVersion1);
     ASSERT_EQ(header.column_family_id, column_family_id);
     ASSERT_EQ(header.compression, blob_compression_type);
+    ASSERT_TRUE(header.is_encrypted);
     ASSERT_FALSE(header.has_ttl);
     ASSERT_EQ(header.expiration_range, ExpirationRange());
 
@@ -85,10 +88,17 @@ class BlobFileBuilderTest : public testing::Test {
       const auto& value = expected_key_value.second;
 
       ASSERT_EQ(record.key_size, key.size());
-      ASSERT_EQ(record.value_size, value.size());
+      ASSERT_EQ(record.value_size, value.size() + kBlobEncryptionTagSize);
       ASSERT_EQ(record.expiration, 0);
       ASSERT_EQ(record.key, key);
-      ASSERT_EQ(record.value, value);
+
+      // The blob is stored encrypted, followed by its authentication tag
+      std::string decrypted_value(record.value.data(), value.size());
+      std::string tag(record.value.data() + value.size(),
+                      kBlobEncryptionTagSize);
+      ASSERT_TRUE(Decryption(Slice(decrypted_value), sst_key, gcm_iv, gcm_aad,
+                             reinterpret_cast<unsigned char*>(&tag[0])));
+      ASSERT_EQ(decrypted_value, value);
 
       // Make sure the blob reference returned by the builder points to the
       // right place
@@ -98,7 +108,7 @@ class BlobFileBuilderTest : public testing::Test {
       ASSERT_FALSE(blob_index.HasTTL());
       ASSERT_EQ(blob_index.file_number(), blob_file_number);
       ASSERT_EQ(blob_index.offset(), blob_offset);
-      ASSERT_EQ(blob_index.size(), value.size());
+      ASSERT_EQ(blob_index.size(), value.size() + kBlobEncryptionTagSize);
     }
 
     BlobLogFooter footer;
@@ -186,7 +196,8 @@ TEST_F(BlobFileBuilderTest, BuildAndCheckOneFile) {
   ASSERT_EQ(blob_file_addition.GetTotalBlobCount(), number_of_blobs);
   ASSERT_EQ(
       blob_file_addition.GetTotalBlobBytes(),
-      number_of_blobs * (BlobLogRecord::kHeaderSize + key_size + value_size));
+      number_of_blobs * (BlobLogRecord::kHeaderSize + key_size + value_size +
+                         kBlobEncryptionTagSize));
 
   // Verify the contents of the new blob file as well as the blob references
   VerifyBlobFile(blob_file_number, blob_file_path, column_family_id,
@@ -266,7 +277,8 @@ TEST_F(BlobFileBuilderTest, BuildAndCheckMultipleFiles) {
     ASSERT_EQ(blob_file_addition.GetBlobFileNumber(), blob_file_number);
     ASSERT_EQ(blob_file_addition.GetTotalBlobCount(), 1);
     ASSERT_EQ(blob_file_addition.GetTotalBlobBytes(),
-              BlobLogRecord::kHeaderSize + key_size + value_size);
+              BlobLogRecord::kHeaderSize + key_size + value_size +
+                  kBlobEncryptionTagSize);
   }
 
   // Verify the contents of the new blob files as well as the blob references
@@ -404,7 +416,8 @@ TEST_F(BlobFileBuilderTest, Compression) {
                               uncompressed_value.size(), &compressed_value));
 
   ASSERT_EQ(blob_file_addition.GetTotalBlobBytes(),
-            BlobLogRecord::kHeaderSize + key_size + compressed_value.size());
+            BlobLogRecord::kHeaderSize + key_size + compressed_value.size() +
+                kBlobEncryptionTagSize);
 
   // Verify the contents of the new blob file as well as the blob reference
   std::vector<std::pair<std::string, std::string>> expected_key_value_pairs{
@@ -551,7 +564,8 @@ TEST_F(BlobFileBuilderTest, Checksum) {
   ASSERT_EQ(blob_file_addition.GetBlobFileNumber(), blob_file_number);
   ASSERT_EQ(blob_file_addition.GetTotalBlobCount(), 1);
   ASSERT_EQ(blob_file_addition.GetTotalBlobBytes(),
-            BlobLogRecord::kHeaderSize + key.size() + value.size());
+            BlobLogRecord::kHeaderSize + key.size() + value.size() +
+                kBlobEncryptionTagSize);
   ASSERT_EQ(blob_file_addition.GetChecksumMethod(), "DummyFileChecksum");
   ASSERT_EQ(blob_file_addition.GetChecksumValue(), "dummy");
 
@@ -8,12 +8,14 @@
 #include <cassert>
 #include <string>
 
+#include "db/blob/blob_constants.h"
 #include "db/blob/blob_log_format.h"
 #include "file/filename.h"
 #include "options/cf_options.h"
 #include "rocksdb/file_system.h"
 #include "rocksdb/slice.h"
 #include "rocksdb/status.h"
+#include "table/block_based/block.h"
 #include "test_util/sync_point.h"
 #include "util/compression.h"
 #include "util/crc32c.h"
@@ -43,10 +45,11 @@ Status BlobFileReader::Create(
   assert(file_reader);
 
   CompressionType compression_type = kNoCompression;
+  bool is_encrypted = false;
 
   {
-    const Status s =
-        ReadHeader(file_reader.get(), column_family_id, &compression_type);
+    const Status s = ReadHeader(file_reader.get(), column_family_id,
+                                &compression_type, &is_encrypted);
     if (!s.ok()) {
       return s;
     }
@@ -59,8 +62,8 @@ Status BlobFileReader::Create(
     }
   }
 
-  blob_file_reader->reset(
-      new BlobFileReader(std::move(file_reader), file_size, compression_type));
+  blob_file_reader->reset(new BlobFileReader(
+      std::move(file_reader), file_size, compression_type, is_encrypted));
 
   return Status::OK();
 }
@@ -127,9 +130,11 @@ Status BlobFileReader::OpenFile(
 
 Status BlobFileReader::ReadHeader(const RandomAccessFileReader* file_reader,
                                   uint32_t column_family_id,
-                                  CompressionType* compression_type) {
+                                  CompressionType* compression_type,
+                                  bool* is_encrypted) {
   assert(file_reader);
   assert(compression_type);
+  assert(is_encrypted);
 
   Slice header_slice;
   Buffer buf;
@@ -171,6 +176,7 @@ Status BlobFileReader::ReadHeader(const RandomAccessFileReader* file_reader,
   }
 
   *compression_type = header.compression;
+  *is_encrypted = header.is_encrypted;
 
   return Status::OK();
 }
@@ -256,10 +262,11 @@ Status BlobFileReader::ReadFromFile(const RandomAccessFileReader* file_reader,
 
 BlobFileReader::BlobFileReader(
     std::unique_ptr<RandomAccessFileReader>&& file_reader, uint64_t file_size,
-    CompressionType compression_type)
+    CompressionType compression_type, bool is_encrypted)
     : file_reader_(std::move(file_reader)),
       file_size_(file_size),
-      compression_type_(compression_type) {
+      compression_type_(compression_type),
+      is_encrypted_(is_encrypted) {
   assert(file_reader_);
 }
 
@@ -320,7 +327,17 @@ Status BlobFileReader::GetBlob(const ReadOptions& read_options,
     }
   }
 
-  const Slice value_slice(record_slice.data() + adjustment, value_size);
+  Slice value_slice(record_slice.data() + adjustment, value_size);
+
+  std::string decrypted_blob;
+
+  if (is_encrypted_) {
+    const Status s = DecryptBlob(value_slice, &decrypted_blob);
+    if (!s.ok()) {
+      return s;
+    }
+    value_slice = decrypted_blob;
+  }
 
   {
     const Status s =
@@ -375,6 +392,28 @@ Status BlobFileReader::VerifyBlob(const Slice& record_slice,
   return Status::OK();
 }
 
+Status BlobFileReader::DecryptBlob(const Slice& value_slice,
+                                   std::string* decrypted_blob) {
+  assert(decrypted_blob);
+
+  if (value_slice.size() < kBlobEncryptionTagSize) {
+    return Status::Corruption("Blob too short for its authentication tag");
+  }
+
+  const size_t blob_size =
+      value_slice.size() - static_cast<size_t>(kBlobEncryptionTagSize);
+  decrypted_blob->assign(value_slice.data(), blob_size);
+  std::string tag(value_slice.data() + blob_size,
+                  static_cast<size_t>(kBlobEncryptionTagSize));
+
+  if (!Decryption(Slice(*decrypted_blob), sst_key, gcm_iv, gcm_aad,
+                  reinterpret_cast<unsigned char*>(&tag[0]))) {
+    return Status::Corruption("Failed to authenticate blob");
+  }
+
+  return Status::OK();
+}
+
 Status BlobFileReader::UncompressBlobIfNeeded(const Slice& value_slice,
                                               CompressionType compression_type,
                                               PinnableSlice* value) {
@@ -7,6 +7,7 @@
 
 #include <cinttypes>
 #include <memory>
+#include <string>
 
 #include "file/random_access_file_reader.h"
 #include "rocksdb/compression_type.h"
@@ -42,7 +43,8 @@ class BlobFileReader {
 
  private:
   BlobFileReader(std::unique_ptr<RandomAccessFileReader>&& file_reader,
-                 uint64_t file_size, CompressionType compression_type);
+                 uint64_t file_size, CompressionType compression_type,
+                 bool is_encrypted);
 
   static Status OpenFile(const ImmutableCFOptions& immutable_cf_options,
                          const FileOptions& file_opts,
@@ -52,7 +54,8 @@ class BlobFileReader {
 
   static Status ReadHeader(const RandomAccessFileReader* file_reader,
                            uint32_t column_family_id,
-                           CompressionType* compression_type);
+                           CompressionType* compression_type,
+                           bool* is_encrypted);
 
   static Status ReadFooter(uint64_t file_size,
                            const RandomAccessFileReader* file_reader);
@@ -67,6 +70,9 @@ class BlobFileReader {
   static Status VerifyBlob(const Slice& record_slice, const Slice& user_key,
                            uint64_t value_size);
 
+  static Status DecryptBlob(const Slice& value_slice,
+                            std::string* decrypted_blob);
+
   static Status UncompressBlobIfNeeded(const Slice& value_slice,
                                        CompressionType compression_type,
                                        PinnableSlice* value);
@@ -76,6 +82,8 @@ class BlobFileReader {
   std::unique_ptr<RandomAccessFileReader> file_reader_;
   uint64_t file_size_;
   CompressionType compression_type_;
+  // Blob files written before blobs were encrypted are read as they are
+  bool is_encrypted_;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -8,6 +8,7 @@
 #include <cassert>
 #include <string>
 
+#include "db/blob/blob_constants.h"
 #include "db/blob/blob_log_format.h"
 #include "db/blob/blob_log_writer.h"
 #include "env/mock_env.h"
@@ -18,6 +19,7 @@
 #include "rocksdb/env.h"
 #include "rocksdb/file_system.h"
 #include "rocksdb/options.h"
+#include "table/block_based/block.h"
 #include "test_util/testharness.h"
 #include "util/compression.h"
 #include "utilities/fault_injection_env.h"
@@ -29,13 +31,15 @@ namespace {
 // Creates a test blob file with a single blob in it. Note: this method
 // makes it possible to test various corner cases by allowing the caller
 // to specify the contents of various blob file header/footer fields.
+// Unencrypted files mimic the ones written before blobs were encrypted.
 void WriteBlobFile(const ImmutableCFOptions& immutable_cf_options,
                    uint32_t column_family_id, bool has_ttl,
                    const ExpirationRange& expiration_range_header,
                    const ExpirationRange& expiration_range_footer,
                    uint64_t blob_file_number, const Slice& key,
                    const Slice& blob, CompressionType compression_type,
-                   uint64_t* blob_offset, uint64_t* blob_size) {
+                   uint64_t* blob_offset, uint64_t* blob_size,
+                   bool is_encrypted = true) {
   assert(!immutable_cf_options.cf_paths.empty());
   assert(blob_offset);
   assert(blob_size);
@@ -60,6 +64,7 @@ void WriteBlobFile(const ImmutableCFOptions& immutable_cf_options,
 
   BlobLogHeader header(column_family_id, compression_type, has_ttl,
                        expiration_range_header);
+  header.is_encrypted = is_encrypted;
 
   ASSERT_OK(blob_log_writer.WriteHeader(header));
 
@@ -68,7 +73,6 @@ void WriteBlobFile(const ImmutableCFOptions& immutable_cf_options,
 
   if (compression_type == kNoCompression) {
     blob_to_write = blob;
-    *blob_size = blob.size();
   } else {
     CompressionOptions opts;
     CompressionContext context(compression_type);
@@ -83,9 +87,22 @@ void WriteBlobFile(const ImmutableCFOptions& immutable_cf_options,
         CompressData(blob, info, compression_format_version, &compressed_blob));
 
     blob_to_write = compressed_blob;
-    *blob_size = compressed_blob.size();
   }
 
+  std::string encrypted_blob;
+
+  if (is_encrypted) {
+    encrypted_blob.assign(blob_to_write.data(), blob_to_write.size());
+    unsigned char tag[kBlobEncryptionTagSize];
+    Encryption(Slice(encrypted_blob), sst_key, gcm_iv, gcm_aad, tag);
+    encrypted_blob.append(reinterpret_cast<const char*>(tag),
+                          kBlobEncryptionTagSize);
+
+    blob_to_write = encrypted_blob;
+  }
+
+  *blob_size = blob_to_write.size();
+
   uint64_t key_offset = 0;
 
   ASSERT_OK(
@@ -482,6 +499,66 @@ TEST_F(BlobFileReaderTest, BlobCRCError) {
   SyncPoint::GetInstance()->ClearAllCallBacks();
 }
 
+TEST_F(BlobFileReaderTest, BlobAuthenticationError) {
+  Options options;
+  options.env = &mock_env_;
+  options.cf_paths.emplace_back(
+      test::PerThreadDBPath(&mock_env_,
+                            "BlobFileReaderTest_BlobAuthenticationError"),
+      0);
+  options.enable_blob_files = true;
+
+  ImmutableCFOptions immutable_cf_options(options);
+
+  constexpr uint32_t column_family_id = 1;
+  constexpr bool has_ttl = false;
+  constexpr ExpirationRange expiration_range;
+  constexpr uint64_t blob_file_number = 1;
+  constexpr char key[] = "key";
+  constexpr char blob[] = "blob";
+
+  uint64_t blob_offset = 0;
+  uint64_t blob_size = 0;
+
+  WriteBlobFile(immutable_cf_options, column_family_id, has_ttl,
+                expiration_range, expiration_range, blob_file_number, key, blob,
+                kNoCompression, &blob_offset, &blob_size);
+
+  constexpr HistogramImpl* blob_file_read_hist = nullptr;
+
+  std::unique_ptr<BlobFileReader> reader;
+
+  ASSERT_OK(BlobFileReader::Create(immutable_cf_options, FileOptions(),
+                                   column_family_id, blob_file_read_hist,
+                                   blob_file_number, &reader));
+
+  // Flip a bit of the encrypted blob; without checksum verification, only
+  // the authentication tag catches it
+  SyncPoint::GetInstance()->SetCallBack(
+      "BlobFileReader::GetBlob:TamperWithResult", [](void* arg) {
+        Slice* const slice = static_cast<Slice*>(arg);
+        assert(slice);
+        assert(!slice->empty());
+
+        const_cast<char*>(slice->data())[0] ^= 0x1;
+      });
+
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  ReadOptions read_options;
+  read_options.verify_checksums = false;
+
+  PinnableSlice value;
+
+  ASSERT_TRUE(reader
+                  ->GetBlob(read_options, key, blob_offset, blob_size,
+                            kNoCompression, &value)
+                  .IsCorruption());
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 TEST_F(BlobFileReaderTest, Compression) {
   if (!Snappy_Supported()) {
     return;
@@ -540,6 +617,50 @@ TEST_F(BlobFileReaderTest, Compression) {
   }
 }
 
+TEST_F(BlobFileReaderTest, Unencrypted) {
+  // Blob files without the encrypted flag in their header are read without
+  // decryption
+
+  Options options;
+  options.env = &mock_env_;
+  options.cf_paths.emplace_back(
+      test::PerThreadDBPath(&mock_env_, "BlobFileReaderTest_Unencrypted"), 0);
+  options.enable_blob_files = true;
+
+  ImmutableCFOptions immutable_cf_options(options);
+
+  constexpr uint32_t column_family_id = 1;
+  constexpr bool has_ttl = false;
+  constexpr ExpirationRange expiration_range;
+  constexpr uint64_t blob_file_number = 1;
+  constexpr char key[] = "key";
+  constexpr char blob[] = "blob";
+  constexpr bool is_encrypted = false;
+
+  uint64_t blob_offset = 0;
+  uint64_t blob_size = 0;
+
+  WriteBlobFile(immutable_cf_options, column_family_id, has_ttl,
+                expiration_range, expiration_range, blob_file_number, key, blob,
+                kNoCompression, &blob_offset, &blob_size, is_encrypted);
+
+  ASSERT_EQ(blob_size, sizeof(blob) - 1);
+
+  constexpr HistogramImpl* blob_file_read_hist = nullptr;
+
+  std::unique_ptr<BlobFileReader> reader;
+
+  ASSERT_OK(BlobFileReader::Create(immutable_cf_options, FileOptions(),
+                                   column_family_id, blob_file_read_hist,
+                                   blob_file_number, &reader));
+
+  PinnableSlice value;
+
+  ASSERT_OK(reader->GetBlob(ReadOptions(), key, blob_offset, blob_size,
+                            kNoCompression, &value));
+  ASSERT_EQ(value, blob);
+}
+
 TEST_F(BlobFileReaderTest, UncompressionError) {
   if (!Snappy_Supported()) {
     return;
@@ -0,0 +1,91 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <unordered_map>
+
+#include "db/blob/blob_constants.h"
+#include "rocksdb/rocksdb_namespace.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class Slice;
+
+// BlobGarbageMeter measures the garbage that a compaction produces in the blob
+// files its input refers to. For each such blob file, it counts the blobs
+// that the input of the compaction refers to (the inflow) and the blobs that
+// its output still refers to (the outflow). The difference is the number of
+// blobs, and their size, that no table file refers to anymore.
+//
+// Blob files the compaction writes have no inflow and are not tracked.
+class BlobGarbageMeter {
+ public:
+  class BlobStats {
+   public:
+    void Add(uint64_t bytes) {
+      ++count_;
+      bytes_ += bytes;
+    }
+
+    uint64_t GetCount() const { return count_; }
+    uint64_t GetBytes() const { return bytes_; }
+
+   private:
+    uint64_t count_ = 0;
+    uint64_t bytes_ = 0;
+  };
+
+  class BlobInOutFlow {
+   public:
+    void AddInFlow(uint64_t bytes) { in_flow_.Add(bytes); }
+    void AddOutFlow(uint64_t bytes) { out_flow_.Add(bytes); }
+
+    bool IsValid() const {
+      return in_flow_.GetCount() >= out_flow_.GetCount() &&
+             in_flow_.GetBytes() >= out_flow_.GetBytes();
+    }
+    bool HasGarbage() const {
+      assert(IsValid());
+      return in_flow_.GetCount() > out_flow_.GetCount();
+    }
+    uint64_t GetGarbageCount() const {
+      assert(IsValid());
+      return in_flow_.GetCount() - out_flow_.GetCount();
+    }
+    uint64_t GetGarbageBytes() const {
+      assert(IsValid());
+      return in_flow_.GetBytes() - out_flow_.GetBytes();
+    }
+
+   private:
+    BlobStats in_flow_;
+    BlobStats out_flow_;
+  };
+
+  // Counts the blob the input entry key, value refers to, if any
+  Status ProcessInFlow(const Slice& key, const Slice& value);
+
+  // Counts the blob the output entry key, value refers to, if any
+  Status ProcessOutFlow(const Slice& key, const Slice& value);
+
+  const std::unordered_map<uint64_t, BlobInOutFlow>& flows() const {
+    return flows_;
+  }
+
+ private:
+  // Sets *blob_file_number to kInvalidBlobFileNumber unless key, value is a
+  // reference to a blob in a blob file. *bytes is the size of the blob record
+  // as accounted by BlobFileBuilder.
+  static Status Parse(const Slice& key, const Slice& value,
+                      uint64_t* blob_file_number, uint64_t* bytes);
+
+  std::unordered_map<uint64_t, BlobInOutFlow> flows_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -18,7 +18,7 @@ void BlobLogHeader::EncodeTo(std::string* dst) {
   PutFixed32(dst, kMagicNumber);
   PutFixed32(dst, version);
   PutFixed32(dst, column_family_id);
-  unsigned char flags = (has_ttl ? 1 : 0);
+  unsigned char flags = (has_ttl ? 1 : 0) | (is_encrypted ? 2 : 0);
   dst->push_back(flags);
   dst->push_back(compression);
   PutFixed64(dst, expiration_range.first);
@@ -49,6 +49,7 @@ Status BlobLogHeader::DecodeFrom(Slice src) {
   flags = src.data()[0];
   compression = static_cast<CompressionType>(src.data()[1]);
   has_ttl = (flags & 1) == 1;
+  is_encrypted = (flags & 2) == 2;
   src.remove_prefix(2);
   if (!GetFixed64(&src, &expiration_range.first) ||
       !GetFixed64(&src, &expiration_range.second)) {
@@ -32,6 +32,8 @@ using ExpirationRange = std::pair<uint64_t, uint64_t>;
 //
 // List of flags:
 //   has_ttl: Whether the file contain TTL data.
+//   is_encrypted: Whether each blob is stored AES-256-GCM encrypted, followed
+//     by its authentication tag.
 //
 // Expiration range in the header is a rough range based on
 // blob_db_options.ttl_range_secs.
@@ -50,6 +52,7 @@ struct BlobLogHeader {
   uint32_t column_family_id = 0;
   CompressionType compression = kNoCompression;
   bool has_ttl = false;
+  bool is_encrypted = false;
   ExpirationRange expiration_range;
 
   void EncodeTo(std::string* dst);
@@ -0,0 +1,120 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/block_cache_manifest.h"
+
+#include <algorithm>
+
+#include "util/coding.h"
+#include "util/crc32c.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// Block cache manifest layout:
+//   magic                  : fixed32
+//   num_files              : varint64
+//   for each file, in increasing file number order:
+//     file_number          : varint64
+//     num_blocks           : varint64
+//     for each block, in increasing offset order:
+//       (offset - previous offset) << 1 | hot : varint64
+//   checksum               : fixed32, masked crc32c of everything above
+const uint32_t kBlockCacheManifestMagic = 0x6d636362;  // "bccm"
+}  // namespace
+
+void BlockCacheManifest::Finalize() {
+  num_blocks_ = 0;
+  for (auto& file : files_) {
+    std::vector<CachedBlock>& blocks = file.second;
+    std::sort(blocks.begin(), blocks.end());
+    blocks.erase(std::unique(blocks.begin(), blocks.end(),
+                             [](const CachedBlock& a, const CachedBlock& b) {
+                               return a.offset == b.offset;
+                             }),
+                 blocks.end());
+    num_blocks_ += blocks.size();
+  }
+}
+
+void BlockCacheManifest::EncodeTo(std::string* dst) const {
+  const size_t start = dst->size();
+  PutFixed32(dst, kBlockCacheManifestMagic);
+  PutVarint64(dst, files_.size());
+  for (const auto& file : files_) {
+    PutVarint64(dst, file.first);
+    PutVarint64(dst, file.second.size());
+    uint64_t prev_offset = 0;
+    for (const CachedBlock& block : file.second) {
+      assert(block.offset >= prev_offset);
+      PutVarint64(dst, ((block.offset - prev_offset) << 1) |
+                           static_cast<uint64_t>(block.hot));
+      prev_offset = block.offset;
+    }
+  }
+  PutFixed32(dst, crc32c::Mask(crc32c::Value(dst->data() + start,
+                                             dst->size() - start)));
+}
+
+Status BlockCacheManifest::DecodeFrom(const Slice& input) {
+  files_.clear();
+  num_blocks_ = 0;
+  if (input.size() < 2 * sizeof(uint32_t)) {
+    return Status::Corruption("Block cache manifest too short");
+  }
+  const size_t body_size = input.size() - sizeof(uint32_t);
+  const uint32_t expected =
+      crc32c::Unmask(DecodeFixed32(input.data() + body_size));
+  if (crc32c::Value(input.data(), body_size) != expected) {
+    return Status::Corruption("Block cache manifest checksum mismatch");
+  }
+  Slice body(input.data(), body_size);
+  if (DecodeFixed32(body.data()) != kBlockCacheManifestMagic) {
+    return Status::Corruption("Bad block cache manifest magic");
+  }
+  body.remove_prefix(sizeof(uint32_t));
+
+  uint64_t num_files = 0;
+  if (!GetVarint64(&body, &num_files)) {
+    return Status::Corruption("Bad block cache manifest file count");
+  }
+  std::map<uint64_t, std::vector<CachedBlock>> files;
+  size_t num_blocks = 0;
+  for (uint64_t i = 0; i < num_files; ++i) {
+    uint64_t file_number = 0;
+    uint64_t count = 0;
+    if (!GetVarint64(&body, &file_number) || !GetVarint64(&body, &count)) {
+      return Status::Corruption("Bad block cache manifest file entry");
+    }
+    // Every block takes at least one byte
+    if (count > body.size()) {
+      return Status::Corruption("Truncated block cache manifest");
+    }
+    std::vector<CachedBlock>& blocks = files[file_number];
+    blocks.reserve(static_cast<size_t>(count));
+    uint64_t offset = 0;
+    for (uint64_t j = 0; j < count; ++j) {
+      uint64_t encoded = 0;
+      if (!GetVarint64(&body, &encoded)) {
+        return Status::Corruption("Bad block cache manifest block entry");
+      }
+      const uint64_t delta = encoded >> 1;
+      if (j > 0 && delta == 0) {
+        return Status::Corruption("Block cache manifest offsets not sorted");
+      }
+      offset += delta;
+      blocks.push_back({offset, (encoded & 1) != 0});
+    }
+    num_blocks += blocks.size();
+  }
+  if (!body.empty()) {
+    return Status::Corruption("Trailing bytes in block cache manifest");
+  }
+  files_ = std::move(files);
+  num_blocks_ = num_blocks;
+  return Status::OK();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
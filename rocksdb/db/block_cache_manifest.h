@@ -0,0 +1,62 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// BlockCacheManifest is a snapshot of the table blocks resident in the block
+// cache, identified by table file number and block offset. DBImpl writes it
+// to BlockCacheManifestFileName() periodically and on close, and replays it
+// on the next DB::Open() to load the same blocks back into the block cache
+// in the background.
+class BlockCacheManifest {
+ public:
+  struct CachedBlock {
+    uint64_t offset;
+    // The block was looked up at least once after it was inserted
+    bool hot;
+
+    bool operator<(const CachedBlock& other) const {
+      return offset < other.offset;
+    }
+  };
+
+  void Add(uint64_t file_number, uint64_t offset, bool hot) {
+    files_[file_number].push_back({offset, hot});
+    ++num_blocks_;
+  }
+
+  // Sort the blocks of each file by offset and drop duplicates. Must be called
+  // before EncodeTo() if blocks were not added in offset order.
+  void Finalize();
+
+  // Serialize the manifest. REQUIRES: Finalize() was called after the last
+  // Add().
+  void EncodeTo(std::string* dst) const;
+
+  // Parse the content of a file written by EncodeTo(). On success the blocks
+  // of each file are in increasing offset order.
+  Status DecodeFrom(const Slice& input);
+
+  const std::map<uint64_t, std::vector<CachedBlock>>& files() const {
+    return files_;
+  }
+
+  size_t num_blocks() const { return num_blocks_; }
+
+ private:
+  std::map<uint64_t, std::vector<CachedBlock>> files_;
+  size_t num_blocks_ = 0;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -3866,6 +3866,16 @@ unsigned char rocksdb_writeoptions_get_memtable_insert_hint_per_batch(
   return opt->rep.memtable_insert_hint_per_batch;
 }
 
+void rocksdb_writeoptions_set_memtable_insert_sort_threshold(
+    rocksdb_writeoptions_t* opt, size_t v) {
+  opt->rep.memtable_insert_sort_threshold = v;
+}
+
+size_t rocksdb_writeoptions_get_memtable_insert_sort_threshold(
+    rocksdb_writeoptions_t* opt) {
+  return opt->rep.memtable_insert_sort_threshold;
+}
+
 rocksdb_compactoptions_t* rocksdb_compactoptions_create() {
   return new rocksdb_compactoptions_t;
 }
@@ -2307,6 +2307,10 @@ int main(int argc, char** argv) {
     CheckCondition(1 ==
                    rocksdb_writeoptions_get_memtable_insert_hint_per_batch(wo));
 
+    rocksdb_writeoptions_set_memtable_insert_sort_threshold(wo, 1000);
+    CheckCondition(
+        1000 == rocksdb_writeoptions_get_memtable_insert_sort_threshold(wo));
+
     rocksdb_writeoptions_destroy(wo);
   }
 
@@ -258,6 +258,21 @@ ColumnFamilyOptions SanitizeOptions(const ImmutableDBOptions& db_options,
   } else if (result.memtable_prefix_bloom_size_ratio < 0) {
     result.memtable_prefix_bloom_size_ratio = 0;
   }
+  // Same for the hash index buckets
+  if (result.memtable_hash_index_size_ratio > 0.25) {
+    result.memtable_hash_index_size_ratio = 0.25;
+  } else if (result.memtable_hash_index_size_ratio < 0) {
+    result.memtable_hash_index_size_ratio = 0;
+  }
+  // Passes that may keep a copy after dropping almost nothing cost more
+  // than the flushes they save
+  if (result.memtable_gc_min_garbage_ratio > 0.9) {
+    result.memtable_gc_min_garbage_ratio = 0.9;
+  } else if (result.memtable_gc_min_garbage_ratio <= 0) {
+    result.memtable_gc_min_garbage_ratio = 0;
+  } else if (result.memtable_gc_min_garbage_ratio < 0.1) {
+    result.memtable_gc_min_garbage_ratio = 0.1;
+  }
 
   if (!result.prefix_extractor) {
     assert(result.memtable_factory);
@@ -526,6 +541,9 @@ ColumnFamilyData::ColumnFamilyData(
       prev_(nullptr),
       log_number_(0),
       flush_reason_(FlushReason::kOthers),
+      flush_output_ratio_(-1.0),
+      memtable_gc_backoff_(0),
+      memtable_gc_skips_left_(0),
       column_family_set_(column_family_set),
       queued_for_flush_(false),
       queued_for_compaction_(false),
@@ -695,6 +713,37 @@ void ColumnFamilyData::SetDropped() {
   column_family_set_->RemoveColumnFamily(this);
 }
 
+void ColumnFamilyData::RecordFlushOutputRatio(uint64_t memtable_bytes,
+                                              uint64_t output_bytes) {
+  if (memtable_bytes == 0) {
+    return;
+  }
+  double ratio = static_cast<double>(output_bytes) / memtable_bytes;
+  if (flush_output_ratio_ < 0) {
+    flush_output_ratio_ = ratio;
+  } else {
+    flush_output_ratio_ = (flush_output_ratio_ + ratio) / 2;
+  }
+}
+
+bool ColumnFamilyData::ShouldTryMemTableGC() {
+  if (memtable_gc_skips_left_ > 0) {
+    --memtable_gc_skips_left_;
+    return false;
+  }
+  return true;
+}
+
+void ColumnFamilyData::RecordMemTableGCResult(bool collected) {
+  if (collected) {
+    memtable_gc_backoff_ = 0;
+  } else {
+    memtable_gc_backoff_ =
+        std::min<uint32_t>(16, std::max<uint32_t>(1, memtable_gc_backoff_ * 2));
+    memtable_gc_skips_left_ = memtable_gc_backoff_;
+  }
+}
+
 ColumnFamilyOptions ColumnFamilyData::GetLatestCFOptions() const {
   return BuildColumnFamilyOptions(initial_cf_options_, mutable_cf_options_);
 }
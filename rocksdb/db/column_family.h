@@ -323,6 +323,25 @@ class ColumnFamilyData {
     flush_reason_ = flush_reason;
   }
   FlushReason GetFlushReason() const { return flush_reason_; }
+
+  // Records the size of the SST file produced by flushing memtables that
+  // used memtable_bytes of memory. Used by cost_based_write_buffer_flush.
+  // REQUIRES: DB mutex held
+  void RecordFlushOutputRatio(uint64_t memtable_bytes, uint64_t output_bytes);
+  // Moving average of flush output bytes per byte of memtable memory, 1.0
+  // before the first flush.
+  // REQUIRES: DB mutex held
+  double flush_output_ratio() const {
+    return flush_output_ratio_ < 0 ? 1.0 : flush_output_ratio_;
+  }
+
+  // Returns true if the next full memtable should be collapsed before it is
+  // flushed, see memtable_gc_min_garbage_ratio. After passes that drop too
+  // little, up to 16 following memtables are flushed without trying.
+  // REQUIRES: DB mutex held
+  bool ShouldTryMemTableGC();
+  // REQUIRES: DB mutex held
+  void RecordMemTableGCResult(bool collected);
   // thread-safe
   const FileOptions* soptions() const;
   const ImmutableCFOptions* ioptions() const { return &ioptions_; }
@@ -574,6 +593,13 @@ class ColumnFamilyData {
 
   std::atomic<FlushReason> flush_reason_;
 
+  // See flush_output_ratio(). Negative until the first flush.
+  double flush_output_ratio_;
+
+  // See ShouldTryMemTableGC()
+  uint32_t memtable_gc_backoff_;
+  uint32_t memtable_gc_skips_left_;
+
   // An object that keeps all the compaction stats
   // and picks the next compaction
   std::unique_ptr<CompactionPicker> compaction_picker_;
@@ -2298,6 +2298,15 @@ TEST_P(ColumnFamilyTest, SanitizeOptions) {
       }
     }
   }
+
+  ColumnFamilyOptions original;
+  for (const auto& ratio : std::vector<std::pair<double, double>>{
+           {-1, 0}, {0, 0}, {0.01, 0.1}, {0.5, 0.5}, {1, 0.9}}) {
+    original.memtable_gc_min_garbage_ratio = ratio.first;
+    ColumnFamilyOptions result =
+        SanitizeOptions(ImmutableDBOptions(db_options), original);
+    ASSERT_EQ(ratio.second, result.memtable_gc_min_garbage_ratio);
+  }
 }
 
 TEST_P(ColumnFamilyTest, ReadDroppedColumnFamily) {
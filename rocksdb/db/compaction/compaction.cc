@@ -357,6 +357,24 @@ bool Compaction::IsTrivialMove() const {
   return true;
 }
 
+bool Compaction::CanMoveNonOverlappingParts() const {
+  if (!immutable_cf_options_.enable_partial_trivial_move ||
+      immutable_cf_options_.compaction_style != kCompactionStyleLevel ||
+      immutable_cf_options_.sst_partitioner_factory != nullptr) {
+    return false;
+  }
+  // Manual compactions may be meant to run the compaction filter on all data
+  if (is_manual_compaction_ ||
+      compaction_reason_ != CompactionReason::kLevelMaxLevelSize) {
+    return false;
+  }
+  return start_level_ > 0 && output_level_ == start_level_ + 1 &&
+         num_input_levels() == 2 && num_input_files(0) == 1 &&
+         num_input_files(1) > 0 &&
+         input(0, 0)->fd.GetPathId() == output_path_id() &&
+         InputCompressionMatchesOutput();
+}
+
 void Compaction::AddInputDeletions(VersionEdit* out_edit) {
   for (size_t which = 0; which < num_input_levels(); which++) {
     for (size_t i = 0; i < inputs_[which].size(); i++) {
@@ -560,11 +578,18 @@ bool Compaction::ShouldFormSubcompactions() const {
   if (max_subcompactions_ <= 1 || cfd_ == nullptr) {
     return false;
   }
+  if (output_level_ == 0) {
+    // Intra-L0 or universal compaction into L0
+    return immutable_cf_options_.enable_l0_subcompactions &&
+           (cfd_->ioptions()->compaction_style == kCompactionStyleLevel ||
+            cfd_->ioptions()->compaction_style == kCompactionStyleUniversal);
+  }
   if (cfd_->ioptions()->compaction_style == kCompactionStyleLevel) {
-    return (start_level_ == 0 || is_manual_compaction_) && output_level_ > 0 &&
-           !IsOutputLevelEmpty();
+    return (start_level_ == 0 || is_manual_compaction_) &&
+           (!IsOutputLevelEmpty() ||
+            immutable_cf_options_.sample_subcompaction_boundaries);
   } else if (cfd_->ioptions()->compaction_style == kCompactionStyleUniversal) {
-    return number_levels_ > 1 && output_level_ > 0;
+    return number_levels_ > 1;
   } else {
     return false;
   }
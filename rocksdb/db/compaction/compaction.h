@@ -173,6 +173,11 @@ class Compaction {
   // moving a single input file to the next level (no merging or splitting)
   bool IsTrivialMove() const;
 
+  // Whether the parts of the single start level input file that do not
+  // overlap the output level input files may be moved to the output level as
+  // table slices instead (DBOptions::enable_partial_trivial_move).
+  bool CanMoveNonOverlappingParts() const;
+
   // If true, then the compaction can be done by simply deleting input files.
   bool deletion_compaction() const { return deletion_compaction_; }
 
@@ -0,0 +1,338 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/compaction/compaction_input_coverage.h"
+
+#include <algorithm>
+#include <memory>
+#include <unordered_set>
+
+#include "db/column_family.h"
+#include "db/compaction/compaction.h"
+#include "db/range_tombstone_fragmenter.h"
+#include "db/table_cache.h"
+#include "db/version_edit.h"
+#include "table/internal_iterator.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class CompactionInputCoverage::SkippingIterator : public InternalIterator {
+ public:
+  SkippingIterator(InternalIterator* iter, const Comparator* ucmp,
+                   const FileMetaData& file, const std::vector<Range>& ranges,
+                   std::atomic<uint64_t>* skips)
+      : iter_(iter),
+        ucmp_(ucmp),
+        smallest_user_key_(file.smallest.user_key().ToString()),
+        largest_user_key_(file.largest.user_key().ToString()),
+        ranges_(ranges),
+        skips_(skips) {}
+
+  ~SkippingIterator() override { delete iter_; }
+
+  bool Valid() const override { return iter_->Valid(); }
+
+  void SeekToFirst() override {
+    SeekRangeIndex(smallest_user_key_);
+    if (IsCovered(smallest_user_key_)) {
+      SeekPastRange();
+    } else {
+      iter_->SeekToFirst();
+    }
+    SkipForward();
+  }
+
+  void Seek(const Slice& target) override {
+    const Slice user_key = ExtractUserKey(target);
+    SeekRangeIndex(user_key);
+    if (IsCovered(user_key)) {
+      SeekPastRange();
+    } else {
+      iter_->Seek(target);
+    }
+    SkipForward();
+  }
+
+  void Next() override {
+    assert(Valid());
+    iter_->Next();
+    SkipForward();
+  }
+
+  // Compactions only iterate forward. The backward operations look the
+  // covered range up for every entry.
+  void SeekToLast() override {
+    SeekRangeIndex(largest_user_key_);
+    if (IsCovered(largest_user_key_)) {
+      SeekBeforeRange();
+    } else {
+      iter_->SeekToLast();
+    }
+    SkipBackward();
+  }
+
+  void SeekForPrev(const Slice& target) override {
+    const Slice user_key = ExtractUserKey(target);
+    SeekRangeIndex(user_key);
+    if (IsCovered(user_key)) {
+      SeekBeforeRange();
+    } else {
+      iter_->SeekForPrev(target);
+    }
+    SkipBackward();
+  }
+
+  void Prev() override {
+    assert(Valid());
+    iter_->Prev();
+    SkipBackward();
+  }
+
+  Slice key() const override { return iter_->key(); }
+  Slice user_key() const override { return iter_->user_key(); }
+  Slice value() const override { return iter_->value(); }
+  Status status() const override { return iter_->status(); }
+  bool PrepareValue() override { return iter_->PrepareValue(); }
+
+  bool MayBeOutOfLowerBound() override {
+    return iter_->MayBeOutOfLowerBound();
+  }
+
+  IterBoundCheck UpperBoundCheckResult() override {
+    return iter_->UpperBoundCheckResult();
+  }
+
+  void SetPinnedItersMgr(PinnedIteratorsManager* pinned_iters_mgr) override {
+    iter_->SetPinnedItersMgr(pinned_iters_mgr);
+  }
+
+  bool IsKeyPinned() const override { return iter_->IsKeyPinned(); }
+  bool IsValuePinned() const override { return iter_->IsValuePinned(); }
+
+  Status GetProperty(std::string prop_name, std::string* prop) override {
+    return iter_->GetProperty(prop_name, prop);
+  }
+
+  // The entries after a skipped range do not follow the entries before it
+  // in their data block, so such a block is never seen whole.
+  bool GetDataBlockPosition(DataBlockPosition* pos) const override {
+    return iter_->GetDataBlockPosition(pos);
+  }
+
+ private:
+  // Positions range_index_ at the first range that ends after user_key
+  void SeekRangeIndex(const Slice& user_key) {
+    range_index_ = static_cast<size_t>(
+        std::upper_bound(ranges_.begin(), ranges_.end(), user_key,
+                         [this](const Slice& key, const Range& range) {
+                           return ucmp_->Compare(key, range.end) < 0;
+                         }) -
+        ranges_.begin());
+  }
+
+  // REQUIRES: range_index_ is the first range that ends after user_key
+  bool IsCovered(const Slice& user_key) const {
+    return range_index_ < ranges_.size() &&
+           ucmp_->Compare(user_key, ranges_[range_index_].start) >= 0;
+  }
+
+  void SeekPastRange() {
+    seek_key_.SetInternalKey(ranges_[range_index_].end, kMaxSequenceNumber,
+                             kValueTypeForSeek);
+    iter_->Seek(seek_key_.GetInternalKey());
+    range_index_++;
+    skips_->fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void SeekBeforeRange() {
+    seek_key_.SetInternalKey(ranges_[range_index_].start, kMaxSequenceNumber,
+                             kValueTypeForSeek);
+    iter_->SeekForPrev(seek_key_.GetInternalKey());
+    skips_->fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void SkipForward() {
+    while (iter_->Valid()) {
+      const Slice user_key = iter_->user_key();
+      while (range_index_ < ranges_.size() &&
+             ucmp_->Compare(user_key, ranges_[range_index_].end) >= 0) {
+        range_index_++;
+      }
+      if (!IsCovered(user_key)) {
+        break;
+      }
+      SeekPastRange();
+    }
+  }
+
+  void SkipBackward() {
+    while (iter_->Valid()) {
+      SeekRangeIndex(iter_->user_key());
+      if (!IsCovered(iter_->user_key())) {
+        break;
+      }
+      SeekBeforeRange();
+    }
+  }
+
+  InternalIterator* const iter_;
+  const Comparator* const ucmp_;
+  const std::string smallest_user_key_;
+  const std::string largest_user_key_;
+  const std::vector<Range>& ranges_;
+  std::atomic<uint64_t>* const skips_;
+  size_t range_index_ = 0;
+  IterKey seek_key_;
+};
+
+CompactionInputCoverage::CompactionInputCoverage(
+    const Compaction* compaction, const std::vector<SequenceNumber>& snapshots)
+    : compaction_(compaction),
+      snapshots_(snapshots),
+      dropped_files_(0),
+      skips_(0) {}
+
+Status CompactionInputCoverage::Init(const ReadOptions& read_options) {
+  ColumnFamilyData* cfd = compaction_->column_family_data();
+  const InternalKeyComparator& icmp = cfd->internal_comparator();
+  const Comparator* ucmp = icmp.user_comparator();
+
+  struct Tombstone {
+    Range range;
+    SequenceNumber seq;
+    // The entries at the user key range.start with a greater sequence number
+    // are not covered, if the tombstone was truncated there
+    SequenceNumber start_max_seq;
+  };
+  std::vector<Tombstone> tombstones;
+  std::unordered_set<const FileMetaData*> files_with_tombstones;
+  for (size_t which = 0; which < compaction_->num_input_levels(); which++) {
+    const LevelFilesBrief* flevel = compaction_->input_levels(which);
+    // As in VersionSet::MakeInputIterator(), the tombstones of L0 files are
+    // not truncated
+    const std::vector<AtomicCompactionUnitBoundary>* boundaries =
+        compaction_->level(which) == 0 ? nullptr
+                                       : compaction_->boundaries(which);
+    for (size_t i = 0; i < flevel->num_files; i++) {
+      const FileMetaData& file = *flevel->files[i].file_metadata;
+      std::unique_ptr<FragmentedRangeTombstoneIterator> iter;
+      Status s = cfd->table_cache()->GetRangeTombstoneIterator(
+          read_options, icmp, file, &iter);
+      if (!s.ok()) {
+        return s;
+      }
+      if (iter == nullptr || iter->empty()) {
+        continue;
+      }
+      files_with_tombstones.insert(&file);
+      const InternalKey* smallest =
+          boundaries != nullptr ? (*boundaries)[i].smallest : nullptr;
+      const InternalKey* largest =
+          boundaries != nullptr ? (*boundaries)[i].largest : nullptr;
+      for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+        Slice start = iter->start_key();
+        Slice end = iter->end_key();
+        SequenceNumber start_max_seq = kMaxSequenceNumber;
+        if (smallest != nullptr &&
+            ucmp->Compare(start, smallest->user_key()) <= 0) {
+          start = smallest->user_key();
+          start_max_seq = GetInternalKeySeqno(smallest->Encode());
+        }
+        // Truncating at largest may leave the entries of its user key
+        // covered or not; they are left out.
+        if (largest != nullptr &&
+            ucmp->Compare(end, largest->user_key()) > 0) {
+          end = largest->user_key();
+        }
+        if (ucmp->Compare(start, end) >= 0) {
+          continue;
+        }
+        tombstones.push_back(
+            {{start.ToString(), end.ToString()}, iter->seq(), start_max_seq});
+      }
+    }
+  }
+  if (tombstones.empty()) {
+    return Status::OK();
+  }
+
+  auto range_start_less = [ucmp](const Range& a, const Range& b) {
+    return ucmp->Compare(a.start, b.start) < 0;
+  };
+  for (size_t which = 0; which < compaction_->num_input_levels(); which++) {
+    for (const FileMetaData* file : *compaction_->inputs(which)) {
+      const Slice smallest_user_key = file->smallest.user_key();
+      const Slice largest_user_key = file->largest.user_key();
+      const SequenceNumber largest_seqno = file->fd.largest_seqno;
+      // The compaction iterator only drops an entry for a tombstone of the
+      // same snapshot stripe, the range of sequence numbers up to and
+      // including the first snapshot at or after the entry.
+      auto snapshot = std::lower_bound(snapshots_.begin(), snapshots_.end(),
+                                       file->fd.smallest_seqno);
+      const SequenceNumber stripe_upper =
+          snapshot == snapshots_.end() ? kMaxSequenceNumber : *snapshot;
+
+      std::vector<Range> ranges;
+      for (const auto& tombstone : tombstones) {
+        if (tombstone.seq <= largest_seqno || tombstone.seq > stripe_upper ||
+            tombstone.start_max_seq < largest_seqno ||
+            ucmp->Compare(tombstone.range.end, smallest_user_key) <= 0 ||
+            ucmp->Compare(tombstone.range.start, largest_user_key) > 0) {
+          continue;
+        }
+        ranges.push_back(tombstone.range);
+      }
+      if (ranges.empty()) {
+        continue;
+      }
+      std::sort(ranges.begin(), ranges.end(), range_start_less);
+      FileCoverage& coverage = files_[file];
+      for (auto& range : ranges) {
+        if (!coverage.ranges.empty() &&
+            ucmp->Compare(range.start, coverage.ranges.back().end) <= 0) {
+          if (ucmp->Compare(range.end, coverage.ranges.back().end) > 0) {
+            coverage.ranges.back().end = std::move(range.end);
+          }
+        } else {
+          coverage.ranges.push_back(std::move(range));
+        }
+      }
+      if (files_with_tombstones.count(file) == 0) {
+        for (const auto& range : coverage.ranges) {
+          if (ucmp->Compare(range.start, smallest_user_key) <= 0 &&
+              ucmp->Compare(range.end, largest_user_key) > 0) {
+            coverage.whole_file = true;
+            break;
+          }
+        }
+      }
+    }
+  }
+  return Status::OK();
+}
+
+bool CompactionInputCoverage::IsFileCovered(const FileMetaData& file) const {
+  auto it = files_.find(&file);
+  if (it == files_.end() || !it->second.whole_file) {
+    return false;
+  }
+  dropped_files_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+InternalIterator* CompactionInputCoverage::NewSkippingIterator(
+    const FileMetaData& file, InternalIterator* iter) const {
+  auto it = files_.find(&file);
+  if (it == files_.end()) {
+    return iter;
+  }
+  return new SkippingIterator(iter,
+                              compaction_->column_family_data()
+                                  ->internal_comparator()
+                                  .user_comparator(),
+                              file, it->second.ranges, &skips_);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
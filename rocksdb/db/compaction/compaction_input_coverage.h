@@ -0,0 +1,85 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "db/dbformat.h"
+#include "rocksdb/options.h"
+#include "rocksdb/status.h"
+#include "rocksdb/types.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class Compaction;
+struct FileMetaData;
+template <class TValue>
+class InternalIteratorBase;
+using InternalIterator = InternalIteratorBase<Slice>;
+
+// CompactionInputCoverage implements DBOptions::
+// skip_range_deleted_compaction_input. It finds the user key ranges of each
+// input file of a compaction in which the compaction iterator would drop
+// every entry because a range tombstone of the compaction covers it: the
+// tombstone is newer than every entry of the file and no snapshot separates
+// them. The iterators over the input files then skip these ranges without
+// reading them.
+//
+// The tombstones are truncated as the compaction truncates them, or more.
+// A file that is covered as a whole is dropped only if it has no range
+// tombstones of its own, which the compaction could otherwise still need.
+class CompactionInputCoverage {
+ public:
+  // REQUIRES: snapshots are sorted in ascending order
+  CompactionInputCoverage(const Compaction* compaction,
+                          const std::vector<SequenceNumber>& snapshots);
+
+  // Reads the range tombstones of the input files and computes the covered
+  // ranges. Until it succeeds, nothing is covered.
+  Status Init(const ReadOptions& read_options);
+
+  // Whether the compaction may skip reading file altogether
+  bool IsFileCovered(const FileMetaData& file) const;
+
+  // Returns an iterator over the entries of iter, the iterator over the
+  // entries of file, outside of the covered ranges of file. Takes ownership
+  // of iter. Returns iter itself if nothing of file is covered.
+  InternalIterator* NewSkippingIterator(const FileMetaData& file,
+                                        InternalIterator* iter) const;
+
+  // Number of files that IsFileCovered() returned true for
+  uint64_t dropped_files() const {
+    return dropped_files_.load(std::memory_order_relaxed);
+  }
+  // Number of times the skipping iterators sought past a covered range
+  uint64_t skips() const { return skips_.load(std::memory_order_relaxed); }
+
+ private:
+  // Entries with a user key in [start, end) are covered
+  struct Range {
+    std::string start;
+    std::string end;
+  };
+
+  struct FileCoverage {
+    // Sorted, disjoint and not adjacent
+    std::vector<Range> ranges;
+    bool whole_file = false;
+  };
+
+  class SkippingIterator;
+
+  const Compaction* compaction_;
+  const std::vector<SequenceNumber>& snapshots_;
+  std::unordered_map<const FileMetaData*, FileCoverage> files_;
+  mutable std::atomic<uint64_t> dropped_files_;
+  mutable std::atomic<uint64_t> skips_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -6,9 +6,14 @@
 #include "db/compaction/compaction_iterator.h"
 
 #include <cinttypes>
+#include <iterator>
+#include <limits>
 
 #include "db/blob/blob_file_builder.h"
+#include "db/blob/blob_file_reader.h"
+#include "db/blob/blob_index.h"
 #include "db/snapshot_checker.h"
+#include "db/version_set.h"
 #include "port/likely.h"
 #include "rocksdb/listener.h"
 #include "table/internal_iterator.h"
@@ -100,6 +105,8 @@ CompactionIterator::CompactionIterator(
   if (compaction_ != nullptr) {
     level_ptrs_ = std::vector<size_t>(compaction_->number_levels(), 0);
   }
+  blob_garbage_collection_cutoff_file_number_ =
+      ComputeBlobGarbageCollectionCutoffFileNumber();
   if (snapshots_->size() == 0) {
     // optimize for fast path if there are no snapshots
     visible_at_tip_ = true;
@@ -677,6 +684,99 @@ void CompactionIterator::NextFromInput() {
   }
 }
 
+uint64_t CompactionIterator::ComputeBlobGarbageCollectionCutoffFileNumber()
+    const {
+  if (compaction_ == nullptr ||
+      !compaction_->enable_blob_garbage_collection()) {
+    return 0;
+  }
+
+  Version* const version = compaction_->input_version();
+  if (version == nullptr) {
+    return 0;
+  }
+
+  const auto& blob_files = version->storage_info()->GetBlobFiles();
+  const size_t cutoff_index = static_cast<size_t>(
+      compaction_->blob_garbage_collection_age_cutoff() * blob_files.size());
+  if (cutoff_index >= blob_files.size()) {
+    return std::numeric_limits<uint64_t>::max();
+  }
+
+  // Blob files are ordered by file number, oldest first
+  auto it = blob_files.begin();
+  std::advance(it, cutoff_index);
+  return it->first;
+}
+
+void CompactionIterator::GarbageCollectBlobIfNeeded() {
+  assert(ikey_.type == kTypeBlobIndex);
+
+  if (blob_garbage_collection_cutoff_file_number_ == 0) {
+    return;
+  }
+
+  BlobIndex blob_index;
+  {
+    const Status s = blob_index.DecodeFrom(value_);
+    if (!s.ok()) {
+      status_ = s;
+      valid_ = false;
+      return;
+    }
+  }
+
+  if (blob_index.IsInlined() || blob_index.HasTTL() ||
+      blob_index.file_number() >= blob_garbage_collection_cutoff_file_number_) {
+    return;
+  }
+
+  std::unique_ptr<BlobFileReader>& reader =
+      blob_file_readers_[blob_index.file_number()];
+  if (!reader) {
+    const Status s = compaction_->input_version()->NewBlobFileReader(
+        blob_index.file_number(), &reader);
+    if (!s.ok()) {
+      status_ = s;
+      valid_ = false;
+      return;
+    }
+  }
+
+  PinnableSlice blob;
+  {
+    const Status s = reader->GetBlob(ReadOptions(), user_key(),
+                                     blob_index.offset(), blob_index.size(),
+                                     blob_index.compression(), &blob);
+    if (!s.ok()) {
+      status_ = s;
+      valid_ = false;
+      return;
+    }
+  }
+  blob_value_.assign(blob.data(), blob.size());
+
+  if (blob_file_builder_) {
+    blob_index_.clear();
+    const Status s =
+        blob_file_builder_->Add(user_key(), blob_value_, &blob_index_);
+    if (!s.ok()) {
+      status_ = s;
+      valid_ = false;
+      return;
+    }
+
+    if (!blob_index_.empty()) {
+      value_ = blob_index_;
+      return;
+    }
+  }
+
+  value_ = blob_value_;
+  ikey_.type = kTypeValue;
+  current_key_.UpdateInternalKey(ikey_.sequence, ikey_.type);
+}
+
 void CompactionIterator::PrepareOutput() {
   if (valid_) {
     if (ikey_.type == kTypeValue) {
@@ -695,7 +795,9 @@ void CompactionIterator::PrepareOutput() {
         }
       }
     } else if (ikey_.type == kTypeBlobIndex) {
-      if (compaction_filter_) {
+      if (!compaction_filter_) {
+        GarbageCollectBlobIfNeeded();
+      } else {
         const auto blob_decision = compaction_filter_->PrepareBlobOutput(
             user_key(), value_, &compaction_filter_value_);
 
@@ -709,6 +811,9 @@ void CompactionIterator::PrepareOutput() {
         } else if (blob_decision ==
                    CompactionFilter::BlobDecision::kChangeValue) {
           value_ = compaction_filter_value_;
+        } else {
+          assert(blob_decision == CompactionFilter::BlobDecision::kKeep);
+          GarbageCollectBlobIfNeeded();
         }
       }
     }
@@ -6,7 +6,9 @@
 
 #include <algorithm>
 #include <deque>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -22,6 +24,8 @@
 namespace ROCKSDB_NAMESPACE {
 
 class BlobFileBuilder;
+class BlobFileReader;
+class Version;
 
 class CompactionIterator {
  public:
@@ -53,6 +57,16 @@ class CompactionIterator {
     virtual bool preserve_deletes() const {
       return compaction_->immutable_cf_options()->preserve_deletes;
     }
+    virtual bool enable_blob_garbage_collection() const {
+      return compaction_->mutable_cf_options()->enable_blob_garbage_collection;
+    }
+    virtual double blob_garbage_collection_age_cutoff() const {
+      return compaction_->mutable_cf_options()
+          ->blob_garbage_collection_age_cutoff;
+    }
+    virtual Version* input_version() const {
+      return compaction_->input_version();
+    }
 
    protected:
     CompactionProxy() = default;
@@ -126,6 +140,15 @@ class CompactionIterator {
   // compression.
   void PrepareOutput();
 
+  // Returns the file number below which blob files are garbage collected, or
+  // 0 if blob garbage collection is disabled.
+  uint64_t ComputeBlobGarbageCollectionCutoffFileNumber() const;
+
+  // If value_ refers to a blob in a blob file that is garbage collected,
+  // reads the blob and writes it to a new blob file, or inline if
+  // blob_file_builder_ is null or the blob is too small.
+  void GarbageCollectBlobIfNeeded();
+
   // Invoke compaction filter if needed.
   // Return true on success, false on failures (e.g.: kIOError).
   bool InvokeFilterIfNeeded(bool* need_skip, Slice* skip_until);
@@ -219,6 +242,11 @@ class CompactionIterator {
   // merge operands and then releasing them after consuming them.
   PinnedIteratorsManager pinned_iters_mgr_;
   std::string blob_index_;
+  uint64_t blob_garbage_collection_cutoff_file_number_;
+  // Readers of the blob files that blobs were relocated from, by file number
+  std::unordered_map<uint64_t, std::unique_ptr<BlobFileReader>>
+      blob_file_readers_;
+  std::string blob_value_;
   std::string compaction_filter_value_;
   InternalKey compaction_filter_skip_until_;
   // "level_ptrs" holds indices that remember which file of an associated
@@ -13,6 +13,7 @@
 #include <cinttypes>
 #include <functional>
 #include <list>
+#include <map>
 #include <memory>
 #include <random>
 #include <set>
@@ -20,7 +21,13 @@
 #include <utility>
 #include <vector>
 
+#include "db/blob/blob_counting_iterator.h"
+#include "db/blob/blob_file_addition.h"
+#include "db/blob/blob_file_builder.h"
+#include "db/blob/blob_garbage_meter.h"
 #include "db/builder.h"
+#include "db/compaction/compaction_input_coverage.h"
+#include "db/compaction/pipelined_input_iterator.h"
 #include "db/db_impl/db_impl.h"
 #include "db/db_iter.h"
 #include "db/dbformat.h"
@@ -34,6 +41,7 @@
 #include "db/merge_helper.h"
 #include "db/output_validator.h"
 #include "db/range_del_aggregator.h"
+#include "db/table_cache.h"
 #include "db/version_set.h"
 #include "file/filename.h"
 #include "file/read_write_util.h"
@@ -44,7 +52,9 @@
 #include "monitoring/iostats_context_imp.h"
 #include "monitoring/perf_context_imp.h"
 #include "monitoring/thread_status_util.h"
+#include "options/options_helper.h"
 #include "port/port.h"
+#include "rocksdb/convenience.h"
 #include "rocksdb/db.h"
 #include "rocksdb/env.h"
 #include "rocksdb/sst_partitioner.h"
@@ -54,6 +64,7 @@
 #include "table/block_based/block.h"
 #include "table/block_based/block_based_table_factory.h"
 #include "table/merging_iterator.h"
+#include "table/table_reader.h"
 #include "table/table_builder.h"
 #include "test_util/sync_point.h"
 #include "util/coding.h"
@@ -141,6 +152,13 @@ struct CompactionJob::SubcompactionState {
   std::unique_ptr<WritableFileWriter> outfile;
   std::unique_ptr<TableBuilder> builder;
 
+  // Blob files written by this subcompaction
+  std::vector<BlobFileAddition> blob_file_additions;
+  std::vector<std::string> blob_file_paths;
+  // Measures the garbage this subcompaction produces in the blob files of its
+  // input, if any of them refers to blob files
+  std::unique_ptr<BlobGarbageMeter> blob_garbage_meter;
+
   Output* current_output() {
     if (outputs.empty()) {
       // This subcompaction's output could be empty if compaction was aborted
@@ -168,6 +186,14 @@ struct CompactionJob::SubcompactionState {
   uint64_t overlapped_bytes = 0;
   // A flag determine whether the key has been seen in ShouldStopBefore()
   bool seen_key = false;
+  // For DBOptions::reuse_compaction_input_blocks: whether the entries added
+  // to the current output block since it was cut all come, in a row, from
+  // the input data block of passthrough_block, the position of the last one.
+  bool passthrough_active = false;
+  DataBlockPosition passthrough_block;
+  // No entry was added to the current output file yet, or the last one ended
+  // its input data block.
+  bool at_input_block_boundary = true;
 
   SubcompactionState(Compaction* c, Slice* _start, Slice* _end, uint64_t size)
       : compaction(c), start(_start), end(_end), approx_size(size) {
@@ -188,6 +214,45 @@ struct CompactionJob::SubcompactionState {
     return Status::OK();
   }
 
+  // Like AddToBuilder(), for an entry output unchanged from the input data
+  // block position pos, or nullptr if it was changed or is not in a data
+  // block. Once every entry of an input data block went into an output block
+  // of its own, the builder is asked to copy the stored input block, and
+  // *block_copied tells whether it did.
+  Status AddToBuilder(const Slice& key, const Slice& value,
+                      const DataBlockPosition* pos, bool* block_copied) {
+    *block_copied = false;
+    if (pos == nullptr) {
+      passthrough_active = false;
+      at_input_block_boundary = false;
+      return AddToBuilder(key, value);
+    }
+    if (pos->entry_offset == 0) {
+      // Only cut the output block where the inputs are not interleaved, so
+      // that a block that does not end up copied is not left short.
+      passthrough_active = at_input_block_boundary;
+      if (passthrough_active) {
+        builder->FlushDataBlock();
+      }
+    } else if (passthrough_active &&
+               (pos->table != passthrough_block.table ||
+                pos->handle != passthrough_block.handle ||
+                pos->entry_offset != passthrough_block.next_entry_offset)) {
+      passthrough_active = false;
+    }
+    Status s = AddToBuilder(key, value);
+    if (!s.ok()) {
+      return s;
+    }
+    passthrough_block = *pos;
+    at_input_block_boundary = pos->next_entry_offset == pos->entries_end;
+    if (passthrough_active && at_input_block_boundary) {
+      *block_copied = builder->CopyDataBlock(*pos);
+      passthrough_active = false;
+    }
+    return Status::OK();
+  }
+
   // Returns true iff we should stop building the current output
   // before processing "internal_key".
   bool ShouldStopBefore(const Slice& internal_key, uint64_t curr_file_size) {
@@ -283,6 +348,7 @@ void CompactionJob::AggregateStatistics() {
 
 CompactionJob::CompactionJob(
     int job_id, Compaction* compaction, const ImmutableDBOptions& db_options,
+    const MutableDBOptions& mutable_db_options,
     const FileOptions& file_options, VersionSet* versions,
     const std::atomic<bool>* shutting_down,
     const SequenceNumber preserve_deletes_seqnum, LogBuffer* log_buffer,
@@ -304,6 +370,7 @@ CompactionJob::CompactionJob(
       db_id_(db_id),
       db_session_id_(db_session_id),
       db_options_(db_options),
+      mutable_db_options_copy_(mutable_db_options),
       file_options_(file_options),
       env_(db_options.env),
       io_tracer_(io_tracer),
@@ -434,6 +501,13 @@ struct RangeWithSize {
 
 void CompactionJob::GenSubcompactionBoundaries() {
   auto* c = compact_->compaction;
+  // The inputs of a compaction into L0 usually all span the whole key range,
+  // so their boundaries can't split it
+  if (c->immutable_cf_options()->sample_subcompaction_boundaries ||
+      c->output_level() == 0) {
+    GenSampledSubcompactionBoundaries();
+    return;
+  }
   auto* cfd = c->column_family_data();
   const Comparator* cfd_comparator = cfd->user_comparator();
   std::vector<Slice> bounds;
@@ -560,6 +634,91 @@ void CompactionJob::GenSubcompactionBoundaries() {
   }
 }
 
+void CompactionJob::GenSampledSubcompactionBoundaries() {
+  auto* c = compact_->compaction;
+  auto* cfd = c->column_family_data();
+  const Comparator* ucmp = cfd->user_comparator();
+  // The input version is referenced by the compaction and will not change
+  // when db_mutex_ is released below
+  auto* v = c->input_version();
+
+  ReadOptions ro;
+  ro.fill_cache = false;
+  std::vector<TableReader::Anchor> anchors;
+  // Reading the indexes may incur I/O. Unlock db mutex to reduce contention
+  db_mutex_->Unlock();
+  for (size_t lvl_idx = 0; lvl_idx < c->num_input_levels(); lvl_idx++) {
+    for (const FileMetaData* f : *c->inputs(lvl_idx)) {
+      const size_t num_anchors = anchors.size();
+      Status s = cfd->table_cache()->ApproximateKeyAnchors(
+          ro, cfd->internal_comparator(), f->fd, &anchors,
+          c->mutable_cf_options()->prefix_extractor.get());
+      if (!s.ok() || anchors.size() == num_anchors) {
+        // Treat the whole file as a single range
+        anchors.erase(anchors.begin() + num_anchors, anchors.end());
+        anchors.emplace_back(f->largest.user_key(),
+                             static_cast<size_t>(f->fd.GetFileSize()));
+      }
+    }
+  }
+  db_mutex_->Lock();
+
+  std::sort(anchors.begin(), anchors.end(),
+            [ucmp](const TableReader::Anchor& a,
+                   const TableReader::Anchor& b) -> bool {
+              return ucmp->Compare(a.user_key, b.user_key) < 0;
+            });
+  uint64_t total = 0;
+  for (const auto& anchor : anchors) {
+    total += anchor.range_size;
+  }
+
+  // Group the anchors into subcompactions
+  uint64_t subcompactions =
+      std::min(static_cast<uint64_t>(anchors.size()),
+               static_cast<uint64_t>(c->max_subcompactions()));
+  if (c->output_level() > 0) {
+    // The output files of all subcompactions into L0 form a single sorted
+    // run, so only avoid small output files in the other levels
+    const double min_file_fill_percent = 4.0 / 5;
+    int base_level = v->storage_info()->base_level();
+    uint64_t max_output_files = static_cast<uint64_t>(std::ceil(
+        total / min_file_fill_percent /
+        MaxFileSizeForLevel(*(c->mutable_cf_options()), c->output_level(),
+            c->immutable_cf_options()->compaction_style, base_level,
+            c->immutable_cf_options()->level_compaction_dynamic_level_bytes)));
+    subcompactions = std::min(subcompactions, max_output_files);
+  }
+
+  uint64_t remaining = total;
+  if (subcompactions > 1) {
+    double mean = total * 1.0 / subcompactions;
+    // Greedily add ranges to the subcompaction until the sum of the ranges'
+    // sizes becomes >= the expected mean size of a subcompaction. The last
+    // anchor is the largest key of the input, so it can't be a boundary.
+    uint64_t sum = 0;
+    for (size_t i = 0; i + 1 < anchors.size() && subcompactions > 1; i++) {
+      sum += anchors[i].range_size;
+      if (sum >= mean &&
+          (sampled_boundaries_.empty() ||
+           ucmp->Compare(anchors[i].user_key, sampled_boundaries_.back()) >
+               0) &&
+          ucmp->Compare(anchors[i].user_key, anchors.back().user_key) < 0) {
+        sampled_boundaries_.emplace_back(std::move(anchors[i].user_key));
+        sizes_.emplace_back(sum);
+        remaining -= sum;
+        subcompactions--;
+        sum = 0;
+      }
+    }
+  }
+  // The last subcompaction goes to the end of the input
+  sizes_.emplace_back(remaining);
+  for (const auto& key : sampled_boundaries_) {
+    boundaries_.emplace_back(key);
+  }
+}
+
 Status CompactionJob::Run() {
   AutoThreadOperationStageUpdater stage_updater(
       ThreadStatus::STAGE_COMPACTION_RUN);
@@ -827,9 +986,61 @@ Status CompactionJob::Install(const MutableCFOptions& mutable_cf_options) {
   return status;
 }
 
+namespace {
+// The range tombstones of input files outside L0 are added to the range
+// deletion aggregator when the level iterator opens the file. With a
+// pipelined input that happens on the prefetch thread while the compaction
+// iterator queries the aggregator, so such compactions are not pipelined.
+bool HasLazilyAddedRangeDeletions(const Compaction* c) {
+  for (size_t which = 0; which < c->num_input_levels(); which++) {
+    if (c->level(which) == 0) {
+      continue;
+    }
+    for (const FileMetaData* f : *c->inputs(which)) {
+      std::shared_ptr<const TableProperties> tp;
+      Status s = c->input_version()->GetTableProperties(&tp, f);
+      if (!s.ok() || tp->num_range_deletions > 0) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool HasBlobFileReferences(const Compaction* c) {
+  for (size_t which = 0; which < c->num_input_levels(); which++) {
+    for (const FileMetaData* f : *c->inputs(which)) {
+      if (f->oldest_blob_file_number != kInvalidBlobFileNumber) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+}  // namespace
+
 void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
   assert(sub_compact != nullptr);
 
+  const MutableCFOptions& mutable_cf_options =
+      *sub_compact->compaction->mutable_cf_options();
+
+#ifndef ROCKSDB_LITE
+  // Compactions that need a snapshot checker are always run locally as the
+  // checker cannot be passed to the compaction service. So are compactions
+  // that may write blob files, as the service only returns table files.
+  if (db_options_.compaction_service && snapshot_checker_ == nullptr &&
+      !mutable_cf_options.enable_blob_files &&
+      !mutable_cf_options.enable_blob_garbage_collection) {
+    CompactionServiceJobStatus comp_status =
+        ProcessKeyValueCompactionWithCompactionService(sub_compact);
+    if (comp_status != CompactionServiceJobStatus::kUseLocal) {
+      return;
+    }
+    // fallback to local compaction
+  }
+#endif  // !ROCKSDB_LITE
+
   uint64_t prev_cpu_micros = env_->NowCPUNanos() / 1000;
 
   ColumnFamilyData* cfd = sub_compact->compaction->column_family_data();
@@ -862,11 +1073,44 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
   // (b) CompactionFilter::Decision::kRemoveAndSkipUntil.
   read_options.total_order_seek = true;
 
+  // The input iterator refers to input_coverage, so it is declared first.
+  std::unique_ptr<CompactionInputCoverage> input_coverage;
+  if (db_options_.skip_range_deleted_compaction_input &&
+      snapshot_checker_ == nullptr) {
+    input_coverage.reset(new CompactionInputCoverage(sub_compact->compaction,
+                                                     existing_snapshots_));
+    Status s = input_coverage->Init(read_options);
+    if (!s.ok()) {
+      // Fall back to reading the whole input
+      ROCKS_LOG_WARN(db_options_.info_log,
+                     "[%s] [JOB %d] Failed to read the range tombstones of "
+                     "the compaction input: %s",
+                     cfd->GetName().c_str(), job_id_, s.ToString().c_str());
+      input_coverage.reset();
+    }
+  }
+
   // Although the v2 aggregator is what the level iterator(s) know about,
   // the AddTombstones calls will be propagated down to the v1 aggregator.
-  std::unique_ptr<InternalIterator> input(
-      versions_->MakeInputIterator(read_options, sub_compact->compaction,
-                                   &range_del_agg, file_options_for_read_));
+  std::unique_ptr<InternalIterator> raw_input(versions_->MakeInputIterator(
+      read_options, sub_compact->compaction, &range_del_agg,
+      file_options_for_read_, input_coverage.get()));
+  InternalIterator* input = raw_input.get();
+  std::unique_ptr<InternalIterator> pipelined_input;
+  if (db_options_.enable_pipelined_compaction &&
+      !HasLazilyAddedRangeDeletions(sub_compact->compaction)) {
+    pipelined_input.reset(new PipelinedInputIterator(input));
+    input = pipelined_input.get();
+  }
+
+  const Comparator* ucmp = cfd->user_comparator();
+  std::unique_ptr<InternalIterator> blob_counting_input;
+  if (HasBlobFileReferences(sub_compact->compaction)) {
+    sub_compact->blob_garbage_meter.reset(new BlobGarbageMeter());
+    blob_counting_input.reset(new BlobCountingIterator(
+        input, sub_compact->blob_garbage_meter.get(), ucmp, sub_compact->end));
+    input = blob_counting_input.get();
+  }
 
   AutoThreadOperationStageUpdater stage_updater(
       ThreadStatus::STAGE_COMPACTION_PROCESS_KV);
@@ -915,13 +1159,22 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
     input->SeekToFirst();
   }
 
+  std::unique_ptr<BlobFileBuilder> blob_file_builder(
+      mutable_cf_options.enable_blob_files
+          ? new BlobFileBuilder(versions_, env_, fs_.get(), cfd->ioptions(),
+                                &mutable_cf_options, &file_options_, job_id_,
+                                cfd->GetID(), cfd->GetName(), Env::IO_LOW,
+                                write_hint_, &sub_compact->blob_file_paths,
+                                &sub_compact->blob_file_additions)
+          : nullptr);
+
   Status status;
   sub_compact->c_iter.reset(new CompactionIterator(
-      input.get(), cfd->user_comparator(), &merge, versions_->LastSequence(),
+      input, cfd->user_comparator(), &merge, versions_->LastSequence(),
       &existing_snapshots_, earliest_write_conflict_snapshot_,
       snapshot_checker_, env_, ShouldReportDetailedTime(env_, stats_),
       /*expect_valid_internal_key=*/true, &range_del_agg,
-      /* blob_file_builder */ nullptr, db_options_.allow_data_in_errors,
+      blob_file_builder.get(), db_options_.allow_data_in_errors,
       sub_compact->compaction, compaction_filter, shutting_down_,
       preserve_deletes_seqnum_, manual_compaction_paused_,
       db_options_.info_log));
@@ -967,11 +1220,37 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
       if (!status.ok()) {
         break;
       }
+      sub_compact->passthrough_active = false;
+      sub_compact->at_input_block_boundary = true;
+    }
+    if (db_options_.reuse_compaction_input_blocks) {
+      // The entry is unchanged if input is still positioned at it, as it is
+      // unless the compaction iterator had to look ahead, and the compaction
+      // iterator passed its value through.
+      DataBlockPosition block_pos;
+      const bool unchanged = input->Valid() &&
+                             input->GetDataBlockPosition(&block_pos) &&
+                             input->key() == key &&
+                             input->value().data() == value.data() &&
+                             input->value().size() == value.size();
+      bool block_copied = false;
+      status = sub_compact->AddToBuilder(
+          key, value, unchanged ? &block_pos : nullptr, &block_copied);
+      if (block_copied) {
+        RecordTick(stats_, COMPACTION_DATA_BLOCKS_COPIED);
+      }
+    } else {
+      status = sub_compact->AddToBuilder(key, value);
     }
-    status = sub_compact->AddToBuilder(key, value);
     if (!status.ok()) {
       break;
     }
+    if (sub_compact->blob_garbage_meter) {
+      status = sub_compact->blob_garbage_meter->ProcessOutFlow(key, value);
+      if (!status.ok()) {
+        break;
+      }
+    }
 
     sub_compact->current_output_file_size =
         sub_compact->builder->EstimatedFileSize();
@@ -1093,6 +1372,19 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
     RecordDroppedKeys(range_del_out_stats, &sub_compact->compaction_job_stats);
   }
 
+  if (blob_file_builder) {
+    if (status.ok()) {
+      status = blob_file_builder->Finish();
+    }
+    if (!status.ok()) {
+      for (const std::string& blob_file_path : sub_compact->blob_file_paths) {
+        Status s = fs_->DeleteFile(blob_file_path, IOOptions(), nullptr);
+        s.PermitUncheckedError();
+      }
+      sub_compact->blob_file_additions.clear();
+    }
+  }
+
   sub_compact->compaction_job_stats.cpu_micros =
       env_->NowCPUNanos() / 1000 - prev_cpu_micros;
 
@@ -1121,11 +1413,21 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
     if (input) {
       input->status().PermitUncheckedError();
     }
+    if (raw_input) {
+      raw_input->status().PermitUncheckedError();
+    }
   }
 #endif  // ROCKSDB_ASSERT_STATUS_CHECKED
 
   sub_compact->c_iter.reset();
-  input.reset();
+  blob_counting_input.reset();
+  pipelined_input.reset();
+  raw_input.reset();
+  if (input_coverage) {
+    RecordTick(stats_, COMPACTION_RANGE_DEL_DROPPED_FILES,
+               input_coverage->dropped_files());
+    RecordTick(stats_, COMPACTION_RANGE_DEL_SKIPS, input_coverage->skips());
+  }
   sub_compact->status = status;
 }
 
@@ -1407,9 +1709,7 @@ Status CompactionJob::FinishCompactionOutputFile(
     // If there is nothing to output, no necessary to generate a sst file.
     // This happens when the output level is bottom level, at the same time
     // the sub_compact output nothing.
-    std::string fname =
-        TableFileName(sub_compact->compaction->immutable_cf_options()->cf_paths,
-                      meta->fd.GetNumber(), meta->fd.GetPathId());
+    std::string fname = GetTableFileName(meta->fd.GetNumber());
     env_->DeleteFile(fname);
 
     // Also need to remove the file from outputs, or it will be added to the
@@ -1434,9 +1734,7 @@ Status CompactionJob::FinishCompactionOutputFile(
   FileDescriptor output_fd;
   uint64_t oldest_blob_file_number = kInvalidBlobFileNumber;
   if (meta != nullptr) {
-    fname =
-        TableFileName(sub_compact->compaction->immutable_cf_options()->cf_paths,
-                      meta->fd.GetNumber(), meta->fd.GetPathId());
+    fname = GetTableFileName(meta->fd.GetNumber());
     output_fd = meta->fd;
     oldest_blob_file_number = meta->oldest_blob_file_number;
   } else {
@@ -1506,11 +1804,63 @@ Status CompactionJob::InstallCompactionResults(
   // Add compaction inputs
   compaction->AddInputDeletions(compact_->compaction->edit());
 
+  // The files written into L0 by several subcompactions form one sorted run,
+  // so give them the sequence number range of the whole output. They are then
+  // adjacent in L0 and picked together by later compactions.
+  SequenceNumber smallest_seqno = kMaxSequenceNumber;
+  SequenceNumber largest_seqno = 0;
+  const bool l0_sorted_run = compaction->output_level() == 0 &&
+                             compact_->sub_compact_states.size() > 1;
+  if (l0_sorted_run) {
+    for (const auto& sub_compact : compact_->sub_compact_states) {
+      for (const auto& out : sub_compact.outputs) {
+        smallest_seqno = std::min(smallest_seqno, out.meta.fd.smallest_seqno);
+        largest_seqno = std::max(largest_seqno, out.meta.fd.largest_seqno);
+      }
+    }
+  }
+
   for (const auto& sub_compact : compact_->sub_compact_states) {
     for (const auto& out : sub_compact.outputs) {
-      compaction->edit()->AddFile(compaction->output_level(), out.meta);
+      if (l0_sorted_run) {
+        FileMetaData meta = out.meta;
+        meta.fd.smallest_seqno = smallest_seqno;
+        meta.fd.largest_seqno = largest_seqno;
+        compaction->edit()->AddFile(compaction->output_level(), meta);
+      } else {
+        compaction->edit()->AddFile(compaction->output_level(), out.meta);
+      }
+    }
+    for (const auto& blob_file_addition : sub_compact.blob_file_additions) {
+      compaction->edit()->AddBlobFile(blob_file_addition);
+    }
+  }
+
+  // Sum up the garbage the subcompactions produced in the blob files of the
+  // input, as (count, bytes) by blob file number
+  std::map<uint64_t, std::pair<uint64_t, uint64_t>> blob_garbage;
+  for (const auto& sub_compact : compact_->sub_compact_states) {
+    if (!sub_compact.blob_garbage_meter) {
+      continue;
     }
+    for (const auto& pair : sub_compact.blob_garbage_meter->flows()) {
+      const BlobGarbageMeter::BlobInOutFlow& flow = pair.second;
+      if (!flow.IsValid()) {
+        return Status::Corruption(
+            "More blobs referenced by compaction output than by its input");
+      }
+      if (flow.HasGarbage()) {
+        auto& garbage = blob_garbage[pair.first];
+        garbage.first += flow.GetGarbageCount();
+        garbage.second += flow.GetGarbageBytes();
+      }
+    }
+  }
+  for (const auto& pair : blob_garbage) {
+    compaction->edit()->AddBlobFileGarbage(pair.first, pair.second.first,
+                                           pair.second.second);
   }
+
   return versions_->LogAndApply(compaction->column_family_data(),
                                 mutable_cf_options, compaction->edit(),
                                 db_mutex_, db_directory_);
@@ -1539,15 +1889,18 @@ void CompactionJob::RecordCompactionIOStats() {
   IOSTATS_RESET(bytes_written);
 }
 
+std::string CompactionJob::GetTableFileName(uint64_t file_number) {
+  return TableFileName(compact_->compaction->immutable_cf_options()->cf_paths,
+                       file_number, compact_->compaction->output_path_id());
+}
+
 Status CompactionJob::OpenCompactionOutputFile(
     SubcompactionState* sub_compact) {
   assert(sub_compact != nullptr);
   assert(sub_compact->builder == nullptr);
   // no need to lock because VersionSet::next_file_number_ is atomic
   uint64_t file_number = versions_->NewFileNumber();
-  std::string fname =
-      TableFileName(sub_compact->compaction->immutable_cf_options()->cf_paths,
-                    file_number, sub_compact->compaction->output_path_id());
+  std::string fname = GetTableFileName(file_number);
   // Fire events.
   ColumnFamilyData* cfd = sub_compact->compaction->column_family_data();
 #ifndef ROCKSDB_LITE
@@ -1722,6 +2075,12 @@ void CompactionJob::UpdateCompactionStats() {
     for (const auto& out : sub_compact.outputs) {
       compaction_stats_.bytes_written += out.meta.fd.file_size;
     }
+
+    compaction_stats_.num_output_files +=
+        static_cast<int>(sub_compact.blob_file_additions.size());
+    for (const auto& blob : sub_compact.blob_file_additions) {
+      compaction_stats_.bytes_written += blob.GetTotalBlobBytes();
+    }
   }
 
   if (compaction_stats_.num_input_records > num_output_records) {
@@ -1812,4 +2171,477 @@ void CompactionJob::LogCompaction() {
   }
 }
 
+#ifndef ROCKSDB_LITE
+namespace {
+// Version of the encoding of CompactionServiceInput and
+// CompactionServiceResult
+constexpr uint32_t kCompactionServiceFormatVersion = 1;
+
+void PutBool(std::string* dst, bool value) {
+  dst->push_back(value ? 1 : 0);
+}
+
+bool GetBool(Slice* input, bool* value) {
+  if (input->empty()) {
+    return false;
+  }
+  *value = (*input)[0] != 0;
+  input->remove_prefix(1);
+  return true;
+}
+
+bool GetLengthPrefixedString(Slice* input, std::string* value) {
+  Slice slice;
+  if (!GetLengthPrefixedSlice(input, &slice)) {
+    return false;
+  }
+  value->assign(slice.data(), slice.size());
+  return true;
+}
+
+bool GetFormatVersion(Slice* input) {
+  uint32_t format_version = 0;
+  return GetVarint32(input, &format_version) &&
+         format_version == kCompactionServiceFormatVersion;
+}
+
+// Only the code and the message of a status are kept
+Status StatusFromCode(Status::Code code, const std::string& msg) {
+  switch (code) {
+    case Status::kOk:
+      return Status::OK();
+    case Status::kNotFound:
+      return Status::NotFound(msg);
+    case Status::kCorruption:
+      return Status::Corruption(msg);
+    case Status::kNotSupported:
+      return Status::NotSupported(msg);
+    case Status::kInvalidArgument:
+      return Status::InvalidArgument(msg);
+    case Status::kIOError:
+      return Status::IOError(msg);
+    case Status::kIncomplete:
+      return Status::Incomplete(msg);
+    case Status::kShutdownInProgress:
+      return Status::ShutdownInProgress(msg);
+    case Status::kTimedOut:
+      return Status::TimedOut(msg);
+    case Status::kBusy:
+      return Status::Busy(msg);
+    case Status::kTryAgain:
+      return Status::TryAgain(msg);
+    default:
+      return Status::Aborted(msg);
+  }
+}
+}  // namespace
+
+void CompactionServiceInput::EncodeTo(std::string* dst) const {
+  PutVarint32(dst, kCompactionServiceFormatVersion);
+  PutLengthPrefixedSlice(dst, column_family_name);
+  PutLengthPrefixedSlice(dst, db_options);
+  PutLengthPrefixedSlice(dst, cf_options);
+  PutVarint64(dst, snapshots.size());
+  for (SequenceNumber snapshot : snapshots) {
+    PutVarint64(dst, snapshot);
+  }
+  PutVarint64(dst, earliest_write_conflict_snapshot);
+  PutVarint64(dst, preserve_deletes_seqnum);
+  PutVarint64(dst, input_files.size());
+  for (uint64_t file_number : input_files) {
+    PutVarint64(dst, file_number);
+  }
+  PutVarint32(dst, static_cast<uint32_t>(output_level));
+  PutBool(dst, has_begin);
+  PutLengthPrefixedSlice(dst, begin);
+  PutBool(dst, has_end);
+  PutLengthPrefixedSlice(dst, end);
+}
+
+Status CompactionServiceInput::DecodeFrom(const Slice& src) {
+  Slice input = src;
+  if (!GetFormatVersion(&input)) {
+    return Status::NotSupported("Unknown compaction service input format");
+  }
+  uint64_t num_snapshots = 0;
+  bool ok = GetLengthPrefixedString(&input, &column_family_name) &&
+            GetLengthPrefixedString(&input, &db_options) &&
+            GetLengthPrefixedString(&input, &cf_options) &&
+            GetVarint64(&input, &num_snapshots);
+  snapshots.clear();
+  for (uint64_t i = 0; ok && i < num_snapshots; i++) {
+    SequenceNumber snapshot = 0;
+    ok = GetVarint64(&input, &snapshot);
+    snapshots.push_back(snapshot);
+  }
+  uint64_t num_input_files = 0;
+  ok = ok && GetVarint64(&input, &earliest_write_conflict_snapshot) &&
+       GetVarint64(&input, &preserve_deletes_seqnum) &&
+       GetVarint64(&input, &num_input_files);
+  input_files.clear();
+  for (uint64_t i = 0; ok && i < num_input_files; i++) {
+    uint64_t file_number = 0;
+    ok = GetVarint64(&input, &file_number);
+    input_files.push_back(file_number);
+  }
+  uint32_t level = 0;
+  ok = ok && GetVarint32(&input, &level) && GetBool(&input, &has_begin) &&
+       GetLengthPrefixedString(&input, &begin) && GetBool(&input, &has_end) &&
+       GetLengthPrefixedString(&input, &end);
+  if (!ok) {
+    return Status::Corruption("Malformed compaction service input");
+  }
+  output_level = static_cast<int>(level);
+  return Status::OK();
+}
+
+void CompactionServiceResult::EncodeTo(std::string* dst) const {
+  PutVarint32(dst, kCompactionServiceFormatVersion);
+  PutVarint32(dst, static_cast<uint32_t>(status.code()));
+  PutLengthPrefixedSlice(
+      dst, status.getState() == nullptr ? "" : status.getState());
+  PutVarint64(dst, output_files.size());
+  for (const auto& file : output_files) {
+    PutLengthPrefixedSlice(dst, file.file_name);
+    PutVarint64(dst, file.smallest_seqno);
+    PutVarint64(dst, file.largest_seqno);
+    PutLengthPrefixedSlice(dst, file.smallest_internal_key);
+    PutLengthPrefixedSlice(dst, file.largest_internal_key);
+    PutVarint64(dst, file.oldest_ancester_time);
+    PutVarint64(dst, file.file_creation_time);
+    PutFixed64(dst, file.paranoid_hash);
+    PutBool(dst, file.marked_for_compaction);
+    PutLengthPrefixedSlice(dst, file.file_checksum);
+    PutLengthPrefixedSlice(dst, file.file_checksum_func_name);
+  }
+  PutVarint32(dst, static_cast<uint32_t>(output_level));
+  PutLengthPrefixedSlice(dst, output_path);
+  PutVarint64(dst, num_output_records);
+  PutVarint64(dst, total_bytes);
+}
+
+Status CompactionServiceResult::DecodeFrom(const Slice& src) {
+  Slice input = src;
+  if (!GetFormatVersion(&input)) {
+    return Status::NotSupported("Unknown compaction service result format");
+  }
+  uint32_t code = 0;
+  std::string msg;
+  uint64_t num_output_files = 0;
+  bool ok = GetVarint32(&input, &code) &&
+            GetLengthPrefixedString(&input, &msg) &&
+            GetVarint64(&input, &num_output_files);
+  output_files.clear();
+  for (uint64_t i = 0; ok && i < num_output_files; i++) {
+    CompactionServiceOutputFile file;
+    ok = GetLengthPrefixedString(&input, &file.file_name) &&
+         GetVarint64(&input, &file.smallest_seqno) &&
+         GetVarint64(&input, &file.largest_seqno) &&
+         GetLengthPrefixedString(&input, &file.smallest_internal_key) &&
+         GetLengthPrefixedString(&input, &file.largest_internal_key) &&
+         GetVarint64(&input, &file.oldest_ancester_time) &&
+         GetVarint64(&input, &file.file_creation_time) &&
+         GetFixed64(&input, &file.paranoid_hash) &&
+         GetBool(&input, &file.marked_for_compaction) &&
+         GetLengthPrefixedString(&input, &file.file_checksum) &&
+         GetLengthPrefixedString(&input, &file.file_checksum_func_name);
+    output_files.push_back(std::move(file));
+  }
+  uint32_t level = 0;
+  ok = ok && GetVarint32(&input, &level) &&
+       GetLengthPrefixedString(&input, &output_path) &&
+       GetVarint64(&input, &num_output_records) &&
+       GetVarint64(&input, &total_bytes);
+  if (!ok) {
+    return Status::Corruption("Malformed compaction service result");
+  }
+  status = StatusFromCode(static_cast<Status::Code>(code), msg);
+  output_level = static_cast<int>(level);
+  return Status::OK();
+}
+
+CompactionServiceJobStatus
+CompactionJob::ProcessKeyValueCompactionWithCompactionService(
+    SubcompactionState* sub_compact) {
+  assert(sub_compact != nullptr);
+  assert(db_options_.compaction_service != nullptr);
+  const Compaction* compaction = sub_compact->compaction;
+  ColumnFamilyData* cfd = compaction->column_family_data();
+
+  CompactionServiceInput compaction_input;
+  compaction_input.column_family_name = cfd->GetName();
+  Status s = GetStringFromDBOptions(
+      &compaction_input.db_options,
+      BuildDBOptions(db_options_, mutable_db_options_copy_));
+  if (s.ok()) {
+    s = GetStringFromColumnFamilyOptions(
+        &compaction_input.cf_options,
+        BuildColumnFamilyOptions(cfd->initial_cf_options(),
+                                 *compaction->mutable_cf_options()));
+  }
+  if (!s.ok()) {
+    sub_compact->status = s;
+    return CompactionServiceJobStatus::kFailure;
+  }
+  compaction_input.snapshots = existing_snapshots_;
+  compaction_input.earliest_write_conflict_snapshot =
+      earliest_write_conflict_snapshot_;
+  compaction_input.preserve_deletes_seqnum = preserve_deletes_seqnum_;
+  for (size_t i = 0; i < compaction->num_input_levels(); i++) {
+    for (const FileMetaData* file : *compaction->inputs(i)) {
+      compaction_input.input_files.push_back(file->fd.GetNumber());
+    }
+  }
+  compaction_input.output_level = compaction->output_level();
+  if (sub_compact->start != nullptr) {
+    compaction_input.has_begin = true;
+    compaction_input.begin = sub_compact->start->ToString();
+  }
+  if (sub_compact->end != nullptr) {
+    compaction_input.has_end = true;
+    compaction_input.end = sub_compact->end->ToString();
+  }
+  std::string compaction_input_binary;
+  compaction_input.EncodeTo(&compaction_input_binary);
+
+  // Unique among the subcompactions of all the running compaction jobs
+  const uint64_t service_job_id =
+      (static_cast<uint64_t>(job_id_) << 32) |
+      static_cast<uint64_t>(sub_compact - &compact_->sub_compact_states[0]);
+
+  ROCKS_LOG_INFO(db_options_.info_log,
+                 "[%s] [JOB %d] Starting remote compaction %" PRIu64
+                 " (output level: %d) with %" ROCKSDB_PRIszt " input files",
+                 cfd->GetName().c_str(), job_id_, service_job_id,
+                 compaction_input.output_level,
+                 compaction_input.input_files.size());
+  CompactionServiceJobStatus compaction_status =
+      db_options_.compaction_service->Start(compaction_input_binary,
+                                            service_job_id);
+  if (compaction_status == CompactionServiceJobStatus::kSuccess) {
+    std::string compaction_result_binary;
+    compaction_status = db_options_.compaction_service->WaitForComplete(
+        service_job_id, &compaction_result_binary);
+    if (compaction_status != CompactionServiceJobStatus::kUseLocal) {
+      CompactionServiceResult compaction_result;
+      s = compaction_result.DecodeFrom(compaction_result_binary);
+      if (s.ok()) {
+        s = compaction_result.status;
+      }
+      if (s.ok() &&
+          compaction_status == CompactionServiceJobStatus::kFailure) {
+        s = Status::Incomplete("CompactionService failed to run the job");
+      }
+      if (s.ok()) {
+        s = InstallCompactionServiceResult(sub_compact, compaction_result);
+      }
+      sub_compact->status = s;
+      compaction_status = s.ok() ? CompactionServiceJobStatus::kSuccess
+                                 : CompactionServiceJobStatus::kFailure;
+    }
+  } else if (compaction_status == CompactionServiceJobStatus::kFailure) {
+    sub_compact->status =
+        Status::Incomplete("CompactionService failed to start the job");
+  }
+
+  if (compaction_status == CompactionServiceJobStatus::kUseLocal) {
+    ROCKS_LOG_INFO(db_options_.info_log,
+                   "[%s] [JOB %d] Remote compaction %" PRIu64
+                   " falls back to local compaction",
+                   cfd->GetName().c_str(), job_id_, service_job_id);
+  } else if (!sub_compact->status.ok()) {
+    ROCKS_LOG_WARN(db_options_.info_log,
+                   "[%s] [JOB %d] Remote compaction %" PRIu64 " failed: %s",
+                   cfd->GetName().c_str(), job_id_, service_job_id,
+                   sub_compact->status.ToString().c_str());
+  }
+  return compaction_status;
+}
+
+Status CompactionJob::InstallCompactionServiceResult(
+    SubcompactionState* sub_compact,
+    const CompactionServiceResult& compaction_result) {
+  const Compaction* compaction = sub_compact->compaction;
+  ColumnFamilyData* cfd = compaction->column_family_data();
+  for (const auto& file : compaction_result.output_files) {
+    // Moves the file into the DB under a new file number. The number is
+    // protected from deletion by the pending outputs of the compaction.
+    const uint64_t file_number = versions_->NewFileNumber();
+    const std::string src_file =
+        compaction_result.output_path + "/" + file.file_name;
+    const std::string tgt_file = GetTableFileName(file_number);
+    EventHelpers::NotifyTableFileCreationStarted(
+        cfd->ioptions()->listeners, dbname_, cfd->GetName(), tgt_file, job_id_,
+        TableFileCreationReason::kCompaction);
+    Status s = fs_->RenameFile(src_file, tgt_file, IOOptions(), nullptr);
+    uint64_t file_size = 0;
+    if (s.ok()) {
+      s = fs_->GetFileSize(tgt_file, IOOptions(), &file_size, nullptr);
+    }
+
+    FileMetaData meta;
+    meta.fd = FileDescriptor(file_number, compaction->output_path_id(),
+                             file_size, file.smallest_seqno,
+                             file.largest_seqno);
+    meta.smallest.DecodeFrom(file.smallest_internal_key);
+    meta.largest.DecodeFrom(file.largest_internal_key);
+    meta.oldest_ancester_time = file.oldest_ancester_time;
+    meta.file_creation_time = file.file_creation_time;
+    meta.marked_for_compaction = file.marked_for_compaction;
+    meta.file_checksum = file.file_checksum;
+    meta.file_checksum_func_name = file.file_checksum_func_name;
+    std::shared_ptr<const TableProperties> table_properties;
+    if (s.ok()) {
+      s = cfd->table_cache()->GetTableProperties(
+          file_options_, cfd->internal_comparator(), meta.fd,
+          &table_properties,
+          compaction->mutable_cf_options()->prefix_extractor.get());
+    }
+    EventHelpers::LogAndNotifyTableFileCreationFinished(
+        event_logger_, cfd->ioptions()->listeners, dbname_, cfd->GetName(),
+        tgt_file, job_id_, meta.fd, meta.oldest_blob_file_number,
+        table_properties ? *table_properties : TableProperties(),
+        TableFileCreationReason::kCompaction, s, meta.file_checksum,
+        meta.file_checksum_func_name);
+    if (!s.ok()) {
+      return s;
+    }
+
+    sub_compact->outputs.emplace_back(
+        std::move(meta), cfd->internal_comparator(),
+        /*enable_order_check=*/false,
+        /*enable_hash=*/paranoid_file_checks_);
+    SubcompactionState::Output* output = sub_compact->current_output();
+    output->validator.SetHash(file.paranoid_hash);
+    output->finished = true;
+    output->table_properties = std::move(table_properties);
+
+    // Report new file to SstFileManagerImpl
+    auto sfm =
+        static_cast<SstFileManagerImpl*>(db_options_.sst_file_manager.get());
+    if (sfm && output->meta.fd.GetPathId() == 0) {
+      s = sfm->OnAddFile(tgt_file);
+      if (s.ok() && sfm->IsMaxAllowedSpaceReached()) {
+        s = Status::SpaceLimit("Max allowed space was reached");
+        InstrumentedMutexLock l(db_mutex_);
+        db_error_handler_->SetBGError(s, BackgroundErrorReason::kCompaction)
+            .PermitUncheckedError();
+      }
+      if (!s.ok()) {
+        return s;
+      }
+    }
+  }
+  sub_compact->num_output_records = compaction_result.num_output_records;
+  sub_compact->total_bytes = compaction_result.total_bytes;
+  return Status::OK();
+}
+
+CompactionServiceCompactionJob::CompactionServiceCompactionJob(
+    int job_id, Compaction* compaction, const ImmutableDBOptions& db_options,
+    const MutableDBOptions& mutable_db_options,
+    const FileOptions& file_options, VersionSet* versions,
+    const std::atomic<bool>* shutting_down, LogBuffer* log_buffer,
+    FSDirectory* output_directory, Statistics* stats,
+    InstrumentedMutex* db_mutex, ErrorHandler* db_error_handler,
+    std::shared_ptr<Cache> table_cache, EventLogger* event_logger,
+    const std::string& dbname, CompactionJobStats* compaction_job_stats,
+    const std::shared_ptr<IOTracer>& io_tracer, const std::string& db_id,
+    const std::string& db_session_id, const std::string& output_path,
+    const CompactionServiceInput& compaction_service_input,
+    CompactionServiceResult* compaction_service_result)
+    : CompactionJob(
+          job_id, compaction, db_options, mutable_db_options, file_options,
+          versions, shutting_down,
+          compaction_service_input.preserve_deletes_seqnum, log_buffer,
+          /*db_directory=*/nullptr, output_directory, stats, db_mutex,
+          db_error_handler, compaction_service_input.snapshots,
+          compaction_service_input.earliest_write_conflict_snapshot,
+          /*snapshot_checker=*/nullptr, std::move(table_cache), event_logger,
+          compaction->mutable_cf_options()->paranoid_file_checks,
+          compaction->mutable_cf_options()->report_bg_io_stats, dbname,
+          compaction_job_stats, Env::Priority::USER, io_tracer,
+          /*manual_compaction_paused=*/nullptr, db_id, db_session_id),
+      output_path_(output_path),
+      compaction_input_(compaction_service_input),
+      compaction_result_(compaction_service_result) {}
+
+void CompactionServiceCompactionJob::Prepare() {
+  AutoThreadOperationStageUpdater stage_updater(
+      ThreadStatus::STAGE_COMPACTION_PREPARE);
+  auto* c = compact_->compaction;
+  assert(c->column_family_data() != nullptr);
+  write_hint_ =
+      c->column_family_data()->CalculateSSTWriteHint(c->output_level());
+  bottommost_level_ = c->bottommost_level();
+
+  Slice* start = nullptr;
+  Slice* end = nullptr;
+  if (compaction_input_.has_begin) {
+    begin_ = compaction_input_.begin;
+    start = &begin_;
+  }
+  if (compaction_input_.has_end) {
+    end_ = compaction_input_.end;
+    end = &end_;
+  }
+  compact_->sub_compact_states.emplace_back(c, start, end, /*size=*/0);
+}
+
+Status CompactionServiceCompactionJob::Run() {
+  AutoThreadOperationStageUpdater stage_updater(
+      ThreadStatus::STAGE_COMPACTION_RUN);
+  auto* c = compact_->compaction;
+  assert(compact_->sub_compact_states.size() == 1);
+  SubcompactionState* sub_compact = &compact_->sub_compact_states[0];
+  log_buffer_->FlushBufferToLog();
+  LogCompaction();
+
+  const uint64_t start_micros = env_->NowMicros();
+  ProcessKeyValueCompaction(sub_compact);
+  compaction_stats_.micros = env_->NowMicros() - start_micros;
+  compaction_stats_.cpu_micros = sub_compact->compaction_job_stats.cpu_micros;
+
+  Status status = sub_compact->status;
+  if (status.ok() && output_directory_) {
+    status = output_directory_->Fsync(IOOptions(), nullptr);
+  }
+
+  AggregateStatistics();
+  UpdateCompactionStats();
+  RecordCompactionIOStats();
+  LogFlush(db_options_.info_log);
+  compact_->status = status;
+
+  compaction_result_->status = status;
+  compaction_result_->output_files.clear();
+  for (const auto& output : sub_compact->outputs) {
+    const FileMetaData& meta = output.meta;
+    CompactionServiceOutputFile file;
+    file.file_name = MakeTableFileName(meta.fd.GetNumber());
+    file.smallest_seqno = meta.fd.smallest_seqno;
+    file.largest_seqno = meta.fd.largest_seqno;
+    file.smallest_internal_key = meta.smallest.Encode().ToString();
+    file.largest_internal_key = meta.largest.Encode().ToString();
+    file.oldest_ancester_time = meta.oldest_ancester_time;
+    file.file_creation_time = meta.file_creation_time;
+    file.paranoid_hash = output.validator.GetHash();
+    file.marked_for_compaction = meta.marked_for_compaction;
+    file.file_checksum = meta.file_checksum;
+    file.file_checksum_func_name = meta.file_checksum_func_name;
+    compaction_result_->output_files.push_back(std::move(file));
+  }
+  compaction_result_->output_level = c->output_level();
+  compaction_result_->output_path = output_path_;
+  compaction_result_->num_output_records = sub_compact->num_output_records;
+  compaction_result_->total_bytes = sub_compact->total_bytes;
+  return status;
+}
+
+std::string CompactionServiceCompactionJob::GetTableFileName(
+    uint64_t file_number) {
+  return MakeTableFileName(output_path_, file_number);
+}
+#endif  // !ROCKSDB_LITE
+
 }  // namespace ROCKSDB_NAMESPACE
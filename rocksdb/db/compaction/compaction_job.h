@@ -47,6 +47,7 @@
 namespace ROCKSDB_NAMESPACE {
 
 class Arena;
+struct CompactionServiceResult;
 class ErrorHandler;
 class MemTable;
 class SnapshotChecker;
@@ -64,6 +65,7 @@ class CompactionJob {
  public:
   CompactionJob(
       int job_id, Compaction* compaction, const ImmutableDBOptions& db_options,
+      const MutableDBOptions& mutable_db_options,
       const FileOptions& file_options, VersionSet* versions,
       const std::atomic<bool>* shutting_down,
       const SequenceNumber preserve_deletes_seqnum, LogBuffer* log_buffer,
@@ -80,7 +82,7 @@ class CompactionJob {
       const std::atomic<int>* manual_compaction_paused = nullptr,
       const std::string& db_id = "", const std::string& db_session_id = "");
 
-  ~CompactionJob();
+  virtual ~CompactionJob();
 
   // no copy/move
   CompactionJob(CompactionJob&& job) = delete;
@@ -103,9 +105,12 @@ class CompactionJob {
   // Return the IO status
   IOStatus io_status() const { return io_status_; }
 
- private:
+ protected:
   struct SubcompactionState;
 
+  // The path of the output table file with the given number
+  virtual std::string GetTableFileName(uint64_t file_number);
+
   void AggregateStatistics();
 
   // Generates a histogram representing potential divisions of key ranges from
@@ -114,6 +119,10 @@ class CompactionJob {
   // each consecutive pair of slices. Then it divides these ranges into
   // consecutive groups such that each group has a similar size.
   void GenSubcompactionBoundaries();
+  // Like GenSubcompactionBoundaries(), but splits the input at keys sampled
+  // from the indexes of the input files instead of at file boundaries. Used
+  // when sample_subcompaction_boundaries is set.
+  void GenSampledSubcompactionBoundaries();
 
   // update the thread status for starting a compaction.
   void ReportStartedCompaction(Compaction* compaction);
@@ -121,6 +130,18 @@ class CompactionJob {
   // Call compaction filter. Then iterate through input and compact the
   // kv-pairs
   void ProcessKeyValueCompaction(SubcompactionState* sub_compact);
+#ifndef ROCKSDB_LITE
+  // Sends the subcompaction to DBOptions::compaction_service and installs
+  // the output files it produced into sub_compact. Returns kUseLocal if the
+  // service asks to run the subcompaction locally instead.
+  CompactionServiceJobStatus ProcessKeyValueCompactionWithCompactionService(
+      SubcompactionState* sub_compact);
+  // Moves the output files of the compaction service into the DB and adds
+  // them to the outputs of sub_compact
+  Status InstallCompactionServiceResult(
+      SubcompactionState* sub_compact,
+      const CompactionServiceResult& compaction_result);
+#endif  // !ROCKSDB_LITE
 
   Status FinishCompactionOutputFile(
       const Status& input_status, SubcompactionState* sub_compact,
@@ -155,6 +176,7 @@ class CompactionJob {
   const std::string db_id_;
   const std::string db_session_id_;
   const ImmutableDBOptions& db_options_;
+  const MutableDBOptions mutable_db_options_copy_;
   const FileOptions file_options_;
 
   Env* env_;
@@ -195,6 +217,8 @@ class CompactionJob {
   bool measure_io_stats_;
   // Stores the Slices that designate the boundaries for each subcompaction
   std::vector<Slice> boundaries_;
+  // Owns the keys in boundaries_ when they were sampled from the input files
+  std::vector<std::string> sampled_boundaries_;
   // Stores the approx size of keys covered in the range of each subcompaction
   std::vector<uint64_t> sizes_;
   Env::WriteLifeTimeHint write_hint_;
@@ -202,4 +226,108 @@ class CompactionJob {
   IOStatus io_status_;
 };
 
+#ifndef ROCKSDB_LITE
+// The input of a compaction sent to DBOptions::compaction_service. It is
+// passed to DB::OpenAndCompact() in serialized form.
+struct CompactionServiceInput {
+  std::string column_family_name;
+  // The options of the DB and of the column family, in the format of
+  // GetStringFromDBOptions() and GetStringFromColumnFamilyOptions(). Options
+  // that cannot be serialized are passed to DB::OpenAndCompact() with
+  // CompactionServiceOptionsOverride.
+  std::string db_options;
+  std::string cf_options;
+
+  std::vector<SequenceNumber> snapshots;
+  SequenceNumber earliest_write_conflict_snapshot = kMaxSequenceNumber;
+  SequenceNumber preserve_deletes_seqnum = 0;
+
+  // The input files, by file number, and the level of the output
+  std::vector<uint64_t> input_files;
+  int output_level = 0;
+
+  // The user key range of the subcompaction, begin inclusive and end
+  // exclusive
+  bool has_begin = false;
+  std::string begin;
+  bool has_end = false;
+  std::string end;
+
+  void EncodeTo(std::string* dst) const;
+  Status DecodeFrom(const Slice& src);
+};
+
+// A table file produced by DB::OpenAndCompact()
+struct CompactionServiceOutputFile {
+  // The name of the file, relative to the output directory
+  std::string file_name;
+  SequenceNumber smallest_seqno = 0;
+  SequenceNumber largest_seqno = 0;
+  // Encoded internal keys
+  std::string smallest_internal_key;
+  std::string largest_internal_key;
+  uint64_t oldest_ancester_time = 0;
+  uint64_t file_creation_time = 0;
+  uint64_t paranoid_hash = 0;
+  bool marked_for_compaction = false;
+  std::string file_checksum;
+  std::string file_checksum_func_name;
+};
+
+// The result of DB::OpenAndCompact(), sent back to the DB in serialized form
+// by CompactionService::WaitForComplete()
+struct CompactionServiceResult {
+  Status status;
+  std::vector<CompactionServiceOutputFile> output_files;
+  int output_level = 0;
+  // The directory of the output files
+  std::string output_path;
+  uint64_t num_output_records = 0;
+  uint64_t total_bytes = 0;
+
+  void EncodeTo(std::string* dst) const;
+  Status DecodeFrom(const Slice& src);
+};
+
+// The compaction job run by DB::OpenAndCompact() on a secondary instance of
+// the DB. It runs a single subcompaction, writes the output files to
+// output_path instead of the DB directories and does not install them.
+class CompactionServiceCompactionJob : private CompactionJob {
+ public:
+  CompactionServiceCompactionJob(
+      int job_id, Compaction* compaction, const ImmutableDBOptions& db_options,
+      const MutableDBOptions& mutable_db_options,
+      const FileOptions& file_options, VersionSet* versions,
+      const std::atomic<bool>* shutting_down, LogBuffer* log_buffer,
+      FSDirectory* output_directory, Statistics* stats,
+      InstrumentedMutex* db_mutex, ErrorHandler* db_error_handler,
+      std::shared_ptr<Cache> table_cache, EventLogger* event_logger,
+      const std::string& dbname, CompactionJobStats* compaction_job_stats,
+      const std::shared_ptr<IOTracer>& io_tracer, const std::string& db_id,
+      const std::string& db_session_id, const std::string& output_path,
+      const CompactionServiceInput& compaction_service_input,
+      CompactionServiceResult* compaction_service_result);
+
+  // REQUIRED: mutex held
+  void Prepare();
+
+  // REQUIRED: mutex not held
+  // Runs the subcompaction and fills in the result
+  Status Run();
+
+  // REQUIRED: mutex held
+  using CompactionJob::CleanupCompaction;
+
+ protected:
+  std::string GetTableFileName(uint64_t file_number) override;
+
+ private:
+  const std::string output_path_;
+  const CompactionServiceInput& compaction_input_;
+  CompactionServiceResult* compaction_result_;
+  Slice begin_;
+  Slice end_;
+};
+#endif  // !ROCKSDB_LITE
+
 }  // namespace ROCKSDB_NAMESPACE
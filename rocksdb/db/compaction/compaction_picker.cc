@@ -80,6 +80,11 @@ bool FindIntraL0Compaction(const std::vector<FileMetaData*>& level_files,
     }
     compact_bytes_per_del_file = new_compact_bytes_per_del_file;
   }
+  // Don't split a sorted run made of several files
+  while (limit > start && limit < level_files.size() &&
+         InSameL0SortedRun(level_files[limit - 1], level_files[limit])) {
+    limit--;
+  }
 
   if ((limit - start) >= min_files_to_compact &&
       compact_bytes_per_del_file < max_compact_bytes_per_del_file) {
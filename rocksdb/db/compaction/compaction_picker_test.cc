@@ -850,6 +850,32 @@ TEST_F(CompactionPickerTest, CompactionPriMinOverlapping3) {
   ASSERT_EQ(8U, compaction->input(0, 0)->fd.GetNumber());
 }
 
+TEST_F(CompactionPickerTest, CompactionPriReadHeatWeightedOverlapping) {
+  NewVersionStorage(6, kCompactionStyleLevel);
+  ioptions_.compaction_pri = kReadHeatWeightedOverlappingRatio;
+  mutable_cf_options_.max_bytes_for_level_base = 10000000;
+  mutable_cf_options_.max_bytes_for_level_multiplier = 10;
+
+  Add(2, 6U, "150", "179", 50000000U);  // Overlaps with file 26
+  Add(2, 7U, "180", "220", 50000000U);  // Overlaps with file 27, 28
+  Add(2, 8U, "321", "400", 50000000U);  // Overlaps with file 29
+
+  Add(3, 26U, "150", "170", 260000000U);
+  Add(3, 27U, "180", "200", 260000000U);
+  Add(3, 28U, "201", "220", 260000000U);
+  Add(3, 29U, "330", "390", 260000000U);
+  // File 7 has the largest overlapping ratio but gets most of the reads
+  file_map_[7U].first->stats.num_reads_sampled = 30000;
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction(level_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, mutable_db_options_, vstorage_.get(),
+      &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(1U, compaction->num_input_files(0));
+  ASSERT_EQ(7U, compaction->input(0, 0)->fd.GetNumber());
+}
+
 TEST_F(CompactionPickerTest, CompactionPriMinOverlapping4) {
   NewVersionStorage(6, kCompactionStyleLevel);
   ioptions_.compaction_pri = kMinOverlappingRatio;
@@ -1853,6 +1879,38 @@ TEST_F(CompactionPickerTest, IntraL0ForEarliestSeqno) {
   ASSERT_EQ(0, compaction->output_level());
 }
 
+TEST_F(CompactionPickerTest, IntraL0DoesNotSplitSortedRun) {
+  mutable_cf_options_.level0_file_num_compaction_trigger = 3;
+  mutable_cf_options_.max_compaction_bytes = 1199999u;
+  NewVersionStorage(6, kCompactionStyleLevel);
+
+  // max_compaction_bytes would limit the intra L0 compaction to files 8 to 4.
+  // Files 4, 3 and 2 were written by the subcompactions of one compaction into
+  // L0 and form a single sorted run, so file 4 is left out as well. The one
+  // L1 file spans entire L0 key range and is marked as being compacted to
+  // avoid L0->L1 compaction.
+  Add(0, 8U, "100", "350", 200000U, 0, 122, 123);
+  Add(0, 7U, "100", "350", 200000U, 0, 120, 121);
+  Add(0, 6U, "100", "350", 200000U, 0, 118, 119);
+  Add(0, 5U, "100", "350", 200000U, 0, 116, 117);
+  Add(0, 4U, "251", "350", 200000U, 0, 100, 115);
+  Add(0, 3U, "151", "250", 200000U, 0, 100, 115);
+  Add(0, 2U, "100", "150", 200000U, 0, 100, 115);
+  Add(1, 1U, "100", "350", 200000U, 0, 90, 99);
+  vstorage_->LevelFiles(1)[0]->being_compacted = true;
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction(level_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, mutable_db_options_, vstorage_.get(),
+      &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(1U, compaction->num_input_levels());
+  ASSERT_EQ(4U, compaction->num_input_files(0));
+  ASSERT_EQ(8U, compaction->input(0, 0)->fd.GetNumber());
+  ASSERT_EQ(5U, compaction->input(0, 3)->fd.GetNumber());
+  ASSERT_EQ(0, compaction->output_level());
+}
+
 #ifndef ROCKSDB_LITE
 TEST_F(CompactionPickerTest, UniversalMarkedCompactionFullOverlap) {
   const uint64_t kFileSize = 100000;
@@ -10,11 +10,13 @@
 #include "db/compaction/compaction_picker_universal.h"
 #ifndef ROCKSDB_LITE
 
+#include <algorithm>
 #include <cinttypes>
 #include <limits>
 #include <queue>
 #include <string>
 #include <utility>
+#include <vector>
 #include "db/column_family.h"
 #include "file/filename.h"
 #include "logging/log_buffer.h"
@@ -53,12 +55,14 @@ class UniversalCompactionBuilder {
     SortedRun(int _level, FileMetaData* _file, uint64_t _size,
               uint64_t _compensated_file_size, bool _being_compacted)
         : level(_level),
-          file(_file),
           size(_size),
           compensated_file_size(_compensated_file_size),
           being_compacted(_being_compacted) {
       assert(compensated_file_size > 0);
-      assert(level != 0 || file != nullptr);
+      assert(level != 0 || _file != nullptr);
+      if (_file != nullptr) {
+        files.push_back(_file);
+      }
     }
 
     void Dump(char* out_buf, size_t out_buf_size,
@@ -69,9 +73,11 @@ class UniversalCompactionBuilder {
                       size_t sorted_run_count) const;
 
     int level;
-    // `file` Will be null for level > 0. For level = 0, the sorted run is
-    // for this file.
-    FileMetaData* file;
+    // `files` will be empty for level > 0. For level = 0, the sorted run is
+    // for these files, which is usually a single file. Several files form a
+    // sorted run when they were written by the subcompactions of a single
+    // compaction, in which case they are adjacent and newest first in L0.
+    std::vector<FileMetaData*> files;
     // For level > 0, `size` and `compensated_file_size` are sum of sizes all
     // files in the level. `being_compacted` should be the same for all files
     // in a non-zero level. Use the value here.
@@ -289,14 +295,22 @@ void UniversalCompactionBuilder::SortedRun::Dump(char* out_buf,
                                                  size_t out_buf_size,
                                                  bool print_path) const {
   if (level == 0) {
-    assert(file != nullptr);
+    assert(!files.empty());
+    const FileMetaData* file = files.front();
+    int len;
     if (file->fd.GetPathId() == 0 || !print_path) {
-      snprintf(out_buf, out_buf_size, "file %" PRIu64, file->fd.GetNumber());
+      len = snprintf(out_buf, out_buf_size, "file %" PRIu64,
+                     file->fd.GetNumber());
     } else {
-      snprintf(out_buf, out_buf_size, "file %" PRIu64
-                                      "(path "
-                                      "%" PRIu32 ")",
-               file->fd.GetNumber(), file->fd.GetPathId());
+      len = snprintf(out_buf, out_buf_size, "file %" PRIu64
+                                            "(path "
+                                            "%" PRIu32 ")",
+                     file->fd.GetNumber(), file->fd.GetPathId());
+    }
+    if (files.size() > 1 && len >= 0 &&
+        static_cast<size_t>(len) < out_buf_size) {
+      snprintf(out_buf + len, out_buf_size - len,
+               " and %" ROCKSDB_PRIszt " more", files.size() - 1);
     }
   } else {
     snprintf(out_buf, out_buf_size, "level %d", level);
@@ -306,13 +320,13 @@ void UniversalCompactionBuilder::SortedRun::Dump(char* out_buf,
 void UniversalCompactionBuilder::SortedRun::DumpSizeInfo(
     char* out_buf, size_t out_buf_size, size_t sorted_run_count) const {
   if (level == 0) {
-    assert(file != nullptr);
+    assert(!files.empty());
     snprintf(out_buf, out_buf_size,
-             "file %" PRIu64 "[%" ROCKSDB_PRIszt
-             "] "
+             "file %" PRIu64 "[%" ROCKSDB_PRIszt "] (%" ROCKSDB_PRIszt
+             " files) "
              "with size %" PRIu64 " (compensated size %" PRIu64 ")",
-             file->fd.GetNumber(), sorted_run_count, file->fd.GetFileSize(),
-             file->compensated_file_size);
+             files.front()->fd.GetNumber(), sorted_run_count, files.size(),
+             size, compensated_file_size);
   } else {
     snprintf(out_buf, out_buf_size,
              "level %d[%" ROCKSDB_PRIszt
@@ -327,6 +341,16 @@ UniversalCompactionBuilder::CalculateSortedRuns(
     const VersionStorageInfo& vstorage) {
   std::vector<UniversalCompactionBuilder::SortedRun> ret;
   for (FileMetaData* f : vstorage.LevelFiles(0)) {
+    if (!ret.empty() && InSameL0SortedRun(ret.back().files.back(), f)) {
+      SortedRun& sr = ret.back();
+      sr.files.push_back(f);
+      sr.size += f->fd.GetFileSize();
+      sr.compensated_file_size += f->compensated_file_size;
+      // Like for a non-zero level, mark the entire run as being compacted if
+      // one or more files are being compacted
+      sr.being_compacted = sr.being_compacted || f->being_compacted;
+      continue;
+    }
     ret.emplace_back(0, f, f->fd.GetFileSize(), f->compensated_file_size,
                      f->being_compacted);
   }
@@ -698,8 +722,9 @@ Compaction* UniversalCompactionBuilder::PickCompactionToReduceSortedRuns(
   for (size_t i = start_index; i < first_index_after; i++) {
     auto& picking_sr = sorted_runs_[i];
     if (picking_sr.level == 0) {
-      FileMetaData* picking_file = picking_sr.file;
-      inputs[0].files.push_back(picking_file);
+      for (FileMetaData* picking_file : picking_sr.files) {
+        inputs[0].files.push_back(picking_file);
+      }
     } else {
       auto& files = inputs[picking_sr.level - start_level].files;
       for (auto* f : vstorage_->LevelFiles(picking_sr.level)) {
@@ -845,9 +870,11 @@ Compaction* UniversalCompactionBuilder::PickDeleteTriggeredCompaction() {
       if (sr->being_compacted) {
         continue;
       }
-      FileMetaData* f = vstorage_->LevelFiles(0)[loop];
-      if (f->marked_for_compaction) {
-        start_level_inputs.files.push_back(f);
+      if (std::any_of(sr->files.begin(), sr->files.end(),
+                      [](const FileMetaData* f) {
+                        return f->marked_for_compaction;
+                      })) {
+        start_level_inputs.files = sr->files;
         start_index =
             static_cast<int>(loop);  // Consider this as the first candidate.
         break;
@@ -864,11 +891,11 @@ Compaction* UniversalCompactionBuilder::PickDeleteTriggeredCompaction() {
         break;
       }
 
-      FileMetaData* f = vstorage_->LevelFiles(0)[loop];
-      start_level_inputs.files.push_back(f);
+      start_level_inputs.files.insert(start_level_inputs.files.end(),
+                                      sr->files.begin(), sr->files.end());
     }
-    if (start_level_inputs.size() <= 1) {
-      // If only the last file in L0 is marked for compaction, ignore it
+    if (start_level_inputs.size() == sorted_runs_[start_index].files.size()) {
+      // If only the last sorted run in L0 is marked for compaction, ignore it
       return nullptr;
     }
     inputs.push_back(start_level_inputs);
@@ -980,8 +1007,9 @@ Compaction* UniversalCompactionBuilder::PickCompactionToOldest(
   for (size_t loop = start_index; loop < sorted_runs_.size(); loop++) {
     auto& picking_sr = sorted_runs_[loop];
     if (picking_sr.level == 0) {
-      FileMetaData* f = picking_sr.file;
-      inputs[0].files.push_back(f);
+      for (FileMetaData* f : picking_sr.files) {
+        inputs[0].files.push_back(f);
+      }
     } else {
       auto& files = inputs[picking_sr.level - start_level].files;
       for (auto* f : vstorage_->LevelFiles(picking_sr.level)) {
@@ -1064,7 +1092,8 @@ Compaction* UniversalCompactionBuilder::PickPeriodicCompaction() {
   if (start_index == sorted_runs_.size() - 1) {
     bool included_file_marked = false;
     int start_level = sorted_runs_[start_index].level;
-    FileMetaData* start_file = sorted_runs_[start_index].file;
+    const std::vector<FileMetaData*>& start_files =
+        sorted_runs_[start_index].files;
     for (const std::pair<int, FileMetaData*>& level_file_pair :
          vstorage_->FilesMarkedForPeriodicCompaction()) {
       if (start_level != 0) {
@@ -1075,7 +1104,8 @@ Compaction* UniversalCompactionBuilder::PickPeriodicCompaction() {
         }
       } else {
         // Last sorted run is a L0 file.
-        if (start_file == level_file_pair.second) {
+        if (std::find(start_files.begin(), start_files.end(),
+                      level_file_pair.second) != start_files.end()) {
           included_file_marked = true;
           break;
         }
@@ -0,0 +1,262 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/compaction/pipelined_input_iterator.h"
+
+#include "monitoring/iostats_context_imp.h"
+#include "monitoring/perf_context_imp.h"
+#include "test_util/sync_point.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// A batch is handed over once it holds this many bytes of keys and values,
+// about two uncompressed data blocks.
+const size_t kBatchBytes = 64 << 10;
+// Number of batches the prefetch thread can run ahead by
+const size_t kNumBatches = 16;
+}  // namespace
+
+#define TAKE_IOSTATS_COUNTER(counter) \
+  counter += IOSTATS(counter);        \
+  IOSTATS_RESET(counter)
+
+#if !defined(NPERF_CONTEXT) && defined(ROCKSDB_SUPPORT_THREAD_LOCAL)
+#define TAKE_PERF_COUNTER(counter)   \
+  counter += perf_context.counter;   \
+  perf_context.counter = 0
+#define ADD_PERF_COUNTER(counter) \
+  perf_context.counter += counter; \
+  counter = 0
+#else
+#define TAKE_PERF_COUNTER(counter)
+#define ADD_PERF_COUNTER(counter) counter = 0
+#endif
+
+void PipelinedInputIterator::ReadCounters::TakeFromThisThread() {
+  TAKE_IOSTATS_COUNTER(bytes_read);
+  TAKE_IOSTATS_COUNTER(read_nanos);
+  TAKE_IOSTATS_COUNTER(open_nanos);
+  TAKE_PERF_COUNTER(block_read_count);
+  TAKE_PERF_COUNTER(block_read_byte);
+  TAKE_PERF_COUNTER(block_read_time);
+  TAKE_PERF_COUNTER(block_checksum_time);
+  TAKE_PERF_COUNTER(block_decompress_time);
+  TAKE_PERF_COUNTER(block_cache_hit_count);
+  TAKE_PERF_COUNTER(block_cache_index_hit_count);
+  TAKE_PERF_COUNTER(index_block_read_count);
+  TAKE_PERF_COUNTER(block_cache_filter_hit_count);
+  TAKE_PERF_COUNTER(filter_block_read_count);
+  TAKE_PERF_COUNTER(read_index_block_nanos);
+  TAKE_PERF_COUNTER(new_table_block_iter_nanos);
+  TAKE_PERF_COUNTER(new_table_iterator_nanos);
+  TAKE_PERF_COUNTER(block_seek_nanos);
+  TAKE_PERF_COUNTER(find_table_nanos);
+  TAKE_PERF_COUNTER(env_new_random_access_file_nanos);
+}
+
+void PipelinedInputIterator::ReadCounters::AddToThisThread() {
+  IOSTATS_ADD(bytes_read, bytes_read);
+  IOSTATS_ADD(read_nanos, read_nanos);
+  IOSTATS_ADD(open_nanos, open_nanos);
+  bytes_read = read_nanos = open_nanos = 0;
+  ADD_PERF_COUNTER(block_read_count);
+  ADD_PERF_COUNTER(block_read_byte);
+  ADD_PERF_COUNTER(block_read_time);
+  ADD_PERF_COUNTER(block_checksum_time);
+  ADD_PERF_COUNTER(block_decompress_time);
+  ADD_PERF_COUNTER(block_cache_hit_count);
+  ADD_PERF_COUNTER(block_cache_index_hit_count);
+  ADD_PERF_COUNTER(index_block_read_count);
+  ADD_PERF_COUNTER(block_cache_filter_hit_count);
+  ADD_PERF_COUNTER(filter_block_read_count);
+  ADD_PERF_COUNTER(read_index_block_nanos);
+  ADD_PERF_COUNTER(new_table_block_iter_nanos);
+  ADD_PERF_COUNTER(new_table_iterator_nanos);
+  ADD_PERF_COUNTER(block_seek_nanos);
+  ADD_PERF_COUNTER(find_table_nanos);
+  ADD_PERF_COUNTER(env_new_random_access_file_nanos);
+}
+
+#undef TAKE_IOSTATS_COUNTER
+#undef TAKE_PERF_COUNTER
+#undef ADD_PERF_COUNTER
+
+PipelinedInputIterator::PipelinedInputIterator(InternalIterator* input)
+    : input_(input),
+      batches_(kNumBatches),
+      current_(nullptr),
+      pos_(0),
+      prefetching_(false),
+      shutdown_(false),
+      perf_level_(PerfLevel::kDisable) {}
+
+PipelinedInputIterator::~PipelinedInputIterator() {
+  StopPrefetch();
+  if (thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      shutdown_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+  }
+}
+
+void PipelinedInputIterator::StopPrefetch() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (prefetching_) {
+    // Makes the prefetch thread fail to take or hand over its next batch
+    free_batches_->finish();
+    full_batches_->finish();
+    cv_.wait(lock, [this] { return !prefetching_; });
+  }
+  read_counters_.AddToThisThread();
+}
+
+template <typename PositionFn>
+void PipelinedInputIterator::Restart(PositionFn position) {
+  StopPrefetch();
+  free_batches_.reset(new WorkQueue<Batch*>());
+  full_batches_.reset(new WorkQueue<Batch*>());
+  for (auto& batch : batches_) {
+    free_batches_->push(&batch);
+  }
+  current_ = nullptr;
+  pos_ = 0;
+  status_ = Status::OK();
+  position();
+  if (!thread_.joinable()) {
+    thread_ = port::Thread([this] { PrefetchThread(); });
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    perf_level_ = GetPerfLevel();
+    prefetching_ = true;
+  }
+  cv_.notify_all();
+  NextBatch();
+}
+
+void PipelinedInputIterator::PrefetchThread() {
+  TEST_SYNC_POINT("PipelinedInputIterator::PrefetchThread:Start");
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this] { return prefetching_ || shutdown_; });
+    if (shutdown_) {
+      return;
+    }
+    SetPerfLevel(perf_level_);
+    lock.unlock();
+    Prefetch();
+    lock.lock();
+    read_counters_.TakeFromThisThread();
+    prefetching_ = false;
+    cv_.notify_all();
+  }
+}
+
+void PipelinedInputIterator::Prefetch() {
+  TEST_SYNC_POINT("PipelinedInputIterator::Prefetch:Start");
+  Batch* batch;
+  while (free_batches_->pop(batch)) {
+    batch->Clear();
+    while (input_->Valid() && batch->data.size() < kBatchBytes) {
+      Slice key = input_->key();
+      Slice value = input_->value();
+      batch->entries.push_back({batch->data.size(),
+                                static_cast<uint32_t>(key.size()),
+                                static_cast<uint32_t>(value.size())});
+      batch->data.append(key.data(), key.size());
+      batch->data.append(value.data(), value.size());
+      input_->Next();
+    }
+    if (!input_->Valid()) {
+      batch->last = true;
+      batch->status = input_->status();
+    }
+    bool last = batch->last;
+    if (!full_batches_->push(batch) || last) {
+      break;
+    }
+  }
+}
+
+void PipelinedInputIterator::NextBatch() {
+  while (true) {
+    if (current_ != nullptr) {
+      if (current_->last) {
+        // Stay past the last entry
+        pos_ = current_->entries.size();
+        status_ = current_->status;
+        // The round is over, so this only waits for the prefetch thread to
+        // hand over its read counters
+        StopPrefetch();
+        return;
+      }
+      free_batches_->push(current_);
+      current_ = nullptr;
+    }
+    Batch* batch;
+    if (!full_batches_->pop(batch)) {
+      // Only after StopPrefetch()
+      status_ = Status::Aborted("Compaction input prefetch stopped");
+      return;
+    }
+    current_ = batch;
+    pos_ = 0;
+    if (!batch->entries.empty()) {
+      UpdateKeyValue();
+      return;
+    }
+  }
+}
+
+void PipelinedInputIterator::UpdateKeyValue() {
+  const Batch::Entry& entry = current_->entries[pos_];
+  const char* data = current_->data.data() + entry.offset;
+  key_ = Slice(data, entry.key_size);
+  value_ = Slice(data + entry.key_size, entry.value_size);
+}
+
+void PipelinedInputIterator::SeekToFirst() {
+  Restart([this] { input_->SeekToFirst(); });
+}
+
+void PipelinedInputIterator::Seek(const Slice& target) {
+  Restart([this, &target] { input_->Seek(target); });
+}
+
+void PipelinedInputIterator::Next() {
+  assert(Valid());
+  if (++pos_ < current_->entries.size()) {
+    UpdateKeyValue();
+  } else {
+    NextBatch();
+  }
+}
+
+void PipelinedInputIterator::SeekToLast() {
+  assert(false);
+  StopPrefetch();
+  current_ = nullptr;
+  status_ = Status::NotSupported("SeekToLast() on compaction input");
+}
+
+void PipelinedInputIterator::SeekForPrev(const Slice& /*target*/) {
+  assert(false);
+  StopPrefetch();
+  current_ = nullptr;
+  status_ = Status::NotSupported("SeekForPrev() on compaction input");
+}
+
+void PipelinedInputIterator::Prev() {
+  assert(false);
+  StopPrefetch();
+  current_ = nullptr;
+  status_ = Status::NotSupported("Prev() on compaction input");
+}
+
+}  // namespace ROCKSDB_NAMESPACE
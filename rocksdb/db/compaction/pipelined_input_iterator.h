@@ -0,0 +1,159 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/perf_level.h"
+#include "table/internal_iterator.h"
+#include "util/work_queue.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// PipelinedInputIterator implements DBOptions::enable_pipelined_compaction.
+// It reads the input of a compaction ahead on a dedicated thread, so that
+// reading, checksumming, decrypting and decompressing input blocks and merging
+// the sorted runs overlap with the compaction iterator and the output table
+// builder. The prefetch thread copies the entries of the input iterator into
+// batches and hands them over through a bounded queue.
+//
+// Only forward iteration is supported. Seek() and SeekToFirst() stop the
+// current prefetch round, position the input iterator and have the same
+// prefetch thread start a new round from there. Keys and values are copies,
+// so they are never pinned, and GetDataBlockPosition() is not forwarded: the
+// prefetch thread may have moved on to another input file by the time an
+// entry is consumed.
+//
+// The read I/O and perf counters the prefetch thread accumulates are added
+// to the thread-local contexts of the consuming thread once the input is
+// exhausted, on Seek() and on destruction.
+class PipelinedInputIterator : public InternalIterator {
+ public:
+  // input must outlive this iterator. Nothing is read before the first
+  // Seek() or SeekToFirst().
+  explicit PipelinedInputIterator(InternalIterator* input);
+
+  // Stops and joins the prefetch thread.
+  ~PipelinedInputIterator() override;
+
+  bool Valid() const override {
+    return current_ != nullptr && pos_ < current_->entries.size();
+  }
+  void SeekToFirst() override;
+  void SeekToLast() override;
+  void Seek(const Slice& target) override;
+  void SeekForPrev(const Slice& target) override;
+  void Next() override;
+  void Prev() override;
+  Slice key() const override {
+    assert(Valid());
+    return key_;
+  }
+  Slice value() const override {
+    assert(Valid());
+    return value_;
+  }
+  Status status() const override { return status_; }
+
+ private:
+  struct Batch {
+    struct Entry {
+      size_t offset;
+      uint32_t key_size;
+      uint32_t value_size;
+    };
+
+    // Keys and values of the entries, each value right after its key
+    std::string data;
+    std::vector<Entry> entries;
+    // The input ended after the entries, with this status
+    bool last = false;
+    Status status;
+
+    void Clear() {
+      data.clear();
+      entries.clear();
+      last = false;
+      status = Status::OK();
+    }
+  };
+
+  // Read counters of the prefetch thread that are not yet added to the
+  // consuming thread. CPU time is left out: the consuming thread subtracts
+  // its own I/O CPU time from its CPU time.
+  struct ReadCounters {
+    uint64_t bytes_read = 0;
+    uint64_t read_nanos = 0;
+    uint64_t open_nanos = 0;
+    uint64_t block_read_count = 0;
+    uint64_t block_read_byte = 0;
+    uint64_t block_read_time = 0;
+    uint64_t block_checksum_time = 0;
+    uint64_t block_decompress_time = 0;
+    uint64_t block_cache_hit_count = 0;
+    uint64_t block_cache_index_hit_count = 0;
+    uint64_t index_block_read_count = 0;
+    uint64_t block_cache_filter_hit_count = 0;
+    uint64_t filter_block_read_count = 0;
+    uint64_t read_index_block_nanos = 0;
+    uint64_t new_table_block_iter_nanos = 0;
+    uint64_t new_table_iterator_nanos = 0;
+    uint64_t block_seek_nanos = 0;
+    uint64_t find_table_nanos = 0;
+    uint64_t env_new_random_access_file_nanos = 0;
+
+    // Moves the counters of the calling thread's contexts here
+    void TakeFromThisThread();
+    // Adds the counters to the calling thread's contexts and clears them
+    void AddToThisThread();
+  };
+
+  // Stops the current prefetch round, runs position on the input iterator
+  // and starts a new round from there.
+  template <typename PositionFn>
+  void Restart(PositionFn position);
+  // Stops the current prefetch round, waits for the prefetch thread to go
+  // idle and takes over its read counters.
+  void StopPrefetch();
+  // Body of the prefetch thread: runs a round each time Restart() asks
+  void PrefetchThread();
+  // Fills batches from the input until its end or until StopPrefetch()
+  void Prefetch();
+  // Moves on to the next batch with entries, or to the end of the input
+  void NextBatch();
+  void UpdateKeyValue();
+
+  InternalIterator* const input_;
+  std::vector<Batch> batches_;
+  // Batches that can be filled, and batches ready to be consumed
+  std::unique_ptr<WorkQueue<Batch*>> free_batches_;
+  std::unique_ptr<WorkQueue<Batch*>> full_batches_;
+  port::Thread thread_;
+
+  // Batch being consumed
+  Batch* current_;
+  size_t pos_;
+  Slice key_;
+  Slice value_;
+  Status status_;
+
+  // Protects the fields below, which hand rounds to the prefetch thread
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  // A round is requested or running
+  bool prefetching_;
+  bool shutdown_;
+  // Perf level of the consuming thread when the round was requested
+  PerfLevel perf_level_;
+  ReadCounters read_counters_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -343,6 +343,151 @@ TEST_F(DBBlockCacheTest, IndexAndFilterBlocksOfNewTableAddedToCache) {
             TestGetTickerCount(options, BLOCK_CACHE_INDEX_HIT));
 }
 
+TEST_F(DBBlockCacheTest, PrefetchHotPartitionsOnOpen) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  // Tables are opened eagerly and without prefetching their partitions
+  options.max_open_files = -1;
+  options.disable_auto_compactions = true;
+  BlockBasedTableOptions table_options;
+  table_options.cache_index_and_filter_blocks = true;
+  table_options.index_type = BlockBasedTableOptions::kTwoLevelIndexSearch;
+  table_options.partition_filters = true;
+  table_options.filter_policy.reset(NewBloomFilterPolicy(10, false));
+  table_options.block_size = 64;
+  table_options.metadata_block_size = 64;
+  table_options.prefetch_hot_partitions = true;
+  table_options.block_cache = NewLRUCache(8 << 20);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  const int kNumKeys = 1000;
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(Put(Key(i), std::string(32, 'v')));
+  }
+  ASSERT_OK(Flush());
+  // Level-0 tables always prefetch all of their partitions
+  MoveFilesToLevel(1);
+  std::vector<LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  ASSERT_EQ(1U, files.size());
+  const std::string heat_file =
+      TableHeatFileName(files[0].db_path + files[0].name);
+
+  // Warm up a narrow key range
+  Reopen(options);
+  for (int i = 0; i < 20; i++) {
+    ASSERT_EQ(std::string(32, 'v'), Get(Key(i)));
+  }
+  Close();
+  ASSERT_OK(env_->FileExists(heat_file));
+
+  // A read-only instance uses the heat file but doesn't write it
+  ASSERT_OK(env_->DeleteFile(heat_file));
+  ASSERT_OK(ReadOnlyReopen(options));
+  for (int i = 0; i < 20; i++) {
+    ASSERT_EQ(std::string(32, 'v'), Get(Key(i)));
+  }
+  Close();
+  ASSERT_TRUE(env_->FileExists(heat_file).IsNotFound());
+  Reopen(options);
+  for (int i = 0; i < 20; i++) {
+    ASSERT_EQ(std::string(32, 'v'), Get(Key(i)));
+  }
+  Close();
+  ASSERT_OK(env_->FileExists(heat_file));
+
+  // With a fresh cache the hot partitions are loaded in the background after
+  // opening, so the same reads don't miss on index or filter partitions.
+  table_options.block_cache = NewLRUCache(8 << 20);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  std::atomic<int> warm_ups{0};
+  SyncPoint::GetInstance()->SetCallBack(
+      "BlockBasedTable::WarmUpHotPartitions:Done",
+      [&](void* /*arg*/) { warm_ups++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+  Reopen(options);
+  while (warm_ups.load() < 1) {
+    env_->SleepForMicroseconds(1000);
+  }
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  const uint64_t index_misses =
+      TestGetTickerCount(options, BLOCK_CACHE_INDEX_MISS);
+  const uint64_t filter_misses =
+      TestGetTickerCount(options, BLOCK_CACHE_FILTER_MISS);
+  for (int i = 0; i < 20; i++) {
+    ASSERT_EQ(std::string(32, 'v'), Get(Key(i)));
+  }
+  ASSERT_EQ(index_misses, TestGetTickerCount(options, BLOCK_CACHE_INDEX_MISS));
+  ASSERT_EQ(filter_misses,
+            TestGetTickerCount(options, BLOCK_CACHE_FILTER_MISS));
+
+  // Keys outside of the hot range still load their partitions on demand
+  ASSERT_EQ(std::string(32, 'v'), Get(Key(kNumKeys - 1)));
+  ASSERT_LT(index_misses, TestGetTickerCount(options, BLOCK_CACHE_INDEX_MISS));
+
+  // Only live tables get their heat saved, and only on close: neither the
+  // reader of the compacted table nor closing the DB afterwards writes it
+  ASSERT_OK(env_->DeleteFile(heat_file));
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_TRUE(env_->FileExists(heat_file).IsNotFound());
+  Close();
+  ASSERT_TRUE(env_->FileExists(heat_file).IsNotFound());
+}
+
+TEST_F(DBBlockCacheTest, WarmUpFromBlockCacheManifest) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.disable_auto_compactions = true;
+  options.block_cache_manifest_period_sec = 3600;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 256;
+  table_options.block_cache = NewLRUCache(8 << 20);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  const int kNumKeys = 1000;
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(Put(Key(i), std::string(32, 'v')));
+  }
+  ASSERT_OK(Flush());
+
+  // Cache the data blocks of a narrow key range; closing records them
+  for (int i = 0; i < 20; i++) {
+    ASSERT_EQ(std::string(32, 'v'), Get(Key(i)));
+  }
+  Close();
+  const std::string manifest_file = BlockCacheManifestFileName(dbname_);
+  ASSERT_OK(env_->FileExists(manifest_file));
+
+  // With a fresh cache the same blocks are loaded in the background after
+  // opening, so reading them again does not miss.
+  table_options.block_cache = NewLRUCache(8 << 20);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  Reopen(options);
+  dbfull()->TEST_WaitForBlockCacheWarmUp();
+  const uint64_t data_misses =
+      TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS);
+  for (int i = 0; i < 20; i++) {
+    ASSERT_EQ(std::string(32, 'v'), Get(Key(i)));
+  }
+  ASSERT_EQ(data_misses, TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS));
+
+  // Blocks that were not cached are still read on demand
+  ASSERT_EQ(std::string(32, 'v'), Get(Key(kNumKeys - 1)));
+  ASSERT_LT(data_misses, TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS));
+  Close();
+
+  // A damaged manifest is ignored
+  ASSERT_OK(WriteStringToFile(env_, "garbage", manifest_file));
+  ASSERT_OK(TryReopen(options));
+  dbfull()->TEST_WaitForBlockCacheWarmUp();
+  ASSERT_EQ(std::string(32, 'v'), Get(Key(0)));
+}
+
 // With fill_cache = false, fills up the cache, then iterates over the entire
 // db, verify dummy entries inserted in `BlockBasedTable::NewDataBlockIterator`
 // does not cause heap-use-after-free errors in COMPILE_WITH_ASAN=1 runs
@@ -7,7 +7,10 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
+#include "db/compaction/compaction_job.h"
 #include "db/db_test_util.h"
+#include "file/file_util.h"
+#include "file/sst_file_manager_impl.h"
 #include "port/port.h"
 #include "port/stack_trace.h"
 #include "rocksdb/concurrent_task_limiter.h"
@@ -1055,6 +1058,707 @@ TEST_F(DBCompactionTest, CompactionSstPartitionerNonTrivial) {
   ASSERT_EQ("B", Get("bbbb1"));
 }
 
+TEST_F(DBCompactionTest, PipelinedCompaction) {
+  // Drops the keys from Key(1000) to Key(1100) by skipping, which seeks the
+  // compaction input
+  class SkipRangeFilter : public CompactionFilter {
+   public:
+    Decision FilterV2(int /*level*/, const Slice& key,
+                      ValueType /*value_type*/,
+                      const Slice& /*existing_value*/,
+                      std::string* /*new_value*/,
+                      std::string* skip_until) const override {
+      if (key == Key(1000)) {
+        *skip_until = Key(1100);
+        return Decision::kRemoveAndSkipUntil;
+      }
+      return Decision::kKeep;
+    }
+    const char* Name() const override { return "SkipRangeFilter"; }
+  };
+  SkipRangeFilter filter;
+
+  Options options = CurrentOptions();
+  options.enable_pipelined_compaction = true;
+  options.disable_auto_compactions = true;
+  options.statistics = CreateDBStatistics();
+  DestroyAndReopen(options);
+
+  std::atomic<int> prefetch_starts(0);
+  std::atomic<int> prefetch_threads(0);
+  SyncPoint::GetInstance()->SetCallBack(
+      "PipelinedInputIterator::Prefetch:Start",
+      [&](void* /*arg*/) { prefetch_starts++; });
+  SyncPoint::GetInstance()->SetCallBack(
+      "PipelinedInputIterator::PrefetchThread:Start",
+      [&](void* /*arg*/) { prefetch_threads++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  const int kNumKeys = 2000;
+  Random rnd(301);
+  std::vector<std::string> values(kNumKeys);
+  for (int i = 0; i < kNumKeys; i++) {
+    values[i] = rnd.RandomString(200);
+    ASSERT_OK(Put(Key(i), values[i]));
+  }
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(1);
+  for (int i = 0; i < kNumKeys; i += 2) {
+    values[i] = rnd.RandomString(200);
+    ASSERT_OK(Put(Key(i), values[i]));
+  }
+  for (int i = 0; i < kNumKeys; i += 3) {
+    values[i].clear();
+    ASSERT_OK(Delete(Key(i)));
+  }
+  ASSERT_OK(Flush());
+  uint64_t input_size = 0;
+  ASSERT_TRUE(
+      db_->GetIntProperty(DB::Properties::kTotalSstFilesSize, &input_size));
+
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_GT(prefetch_starts.load(), 0);
+  // The prefetch thread's reads are accounted to the compaction
+  ASSERT_GE(TestGetTickerCount(options, COMPACT_READ_BYTES), input_size / 2);
+  ASSERT_EQ("0,1", FilesPerLevel());
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ(values[i].empty() ? "NOT_FOUND" : values[i], Get(Key(i)));
+  }
+
+  options.compaction_filter = &filter;
+  Reopen(options);
+  ASSERT_OK(Put(Key(kNumKeys), "v"));
+  ASSERT_OK(Flush());
+  prefetch_starts = 0;
+  prefetch_threads = 0;
+  CompactRangeOptions cro;
+  cro.bottommost_level_compaction = BottommostLevelCompaction::kForce;
+  ASSERT_OK(db_->CompactRange(cro, nullptr, nullptr));
+  // Skipping restarts prefetching on the same thread
+  ASSERT_GT(prefetch_threads.load(), 0);
+  ASSERT_GT(prefetch_starts.load(), prefetch_threads.load());
+  for (int i = 0; i < kNumKeys; i++) {
+    if (i >= 1000 && i < 1100) {
+      ASSERT_EQ("NOT_FOUND", Get(Key(i)));
+    } else {
+      ASSERT_EQ(values[i].empty() ? "NOT_FOUND" : values[i], Get(Key(i)));
+    }
+  }
+  ASSERT_EQ("v", Get(Key(kNumKeys)));
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
+TEST_F(DBCompactionTest, SampledSubcompactionBoundaries) {
+  for (bool partitioned_index : {false, true}) {
+    Options options = CurrentOptions();
+    options.sample_subcompaction_boundaries = true;
+    options.max_subcompactions = 4;
+    options.target_file_size_base = 64 << 10;
+    options.disable_auto_compactions = true;
+    options.statistics = CreateDBStatistics();
+    BlockBasedTableOptions table_options;
+    if (partitioned_index) {
+      table_options.index_type = BlockBasedTableOptions::kTwoLevelIndexSearch;
+      table_options.metadata_block_size = 256;
+    }
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    DestroyAndReopen(options);
+
+    // Two overlapping L0 files, compacted into the empty L1
+    const int kNumKeys = 2000;
+    Random rnd(301);
+    std::vector<std::string> values(kNumKeys);
+    for (int i = 0; i < kNumKeys; i++) {
+      values[i] = rnd.RandomString(200);
+      ASSERT_OK(Put(Key(i), values[i]));
+    }
+    ASSERT_OK(Flush());
+    for (int i = 0; i < kNumKeys; i += 2) {
+      values[i] = rnd.RandomString(200);
+      ASSERT_OK(Put(Key(i), values[i]));
+    }
+    ASSERT_OK(Flush());
+    ASSERT_EQ("2", FilesPerLevel());
+
+    ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+    ASSERT_EQ(0, NumTableFilesAtLevel(0));
+    HistogramData subcompactions;
+    options.statistics->histogramData(NUM_SUBCOMPACTIONS_SCHEDULED,
+                                      &subcompactions);
+    ASSERT_EQ(1U, subcompactions.count);
+    ASSERT_EQ(options.max_subcompactions, subcompactions.max);
+    for (int i = 0; i < kNumKeys; i++) {
+      ASSERT_EQ(values[i], Get(Key(i)));
+    }
+  }
+}
+
+TEST_F(DBCompactionTest, ReuseCompactionInputBlocks) {
+  Options options = CurrentOptions();
+  options.reuse_compaction_input_blocks = true;
+  options.disable_auto_compactions = true;
+  options.statistics = CreateDBStatistics();
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+  // Keeps the compaction from zeroing the sequence numbers of the keys
+  const Snapshot* snapshot = db_->GetSnapshot();
+
+  // Two L0 files with disjoint key ranges: every input block is output as-is
+  const int kNumKeys = 400;
+  Random rnd(301);
+  std::vector<std::string> values(kNumKeys);
+  for (int i = 0; i < kNumKeys; i++) {
+    values[i] = rnd.RandomString(100);
+    ASSERT_OK(Put(Key(i), values[i]));
+    if (i == kNumKeys / 2 - 1) {
+      ASSERT_OK(Flush());
+    }
+  }
+  ASSERT_OK(Flush());
+  ASSERT_EQ("2", FilesPerLevel());
+  TablePropertiesCollection props;
+  ASSERT_OK(db_->GetPropertiesOfAllTables(&props));
+  uint64_t num_data_blocks = 0;
+  for (const auto& p : props) {
+    num_data_blocks += p.second->num_data_blocks;
+  }
+
+  ASSERT_OK(dbfull()->TEST_CompactRange(0, nullptr, nullptr));
+  ASSERT_EQ("0,1", FilesPerLevel());
+  ASSERT_EQ(num_data_blocks,
+            options.statistics->getTickerCount(COMPACTION_DATA_BLOCKS_COPIED));
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ(values[i], Get(Key(i)));
+  }
+
+  // Overwriting a few keys only rebuilds the blocks that hold them
+  for (int i = 100; i < 110; i++) {
+    values[i] = rnd.RandomString(100);
+    ASSERT_OK(Put(Key(i), values[i]));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_OK(dbfull()->TEST_CompactRange(0, nullptr, nullptr));
+  ASSERT_EQ("0,1", FilesPerLevel());
+  const uint64_t copied =
+      options.statistics->getTickerCount(COMPACTION_DATA_BLOCKS_COPIED);
+  ASSERT_GT(copied, num_data_blocks);
+  ASSERT_LT(copied, 2 * num_data_blocks);
+
+  db_->ReleaseSnapshot(snapshot);
+  Reopen(options);
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ(values[i], Get(Key(i)));
+  }
+}
+
+TEST_F(DBCompactionTest, PartialTrivialMove) {
+  Options options = CurrentOptions();
+  options.enable_partial_trivial_move = true;
+  options.disable_auto_compactions = true;
+  options.num_levels = 3;
+  options.max_bytes_for_level_base = 4096;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  // An L2 file in the middle of the key range of a larger L1 file
+  const int kNumKeys = 400;
+  Random rnd(301);
+  std::vector<std::string> values(kNumKeys);
+  for (int i = 190; i < 210; i++) {
+    ASSERT_OK(Put(Key(i), rnd.RandomString(100)));
+  }
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(2);
+  for (int i = 0; i < kNumKeys; i++) {
+    values[i] = rnd.RandomString(100);
+    ASSERT_OK(Put(Key(i), values[i]));
+  }
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(1);
+  ASSERT_EQ("0,1,1", FilesPerLevel());
+  std::vector<LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  uint64_t physical_number = 0;
+  for (const auto& file : files) {
+    if (file.level == 1) {
+      physical_number = file.file_number;
+    }
+  }
+  ASSERT_NE(0, physical_number);
+  const std::string physical_file = MakeTableFileName(dbname_, physical_number);
+
+  int partial_moves = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::BackgroundCompaction:PartialTrivialMove",
+      [&](void* /*arg*/) { partial_moves++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+  ASSERT_OK(dbfull()->SetOptions({{"disable_auto_compactions", "false"}}));
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  // The parts before and after the L2 file were moved as slices of the L1
+  // file and only the middle part was compacted
+  ASSERT_EQ(1, partial_moves);
+  ASSERT_EQ("0,0,3", FilesPerLevel());
+  ASSERT_OK(env_->FileExists(physical_file));
+
+  auto verify = [&]() {
+    for (int i = 0; i < kNumKeys; i++) {
+      ASSERT_EQ(values[i], Get(Key(i)));
+    }
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    int i = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), i++) {
+      ASSERT_EQ(Key(i), iter->key().ToString());
+      ASSERT_EQ(values[i], iter->value().ToString());
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(kNumKeys, i);
+    for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+      i--;
+      ASSERT_EQ(Key(i), iter->key().ToString());
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(0, i);
+    iter->Seek(Key(100));
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(Key(100), iter->key().ToString());
+
+    // A slice that ends before the upper bound moves on to the next file
+    const std::string upper_bound = Key(300);
+    Slice upper_bound_slice(upper_bound);
+    ReadOptions bounded_ro;
+    bounded_ro.iterate_upper_bound = &upper_bound_slice;
+    iter.reset(db_->NewIterator(bounded_ro));
+    i = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), i++) {
+      ASSERT_EQ(Key(i), iter->key().ToString());
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(300, i);
+  };
+  verify();
+  Reopen(options);
+  verify();
+
+  // Slices are listed with the same numbers by both metadata APIs, so they
+  // can be passed to CompactFiles() and DeleteFile()
+  ColumnFamilyMetaData cf_meta;
+  db_->GetColumnFamilyMetaData(&cf_meta);
+  std::set<uint64_t> file_numbers;
+  for (const auto& file : cf_meta.levels[2].files) {
+    file_numbers.insert(file.file_number);
+  }
+  ASSERT_EQ(3U, file_numbers.size());
+  files.clear();
+  db_->GetLiveFilesMetaData(&files);
+  ASSERT_EQ(3U, files.size());
+  for (const auto& file : files) {
+    ASSERT_EQ(1U, file_numbers.count(file.file_number));
+  }
+  ASSERT_OK(db_->CompactFiles(CompactionOptions(), {files[0].name}, 2));
+  verify();
+
+  // The physical file is deleted once no slice refers to it
+  CompactRangeOptions cro;
+  cro.bottommost_level_compaction = BottommostLevelCompaction::kForce;
+  ASSERT_OK(db_->CompactRange(cro, nullptr, nullptr));
+  ASSERT_EQ("0,0,1", FilesPerLevel());
+  ASSERT_TRUE(env_->FileExists(physical_file).IsNotFound());
+  verify();
+}
+
+// Stands in for a worker process by running the jobs with
+// DB::OpenAndCompact() in the process of the DB
+class TestCompactionService : public CompactionService {
+ public:
+  TestCompactionService(const std::string& db_path, const Options& options)
+      : db_path_(db_path), options_(options) {}
+
+  const char* Name() const override { return "TestCompactionService"; }
+
+  CompactionServiceJobStatus Start(const std::string& compaction_service_input,
+                                   uint64_t job_id) override {
+    std::lock_guard<std::mutex> l(mutex_);
+    jobs_[job_id] = compaction_service_input;
+    last_input_ = compaction_service_input;
+    return CompactionServiceJobStatus::kSuccess;
+  }
+
+  CompactionServiceJobStatus WaitForComplete(
+      uint64_t job_id, std::string* compaction_service_result) override {
+    std::string compaction_input;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      auto it = jobs_.find(job_id);
+      if (it == jobs_.end()) {
+        return CompactionServiceJobStatus::kFailure;
+      }
+      compaction_input = std::move(it->second);
+      jobs_.erase(it);
+    }
+    if (use_local_) {
+      return CompactionServiceJobStatus::kUseLocal;
+    }
+
+    CompactionServiceOptionsOverride override_options;
+    override_options.env = options_.env;
+    override_options.comparator = options_.comparator;
+    override_options.merge_operator = options_.merge_operator;
+    override_options.table_factory = options_.table_factory;
+    const std::string output_directory =
+        db_path_ + "_compaction_service_" + ToString(job_id);
+    Status s = DB::OpenAndCompact(db_path_, output_directory, compaction_input,
+                                  compaction_service_result, override_options);
+    // Only the info log is left
+    DestroyDir(options_.env, output_directory).PermitUncheckedError();
+    if (!s.ok()) {
+      return CompactionServiceJobStatus::kFailure;
+    }
+    num_jobs_++;
+    return CompactionServiceJobStatus::kSuccess;
+  }
+
+  int GetNumJobs() const { return num_jobs_.load(); }
+
+  void SetUseLocal(bool use_local) { use_local_ = use_local; }
+
+  std::string GetLastInput() {
+    std::lock_guard<std::mutex> l(mutex_);
+    return last_input_;
+  }
+
+ private:
+  const std::string db_path_;
+  const Options options_;
+  std::mutex mutex_;
+  std::map<uint64_t, std::string> jobs_;
+  std::string last_input_;
+  std::atomic<int> num_jobs_{0};
+  std::atomic<bool> use_local_{false};
+};
+
+TEST_F(DBCompactionTest, CompactionService) {
+  class CompactionOutputListener : public EventListener {
+   public:
+    void OnTableFileCreated(const TableFileCreationInfo& info) override {
+      if (info.reason == TableFileCreationReason::kCompaction &&
+          info.status.ok()) {
+        std::lock_guard<std::mutex> l(mutex_);
+        file_paths_.insert(info.file_path);
+      }
+    }
+    bool Created(const std::string& file_path) {
+      std::lock_guard<std::mutex> l(mutex_);
+      return file_paths_.count(file_path) > 0;
+    }
+
+   private:
+    std::mutex mutex_;
+    std::set<std::string> file_paths_;
+  };
+
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.paranoid_file_checks = true;
+  auto compaction_service =
+      std::make_shared<TestCompactionService>(dbname_, options);
+  options.compaction_service = compaction_service;
+  auto listener = std::make_shared<CompactionOutputListener>();
+  options.listeners.push_back(listener);
+  std::shared_ptr<SstFileManager> sst_file_manager(NewSstFileManager(env_));
+  options.sst_file_manager = sst_file_manager;
+  DestroyAndReopen(options);
+
+  for (int i = 0; i < 20; i++) {
+    for (int j = 0; j < 10; j++) {
+      int key_id = i * 10 + j;
+      ASSERT_OK(Put(Key(key_id), "value" + ToString(key_id)));
+    }
+    ASSERT_OK(Flush());
+  }
+  for (int i = 0; i < 10; i++) {
+    for (int j = 0; j < 10; j++) {
+      int key_id = i * 20 + j * 2;
+      ASSERT_OK(Put(Key(key_id), "value_new" + ToString(key_id)));
+    }
+    ASSERT_OK(Flush());
+  }
+  ASSERT_OK(Delete(Key(1)));
+  ASSERT_OK(Flush());
+
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_GT(compaction_service->GetNumJobs(), 0);
+  ASSERT_EQ("0,1", FilesPerLevel());
+
+  // The installed output is reported like a local one
+  std::vector<LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  ASSERT_EQ(1U, files.size());
+  ASSERT_TRUE(listener->Created(dbname_ + files[0].name));
+  std::unordered_map<std::string, uint64_t> files_in_db;
+  ASSERT_OK(GetAllSSTFiles(&files_in_db));
+  auto sfm = static_cast<SstFileManagerImpl*>(sst_file_manager.get());
+  ASSERT_EQ(files_in_db, sfm->GetTrackedFiles());
+
+  auto verify = [&]() {
+    ASSERT_EQ("NOT_FOUND", Get(Key(1)));
+    for (int i = 2; i < 200; i++) {
+      if (i % 2 == 0) {
+        ASSERT_EQ("value_new" + ToString(i), Get(Key(i)));
+      } else {
+        ASSERT_EQ("value" + ToString(i), Get(Key(i)));
+      }
+    }
+  };
+  verify();
+  Reopen(options);
+  verify();
+
+  // The jobs that the service hands back run in the DB
+  const int num_jobs = compaction_service->GetNumJobs();
+  compaction_service->SetUseLocal(true);
+  for (int i = 0; i < 200; i += 3) {
+    ASSERT_OK(Put(Key(i), "value_local" + ToString(i)));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_OK(dbfull()->SetDBOptions({{"max_background_jobs", "5"}}));
+  const SequenceNumber preserve_deletes_seqnum = db_->GetLatestSequenceNumber();
+  ASSERT_TRUE(db_->SetPreserveDeletesSequenceNumber(preserve_deletes_seqnum));
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(num_jobs, compaction_service->GetNumJobs());
+
+  // The job is described with the current state of the DB
+  CompactionServiceInput input;
+  ASSERT_OK(input.DecodeFrom(compaction_service->GetLastInput()));
+  DBOptions db_options;
+  ASSERT_OK(GetDBOptionsFromString(DBOptions(), input.db_options, &db_options));
+  ASSERT_EQ(5, db_options.max_background_jobs);
+  ASSERT_EQ(preserve_deletes_seqnum, input.preserve_deletes_seqnum);
+  ASSERT_EQ("0,1", FilesPerLevel());
+  for (int i = 0; i < 200; i += 3) {
+    ASSERT_EQ("value_local" + ToString(i), Get(Key(i)));
+  }
+}
+
+TEST_F(DBCompactionTest, CompactionServiceNonDefaultColumnFamily) {
+  // The worker gets the comparator of the column family it compacts, which
+  // the default column family doesn't use
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  Options cf_options = options;
+  cf_options.comparator = ReverseBytewiseComparator();
+  auto compaction_service =
+      std::make_shared<TestCompactionService>(dbname_, cf_options);
+  options.compaction_service = compaction_service;
+  cf_options.compaction_service = compaction_service;
+  DestroyAndReopen(options);
+  CreateColumnFamilies({"reverse"}, cf_options);
+  ReopenWithColumnFamilies({kDefaultColumnFamilyName, "reverse"},
+                           std::vector<Options>{options, cf_options});
+
+  ASSERT_OK(Put(0, Key(0), "default"));
+  ASSERT_OK(Flush(0));
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 10; j++) {
+      ASSERT_OK(Put(1, Key(j), "value" + ToString(i)));
+    }
+    ASSERT_OK(Flush(1));
+  }
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), handles_[1], nullptr,
+                              nullptr));
+  ASSERT_GT(compaction_service->GetNumJobs(), 0);
+  ASSERT_EQ(0, NumTableFilesAtLevel(0, 1));
+  for (int j = 0; j < 10; j++) {
+    ASSERT_EQ("value3", Get(1, Key(j)));
+  }
+  ASSERT_EQ("default", Get(0, Key(0)));
+}
+
+TEST_F(DBCompactionTest, SkipRangeDeletedCompactionInput) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.skip_range_deleted_compaction_input = true;
+  options.statistics = CreateDBStatistics();
+  DestroyAndReopen(options);
+
+  auto write_files = [&]() {
+    // Four non-overlapping L1 files of 25 keys each
+    for (int i = 0; i < 4; i++) {
+      for (int j = 0; j < 25; j++) {
+        int key_id = i * 25 + j;
+        ASSERT_OK(Put(Key(key_id), "value" + ToString(key_id)));
+      }
+      ASSERT_OK(Flush());
+      MoveFilesToLevel(1);
+    }
+    ASSERT_EQ("0,4", FilesPerLevel());
+  };
+  auto verify = [&]() {
+    for (int i = 0; i < 100; i++) {
+      if (i < 60) {
+        ASSERT_EQ("NOT_FOUND", Get(Key(i)));
+      } else {
+        ASSERT_EQ("value" + ToString(i), Get(Key(i)));
+      }
+    }
+  };
+
+  write_files();
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             Key(0), Key(60)));
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  // The first two L1 files are not read, the covered part of the third one
+  // is sought past
+  ASSERT_EQ(2, options.statistics->getTickerCount(
+                   COMPACTION_RANGE_DEL_DROPPED_FILES));
+  ASSERT_EQ(1, options.statistics->getTickerCount(COMPACTION_RANGE_DEL_SKIPS));
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+  verify();
+  Reopen(options);
+  verify();
+
+  // Nothing is skipped when a snapshot separates the keys from the tombstone
+  DestroyAndReopen(options);
+  ASSERT_OK(options.statistics->Reset());
+  write_files();
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             Key(0), Key(60)));
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(0, options.statistics->getTickerCount(
+                   COMPACTION_RANGE_DEL_DROPPED_FILES));
+  ASSERT_EQ(0, options.statistics->getTickerCount(COMPACTION_RANGE_DEL_SKIPS));
+  verify();
+  ReadOptions read_options;
+  read_options.snapshot = snapshot;
+  for (int i = 0; i < 100; i++) {
+    std::string value;
+    ASSERT_OK(db_->Get(read_options, Key(i), &value));
+    ASSERT_EQ("value" + ToString(i), value);
+  }
+  db_->ReleaseSnapshot(snapshot);
+}
+
+TEST_F(DBCompactionTest, CompactionWithBlobGarbageCollection) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.min_blob_size = 10;
+  DestroyAndReopen(options);
+
+  constexpr int kNumKeys = 20;
+  auto long_value = [](int i, int version) {
+    return "long_value" + ToString(i) + "_" + ToString(version);
+  };
+  auto get_blob_files = [&]() {
+    return dbfull()
+        ->TEST_GetVersionSet()
+        ->GetColumnFamilySet()
+        ->GetDefault()
+        ->current()
+        ->storage_info()
+        ->GetBlobFiles();
+  };
+  // Returns the reader of a blob file in the table cache, if any
+  auto get_blob_file_reader = [&](uint64_t blob_file_number) -> void* {
+    Cache* const table_cache = dbfull()->TEST_table_cache();
+    Cache::Handle* const handle = table_cache->Lookup(
+        Slice(reinterpret_cast<const char*>(&blob_file_number),
+              sizeof(blob_file_number)));
+    if (handle == nullptr) {
+      return nullptr;
+    }
+    void* const reader = table_cache->Value(handle);
+    table_cache->Release(handle);
+    return reader;
+  };
+  CompactRangeOptions compact_options;
+  compact_options.bottommost_level_compaction =
+      BottommostLevelCompaction::kForce;
+
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(Put(Key(i), long_value(i, 0)));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_TRUE(get_blob_files().empty());
+
+  // The compaction moves the values to a blob file
+  options.enable_blob_files = true;
+  Reopen(options);
+  ASSERT_OK(db_->CompactRange(compact_options, nullptr, nullptr));
+  auto blob_files = get_blob_files();
+  ASSERT_EQ(1, blob_files.size());
+  const uint64_t first_blob_file_number = blob_files.begin()->first;
+  ASSERT_EQ(kNumKeys, blob_files.begin()->second->GetTotalBlobCount());
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ(long_value(i, 0), Get(Key(i)));
+  }
+
+  // Lookups share the reader of the blob file
+  void* const first_blob_file_reader =
+      get_blob_file_reader(first_blob_file_number);
+  ASSERT_NE(nullptr, first_blob_file_reader);
+  ASSERT_EQ(long_value(1, 0), Get(Key(1)));
+  ASSERT_EQ(first_blob_file_reader,
+            get_blob_file_reader(first_blob_file_number));
+
+  // Overwriting half of the values makes their blobs garbage
+  for (int i = 0; i < kNumKeys; i += 2) {
+    ASSERT_OK(Put(Key(i), long_value(i, 1)));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(compact_options, nullptr, nullptr));
+  blob_files = get_blob_files();
+  ASSERT_EQ(2, blob_files.size());
+  ASSERT_EQ(kNumKeys / 2,
+            blob_files[first_blob_file_number]->GetGarbageBlobCount());
+
+  // Garbage collecting every blob file relocates the valid blobs to a new
+  // one, and the old blob files are dropped. A compaction filter that keeps
+  // the keys does not prevent that.
+  class KeepFilter : public CompactionFilter {
+   public:
+    bool Filter(int /*level*/, const Slice& /*key*/, const Slice& /*value*/,
+                std::string* /*new_value*/,
+                bool* /*value_changed*/) const override {
+      return false;
+    }
+    const char* Name() const override { return "KeepFilter"; }
+  };
+  KeepFilter filter;
+  options.compaction_filter = &filter;
+  options.enable_blob_garbage_collection = true;
+  options.blob_garbage_collection_age_cutoff = 1.0;
+  Reopen(options);
+  ASSERT_EQ(long_value(1, 0), Get(Key(1)));
+  ASSERT_NE(nullptr, get_blob_file_reader(first_blob_file_number));
+  ASSERT_OK(db_->CompactRange(compact_options, nullptr, nullptr));
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  // The reader is dropped with its blob file
+  ASSERT_EQ(nullptr, get_blob_file_reader(first_blob_file_number));
+  blob_files = get_blob_files();
+  ASSERT_EQ(1, blob_files.size());
+  ASSERT_GT(blob_files.begin()->first, first_blob_file_number + 1);
+  ASSERT_EQ(kNumKeys, blob_files.begin()->second->GetTotalBlobCount());
+  ASSERT_EQ(0, blob_files.begin()->second->GetGarbageBlobCount());
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ(long_value(i, i % 2 == 0 ? 1 : 0), Get(Key(i)));
+  }
+  Reopen(options);
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ(long_value(i, i % 2 == 0 ? 1 : 0), Get(Key(i)));
+  }
+}
+
 TEST_F(DBCompactionTest, ZeroSeqIdCompaction) {
   Options options = CurrentOptions();
   options.compaction_style = kCompactionStyleLevel;
@@ -3404,6 +4108,83 @@ TEST_P(DBCompactionTestWithParam, IntraL0CompactionDoesNotObsoleteDeletions) {
   ASSERT_TRUE(db_->Get(roptions, Key(0), &result).IsNotFound());
 }
 
+TEST_F(DBCompactionTest, IntraL0CompactionSubcompactions) {
+  Options options = CurrentOptions();
+  options.compression = kNoCompression;
+  options.level0_file_num_compaction_trigger = 5;
+  options.max_background_compactions = 2;
+  options.max_subcompactions = 3;
+  options.enable_l0_subcompactions = true;
+  options.force_consistency_checks = true;
+  DestroyAndReopen(options);
+
+  // The L0->L1 must be picked before we begin flushing files to trigger
+  // intra-L0 compaction. No compaction may run until the intra-L0 compaction
+  // has been picked.
+  std::atomic<bool> intra_l0_picked(false);
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->LoadDependency(
+      {{"LevelCompactionPicker::PickCompaction:Return",
+        "DBCompactionTest::IntraL0CompactionSubcompactions:L0ToL1Ready"},
+       {"DBCompactionTest::IntraL0CompactionSubcompactions:IntraL0Picked",
+        "CompactionJob::Run():Start"}});
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+      "LevelCompactionPicker::PickCompaction:Return", [&](void* arg) {
+        Compaction* c = static_cast<Compaction*>(arg);
+        if (c->output_level() == 0) {
+          intra_l0_picked.store(true);
+        }
+      });
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->EnableProcessing();
+
+  // Files 0-4 are included in an L0->L1 compaction. Files 5-8 are picked by
+  // FindIntraL0Compaction and split into subcompactions by key range.
+  const int kNumKeys = 1000;
+  Random rnd(301);
+  std::vector<std::string> values(kNumKeys);
+  for (int i = 0; i < 9; ++i) {
+    if (i == 5) {
+      TEST_SYNC_POINT(
+          "DBCompactionTest::IntraL0CompactionSubcompactions:L0ToL1Ready");
+    }
+    for (int k = 0; k < kNumKeys; ++k) {
+      values[k] = rnd.RandomString(100);
+      ASSERT_OK(Put(Key(k), values[k]));
+    }
+    ASSERT_OK(Flush());
+  }
+  while (!intra_l0_picked.load()) {
+    env_->SleepForMicroseconds(1000);
+  }
+  TEST_SYNC_POINT(
+      "DBCompactionTest::IntraL0CompactionSubcompactions:IntraL0Picked");
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->DisableProcessing();
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  // The output files of the intra-L0 compaction form a single sorted run
+  std::vector<std::vector<FileMetaData>> level_to_files;
+  dbfull()->TEST_GetFilesMetaData(dbfull()->DefaultColumnFamily(),
+                                  &level_to_files);
+  ASSERT_GT(level_to_files[0].size(), 1);
+  ASSERT_GT(level_to_files[1].size(), 0);
+  for (const auto& f : level_to_files[0]) {
+    ASSERT_EQ(level_to_files[0][0].fd.smallest_seqno, f.fd.smallest_seqno);
+    ASSERT_EQ(level_to_files[0][0].fd.largest_seqno, f.fd.largest_seqno);
+  }
+
+  auto verify = [&]() {
+    for (int k = 0; k < kNumKeys; ++k) {
+      ASSERT_EQ(values[k], Get(Key(k)));
+    }
+  };
+  verify();
+  Reopen(options);
+  verify();
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+  verify();
+}
+
 TEST_P(DBCompactionTestWithParam, FullCompactionInBottomPriThreadPool) {
   const int kNumFilesTrigger = 3;
   Env::Default()->SetBackgroundThreads(1, Env::Priority::BOTTOM);
@@ -4972,7 +5753,8 @@ INSTANTIATE_TEST_CASE_P(
     ::testing::Values(CompactionPri::kByCompensatedSize,
                       CompactionPri::kOldestLargestSeqFirst,
                       CompactionPri::kOldestSmallestSeqFirst,
-                      CompactionPri::kMinOverlappingRatio));
+                      CompactionPri::kMinOverlappingRatio,
+                      CompactionPri::kReadHeatWeightedOverlappingRatio));
 
 class NoopMergeOperator : public MergeOperator {
  public:
@@ -81,6 +81,11 @@ Status DBImpl::GetLiveFiles(std::vector<std::string>& ret,
     }
     cfd->current()->AddLiveFiles(&live_table_files, &live_blob_files);
   }
+  // Table slices of the same physical file are listed once
+  std::sort(live_table_files.begin(), live_table_files.end());
+  live_table_files.erase(
+      std::unique(live_table_files.begin(), live_table_files.end()),
+      live_table_files.end());
 
   ret.clear();
   ret.reserve(live_table_files.size() + live_blob_files.size() +
@@ -22,10 +22,12 @@
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "db/arena_wrapped_db_iter.h"
+#include "db/block_cache_manifest.h"
 #include "db/builder.h"
 #include "db/compaction/compaction_job.h"
 #include "db/db_info_dumper.h"
@@ -190,6 +192,10 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
       bg_flush_scheduled_(0),
       num_running_flushes_(0),
       bg_purge_scheduled_(0),
+      bg_block_cache_warmup_scheduled_(0),
+      next_block_cache_warmup_job_(0),
+      block_cache_warmup_loaded_(0),
+      block_cache_warmup_aborted_(false),
       disable_delete_obsolete_files_(0),
       pending_purge_obsolete_files_(0),
       delete_obsolete_files_last_run_(env_->NowMicros()),
@@ -250,6 +256,11 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
   co.metadata_charge_policy = kDontChargeCacheMetadata;
   table_cache_ = NewLRUCache(co);
 
+  if (immutable_db_options_.wal_sync_coalescing_max_wait_us > 0) {
+    wal_sync_coalescer_.reset(new WalSyncCoalescer(
+        immutable_db_options_.wal_sync_coalescing_max_wait_us));
+  }
+
   versions_.reset(new VersionSet(dbname_, &immutable_db_options_, file_options_,
                                  table_cache_.get(), write_buffer_manager_,
                                  &write_controller_, &block_cache_tracer_,
@@ -486,6 +497,9 @@ void DBImpl::CancelAllBackgroundWork(bool wait) {
 }
 
 Status DBImpl::CloseHelper() {
+  // Write out the staged WAL records before anything is torn down
+  wal_staging_.reset();
+
   // Guarantee that there is no background error recovery in progress before
   // continuing with the shutdown
   mutex_.Lock();
@@ -513,13 +527,29 @@ Status DBImpl::CloseHelper() {
   // Wait for background work to finish
   while (bg_bottom_compaction_scheduled_ || bg_compaction_scheduled_ ||
          bg_flush_scheduled_ || bg_purge_scheduled_ ||
-         pending_purge_obsolete_files_ ||
+         bg_block_cache_warmup_scheduled_ || pending_purge_obsolete_files_ ||
          error_handler_.IsRecoveryInProgress()) {
     TEST_SYNC_POINT("DBImpl::~DBImpl:WaitJob");
     bg_cv_.Wait();
   }
   TEST_SYNC_POINT_CALLBACK("DBImpl::CloseHelper:PendingPurgeFinished",
                            &files_grabbed_for_purge_);
+  if (immutable_db_options_.block_cache_manifest_period_sec > 0 &&
+      opened_successfully_ && !block_cache_warmup_aborted_) {
+    mutex_.Unlock();
+    Status s = WriteBlockCacheManifest();
+    if (!s.ok()) {
+      ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                     "Failed to write block cache manifest on close: %s",
+                     s.ToString().c_str());
+    }
+    mutex_.Lock();
+  }
+  if (save_partition_heat_ && opened_successfully_) {
+    mutex_.Unlock();
+    SavePartitionHeat();
+    mutex_.Lock();
+  }
   EraseThreadStatusDbInfo();
   flush_scheduler_.Clear();
   trim_history_scheduler_.Clear();
@@ -697,7 +727,8 @@ void DBImpl::StartPeriodicWorkScheduler() {
 
   periodic_work_scheduler_->Register(
       this, mutable_db_options_.stats_dump_period_sec,
-      mutable_db_options_.stats_persist_period_sec);
+      mutable_db_options_.stats_persist_period_sec,
+      immutable_db_options_.block_cache_manifest_period_sec);
 #endif  // !ROCKSDB_LITE
 }
 
@@ -921,6 +952,359 @@ void DBImpl::FlushInfoLog() {
   LogFlush(immutable_db_options_.info_log);
 }
 
+void DBImpl::DumpBlockCacheManifest() {
+  if (shutdown_initiated_) {
+    return;
+  }
+  TEST_SYNC_POINT("DBImpl::DumpBlockCacheManifest:StartRunning");
+  Status s = WriteBlockCacheManifest();
+  if (!s.ok() && !s.IsIncomplete()) {
+    ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                   "Failed to write block cache manifest: %s",
+                   s.ToString().c_str());
+  }
+}
+
+Status DBImpl::WriteBlockCacheManifest() {
+  autovector<Version*> versions;
+  {
+    InstrumentedMutexLock l(&mutex_);
+    if (bg_block_cache_warmup_scheduled_ > 0) {
+      return Status::Incomplete("Block cache warm-up in progress");
+    }
+    for (auto cfd : *versions_->GetColumnFamilySet()) {
+      if (cfd->IsDropped() || !cfd->initialized()) {
+        continue;
+      }
+      cfd->Ref();
+      Version* v = cfd->current();
+      v->Ref();
+      versions.push_back(v);
+    }
+  }
+
+  // Map the cache key prefix of every open table to its file number, for
+  // each block cache in use.
+  struct CacheKeyPrefixes {
+    std::unordered_map<std::string, uint64_t> file_numbers;
+    std::set<size_t> sizes;
+  };
+  std::unordered_map<Cache*, CacheKeyPrefixes> caches;
+  for (Version* v : versions) {
+    ColumnFamilyData* cfd = v->cfd();
+    TableCache* table_cache = cfd->table_cache();
+    const VersionStorageInfo* vstorage = v->storage_info();
+    for (int level = 0; level < vstorage->num_levels(); ++level) {
+      for (FileMetaData* f : vstorage->LevelFiles(level)) {
+        TableReader* table_reader = f->fd.table_reader;
+        Cache::Handle* handle = nullptr;
+        if (table_reader == nullptr) {
+          // A table that is not open has no blocks in the block cache
+          Status s = table_cache->FindTable(
+              ReadOptions(), file_options_, cfd->internal_comparator(), f->fd,
+              &handle, /*prefix_extractor=*/nullptr, /*no_io=*/true);
+          if (!s.ok()) {
+            continue;
+          }
+          table_reader = table_cache->GetTableReaderFromHandle(handle);
+        }
+        Slice prefix;
+        Cache* block_cache = table_reader->GetBlockCache(&prefix);
+        if (block_cache != nullptr && !prefix.empty()) {
+          CacheKeyPrefixes& prefixes = caches[block_cache];
+          prefixes.file_numbers.emplace(prefix.ToString(), f->fd.GetNumber());
+          prefixes.sizes.insert(prefix.size());
+        }
+        if (handle != nullptr) {
+          table_cache->ReleaseHandle(handle);
+        }
+      }
+    }
+  }
+  {
+    InstrumentedMutexLock l(&mutex_);
+    for (Version* v : versions) {
+      ColumnFamilyData* cfd = v->cfd();
+      v->Unref();
+      cfd->UnrefAndTryDelete();
+    }
+  }
+
+  BlockCacheManifest manifest;
+  for (const auto& cache : caches) {
+    const CacheKeyPrefixes& prefixes = cache.second;
+    cache.first->ApplyToAllCacheKeys(
+        [&](const Slice& key, bool hit) {
+          // A block cache key is the table's prefix followed by the varint
+          // encoded block offset.
+          for (size_t prefix_size : prefixes.sizes) {
+            if (prefix_size >= key.size()) {
+              break;
+            }
+            auto it = prefixes.file_numbers.find(
+                std::string(key.data(), prefix_size));
+            if (it == prefixes.file_numbers.end()) {
+              continue;
+            }
+            Slice suffix(key.data() + prefix_size, key.size() - prefix_size);
+            uint64_t offset = 0;
+            if (GetVarint64(&suffix, &offset) && suffix.empty()) {
+              manifest.Add(it->second, offset, hit);
+              return;
+            }
+          }
+        },
+        /*thread_safe=*/true);
+  }
+  manifest.Finalize();
+
+  std::string contents;
+  manifest.EncodeTo(&contents);
+  const std::string fname = BlockCacheManifestFileName(dbname_);
+  const std::string tmp_fname = fname + "." + kTempFileNameSuffix;
+  IOStatus io_s =
+      WriteStringToFile(fs_.get(), contents, tmp_fname, /*should_sync=*/true);
+  if (io_s.ok()) {
+    io_s = fs_->RenameFile(tmp_fname, fname, IOOptions(), nullptr);
+  }
+  if (io_s.ok()) {
+    ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                   "Recorded %" ROCKSDB_PRIszt
+                   " cached blocks of %" ROCKSDB_PRIszt
+                   " table files in %s",
+                   manifest.num_blocks(), manifest.files().size(),
+                   fname.c_str());
+  }
+  return io_s;
+}
+
+void DBImpl::SavePartitionHeat() {
+  // The referenced versions keep their table files from being purged while
+  // the heat files are written, so no heat file outlives its table.
+  autovector<Version*> versions;
+  {
+    InstrumentedMutexLock l(&mutex_);
+    for (auto cfd : *versions_->GetColumnFamilySet()) {
+      if (cfd->IsDropped() || !cfd->initialized()) {
+        continue;
+      }
+      cfd->Ref();
+      Version* v = cfd->current();
+      v->Ref();
+      versions.push_back(v);
+    }
+  }
+
+  std::unordered_set<uint64_t> saved;
+  for (Version* v : versions) {
+    ColumnFamilyData* cfd = v->cfd();
+    TableCache* table_cache = cfd->table_cache();
+    const VersionStorageInfo* vstorage = v->storage_info();
+    for (int level = 0; level < vstorage->num_levels(); ++level) {
+      for (FileMetaData* f : vstorage->LevelFiles(level)) {
+        // Slices of a table file share its reader
+        if (!saved.insert(f->fd.GetPhysicalNumber()).second) {
+          continue;
+        }
+        TableReader* table_reader = f->fd.table_reader;
+        Cache::Handle* handle = nullptr;
+        if (table_reader == nullptr) {
+          // A table that is not open has not been read since it was opened
+          Status s = table_cache->FindTable(
+              ReadOptions(), file_options_, cfd->internal_comparator(), f->fd,
+              &handle, /*prefix_extractor=*/nullptr, /*no_io=*/true);
+          if (!s.ok()) {
+            continue;
+          }
+          table_reader = table_cache->GetTableReaderFromHandle(handle);
+        }
+        std::string contents;
+        if (table_reader->EncodePartitionHeat(&contents)) {
+          const std::string fname = TableHeatFileName(
+              TableFileName(cfd->ioptions()->cf_paths,
+                            f->fd.GetPhysicalNumber(), f->fd.GetPathId()));
+          // The heat is only a hint, so a torn file that fails its checksum
+          // after a crash is fine
+          IOStatus io_s = WriteStringToFile(fs_.get(), contents, fname,
+                                            /*should_sync=*/false);
+          if (!io_s.ok()) {
+            ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                           "Failed to save partition heat to %s: %s",
+                           fname.c_str(), io_s.ToString().c_str());
+          }
+        }
+        if (handle != nullptr) {
+          table_cache->ReleaseHandle(handle);
+        }
+      }
+    }
+  }
+
+  InstrumentedMutexLock l(&mutex_);
+  for (Version* v : versions) {
+    ColumnFamilyData* cfd = v->cfd();
+    v->Unref();
+    cfd->UnrefAndTryDelete();
+  }
+}
+
+void DBImpl::ScheduleBlockCacheWarmUp() {
+  if (immutable_db_options_.block_cache_manifest_period_sec == 0) {
+    return;
+  }
+  const std::string fname = BlockCacheManifestFileName(dbname_);
+  std::string contents;
+  IOStatus io_s = fs_->FileExists(fname, IOOptions(), nullptr);
+  if (io_s.ok()) {
+    io_s = ReadFileToString(fs_.get(), fname, &contents);
+  }
+  if (!io_s.ok()) {
+    if (!io_s.IsNotFound()) {
+      ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                     "Failed to read block cache manifest %s: %s",
+                     fname.c_str(), io_s.ToString().c_str());
+    }
+    return;
+  }
+  BlockCacheManifest manifest;
+  Status s = manifest.DecodeFrom(contents);
+  if (!s.ok()) {
+    ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                   "Ignoring block cache manifest %s: %s", fname.c_str(),
+                   s.ToString().c_str());
+    return;
+  }
+
+  InstrumentedMutexLock l(&mutex_);
+  assert(bg_block_cache_warmup_scheduled_ == 0);
+  // Blocks that were hit are loaded before the others, so that they are in
+  // the cache even if the warm-up is cut short.
+  std::vector<BlockCacheWarmUpJob> hot_jobs;
+  std::vector<BlockCacheWarmUpJob> cold_jobs;
+  for (auto cfd : *versions_->GetColumnFamilySet()) {
+    if (cfd->IsDropped() || !cfd->initialized()) {
+      continue;
+    }
+    Version* v = cfd->current();
+    const VersionStorageInfo* vstorage = v->storage_info();
+    bool used = false;
+    for (int level = 0; level < vstorage->num_levels(); ++level) {
+      for (FileMetaData* f : vstorage->LevelFiles(level)) {
+        auto it = manifest.files().find(f->fd.GetNumber());
+        if (it == manifest.files().end()) {
+          continue;
+        }
+        BlockCacheWarmUpJob hot{
+            cfd, f->fd, cfd->GetLatestMutableCFOptions()->prefix_extractor, {}};
+        BlockCacheWarmUpJob cold = hot;
+        for (const BlockCacheManifest::CachedBlock& block : it->second) {
+          (block.hot ? hot : cold).block_offsets.push_back(block.offset);
+        }
+        if (!hot.block_offsets.empty()) {
+          hot_jobs.push_back(std::move(hot));
+        }
+        if (!cold.block_offsets.empty()) {
+          cold_jobs.push_back(std::move(cold));
+        }
+        used = true;
+      }
+    }
+    if (used) {
+      cfd->Ref();
+      v->Ref();
+      block_cache_warmup_versions_.push_back(v);
+    }
+  }
+  if (block_cache_warmup_versions_.empty()) {
+    return;
+  }
+  block_cache_warmup_jobs_ = std::move(hot_jobs);
+  for (auto& job : cold_jobs) {
+    block_cache_warmup_jobs_.push_back(std::move(job));
+  }
+  next_block_cache_warmup_job_.store(0, std::memory_order_relaxed);
+  block_cache_warmup_loaded_ = 0;
+
+  const size_t num_threads =
+      std::min(block_cache_warmup_jobs_.size(),
+               static_cast<size_t>(GetBGJobLimits().max_compactions));
+  ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                 "Warming up block cache from %s with %" ROCKSDB_PRIszt
+                 " jobs on %" ROCKSDB_PRIszt " threads",
+                 fname.c_str(), block_cache_warmup_jobs_.size(), num_threads);
+  for (size_t i = 0; i < num_threads; ++i) {
+    bg_block_cache_warmup_scheduled_++;
+    env_->Schedule(&DBImpl::BGWorkBlockCacheWarmUp, this, Env::Priority::LOW,
+                   nullptr);
+  }
+}
+
+void DBImpl::BGWorkBlockCacheWarmUp(void* db) {
+  IOSTATS_SET_THREAD_POOL_ID(Env::Priority::LOW);
+  TEST_SYNC_POINT("DBImpl::BGWorkBlockCacheWarmUp");
+  reinterpret_cast<DBImpl*>(db)->BackgroundCallBlockCacheWarmUp();
+}
+
+void DBImpl::BackgroundCallBlockCacheWarmUp() {
+  ReadOptions read_options;
+  RateLimiter* rate_limiter = immutable_db_options_.rate_limiter.get();
+  size_t num_loaded = 0;
+  bool aborted = false;
+  // The jobs are not modified until the last warm-up thread is done
+  for (size_t i = next_block_cache_warmup_job_.fetch_add(1);
+       i < block_cache_warmup_jobs_.size();
+       i = next_block_cache_warmup_job_.fetch_add(1)) {
+    if (shutting_down_.load(std::memory_order_acquire)) {
+      aborted = true;
+      break;
+    }
+    const BlockCacheWarmUpJob& job = block_cache_warmup_jobs_[i];
+    TableCache* table_cache = job.cfd->table_cache();
+    Cache::Handle* handle = nullptr;
+    Status s = table_cache->FindTable(
+        read_options, file_options_, job.cfd->internal_comparator(), job.fd,
+        &handle, job.prefix_extractor.get());
+    if (s.ok()) {
+      size_t loaded = 0;
+      s = table_cache->GetTableReaderFromHandle(handle)->WarmUpBlockCache(
+          read_options, job.block_offsets, rate_limiter, &loaded);
+      table_cache->ReleaseHandle(handle);
+      num_loaded += loaded;
+    }
+    if (!s.ok() && !s.IsNotSupported()) {
+      ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                     "Failed to warm up block cache from table file #%" PRIu64
+                     ": %s",
+                     job.fd.GetNumber(), s.ToString().c_str());
+    }
+  }
+
+  mutex_.Lock();
+  block_cache_warmup_loaded_ += num_loaded;
+  if (aborted) {
+    block_cache_warmup_aborted_ = true;
+  }
+  if (--bg_block_cache_warmup_scheduled_ == 0) {
+    ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                   "Block cache warm-up %s, loaded %" ROCKSDB_PRIszt " blocks",
+                   block_cache_warmup_aborted_ ? "aborted" : "finished",
+                   block_cache_warmup_loaded_);
+    block_cache_warmup_jobs_.clear();
+    for (Version* v : block_cache_warmup_versions_) {
+      ColumnFamilyData* cfd = v->cfd();
+      v->Unref();
+      cfd->UnrefAndTryDelete();
+    }
+    block_cache_warmup_versions_.clear();
+  }
+  bg_cv_.SignalAll();
+  // IMPORTANT: there should be no code after calling SignalAll. This call may
+  // signal the DB destructor that it's OK to proceed with destruction. In
+  // that case, all DB variables will be dealloacated and referencing them
+  // will cause trouble.
+  mutex_.Unlock();
+}
+
 Status DBImpl::TablesRangeTombstoneSummary(ColumnFamilyHandle* column_family,
                                            int max_entries_to_print,
                                            std::string* out_str) {
@@ -1101,7 +1485,8 @@ Status DBImpl::SetDBOptions(
         periodic_work_scheduler_->Unregister(this);
         periodic_work_scheduler_->Register(
             this, new_options.stats_dump_period_sec,
-            new_options.stats_persist_period_sec);
+            new_options.stats_persist_period_sec,
+            immutable_db_options_.block_cache_manifest_period_sec);
         mutex_.Lock();
       }
       write_controller_.set_max_delayed_write_rate(
@@ -3617,6 +4002,12 @@ void DBImpl::GetLiveFilesMetaData(std::vector<LiveFileMetaData>* metadata) {
   versions_->GetLiveFilesMetaData(metadata);
 }
 
+void DBImpl::GetLiveTableFilesMetaData(
+    std::vector<LiveFileMetaData>* metadata) {
+  InstrumentedMutexLock l(&mutex_);
+  versions_->GetLiveTableFilesMetaData(metadata);
+}
+
 Status DBImpl::GetLiveFilesChecksumInfo(FileChecksumList* checksum_list) {
   InstrumentedMutexLock l(&mutex_);
   return versions_->GetLiveFilesChecksumInfo(checksum_list);
@@ -3649,7 +4040,7 @@ void DBImpl::GetColumnFamilyMetaData(ColumnFamilyHandle* column_family,
 Status DBImpl::CheckConsistency() {
   mutex_.AssertHeld();
   std::vector<LiveFileMetaData> metadata;
-  versions_->GetLiveFilesMetaData(&metadata);
+  versions_->GetLiveTableFilesMetaData(&metadata);
   TEST_SYNC_POINT("DBImpl::CheckConsistency:AfterGetLiveFilesMetaData");
 
   std::string corruption_messages;
@@ -3885,14 +4276,18 @@ Status DestroyDB(const std::string& dbname, const Options& options,
     for (const auto& path : paths) {
       if (env->GetChildren(path, &filenames).ok()) {
         for (const auto& fname : filenames) {
-          if (ParseFileName(fname, &number, &type) &&
-              type == kTableFile) {  // Lock file will be deleted at end
+          if (!ParseFileName(fname, &number, &type)) {
+            continue;
+          }
+          if (type == kTableFile) {  // Lock file will be deleted at end
             std::string table_path = path + "/" + fname;
             Status del = DeleteDBFile(&soptions, table_path, dbname,
                                       /*force_bg=*/false, /*force_fg=*/false);
             if (!del.ok() && result.ok()) {
               result = del;
             }
+          } else if (type == kTableHeatFile) {
+            env->DeleteFile(path + "/" + fname).PermitUncheckedError();
           }
         }
         // TODO: Should we return an error if we cannot delete the directory?
@@ -4778,8 +5173,9 @@ Status DBImpl::VerifyChecksumInternal(const ReadOptions& read_options,
            j++) {
         const auto& fd_with_krange = vstorage->LevelFilesBrief(i).files[j];
         const auto& fd = fd_with_krange.fd;
-        std::string fname = TableFileName(cfd->ioptions()->cf_paths,
-                                          fd.GetNumber(), fd.GetPathId());
+        std::string fname =
+            TableFileName(cfd->ioptions()->cf_paths, fd.GetPhysicalNumber(),
+                          fd.GetPathId());
         if (use_file_checksum) {
           const FileMetaData* fmeta = fd_with_krange.file_metadata;
           assert(fmeta);
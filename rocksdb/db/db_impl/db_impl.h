@@ -40,6 +40,8 @@
 #include "db/trim_history_scheduler.h"
 #include "db/version_edit.h"
 #include "db/wal_manager.h"
+#include "db/wal_staging.h"
+#include "db/wal_sync_coalescer.h"
 #include "db/write_controller.h"
 #include "db/write_thread.h"
 #include "logging/event_logger.h"
@@ -404,6 +406,10 @@ class DBImpl : public DB {
   virtual void GetLiveFilesMetaData(
       std::vector<LiveFileMetaData>* metadata) override;
 
+  // Like GetLiveFilesMetaData(), but lists the table files on disk. See
+  // VersionSet::GetLiveTableFilesMetaData().
+  void GetLiveTableFilesMetaData(std::vector<LiveFileMetaData>* metadata);
+
   virtual Status GetLiveFilesChecksumInfo(
       FileChecksumList* checksum_list) override;
 
@@ -1018,6 +1024,8 @@ class DBImpl : public DB {
   int TEST_BGFlushesAllowed() const;
   size_t TEST_GetWalPreallocateBlockSize(uint64_t write_buffer_size) const;
   void TEST_WaitForStatsDumpRun(std::function<void()> callback) const;
+  // Wait for the block cache warm-up started by DB::Open() to finish.
+  void TEST_WaitForBlockCacheWarmUp();
   size_t TEST_EstimateInMemoryStatsHistorySize() const;
 
   VersionSet* TEST_GetVersionSet() const { return versions_.get(); }
@@ -1041,6 +1049,9 @@ class DBImpl : public DB {
   // flush LOG out of application buffer
   void FlushInfoLog();
 
+  // record the blocks in the block cache in BLOCK_CACHE_MANIFEST
+  void DumpBlockCacheManifest();
+
  protected:
   const std::string dbname_;
   std::string db_id_;
@@ -1193,12 +1204,19 @@ class DBImpl : public DB {
   // of the write batch that does not have duplicate keys. When seq_per_batch is
   // not set, each key is a separate sub_batch. Otherwise each duplicate key
   // marks start of a new sub-batch.
+  //
+  // deferred_memtable_writes is the number of threads that will insert the
+  // batch into the memtables once it is written (see WalStaging).
   Status WriteImplWALOnly(
       WriteThread* write_thread, const WriteOptions& options,
       WriteBatch* updates, WriteCallback* callback, uint64_t* log_used,
       const uint64_t log_ref, uint64_t* seq_used, const size_t sub_batch_cnt,
       PreReleaseCallback* pre_release_callback, const AssignOrder assign_order,
-      const PublishLastSeq publish_last_seq, const bool disable_memtable);
+      const PublishLastSeq publish_last_seq, const bool disable_memtable,
+      const size_t deferred_memtable_writes = 0);
+
+  // Starts the WAL log thread if enable_wal_staging_buffers is set.
+  void StartWalStaging();
 
   // write cached_recoverable_state_ to memtable if it is not empty
   // The writer must be the leader in write_thread_ and holding mutex_
@@ -1251,6 +1269,7 @@ class DBImpl : public DB {
 #endif
   friend struct SuperVersion;
   friend class CompactedDBImpl;
+  friend class DBImplSecondary;
   friend class DBTest_ConcurrentFlushWAL_Test;
   friend class DBTest_MixedSlowdownOptionsStop_Test;
   friend class DBCompactionTest_CompactBottomLevelFilesWithDeletions_Test;
@@ -1575,16 +1594,29 @@ class DBImpl : public DB {
   // REQUIRES: mutex locked and in write thread.
   Status HandleWriteBufferFull(WriteContext* write_context);
 
+  // Picks the column family whose active memtable gives the most memory back
+  // per byte of flush and L0->L1 compaction I/O it causes. Used by
+  // HandleWriteBufferFull() when cost_based_write_buffer_flush is set.
+  // REQUIRES: mutex locked
+  ColumnFamilyData* PickColumnFamilyByFlushCost();
+
   // REQUIRES: mutex locked
   Status PreprocessWrite(const WriteOptions& write_options, bool* need_log_sync,
                          WriteContext* write_context);
 
+  // Merges the batches of write_group that go to the WAL. When more than one
+  // batch is merged, only the header is built in tmp_batch, and wal_parts is
+  // set to the entries of the batches, preceded by a slot for the header.
   WriteBatch* MergeBatch(const WriteThread::WriteGroup& write_group,
-                         WriteBatch* tmp_batch, size_t* write_with_wal,
+                         WriteBatch* tmp_batch, std::vector<Slice>* wal_parts,
+                         size_t* write_with_wal,
                          WriteBatch** to_be_cached_state);
 
+  // If wal_parts is not empty, the record written is the header of
+  // merged_batch followed by wal_parts[1..], as set up by MergeBatch().
   IOStatus WriteToWAL(const WriteBatch& merged_batch, log::Writer* log_writer,
-                      uint64_t* log_used, uint64_t* log_size);
+                      uint64_t* log_used, uint64_t* log_size,
+                      std::vector<Slice>* wal_parts = nullptr);
 
   IOStatus WriteToWAL(const WriteThread::WriteGroup& write_group,
                       log::Writer* log_writer, uint64_t* log_used,
@@ -1655,12 +1687,14 @@ class DBImpl : public DB {
   static void BGWorkBottomCompaction(void* arg);
   static void BGWorkFlush(void* arg);
   static void BGWorkPurge(void* arg);
+  static void BGWorkBlockCacheWarmUp(void* arg);
   static void UnscheduleCompactionCallback(void* arg);
   static void UnscheduleFlushCallback(void* arg);
   void BackgroundCallCompaction(PrepickedCompaction* prepicked_compaction,
                                 Env::Priority thread_pri);
   void BackgroundCallFlush(Env::Priority thread_pri);
   void BackgroundCallPurge();
+  void BackgroundCallBlockCacheWarmUp();
   Status BackgroundCompaction(bool* madeProgress, JobContext* job_context,
                               LogBuffer* log_buffer,
                               PrepickedCompaction* prepicked_compaction,
@@ -1682,6 +1716,19 @@ class DBImpl : public DB {
   // Schedule background tasks
   void StartPeriodicWorkScheduler();
 
+  // Write the table blocks currently in the block cache to
+  // BLOCK_CACHE_MANIFEST. Returns Incomplete while a warm-up started from the
+  // previous manifest is still running.
+  Status WriteBlockCacheManifest();
+
+  // Write the partition heat of the open readers of live table files next to
+  // the table files. See BlockBasedTableOptions::prefetch_hot_partitions.
+  void SavePartitionHeat();
+
+  // Read BLOCK_CACHE_MANIFEST and schedule background jobs loading the blocks
+  // it lists back into the block cache.
+  void ScheduleBlockCacheWarmUp();
+
   void PrintStatistics();
 
   size_t EstimateInMemoryStatsHistorySize() const;
@@ -1697,6 +1744,17 @@ class DBImpl : public DB {
   // hold the data set.
   Status ReFitLevel(ColumnFamilyData* cfd, int level, int target_level = -1);
 
+  // Implements DBOptions::enable_partial_trivial_move for c, which must
+  // satisfy Compaction::CanMoveNonOverlappingParts(): replaces its start level
+  // input file with table slices and moves the slices that do not overlap the
+  // output level down. Returns false without changing anything if that is
+  // not worth it. Otherwise the result of applying the change is in *status.
+  // REQUIRES: mutex_ held
+  bool MoveNonOverlappingParts(Compaction* c, JobContext* job_context,
+                               LogBuffer* log_buffer,
+                               const CompactionJobStats& compaction_job_stats,
+                               Status* status);
+
   // helper functions for adding and removing from flush & compaction queues
   void AddToCompactionQueue(ColumnFamilyData* cfd);
   ColumnFamilyData* PopFirstFromCompactionQueue();
@@ -1962,6 +2020,7 @@ class DBImpl : public DB {
 
   WriteThread write_thread_;
   WriteBatch tmp_batch_;
+  std::vector<Slice> tmp_wal_parts_;
   // The write thread when the writers have no memtable write. This will be used
   // in 2PC to batch the prepares separately from the serial commit.
   WriteThread nonmem_write_thread_;
@@ -2048,6 +2107,27 @@ class DBImpl : public DB {
   // number of background obsolete file purge jobs, submitted to the HIGH pool
   int bg_purge_scheduled_;
 
+  // The blocks of one table file to load into the block cache
+  struct BlockCacheWarmUpJob {
+    ColumnFamilyData* cfd;
+    FileDescriptor fd;
+    std::shared_ptr<const SliceTransform> prefix_extractor;
+    std::vector<uint64_t> block_offsets;
+  };
+
+  // number of background block cache warm-up jobs, submitted to the LOW pool
+  int bg_block_cache_warmup_scheduled_;
+  // Work shared by the block cache warm-up jobs. The jobs are claimed through
+  // next_block_cache_warmup_job_; the versions holding their files, and the
+  // column families, are referenced until the last job finishes.
+  std::vector<BlockCacheWarmUpJob> block_cache_warmup_jobs_;
+  std::atomic<size_t> next_block_cache_warmup_job_;
+  std::vector<Version*> block_cache_warmup_versions_;
+  size_t block_cache_warmup_loaded_;
+  // The warm-up was cut short by shutdown, so the manifest it was started
+  // from is kept rather than overwritten on close.
+  bool block_cache_warmup_aborted_;
+
   std::deque<ManualCompactionState*> manual_compaction_dequeue_;
 
   // shall we disable deletion of obsolete files
@@ -2077,6 +2157,14 @@ class DBImpl : public DB {
   // Number of threads intending to write to memtable
   std::atomic<size_t> pending_memtable_writes_ = {};
 
+  // Per-core WAL staging buffers and their log thread. Only set with
+  // enable_wal_staging_buffers.
+  std::unique_ptr<WalStaging> wal_staging_;
+
+  // Adapts how long sync write group leaders wait for more sync writes. Only
+  // set with wal_sync_coalescing_max_wait_us.
+  std::unique_ptr<WalSyncCoalescer> wal_sync_coalescer_;
+
   // Each flush or compaction gets its own job id. this counter makes sure
   // they're unique
   std::atomic<int> next_job_id_;
@@ -2124,6 +2212,10 @@ class DBImpl : public DB {
   // Indicate DB was opened successfully
   bool opened_successfully_;
 
+  // Unlike read-only and secondary instances, a DB opened with DBImpl::Open()
+  // owns its table files and saves their partition heat next to them on close
+  bool save_partition_heat_ = false;
+
   // The min threshold to triggere bottommost compaction for removing
   // garbages, among all column families.
   SequenceNumber bottommost_files_mark_threshold_ = kMaxSequenceNumber;
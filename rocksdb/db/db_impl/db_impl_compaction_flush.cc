@@ -1144,7 +1144,7 @@ Status DBImpl::CompactFilesImpl(
   assert(is_snapshot_supported_ || snapshots_.empty());
   CompactionJobStats compaction_job_stats;
   CompactionJob compaction_job(
-      job_context->job_id, c.get(), immutable_db_options_,
+      job_context->job_id, c.get(), immutable_db_options_, mutable_db_options_,
       file_options_for_compaction_, versions_.get(), &shutting_down_,
       preserve_deletes_seqnum_.load(), log_buffer, directories_.GetDbDir(),
       GetDataDir(c->column_family_data(), c->output_path_id()), stats_, &mutex_,
@@ -1420,12 +1420,7 @@ Status DBImpl::ReFitLevel(ColumnFamilyData* cfd, int level, int target_level) {
     edit.SetColumnFamily(cfd->GetID());
     for (const auto& f : vstorage->LevelFiles(level)) {
       edit.DeleteFile(level, f->fd.GetNumber());
-      edit.AddFile(to_level, f->fd.GetNumber(), f->fd.GetPathId(),
-                   f->fd.GetFileSize(), f->smallest, f->largest,
-                   f->fd.smallest_seqno, f->fd.largest_seqno,
-                   f->marked_for_compaction, f->oldest_blob_file_number,
-                   f->oldest_ancester_time, f->file_creation_time,
-                   f->file_checksum, f->file_checksum_func_name);
+      edit.AddExistingFile(to_level, *f);
     }
     ROCKS_LOG_DEBUG(immutable_db_options_.info_log,
                     "[%s] Apply version edit:\n%s", cfd->GetName().c_str(),
@@ -2866,13 +2861,7 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
       for (size_t i = 0; i < c->num_input_files(l); i++) {
         FileMetaData* f = c->input(l, i);
         c->edit()->DeleteFile(c->level(l), f->fd.GetNumber());
-        c->edit()->AddFile(c->output_level(), f->fd.GetNumber(),
-                           f->fd.GetPathId(), f->fd.GetFileSize(), f->smallest,
-                           f->largest, f->fd.smallest_seqno,
-                           f->fd.largest_seqno, f->marked_for_compaction,
-                           f->oldest_blob_file_number, f->oldest_ancester_time,
-                           f->file_creation_time, f->file_checksum,
-                           f->file_checksum_func_name);
+        c->edit()->AddExistingFile(c->output_level(), *f);
 
         ROCKS_LOG_BUFFER(
             log_buffer,
@@ -2915,6 +2904,13 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
     ThreadStatusUtil::ResetThreadStatus();
     TEST_SYNC_POINT_CALLBACK("DBImpl::BackgroundCompaction:AfterCompaction",
                              c->column_family_data());
+  } else if (!trivial_move_disallowed && c->CanMoveNonOverlappingParts() &&
+             MoveNonOverlappingParts(c.get(), job_context, log_buffer,
+                                     compaction_job_stats, &status)) {
+    io_s = versions_->io_status();
+    *made_progress = true;
+    TEST_SYNC_POINT_CALLBACK("DBImpl::BackgroundCompaction:AfterCompaction",
+                             c->column_family_data());
   } else if (!is_prepicked && c->output_level() > 0 &&
              c->output_level() ==
                  c->column_family_data()
@@ -2952,7 +2948,8 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
     assert(is_snapshot_supported_ || snapshots_.empty());
     CompactionJob compaction_job(
         job_context->job_id, c.get(), immutable_db_options_,
-        file_options_for_compaction_, versions_.get(), &shutting_down_,
+        mutable_db_options_, file_options_for_compaction_, versions_.get(),
+        &shutting_down_,
         preserve_deletes_seqnum_.load(), log_buffer, directories_.GetDbDir(),
         GetDataDir(c->column_family_data(), c->output_path_id()), stats_,
         &mutex_, &error_handler_, snapshot_seqs,
@@ -3092,6 +3089,163 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
   return status;
 }
 
+bool DBImpl::MoveNonOverlappingParts(
+    Compaction* c, JobContext* job_context, LogBuffer* log_buffer,
+    const CompactionJobStats& compaction_job_stats, Status* status) {
+  mutex_.AssertHeld();
+  assert(c->CanMoveNonOverlappingParts());
+  ColumnFamilyData* cfd = c->column_family_data();
+  const InternalKeyComparator& icmp = cfd->internal_comparator();
+  const Comparator* ucmp = icmp.user_comparator();
+  const FileMetaData* f = c->input(0, 0);
+  // The user key range of the output level inputs
+  const Slice lo = c->inputs(1)->front()->smallest.user_key();
+  const Slice hi = c->inputs(1)->back()->largest.user_key();
+  const bool has_left = ucmp->Compare(f->smallest.user_key(), lo) < 0;
+  const bool has_right = ucmp->Compare(hi, f->largest.user_key()) < 0;
+  if (!has_left && !has_right) {
+    return false;
+  }
+
+  // Find the keys of f around the two boundaries. Each user key stays
+  // within a single slice, so that point lookups find all of its entries.
+  InternalKey left_largest = f->smallest;
+  InternalKey middle_smallest = f->smallest;
+  InternalKey middle_largest = f->largest;
+  InternalKey right_smallest = f->largest;
+  uint64_t left_size = 0;
+  uint64_t right_size = 0;
+  bool split = false;
+  mutex_.Unlock();
+  {
+    std::shared_ptr<const TableProperties> tp;
+    Status s = c->input_version()->GetTableProperties(&tp, f);
+    // A range deletion could span the parts
+    if (s.ok() && tp != nullptr && tp->num_range_deletions == 0) {
+      const SliceTransform* prefix_extractor =
+          c->mutable_cf_options()->prefix_extractor.get();
+      ReadOptions read_options;
+      read_options.verify_checksums = true;
+      read_options.fill_cache = false;
+      std::unique_ptr<InternalIterator> iter(cfd->table_cache()->NewIterator(
+          read_options, file_options_for_compaction_, icmp, *f,
+          nullptr /* range_del_agg */, prefix_extractor,
+          nullptr /* table_reader_ptr */, nullptr /* file_read_hist */,
+          TableReaderCaller::kCompaction, nullptr /* arena */,
+          true /* skip_filters */, c->start_level(),
+          MaxFileSizeForL0MetaPin(*c->mutable_cf_options()),
+          nullptr /* smallest_compaction_key */,
+          nullptr /* largest_compaction_key */,
+          false /* allow_unprepared_value */));
+      split = true;
+      if (has_left) {
+        iter->Seek(InternalKey(lo, kMaxSequenceNumber, kValueTypeForSeek)
+                       .Encode());
+        split = iter->Valid();
+        if (split) {
+          middle_smallest.DecodeFrom(iter->key());
+          iter->Prev();
+          split = iter->Valid();
+        }
+        if (split) {
+          left_largest.DecodeFrom(iter->key());
+        }
+      }
+      if (split && has_right) {
+        iter->Seek(InternalKey(hi, 0, kTypeDeletion).Encode());
+        while (iter->Valid() &&
+               ucmp->Compare(ExtractUserKey(iter->key()), hi) <= 0) {
+          iter->Next();
+        }
+        split = iter->Valid();
+        if (split) {
+          right_smallest.DecodeFrom(iter->key());
+          iter->Prev();
+          split = iter->Valid();
+        }
+        if (split) {
+          middle_largest.DecodeFrom(iter->key());
+        }
+      }
+      split = split && iter->status().ok();
+
+      if (split) {
+        if (has_left) {
+          left_size = cfd->table_cache()->ApproximateSize(
+              f->smallest.Encode(), middle_smallest.Encode(), f->fd,
+              TableReaderCaller::kCompaction, icmp, prefix_extractor);
+        }
+        if (has_right) {
+          right_size = cfd->table_cache()->ApproximateSize(
+              right_smallest.Encode(), f->largest.Encode(), f->fd,
+              TableReaderCaller::kCompaction, icmp, prefix_extractor);
+        }
+        // Leave small parts to the compaction. Slices referring to less than
+        // half of their table file would be compacted again soon.
+        split = (left_size + right_size) * 2 >= f->fd.GetFileSize() &&
+                left_size + right_size < f->fd.GetFileSize();
+      }
+    }
+  }
+  mutex_.Lock();
+  if (!split) {
+    return false;
+  }
+
+  TEST_SYNC_POINT("DBImpl::BackgroundCompaction:PartialTrivialMove");
+  NotifyOnCompactionBegin(cfd, c, *status, compaction_job_stats,
+                          job_context->job_id);
+
+  VersionEdit* edit = c->edit();
+  edit->DeleteFile(c->start_level(), f->fd.GetNumber());
+  auto add_slice = [&](int level, const InternalKey& smallest,
+                       const InternalKey& largest, uint64_t file_size) {
+    FileMetaData slice = *f;
+    slice.fd = FileDescriptor(versions_->NewFileNumber(), f->fd.GetPathId(),
+                              std::max<uint64_t>(file_size, 1),
+                              f->fd.smallest_seqno, f->fd.largest_seqno);
+    slice.fd.physical_number = f->fd.GetPhysicalNumber();
+    slice.fd.physical_file_size = f->fd.GetPhysicalFileSize();
+    slice.smallest = smallest;
+    slice.largest = largest;
+    edit->AddExistingFile(level, slice);
+    ROCKS_LOG_BUFFER(log_buffer,
+                     "[%s] Slice #%" PRIu64 " of #%" PRIu64
+                     " to level-%d %" PRIu64 " bytes\n",
+                     cfd->GetName().c_str(), slice.fd.GetNumber(),
+                     slice.fd.GetPhysicalNumber(), level, file_size);
+  };
+  if (has_left) {
+    add_slice(c->output_level(), f->smallest, left_largest, left_size);
+  }
+  add_slice(c->start_level(), middle_smallest, middle_largest,
+            f->fd.GetFileSize() - left_size - right_size);
+  if (has_right) {
+    add_slice(c->output_level(), right_smallest, f->largest, right_size);
+  }
+
+  *status = versions_->LogAndApply(cfd, *c->mutable_cf_options(), edit,
+                                   &mutex_, directories_.GetDbDir());
+  InstallSuperVersionAndScheduleWork(
+      cfd, &job_context->superversion_contexts[0], *c->mutable_cf_options());
+
+  const uint64_t moved_bytes = left_size + right_size;
+  cfd->internal_stats()->IncBytesMoved(c->output_level(), moved_bytes);
+  event_logger_.LogToBuffer(log_buffer)
+      << "job" << job_context->job_id << "event"
+      << "partial_trivial_move"
+      << "file" << f->fd.GetNumber() << "destination_level"
+      << c->output_level() << "total_files_size" << moved_bytes;
+  VersionStorageInfo::LevelSummaryStorage tmp;
+  ROCKS_LOG_BUFFER(log_buffer,
+                   "[%s] Moved parts of #%" PRIu64 " to level-%d %" PRIu64
+                   " bytes %s: %s\n",
+                   cfd->GetName().c_str(), f->fd.GetNumber(),
+                   c->output_level(), moved_bytes, status->ToString().c_str(),
+                   cfd->current()->storage_info()->LevelSummary(&tmp));
+  return true;
+}
+
 bool DBImpl::HasPendingManualCompaction() {
   return (!manual_compaction_dequeue_.empty());
 }
@@ -285,6 +285,13 @@ PeriodicWorkTestScheduler* DBImpl::TEST_GetPeriodicWorkScheduler() const {
 }
 #endif  // !ROCKSDB_LITE
 
+void DBImpl::TEST_WaitForBlockCacheWarmUp() {
+  InstrumentedMutexLock l(&mutex_);
+  while (bg_block_cache_warmup_scheduled_ > 0) {
+    bg_cv_.Wait();
+  }
+}
+
 size_t DBImpl::TEST_EstimateInMemoryStatsHistorySize() const {
   return EstimateInMemoryStatsHistorySize();
 }
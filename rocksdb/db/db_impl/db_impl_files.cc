@@ -146,7 +146,7 @@ void DBImpl::FindObsoleteFiles(JobContext* job_context, bool force,
   // calling FindObsoleteFiles with full_scan=true will not add these files to
   // candidate list for purge.
   for (const auto& sst_to_del : job_context->sst_delete_files) {
-    MarkAsGrabbedForPurge(sst_to_del.metadata->fd.GetNumber());
+    MarkAsGrabbedForPurge(sst_to_del.metadata->fd.GetPhysicalNumber());
   }
 
   for (const auto& blob_file : job_context->blob_delete_files) {
@@ -381,7 +381,7 @@ void DBImpl::PurgeObsoleteFiles(JobContext& state, bool schedule_only) {
   // We may ignore the dbname when generating the file names.
   for (auto& file : state.sst_delete_files) {
     candidate_files.emplace_back(
-        MakeTableFileName(file.metadata->fd.GetNumber()), file.path);
+        MakeTableFileName(file.metadata->fd.GetPhysicalNumber()), file.path);
     if (file.metadata->table_reader_handle) {
       table_cache_->Release(file.metadata->table_reader_handle);
     }
@@ -486,6 +486,11 @@ void DBImpl::PurgeObsoleteFiles(JobContext& state, bool schedule_only) {
           files_to_del.insert(number);
         }
         break;
+      case kTableHeatFile:
+        // Partition heat of a table file that is gone is useless
+        keep = (sst_live_set.find(number) != sst_live_set.end()) ||
+               number >= state.min_pending_output;
+        break;
       case kBlobFile:
         keep = number >= state.min_pending_output ||
                (blob_live_set.find(number) != blob_live_set.end());
@@ -525,6 +530,7 @@ void DBImpl::PurgeObsoleteFiles(JobContext& state, bool schedule_only) {
       case kCurrentFile:
       case kDBLockFile:
       case kIdentityFile:
+      case kBlockCacheManifestFile:
       case kMetaDatabase:
         keep = true;
         break;
@@ -542,8 +548,14 @@ void DBImpl::PurgeObsoleteFiles(JobContext& state, bool schedule_only) {
       fname = MakeTableFileName(candidate_file.file_path, number);
       dir_to_sync = candidate_file.file_path;
     } else if (type == kBlobFile) {
+      // evict from cache
+      TableCache::Evict(table_cache_.get(), number);
       fname = BlobFileName(candidate_file.file_path, number);
       dir_to_sync = candidate_file.file_path;
+    } else if (type == kTableHeatFile) {
+      fname = TableHeatFileName(
+          MakeTableFileName(candidate_file.file_path, number));
+      dir_to_sync = candidate_file.file_path;
     } else {
       dir_to_sync =
           (type == kLogFile) ? immutable_db_options_.wal_dir : dbname_;
@@ -258,6 +258,11 @@ Status DBImpl::ValidateOptions(const DBOptions& db_options) {
         "unordered_write is incompatible with enable_pipelined_write");
   }
 
+  if (db_options.enable_wal_staging_buffers && !db_options.unordered_write) {
+    return Status::InvalidArgument(
+        "enable_wal_staging_buffers requires unordered_write");
+  }
+
   if (db_options.atomic_flush && db_options.enable_pipelined_write) {
     return Status::InvalidArgument(
         "atomic_flush is incompatible with enable_pipelined_write");
@@ -1532,6 +1537,7 @@ Status DBImpl::Open(const DBOptions& db_options, const std::string& dbname,
   }
 
   DBImpl* impl = new DBImpl(db_options, dbname, seq_per_batch, batch_per_txn);
+  impl->save_partition_heat_ = true;
   s = impl->env_->CreateDirIfMissing(impl->immutable_db_options_.wal_dir);
   if (s.ok()) {
     std::vector<std::string> paths;
@@ -1729,7 +1735,7 @@ Status DBImpl::Open(const DBOptions& db_options, const std::string& dbname,
     std::vector<LiveFileMetaData> metadata;
 
     impl->mutex_.Lock();
-    impl->versions_->GetLiveFilesMetaData(&metadata);
+    impl->versions_->GetLiveTableFilesMetaData(&metadata);
     impl->mutex_.Unlock();
 
     std::unordered_map<std::string, uint64_t> known_file_sizes;
@@ -1809,6 +1815,8 @@ Status DBImpl::Open(const DBOptions& db_options, const std::string& dbname,
   }
   if (s.ok()) {
     impl->StartPeriodicWorkScheduler();
+    impl->ScheduleBlockCacheWarmUp();
+    impl->StartWalStaging();
   } else {
     for (auto* h : *handles) {
       delete h;
@@ -8,9 +8,12 @@
 #include <cinttypes>
 
 #include "db/arena_wrapped_db_iter.h"
+#include "db/compaction/compaction_job.h"
 #include "db/merge_context.h"
 #include "logging/auto_roll_logger.h"
 #include "monitoring/perf_context_imp.h"
+#include "rocksdb/convenience.h"
+#include "rocksdb/utilities/options_util.h"
 #include "util/cast_util.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -486,7 +489,7 @@ Status DBImplSecondary::CheckConsistency() {
   }
 
   std::vector<LiveFileMetaData> metadata;
-  versions_->GetLiveFilesMetaData(&metadata);
+  versions_->GetLiveTableFilesMetaData(&metadata);
 
   std::string corruption_messages;
   for (const auto& md : metadata) {
@@ -662,6 +665,169 @@ Status DB::OpenAsSecondary(
   }
   return s;
 }
+
+Status DBImplSecondary::CompactWithoutInstallation(
+    ColumnFamilyHandle* cfh, const CompactionServiceInput& input,
+    const std::string& output_path, CompactionServiceResult* result) {
+  InstrumentedMutexLock l(&mutex_);
+  auto cfd = static_cast_with_check<ColumnFamilyHandleImpl>(cfh)->cfd();
+  if (cfd == nullptr) {
+    return Status::InvalidArgument("Cannot find column family",
+                                   cfh->GetName());
+  }
+
+  std::unordered_set<uint64_t> input_set(input.input_files.begin(),
+                                         input.input_files.end());
+  Version* version = cfd->current();
+  VersionStorageInfo* vstorage = version->storage_info();
+  const MutableCFOptions* mutable_cf_options =
+      cfd->GetLatestMutableCFOptions();
+
+  // Cut the output files at the size the primary would
+  CompactionOptions comp_options;
+  comp_options.output_file_size_limit = MaxFileSizeForLevel(
+      *mutable_cf_options, input.output_level,
+      cfd->ioptions()->compaction_style, vstorage->base_level(),
+      cfd->ioptions()->level_compaction_dynamic_level_bytes);
+
+  std::vector<CompactionInputFiles> input_files;
+  Status s = cfd->compaction_picker()->GetCompactionInputsFromFileNumbers(
+      &input_files, &input_set, vstorage, comp_options);
+  if (!s.ok()) {
+    return s;
+  }
+
+  std::unique_ptr<FSDirectory> output_dir;
+  s = CreateAndNewDirectory(fs_.get(), output_path, &output_dir);
+  if (!s.ok()) {
+    return s;
+  }
+
+  std::unique_ptr<Compaction> c(cfd->compaction_picker()->CompactFiles(
+      comp_options, input_files, input.output_level, vstorage,
+      *mutable_cf_options, mutable_db_options_, /*output_path_id=*/0));
+  assert(c != nullptr);
+  c->SetInputVersion(version);
+
+  LogBuffer log_buffer(InfoLogLevel::INFO_LEVEL,
+                       immutable_db_options_.info_log.get());
+  const int job_id = next_job_id_.fetch_add(1);
+  CompactionJobStats compaction_job_stats;
+  CompactionServiceCompactionJob compaction_job(
+      job_id, c.get(), immutable_db_options_, mutable_db_options_,
+      file_options_for_compaction_, versions_.get(), &shutting_down_,
+      &log_buffer, output_dir.get(), stats_,
+      &mutex_, &error_handler_, table_cache_, &event_logger_, dbname_,
+      &compaction_job_stats, io_tracer_, db_id_, db_session_id_, output_path,
+      input, result);
+
+  compaction_job.Prepare();
+
+  mutex_.Unlock();
+  s = compaction_job.Run();
+  mutex_.Lock();
+
+  compaction_job.CleanupCompaction();
+  c->ReleaseCompactionFiles(s);
+  c.reset();
+  log_buffer.FlushBufferToLog();
+  return s;
+}
+
+Status DB::OpenAndCompact(
+    const std::string& name, const std::string& output_directory,
+    const std::string& input, std::string* output,
+    const CompactionServiceOptionsOverride& override_options) {
+  CompactionServiceInput compaction_input;
+  Status s = compaction_input.DecodeFrom(input);
+  if (!s.ok()) {
+    return s;
+  }
+
+  ConfigOptions config_options;
+  config_options.env = override_options.env;
+  config_options.ignore_unknown_options = true;
+  DBOptions db_options;
+  s = GetDBOptionsFromString(config_options, DBOptions(),
+                             compaction_input.db_options, &db_options);
+  if (!s.ok()) {
+    return s;
+  }
+  ColumnFamilyOptions cf_options;
+  s = GetColumnFamilyOptionsFromString(config_options, ColumnFamilyOptions(),
+                                       compaction_input.cf_options,
+                                       &cf_options);
+  if (!s.ok()) {
+    return s;
+  }
+
+  // The options that are not serialized
+  db_options.env = override_options.env;
+  db_options.file_checksum_gen_factory =
+      override_options.file_checksum_gen_factory;
+  cf_options.comparator = override_options.comparator;
+  cf_options.merge_operator = override_options.merge_operator;
+  cf_options.compaction_filter = override_options.compaction_filter;
+  cf_options.compaction_filter_factory =
+      override_options.compaction_filter_factory;
+  cf_options.prefix_extractor = override_options.prefix_extractor;
+  if (override_options.table_factory != nullptr) {
+    cf_options.table_factory = override_options.table_factory;
+  }
+  cf_options.sst_partitioner_factory = override_options.sst_partitioner_factory;
+
+  // Required by secondary instances
+  db_options.max_open_files = -1;
+  db_options.compaction_service = nullptr;
+
+  s = db_options.env->CreateDirIfMissing(output_directory);
+  if (!s.ok()) {
+    return s;
+  }
+
+  std::vector<ColumnFamilyDescriptor> column_families;
+  column_families.emplace_back(compaction_input.column_family_name,
+                               cf_options);
+  // The default column family must always be opened. It is not compacted,
+  // but its options must still fit it, e.g. its comparator, so take them
+  // from the OPTIONS file of the DB.
+  if (compaction_input.column_family_name != kDefaultColumnFamilyName) {
+    ColumnFamilyOptions default_cf_options;
+    DBOptions persisted_db_options;
+    std::vector<ColumnFamilyDescriptor> persisted_column_families;
+    if (LoadLatestOptions(config_options, name, &persisted_db_options,
+                          &persisted_column_families)
+            .ok()) {
+      for (const auto& cf : persisted_column_families) {
+        if (cf.name == kDefaultColumnFamilyName) {
+          default_cf_options = cf.options;
+        }
+      }
+    }
+    column_families.emplace_back(kDefaultColumnFamilyName, default_cf_options);
+  }
+
+  DB* db = nullptr;
+  std::vector<ColumnFamilyHandle*> handles;
+  s = DB::OpenAsSecondary(db_options, name, output_directory, column_families,
+                          &handles, &db);
+  if (!s.ok()) {
+    return s;
+  }
+
+  CompactionServiceResult compaction_result;
+  auto db_secondary = static_cast_with_check<DBImplSecondary>(db);
+  assert(!handles.empty());
+  s = db_secondary->CompactWithoutInstallation(
+      handles[0], compaction_input, output_directory, &compaction_result);
+  compaction_result.EncodeTo(output);
+
+  for (auto& handle : handles) {
+    delete handle;
+  }
+  delete db;
+  return s;
+}
 #else   // !ROCKSDB_LITE
 
 Status DB::OpenAsSecondary(const Options& /*options*/,
@@ -678,6 +844,13 @@ Status DB::OpenAsSecondary(
     std::vector<ColumnFamilyHandle*>* /*handles*/, DB** /*dbptr*/) {
   return Status::NotSupported("Not supported in ROCKSDB_LITE.");
 }
+
+Status DB::OpenAndCompact(
+    const std::string& /*name*/, const std::string& /*output_directory*/,
+    const std::string& /*input*/, std::string* /*output*/,
+    const CompactionServiceOptionsOverride& /*override_options*/) {
+  return Status::NotSupported("Not supported in ROCKSDB_LITE.");
+}
 #endif  // !ROCKSDB_LITE
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -13,6 +13,9 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+struct CompactionServiceInput;
+struct CompactionServiceResult;
+
 // A wrapper class to hold log reader, log reporter, log status.
 class LogReaderContainer {
  public:
@@ -222,6 +225,14 @@ class DBImplSecondary : public DBImpl {
   // not flag the missing file as inconsistency.
   Status CheckConsistency() override;
 
+  // Runs the compaction described by input, as sent by the primary to
+  // DBOptions::compaction_service, and writes the output files to
+  // output_path without installing them. Used by DB::OpenAndCompact().
+  Status CompactWithoutInstallation(ColumnFamilyHandle* cfh,
+                                    const CompactionServiceInput& input,
+                                    const std::string& output_path,
+                                    CompactionServiceResult* result);
+
  protected:
   // ColumnFamilyCollector is a write batch handler which does nothing
   // except recording unique column family IDs
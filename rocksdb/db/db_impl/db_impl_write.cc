@@ -126,12 +126,25 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
                                      // every key is a sub-batch consuming a seq
                                      : WriteBatchInternal::Count(my_batch);
     uint64_t seq = 0;
-    // Use a write thread to i) optimize for WAL write, ii) publish last
-    // sequence in in increasing order, iii) call pre_release_callback serially
-    Status status = WriteImplWALOnly(
-        &write_thread_, write_options, my_batch, callback, log_used, log_ref,
-        &seq, sub_batch_cnt, pre_release_callback, kDoAssignOrder,
-        kDoPublishLastSeq, disable_memtable);
+    Status status;
+    if (wal_staging_ != nullptr && !seq_per_batch_ && callback == nullptr &&
+        pre_release_callback == nullptr && log_used == nullptr &&
+        log_ref == 0 && !disable_memtable && batch_cnt == 0 &&
+        !write_options.disableWAL && !write_options.no_slowdown &&
+        WriteBatchInternal::Count(my_batch) > 0 &&
+        my_batch->GetWalTerminationPoint().is_cleared()) {
+      // Hand the batch to the log thread through this core's staging buffer
+      RecordTick(stats_, WRITE_WITH_WAL);
+      status = wal_staging_->Write(write_options, my_batch, &seq);
+    } else {
+      // Use a write thread to i) optimize for WAL write, ii) publish last
+      // sequence in in increasing order, iii) call pre_release_callback
+      // serially
+      status = WriteImplWALOnly(
+          &write_thread_, write_options, my_batch, callback, log_used, log_ref,
+          &seq, sub_batch_cnt, pre_release_callback, kDoAssignOrder,
+          kDoPublishLastSeq, disable_memtable);
+    }
     TEST_SYNC_POINT("DBImpl::WriteImpl:UnorderedWriteAfterWriteWAL");
     if (!status.ok()) {
       return status;
@@ -170,6 +183,7 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
     if (w.ShouldWriteToMemtable()) {
       PERF_TIMER_STOP(write_pre_and_post_process_time);
       PERF_TIMER_GUARD(write_memtable_time);
+      StopWatch sw(env_, stats_, WRITE_MEMTABLE_MICROS);
 
       ColumnFamilyMemTablesImpl column_family_memtables(
           versions_->GetColumnFamilySet());
@@ -245,6 +259,20 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
 
   mutex_.Unlock();
 
+  if (wal_sync_coalescer_ != nullptr && need_log_sync && status.ok() &&
+      !two_write_queues_) {
+    // Give sync writes that arrive shortly a chance to join the group and
+    // share its WAL sync
+    uint64_t wait_us = wal_sync_coalescer_->WaitMicros();
+    if (wait_us > 0) {
+      StopWatch sw(env_, stats_, WAL_SYNC_COALESCING_WAIT_MICROS);
+      WriteThread::Writer* newest_writer = write_thread_.NewestWriter();
+      env_->SleepForMicroseconds(static_cast<int>(wait_us));
+      wal_sync_coalescer_->RecordWait(write_thread_.NewestWriter() !=
+                                      newest_writer);
+    }
+  }
+
   // Add to log and apply to memtable.  We can release the lock
   // during this phase since &w is currently responsible for logging
   // and protects against concurrent loggers and concurrent writes
@@ -327,12 +355,14 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
     if (!two_write_queues_) {
       if (status.ok() && !write_options.disableWAL) {
         PERF_TIMER_GUARD(write_wal_time);
+        StopWatch sw(env_, stats_, WRITE_WAL_MICROS);
         io_s = WriteToWAL(write_group, log_writer, log_used, need_log_sync,
                           need_log_dir_sync, last_sequence + 1);
       }
     } else {
       if (status.ok() && !write_options.disableWAL) {
         PERF_TIMER_GUARD(write_wal_time);
+        StopWatch sw(env_, stats_, WRITE_WAL_MICROS);
         // LastAllocatedSequence is increased inside WriteToWAL under
         // wal_write_mutex_ to ensure ordered events in WAL
         io_s = ConcurrentWriteToWAL(write_group, log_used, &last_sequence,
@@ -382,6 +412,7 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
       PERF_TIMER_GUARD(write_memtable_time);
 
       if (!parallel) {
+        StopWatch sw(env_, stats_, WRITE_MEMTABLE_MICROS);
         // w.sequence will be set inside InsertInto
         w.status = WriteBatchInternal::InsertInto(
             write_group, current_sequence, column_family_memtables_.get(),
@@ -397,6 +428,7 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
         // Each parallel follower is doing each own writes. The leader should
         // also do its own.
         if (w.ShouldWriteToMemtable()) {
+          StopWatch sw(env_, stats_, WRITE_MEMTABLE_MICROS);
           ColumnFamilyMemTablesImpl column_family_memtables(
               versions_->GetColumnFamilySet());
           assert(w.sequence == current_sequence);
@@ -529,6 +561,7 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
     IOStatus io_s;
     if (w.status.ok() && !write_options.disableWAL) {
       PERF_TIMER_GUARD(write_wal_time);
+      StopWatch sw(env_, stats_, WRITE_WAL_MICROS);
       stats->AddDBStats(InternalStats::kIntStatsWriteDoneBySelf, 1);
       RecordTick(stats_, WRITE_DONE_BY_SELF, 1);
       if (wal_write_group.size > 1) {
@@ -567,11 +600,15 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
         immutable_db_options_.allow_concurrent_memtable_write) {
       write_thread_.LaunchParallelMemTableWriters(&memtable_write_group);
     } else {
-      memtable_write_group.status = WriteBatchInternal::InsertInto(
-          memtable_write_group, w.sequence, column_family_memtables_.get(),
-          &flush_scheduler_, &trim_history_scheduler_,
-          write_options.ignore_missing_column_families, 0 /*log_number*/, this,
-          false /*concurrent_memtable_writes*/, seq_per_batch_, batch_per_txn_);
+      {
+        StopWatch sw(env_, stats_, WRITE_MEMTABLE_MICROS);
+        memtable_write_group.status = WriteBatchInternal::InsertInto(
+            memtable_write_group, w.sequence, column_family_memtables_.get(),
+            &flush_scheduler_, &trim_history_scheduler_,
+            write_options.ignore_missing_column_families, 0 /*log_number*/,
+            this, false /*concurrent_memtable_writes*/, seq_per_batch_,
+            batch_per_txn_);
+      }
       versions_->SetLastSequence(memtable_write_group.last_sequence);
       write_thread_.ExitAsMemTableWriter(&w, memtable_write_group);
     }
@@ -579,14 +616,18 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
 
   if (w.state == WriteThread::STATE_PARALLEL_MEMTABLE_WRITER) {
     assert(w.ShouldWriteToMemtable());
-    ColumnFamilyMemTablesImpl column_family_memtables(
-        versions_->GetColumnFamilySet());
-    w.status = WriteBatchInternal::InsertInto(
-        &w, w.sequence, &column_family_memtables, &flush_scheduler_,
-        &trim_history_scheduler_, write_options.ignore_missing_column_families,
-        0 /*log_number*/, this, true /*concurrent_memtable_writes*/,
-        false /*seq_per_batch*/, 0 /*batch_cnt*/, true /*batch_per_txn*/,
-        write_options.memtable_insert_hint_per_batch);
+    {
+      StopWatch sw(env_, stats_, WRITE_MEMTABLE_MICROS);
+      ColumnFamilyMemTablesImpl column_family_memtables(
+          versions_->GetColumnFamilySet());
+      w.status = WriteBatchInternal::InsertInto(
+          &w, w.sequence, &column_family_memtables, &flush_scheduler_,
+          &trim_history_scheduler_,
+          write_options.ignore_missing_column_families, 0 /*log_number*/, this,
+          true /*concurrent_memtable_writes*/, false /*seq_per_batch*/,
+          0 /*batch_cnt*/, true /*batch_per_txn*/,
+          write_options.memtable_insert_hint_per_batch);
+    }
     if (write_thread_.CompleteParallelMemTableWriter(&w)) {
       MemTableInsertStatusCheck(w.status);
       versions_->SetLastSequence(w.write_group->last_sequence);
@@ -649,6 +690,23 @@ Status DBImpl::UnorderedWriteMemtable(const WriteOptions& write_options,
   return Status::OK();
 }
 
+void DBImpl::StartWalStaging() {
+  if (!immutable_db_options_.enable_wal_staging_buffers) {
+    return;
+  }
+  assert(immutable_db_options_.unordered_write);
+  wal_staging_.reset(new WalStaging(
+      env_, [this](const WriteOptions& write_options, WriteBatch* batch,
+                   size_t memtable_writes, SequenceNumber* seq) {
+        return WriteImplWALOnly(
+            &write_thread_, write_options, batch, nullptr /*callback*/,
+            nullptr /*log_used*/, 0 /*log_ref*/, seq,
+            WriteBatchInternal::Count(batch), nullptr /*pre_release_callback*/,
+            kDoAssignOrder, kDoPublishLastSeq, true /*disable_memtable*/,
+            memtable_writes);
+      }));
+}
+
 // The 2nd write queue. If enabled it will be used only for WAL-only writes.
 // This is the only queue that updates LastPublishedSequence which is only
 // applicable in a two-queue setting.
@@ -657,12 +715,17 @@ Status DBImpl::WriteImplWALOnly(
     WriteBatch* my_batch, WriteCallback* callback, uint64_t* log_used,
     const uint64_t log_ref, uint64_t* seq_used, const size_t sub_batch_cnt,
     PreReleaseCallback* pre_release_callback, const AssignOrder assign_order,
-    const PublishLastSeq publish_last_seq, const bool disable_memtable) {
+    const PublishLastSeq publish_last_seq, const bool disable_memtable,
+    const size_t deferred_memtable_writes) {
   Status status;
   PERF_TIMER_GUARD(write_pre_and_post_process_time);
   WriteThread::Writer w(write_options, my_batch, callback, log_ref,
                         disable_memtable, sub_batch_cnt, pre_release_callback);
-  RecordTick(stats_, WRITE_WITH_WAL);
+  w.deferred_memtable_writes = deferred_memtable_writes;
+  if (deferred_memtable_writes == 0) {
+    // Staged writes are counted by their writers
+    RecordTick(stats_, WRITE_WITH_WAL);
+  }
   StopWatch write_sw(env_, immutable_db_options_.statistics.get(), DB_WRITE);
 
   write_thread->JoinBatchGroup(&w);
@@ -743,6 +806,7 @@ Status DBImpl::WriteImplWALOnly(
   PERF_TIMER_STOP(write_pre_and_post_process_time);
 
   PERF_TIMER_GUARD(write_wal_time);
+  StopWatch wal_sw(env_, stats_, WRITE_WAL_MICROS);
   // LastAllocatedSequence is increased inside WriteToWAL under
   // wal_write_mutex_ to ensure ordered events in WAL
   size_t seq_inc = 0 /* total_count */;
@@ -779,6 +843,7 @@ Status DBImpl::WriteImplWALOnly(
     if (!writer->disable_memtable) {
       memtable_write_cnt++;
     }
+    memtable_write_cnt += writer->deferred_memtable_writes;
     // else seq advances only by memtable writes
   }
   if (status.ok() && write_options.sync) {
@@ -974,10 +1039,14 @@ Status DBImpl::PreprocessWrite(const WriteOptions& write_options,
 }
 
 WriteBatch* DBImpl::MergeBatch(const WriteThread::WriteGroup& write_group,
-                               WriteBatch* tmp_batch, size_t* write_with_wal,
+                               WriteBatch* tmp_batch,
+                               std::vector<Slice>* wal_parts,
+                               size_t* write_with_wal,
                                WriteBatch** to_be_cached_state) {
   assert(write_with_wal != nullptr);
   assert(tmp_batch != nullptr);
+  assert(wal_parts != nullptr);
+  wal_parts->clear();
   assert(*to_be_cached_state == nullptr);
   WriteBatch* merged_batch = nullptr;
   *write_with_wal = 0;
@@ -994,16 +1063,15 @@ WriteBatch* DBImpl::MergeBatch(const WriteThread::WriteGroup& write_group,
     }
     *write_with_wal = 1;
   } else {
-    // WAL needs all of the batches flattened into a single batch.
-    // We could avoid copying here with an iov-like AddRecord
-    // interface
+    // WAL needs all of the batches flattened into a single record. Only the
+    // header is built in tmp_batch; the entries of the batches are handed to
+    // the log writer by reference and gathered when the record is written.
     merged_batch = tmp_batch;
+    wal_parts->emplace_back();  // header
     for (auto writer : write_group) {
       if (!writer->CallbackFailed()) {
-        Status s = WriteBatchInternal::Append(merged_batch, writer->batch,
-                                              /*WAL_only*/ true);
-        // Always returns Status::OK.
-        assert(s.ok());
+        wal_parts->push_back(WriteBatchInternal::AppendByReference(
+            merged_batch, writer->batch, /*WAL_only*/ true));
         if (WriteBatchInternal::IsLatestPersistentState(writer->batch)) {
           // We only need to cache the last of such write batch
           *to_be_cached_state = writer->batch;
@@ -1019,10 +1087,20 @@ WriteBatch* DBImpl::MergeBatch(const WriteThread::WriteGroup& write_group,
 // write thread. Otherwise this must be called holding log_write_mutex_.
 IOStatus DBImpl::WriteToWAL(const WriteBatch& merged_batch,
                             log::Writer* log_writer, uint64_t* log_used,
-                            uint64_t* log_size) {
+                            uint64_t* log_size,
+                            std::vector<Slice>* wal_parts) {
   assert(log_size != nullptr);
   Slice log_entry = WriteBatchInternal::Contents(&merged_batch);
-  *log_size = log_entry.size();
+  size_t log_entry_size = log_entry.size();
+  const bool gather = wal_parts != nullptr && !wal_parts->empty();
+  if (gather) {
+    assert(log_entry.size() == WriteBatchInternal::kHeader);
+    (*wal_parts)[0] = log_entry;
+    for (size_t i = 1; i < wal_parts->size(); i++) {
+      log_entry_size += (*wal_parts)[i].size();
+    }
+  }
+  *log_size = log_entry_size;
   // When two_write_queues_ WriteToWAL has to be protected from concurretn calls
   // from the two queues anyway and log_write_mutex_ is already held. Otherwise
   // if manual_wal_flush_ is enabled we need to protect log_writer->AddRecord
@@ -1034,7 +1112,9 @@ IOStatus DBImpl::WriteToWAL(const WriteBatch& merged_batch,
   if (UNLIKELY(needs_locking)) {
     log_write_mutex_.Lock();
   }
-  IOStatus io_s = log_writer->AddRecord(log_entry);
+  IOStatus io_s =
+      gather ? log_writer->AddRecord(wal_parts->data(), wal_parts->size())
+             : log_writer->AddRecord(log_entry);
 
   if (UNLIKELY(needs_locking)) {
     log_write_mutex_.Unlock();
@@ -1042,10 +1122,10 @@ IOStatus DBImpl::WriteToWAL(const WriteBatch& merged_batch,
   if (log_used != nullptr) {
     *log_used = logfile_number_;
   }
-  total_log_size_ += log_entry.size();
+  total_log_size_ += log_entry_size;
   // TODO(myabandeh): it might be unsafe to access alive_log_files_.back() here
   // since alive_log_files_ might be modified concurrently
-  alive_log_files_.back().AddSize(log_entry.size());
+  alive_log_files_.back().AddSize(log_entry_size);
   log_empty_ = false;
   return io_s;
 }
@@ -1059,8 +1139,9 @@ IOStatus DBImpl::WriteToWAL(const WriteThread::WriteGroup& write_group,
   // Same holds for all in the batch group
   size_t write_with_wal = 0;
   WriteBatch* to_be_cached_state = nullptr;
-  WriteBatch* merged_batch = MergeBatch(write_group, &tmp_batch_,
-                                        &write_with_wal, &to_be_cached_state);
+  WriteBatch* merged_batch =
+      MergeBatch(write_group, &tmp_batch_, &tmp_wal_parts_, &write_with_wal,
+                 &to_be_cached_state);
   if (merged_batch == write_group.leader->batch) {
     write_group.leader->log_used = logfile_number_;
   } else if (write_with_wal > 1) {
@@ -1072,7 +1153,8 @@ IOStatus DBImpl::WriteToWAL(const WriteThread::WriteGroup& write_group,
   WriteBatchInternal::SetSequence(merged_batch, sequence);
 
   uint64_t log_size;
-  io_s = WriteToWAL(*merged_batch, log_writer, log_used, &log_size);
+  io_s = WriteToWAL(*merged_batch, log_writer, log_used, &log_size,
+                    &tmp_wal_parts_);
   if (to_be_cached_state) {
     cached_recoverable_state_ = *to_be_cached_state;
     cached_recoverable_state_empty_ = false;
@@ -1080,6 +1162,8 @@ IOStatus DBImpl::WriteToWAL(const WriteThread::WriteGroup& write_group,
 
   if (io_s.ok() && need_log_sync) {
     StopWatch sw(env_, stats_, WAL_FILE_SYNC_MICROS);
+    uint64_t sync_start =
+        wal_sync_coalescer_ != nullptr ? env_->NowMicros() : 0;
     // It's safe to access logs_ with unlocked mutex_ here because:
     //  - we've set getting_synced=true for all logs,
     //    so other threads won't pop from logs_ while we're here,
@@ -1100,6 +1184,10 @@ IOStatus DBImpl::WriteToWAL(const WriteThread::WriteGroup& write_group,
       // we can avoid the disk I/O in the write code path.
       io_s = directories_.GetWalDir()->Fsync(IOOptions(), nullptr);
     }
+    if (io_s.ok() && wal_sync_coalescer_ != nullptr) {
+      wal_sync_coalescer_->RecordSync(env_->NowMicros() - sync_start,
+                                      write_group.size);
+    }
   }
 
   if (merged_batch == &tmp_batch_) {
@@ -1110,6 +1198,7 @@ IOStatus DBImpl::WriteToWAL(const WriteThread::WriteGroup& write_group,
     if (need_log_sync) {
       stats->AddDBStats(InternalStats::kIntStatsWalFileSynced, 1);
       RecordTick(stats_, WAL_FILE_SYNCED);
+      RecordInHistogram(stats_, WAL_SYNC_COALESCED_WRITES, write_group.size);
     }
     stats->AddDBStats(InternalStats::kIntStatsWalFileBytes, log_size);
     RecordTick(stats_, WAL_FILE_BYTES, log_size);
@@ -1127,10 +1216,11 @@ IOStatus DBImpl::ConcurrentWriteToWAL(
   assert(!write_group.leader->disable_wal);
   // Same holds for all in the batch group
   WriteBatch tmp_batch;
+  std::vector<Slice> wal_parts;
   size_t write_with_wal = 0;
   WriteBatch* to_be_cached_state = nullptr;
-  WriteBatch* merged_batch =
-      MergeBatch(write_group, &tmp_batch, &write_with_wal, &to_be_cached_state);
+  WriteBatch* merged_batch = MergeBatch(write_group, &tmp_batch, &wal_parts,
+                                        &write_with_wal, &to_be_cached_state);
 
   // We need to lock log_write_mutex_ since logs_ and alive_log_files might be
   // pushed back concurrently
@@ -1148,7 +1238,8 @@ IOStatus DBImpl::ConcurrentWriteToWAL(
 
   log::Writer* log_writer = logs_.back().writer;
   uint64_t log_size;
-  io_s = WriteToWAL(*merged_batch, log_writer, log_used, &log_size);
+  io_s = WriteToWAL(*merged_batch, log_writer, log_used, &log_size,
+                    &wal_parts);
   if (to_be_cached_state) {
     cached_recoverable_state_ = *to_be_cached_state;
     cached_recoverable_state_empty_ = false;
@@ -1357,6 +1448,12 @@ Status DBImpl::HandleWriteBufferFull(WriteContext* write_context) {
   autovector<ColumnFamilyData*> cfds;
   if (immutable_db_options_.atomic_flush) {
     SelectColumnFamiliesForAtomicFlush(&cfds);
+  } else if (immutable_db_options_.cost_based_write_buffer_flush) {
+    ColumnFamilyData* cfd_picked = PickColumnFamilyByFlushCost();
+    if (cfd_picked != nullptr) {
+      cfds.push_back(cfd_picked);
+    }
+    MaybeFlushStatsCF(&cfds);
   } else {
     ColumnFamilyData* cfd_picked = nullptr;
     SequenceNumber seq_num_for_cf_picked = kMaxSequenceNumber;
@@ -1415,6 +1512,90 @@ Status DBImpl::HandleWriteBufferFull(WriteContext* write_context) {
   return status;
 }
 
+ColumnFamilyData* DBImpl::PickColumnFamilyByFlushCost() {
+  mutex_.AssertHeld();
+  // Charged to every flush so that tiny memtables are not flushed one after
+  // another into tiny L0 files.
+  static const double kFlushFileOverheadBytes = 64 << 10;
+  struct Candidate {
+    ColumnFamilyData* cfd;
+    double freed;
+    double fill_rate;
+  };
+  autovector<Candidate> candidates;
+  int64_t now = 0;
+  if (!env_->GetCurrentTime(&now).ok()) {
+    now = 0;
+  }
+  double total_fill_rate = 0;
+  for (auto cfd : *versions_->GetColumnFamilySet()) {
+    if (cfd->IsDropped() || cfd->mem()->IsEmpty()) {
+      continue;
+    }
+    // We only consider active mem table, hoping immutable memtable is
+    // already in the process of flushing.
+    MemTable* mem = cfd->mem();
+    double freed = static_cast<double>(mem->ApproximateMemoryUsageFast());
+    uint64_t oldest_key_time = mem->ApproximateOldestKeyTime();
+    uint64_t age = 1;
+    if (oldest_key_time != port::kMaxUint64 &&
+        static_cast<uint64_t>(now) > oldest_key_time) {
+      age = static_cast<uint64_t>(now) - oldest_key_time;
+    }
+    double fill_rate = freed / age;
+    total_fill_rate += fill_rate;
+    candidates.push_back({cfd, freed, fill_rate});
+  }
+
+  // Time until the whole write buffer is refilled at the current write rate.
+  // A column family that refills its memtable faster than that gives its
+  // memory back only for part of the time, so its benefit is discounted.
+  double refill_time =
+      total_fill_rate > 0
+          ? static_cast<double>(write_buffer_manager_->buffer_size()) /
+                total_fill_rate
+          : 0;
+  ColumnFamilyData* cfd_picked = nullptr;
+  double best_score = 0;
+  SequenceNumber seq_num_for_cf_picked = kMaxSequenceNumber;
+  for (const auto& c : candidates) {
+    double benefit = c.freed;
+    if (refill_time > 0 && c.fill_rate > 0) {
+      benefit *= std::min(1.0, (c.freed / c.fill_rate) / refill_time);
+    }
+    // Bytes written by the flush, plus a fixed overhead for the L0 file it
+    // creates, plus this flush's share of the L0->L1 compaction it
+    // eventually triggers.
+    double cost =
+        c.freed * c.cfd->flush_output_ratio() + kFlushFileOverheadBytes;
+    const ImmutableCFOptions* ioptions = c.cfd->ioptions();
+    VersionStorageInfo* vstorage = c.cfd->current()->storage_info();
+    if (ioptions->compaction_style == kCompactionStyleLevel &&
+        vstorage->base_level() > 0) {
+      int trigger = std::max(
+          1, c.cfd->GetLatestMutableCFOptions()
+                 ->level0_file_num_compaction_trigger);
+      cost += static_cast<double>(
+                  vstorage->NumLevelBytes(vstorage->base_level())) /
+              trigger;
+    }
+    double score = benefit / cost;
+    SequenceNumber seq = c.cfd->mem()->GetCreationSeq();
+    if (cfd_picked == nullptr || score > best_score ||
+        (score == best_score && seq < seq_num_for_cf_picked)) {
+      cfd_picked = c.cfd;
+      best_score = score;
+      seq_num_for_cf_picked = seq;
+    }
+  }
+  if (cfd_picked != nullptr) {
+    ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                   "[%s] Picked for flush by cost, score %.4f",
+                   cfd_picked->GetName().c_str(), best_score);
+  }
+  return cfd_picked;
+}
+
 uint64_t DBImpl::GetMaxTotalWalSize() const {
   mutex_.AssertHeld();
   return mutable_db_options_.max_total_wal_size == 0
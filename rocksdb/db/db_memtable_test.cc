@@ -331,6 +331,162 @@ TEST_F(DBMemTableTest, ColumnFamilyId) {
   }
 }
 
+TEST_F(DBMemTableTest, HashIndexGet) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.memtable_hash_index_size_ratio = 0.01;
+  options.merge_operator = MergeOperators::CreateStringAppendOperator();
+  DestroyAndReopen(options);
+
+  ASSERT_OK(Put("put", "v1"));
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ASSERT_OK(Put("put", "v2"));
+  ASSERT_OK(Put("deleted", "v1"));
+  ASSERT_OK(Delete("deleted"));
+  ASSERT_OK(Put("single_deleted", "v1"));
+  ASSERT_OK(SingleDelete("single_deleted"));
+  ASSERT_OK(Put("merged", "v1"));
+  ASSERT_OK(Merge("merged", "v2"));
+  ASSERT_OK(Put("range_deleted", "v1"));
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             "range_deleted", "range_deleted0"));
+
+  SetPerfLevel(kEnableCount);
+  get_perf_context()->Reset();
+  // Answered by the index
+  ASSERT_EQ("v2", Get("put"));
+  ASSERT_EQ("NOT_FOUND", Get("deleted"));
+  ASSERT_EQ("NOT_FOUND", Get("single_deleted"));
+  ASSERT_EQ("NOT_FOUND", Get("range_deleted"));
+  ASSERT_EQ("NOT_FOUND", Get("missing"));
+  ASSERT_EQ(5, get_perf_context()->memtable_hash_index_hit_count);
+  ASSERT_EQ(0, get_perf_context()->memtable_hash_index_miss_count);
+
+  // Need older entries
+  ASSERT_EQ("v1", Get("put", snapshot));
+  ASSERT_EQ("v1,v2", Get("merged"));
+  ASSERT_EQ(5, get_perf_context()->memtable_hash_index_hit_count);
+  ASSERT_EQ(2, get_perf_context()->memtable_hash_index_miss_count);
+  SetPerfLevel(kDisable);
+
+  // A new memtable gets a new index
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put("put", "v3"));
+  ASSERT_EQ("v3", Get("put"));
+  ASSERT_EQ("v1", Get("put", snapshot));
+  ASSERT_EQ("v1,v2", Get("merged"));
+  db_->ReleaseSnapshot(snapshot);
+}
+
+TEST_F(DBMemTableTest, HashIndexConcurrentInsert) {
+  const int kNumThreads = 4;
+  const int kNumKeys = 100;
+  const int kNumRounds = 50;
+  Options options;
+  options.memtable_hash_index_size_ratio = 0.001;
+  options.allow_concurrent_memtable_write = true;
+  InternalKeyComparator cmp(BytewiseComparator());
+  ImmutableCFOptions ioptions(options);
+  WriteBufferManager wb(options.db_write_buffer_size);
+  MemTable* mem = new MemTable(cmp, ioptions, MutableCFOptions(options), &wb,
+                               kMaxSequenceNumber, 0 /* column_family_id */);
+
+  // Each thread writes every key once per round, with the sequence numbers of
+  // the threads interleaved, so the newest entry of each key comes from the
+  // last thread of the last round whatever the order of the inserts.
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumThreads; t++) {
+    threads.emplace_back([&, t]() {
+      MemTablePostProcessInfo post_process_info;
+      for (int round = 0; round < kNumRounds; round++) {
+        for (int k = 0; k < kNumKeys; k++) {
+          SequenceNumber seq =
+              1 + (static_cast<SequenceNumber>(round) * kNumKeys + k) *
+                      kNumThreads +
+              t;
+          ASSERT_TRUE(mem->Add(seq, kTypeValue, Key(k), ToString(seq),
+                               true /* allow_concurrent */,
+                               &post_process_info));
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (int k = 0; k < kNumKeys; k++) {
+    std::string value;
+    Status status;
+    MergeContext merge_context;
+    SequenceNumber max_covering_tombstone_seq = 0;
+    LookupKey lkey(Key(k), kMaxSequenceNumber);
+    ASSERT_TRUE(mem->Get(lkey, &value, /*timestamp=*/nullptr, &status,
+                         &merge_context, &max_covering_tombstone_seq,
+                         ReadOptions()));
+    ASSERT_OK(status);
+    SequenceNumber newest =
+        1 + (static_cast<SequenceNumber>(kNumRounds - 1) * kNumKeys + k) *
+                kNumThreads +
+        kNumThreads - 1;
+    ASSERT_EQ(ToString(newest), value);
+  }
+
+  delete mem;
+}
+
+TEST_F(DBMemTableTest, MemTableGarbageCollection) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.write_buffer_size = 64 << 10;
+  options.memtable_gc_min_garbage_ratio = 0.5;
+  DestroyAndReopen(options);
+
+  ASSERT_OK(Put("key0", "first"));
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ASSERT_OK(Put("deleted", "v1"));
+  ASSERT_OK(Delete("deleted"));
+
+  // Overwrite ten keys with many memtables worth of data
+  Random rnd(301);
+  std::vector<std::string> values(10);
+  for (int i = 0; i < 1000; ++i) {
+    values[i % 10] = rnd.RandomString(1000);
+    ASSERT_OK(Put("key" + ToString(i % 10), values[i % 10]));
+  }
+  // The copies stay in the memtable list, so wait for the flush threads
+  // rather than for the memtables to be flushed
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  // The obsolete versions were dropped instead of flushed
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_EQ(values[i], Get("key" + ToString(i)));
+  }
+  ASSERT_EQ("first", Get("key0", snapshot));
+  ASSERT_EQ("NOT_FOUND", Get("deleted"));
+
+#ifndef ROCKSDB_LITE
+  auto cfd = static_cast_with_check<ColumnFamilyHandleImpl>(
+                 db_->DefaultColumnFamily())
+                 ->cfd();
+  const uint64_t* cf_stats_value =
+      cfd->internal_stats()->TEST_GetCFStatsValue();
+  ASSERT_GT(cf_stats_value[InternalStats::MEMTABLE_GC_DROPPED_BYTES], 0);
+  ASSERT_GT(cf_stats_value[InternalStats::MEMTABLE_GC_INPUT_BYTES],
+            cf_stats_value[InternalStats::MEMTABLE_GC_DROPPED_BYTES]);
+#endif  // ROCKSDB_LITE
+
+  // The live data is still flushed when asked to
+  ASSERT_OK(Flush());
+  ASSERT_EQ(1, NumTableFilesAtLevel(0));
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_EQ(values[i], Get("key" + ToString(i)));
+  }
+  ASSERT_EQ("first", Get("key0", snapshot));
+  ASSERT_EQ("NOT_FOUND", Get("deleted"));
+  db_->ReleaseSnapshot(snapshot);
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -163,6 +163,56 @@ TEST_F(DBMergeOperatorTest, MergeErrorOnWrite) {
   VerifyDBInternal({{"k1", "corrupted"}, {"k1", "v2"}, {"k1", "v1"}});
 }
 
+TEST_F(DBMergeOperatorTest, InplaceMerge) {
+  Options options;
+  options.create_if_missing = true;
+  options.merge_operator = MergeOperators::CreateUInt64AddOperator();
+  options.inplace_update_support = true;
+  options.inplace_merge_support = true;
+  options.allow_concurrent_memtable_write = false;
+  options.env = env_;
+  Reopen(options);
+
+  std::string one, ten, eleven;
+  PutFixed64(&one, 1);
+  PutFixed64(&ten, 10);
+  PutFixed64(&eleven, 11);
+  // Operands are folded into the first operand
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_OK(Merge("counter", one));
+  }
+  // Operands are applied to the value
+  ASSERT_OK(Put("value", one));
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_OK(Merge("value", one));
+  }
+  VerifyDBInternal({{"counter", ten}, {"value", eleven}});
+  ASSERT_EQ(ten, Get("counter"));
+  ASSERT_EQ(eleven, Get("value"));
+
+  // Operands in a new memtable are folded separately
+  ASSERT_OK(Flush());
+  ASSERT_OK(Merge("counter", one));
+  ASSERT_OK(Merge("counter", one));
+  ASSERT_EQ(12U, DecodeFixed64(Get("counter").data()));
+
+  // An operand is not folded into a value a range deletion may cover
+  ASSERT_OK(Put("deleted", ten));
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             "deleted", "deleted0"));
+  ASSERT_OK(Merge("deleted", one));
+  ASSERT_EQ(one, Get("deleted"));
+
+  // Operators that do not declare themselves associative and commutative
+  // append operands as usual
+  options.merge_operator = MergeOperators::CreateStringAppendOperator();
+  DestroyAndReopen(options);
+  ASSERT_OK(Merge("k1", "a"));
+  ASSERT_OK(Merge("k1", "b"));
+  VerifyDBInternal({{"k1", "b"}, {"k1", "a"}});
+  ASSERT_EQ("a,b", Get("k1"));
+}
+
 TEST_F(DBMergeOperatorTest, MergeErrorOnIteration) {
   Options options;
   options.create_if_missing = true;
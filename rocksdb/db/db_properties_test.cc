@@ -612,6 +612,54 @@ TEST_F(DBPropertiesTest, AggregatedTablePropertiesAtLevel) {
   }
 }
 
+TEST_F(DBPropertiesTest, WriteStageStats) {
+  Options options = CurrentOptions();
+  std::map<std::string, std::string> stats;
+  std::string value;
+  Reopen(options);
+  // Requires statistics
+  ASSERT_FALSE(db_->GetMapProperty(DB::Properties::kWriteStageStats, &stats));
+  ASSERT_FALSE(db_->GetProperty(DB::Properties::kWriteStageStats, &value));
+
+  options.statistics = CreateDBStatistics();
+  options.statistics->set_stats_level(StatsLevel::kAll);
+  Reopen(options);
+  const int kThreads = 4;
+  const int kWritesPerThread = 100;
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < kWritesPerThread; i++) {
+        ASSERT_OK(Put(Key(t * kWritesPerThread + i), "v"));
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  ASSERT_TRUE(db_->GetMapProperty(DB::Properties::kWriteStageStats, &stats));
+  ASSERT_EQ(ToString(kThreads * kWritesPerThread), stats["write.count"]);
+  // Each write group was formed, written to the WAL and to the memtable once
+  uint64_t groups = ParseUint64(stats["group_formation.count"]);
+  ASSERT_GT(groups, 0U);
+  ASSERT_LE(groups, static_cast<uint64_t>(kThreads * kWritesPerThread));
+  ASSERT_EQ(ToString(groups), stats["wal.count"]);
+  ASSERT_GE(ParseUint64(stats["memtable.count"]), groups);
+  // No write was synced
+  ASSERT_EQ("0", stats["wal_sync.count"]);
+  for (const char* stage : {"join_wait", "memtable_barrier_wait", "spin",
+                            "yield", "block"}) {
+    for (const char* stat : {"count", "sum", "avg", "p50", "p95", "p99",
+                             "max"}) {
+      ASSERT_EQ(1U, stats.count(std::string(stage) + "." + stat));
+    }
+  }
+
+  ASSERT_TRUE(db_->GetProperty(DB::Properties::kWriteStageStats, &value));
+  ASSERT_NE(std::string::npos, value.find("group_formation"));
+}
+
 TEST_F(DBPropertiesTest, NumImmutableMemTable) {
   do {
     Options options = CurrentOptions();
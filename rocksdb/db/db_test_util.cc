@@ -137,7 +137,7 @@ bool DBTestBase::ShouldSkipOptions(int option_config, int skip_mask) {
         option_config == kUniversalCompactionMultiLevel ||
         option_config == kUniversalSubcompactions ||
         option_config == kFIFOCompaction ||
-        option_config == kConcurrentSkipList) {
+        option_config == kConcurrentSkipList || option_config == kBTreeRep) {
       return true;
     }
 #endif
@@ -403,6 +403,10 @@ Options DBTestBase::GetOptions(
       options.allow_concurrent_memtable_write = false;
       options.unordered_write = false;
       break;
+    case kBTreeRep:
+      options.memtable_factory.reset(new BTreeRepFactory());
+      options.allow_concurrent_memtable_write = true;
+      break;
     case kHashLinkList:
       options.prefix_extractor.reset(NewFixedPrefixTransform(1));
       options.memtable_factory.reset(
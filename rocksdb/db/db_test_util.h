@@ -822,6 +822,12 @@ class CacheWrapper : public Cache {
     target_->ApplyToAllCacheEntries(callback, thread_safe);
   }
 
+  void ApplyToAllCacheKeys(
+      const std::function<void(const Slice& key, bool hit)>& callback,
+      bool thread_safe) override {
+    target_->ApplyToAllCacheKeys(callback, thread_safe);
+  }
+
   void EraseUnRefEntries() override { target_->EraseUnRefEntries(); }
 
  protected:
@@ -872,6 +878,7 @@ class DBTestBase : public testing::Test {
     kUniversalSubcompactions,
     kxxHash64Checksum,
     kUnorderedWrite,
+    kBTreeRep,
     // This must be the last line
     kEnd,
   };
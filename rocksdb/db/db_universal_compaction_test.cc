@@ -1971,6 +1971,73 @@ TEST_F(DBTestUniversalCompaction2, SingleLevel) {
 }
 #endif  // ENABLE_SINGLE_LEVEL_DTC
 
+TEST_F(DBTestUniversalCompaction2, SingleLevelSubcompactions) {
+  Options opts = CurrentOptions();
+  opts.compaction_style = kCompactionStyleUniversal;
+  opts.num_levels = 1;
+  opts.level0_file_num_compaction_trigger = 4;
+  opts.compression = kNoCompression;
+  opts.max_subcompactions = 4;
+  opts.enable_l0_subcompactions = true;
+  opts.target_file_size_base = 64 << 10;
+  opts.force_consistency_checks = true;
+  Reopen(opts);
+
+  const int kNumKeys = 2000;
+  Random rnd(301);
+  std::vector<std::string> values(kNumKeys);
+  for (int i = 0; i < kNumKeys; i++) {
+    values[i] = rnd.RandomString(200);
+    ASSERT_OK(Put(Key(i), values[i]));
+  }
+  ASSERT_OK(Flush());
+  // Keep the range tombstone and the keys it covers, so that the tombstone is
+  // split across the subcompactions
+  const Snapshot* snapshot = db_->GetSnapshot();
+  for (int i = 0; i < kNumKeys; i += 2) {
+    values[i] = rnd.RandomString(200);
+    ASSERT_OK(Put(Key(i), values[i]));
+  }
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             Key(900), Key(1100)));
+  ASSERT_OK(Flush());
+
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+
+  // The output files form a single sorted run, so they don't trigger
+  // another compaction
+  std::vector<LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  ASSERT_EQ(4U, files.size());
+  for (const auto& f : files) {
+    ASSERT_EQ(0, f.level);
+    ASSERT_EQ(files[0].smallest_seqno, f.smallest_seqno);
+    ASSERT_EQ(files[0].largest_seqno, f.largest_seqno);
+  }
+
+  auto verify = [&]() {
+    for (int i = 0; i < kNumKeys; i++) {
+      if (i >= 900 && i < 1100) {
+        ASSERT_EQ("NOT_FOUND", Get(Key(i)));
+      } else {
+        ASSERT_EQ(values[i], Get(Key(i)));
+      }
+    }
+  };
+  verify();
+  Reopen(opts);
+  verify();
+
+  // A newer file is merged with the whole sorted run
+  db_->ReleaseSnapshot(snapshot);
+  ASSERT_OK(Put(Key(kNumKeys), "v"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  verify();
+  ASSERT_EQ("v", Get(Key(kNumKeys)));
+}
+
 TEST_F(DBTestUniversalCompaction2, MultipleLevels) {
   const int kWindowSize = 100;
   const int kNumDelsTrigger = 90;
@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "db/db_test_util.h"
+#include "db/wal_sync_coalescer.h"
 #include "db/write_batch_internal.h"
 #include "db/write_thread.h"
 #include "port/port.h"
@@ -441,6 +442,163 @@ TEST_P(DBWriteTest, ConcurrentlyDisabledWAL) {
     ASSERT_LE(bytes_num, 1024 * 100);
 }
 
+TEST_P(DBWriteTest, SortedMemtableInsert) {
+  Options options = GetOptions();
+  options.merge_operator = MergeOperators::CreateStringAppendOperator();
+  Reopen(options);
+  WriteOptions write_options;
+  write_options.memtable_insert_sort_threshold = 8;
+
+  ASSERT_OK(Put("del", "v0"));
+  ASSERT_OK(Put("sdel", "v0"));
+  const SequenceNumber seq = db_->GetLatestSequenceNumber();
+
+  // Keys in reverse order, with overwrites of the same key in the batch
+  WriteBatch batch;
+  for (int i = 99; i >= 0; i--) {
+    ASSERT_OK(batch.Put(Key(i), "a" + ToString(i)));
+  }
+  for (int i = 0; i < 100; i += 2) {
+    ASSERT_OK(batch.Put(Key(i), "b" + ToString(i)));
+  }
+  ASSERT_OK(batch.Delete("del"));
+  ASSERT_OK(batch.SingleDelete("sdel"));
+  ASSERT_OK(batch.Put("del", "v1"));
+  ASSERT_OK(db_->Write(write_options, &batch));
+  ASSERT_EQ(seq + batch.Count(), db_->GetLatestSequenceNumber());
+
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ((i % 2 == 0 ? "b" : "a") + ToString(i), Get(Key(i)));
+  }
+  ASSERT_EQ("v1", Get("del"));
+  ASSERT_EQ("NOT_FOUND", Get("sdel"));
+
+  // A batch with a merge is inserted in order
+  WriteBatch merge_batch;
+  for (int i = 0; i < 10; i++) {
+    ASSERT_OK(merge_batch.Merge("merge", ToString(i)));
+  }
+  ASSERT_OK(db_->Write(write_options, &merge_batch));
+  ASSERT_EQ("0,1,2,3,4,5,6,7,8,9", Get("merge"));
+
+  Reopen(options);
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ((i % 2 == 0 ? "b" : "a") + ToString(i), Get(Key(i)));
+  }
+  ASSERT_EQ("v1", Get("del"));
+  ASSERT_EQ("0,1,2,3,4,5,6,7,8,9", Get("merge"));
+}
+
+TEST_P(DBWriteTest, WalStagingBuffers) {
+  Options options = GetOptions();
+  options.enable_pipelined_write = false;
+  options.unordered_write = false;
+  options.enable_wal_staging_buffers = true;
+  ASSERT_TRUE(TryReopen(options).IsInvalidArgument());
+
+  options.unordered_write = true;
+  Reopen(options);
+  const int kThreads = 8;
+  const int kKeysPerThread = 500;
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([&, t] {
+      WriteOptions write_options;
+      for (int i = 0; i < kKeysPerThread; i++) {
+        write_options.sync = (i % 100 == 0);
+        WriteBatch batch;
+        ASSERT_OK(batch.Put(Key(t * kKeysPerThread + i), ToString(i)));
+        ASSERT_OK(batch.Put("t" + ToString(t), ToString(i)));
+        ASSERT_OK(db_->Write(write_options, &batch));
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  ASSERT_EQ(static_cast<SequenceNumber>(kThreads * kKeysPerThread * 2),
+            db_->GetLatestSequenceNumber());
+
+  for (int reopen = 0; reopen < 2; reopen++) {
+    for (int t = 0; t < kThreads; t++) {
+      for (int i = 0; i < kKeysPerThread; i++) {
+        ASSERT_EQ(ToString(i), Get(Key(t * kKeysPerThread + i)));
+      }
+      ASSERT_EQ(ToString(kKeysPerThread - 1), Get("t" + ToString(t)));
+    }
+    // The staged records are recovered from the WAL
+    Reopen(options);
+  }
+}
+
+TEST_P(DBWriteTest, WalSyncCoalescing) {
+  Options options = GetOptions();
+  options.statistics = CreateDBStatistics();
+  options.wal_sync_coalescing_max_wait_us = 1000;
+  Reopen(options);
+  const int kThreads = 8;
+  const int kKeysPerThread = 50;
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([&, t] {
+      WriteOptions write_options;
+      write_options.sync = true;
+      for (int i = 0; i < kKeysPerThread; i++) {
+        ASSERT_OK(db_->Put(write_options, Key(t * kKeysPerThread + i),
+                           ToString(i)));
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  HistogramData coalesced;
+  options.statistics->histogramData(WAL_SYNC_COALESCED_WRITES, &coalesced);
+  if (!options.two_write_queues) {
+    // Every write was synced, by exactly one sync
+    ASSERT_EQ(static_cast<uint64_t>(kThreads * kKeysPerThread), coalesced.sum);
+    ASSERT_EQ(options.statistics->getTickerCount(WAL_FILE_SYNCED),
+              coalesced.count);
+  }
+
+  Reopen(options);
+  for (int i = 0; i < kThreads * kKeysPerThread; i++) {
+    ASSERT_EQ(ToString(i % kKeysPerThread), Get(Key(i)));
+  }
+}
+
+TEST(WalSyncCoalescerTest, AdaptsWait) {
+  WalSyncCoalescer coalescer(100);
+  // No wait before the sync latency is known, or while syncs are not shared
+  ASSERT_EQ(0U, coalescer.WaitMicros());
+  coalescer.RecordSync(1000, 1);
+  ASSERT_EQ(1000U, coalescer.TEST_avg_sync_micros());
+  ASSERT_EQ(0U, coalescer.WaitMicros());
+
+  // A shared sync starts probing, gathering writers grows the wait
+  coalescer.RecordSync(1000, 4);
+  ASSERT_EQ(12U, coalescer.WaitMicros());
+  coalescer.RecordWait(true);
+  ASSERT_EQ(24U, coalescer.WaitMicros());
+  for (int i = 0; i < 10; i++) {
+    coalescer.RecordWait(true);
+  }
+  // Bounded by the max wait
+  ASSERT_EQ(100U, coalescer.WaitMicros());
+
+  // Waiting in vain shrinks it
+  coalescer.RecordWait(false);
+  ASSERT_EQ(50U, coalescer.WaitMicros());
+
+  // Bounded by half of the sync latency
+  for (int i = 0; i < 100; i++) {
+    coalescer.RecordSync(40, 2);
+  }
+  ASSERT_EQ(40U, coalescer.TEST_avg_sync_micros());
+  ASSERT_EQ(20U, coalescer.WaitMicros());
+}
+
 INSTANTIATE_TEST_CASE_P(DBWriteTestInstance, DBWriteTest,
                         testing::Values(DBTestBase::kDefault,
                                         DBTestBase::kConcurrentWALWrites,
@@ -38,7 +38,9 @@ TEST_F(FileNameTest, Parse) {
         {"100.log", 100, kLogFile, kAllMode},
         {"0.log", 0, kLogFile, kAllMode},
         {"0.sst", 0, kTableFile, kAllMode},
+        {"100.heat", 100, kTableHeatFile, kAllMode},
         {"CURRENT", 0, kCurrentFile, kAllMode},
+        {"BLOCK_CACHE_MANIFEST", 0, kBlockCacheManifestFile, kAllMode},
         {"LOCK", 0, kDBLockFile, kAllMode},
         {"MANIFEST-2", 2, kDescriptorFile, kAllMode},
         {"MANIFEST-7", 7, kDescriptorFile, kAllMode},
@@ -15,6 +15,7 @@
 #include <vector>
 
 #include "db/builder.h"
+#include "db/compaction/compaction_iterator.h"
 #include "db/db_iter.h"
 #include "db/dbformat.h"
 #include "db/event_helpers.h"
@@ -23,6 +24,8 @@
 #include "db/memtable.h"
 #include "db/memtable_list.h"
 #include "db/merge_context.h"
+#include "db/merge_helper.h"
+#include "db/range_del_aggregator.h"
 #include "db/range_tombstone_fragmenter.h"
 #include "db/version_set.h"
 #include "file/file_util.h"
@@ -122,6 +125,7 @@ FlushJob::FlushJob(
       edit_(nullptr),
       base_(nullptr),
       pick_memtable_called(false),
+      flush_requested_(false),
       thread_pri_(thread_pri),
       io_tracer_(io_tracer) {
   // Update the thread status to indicate flush.
@@ -165,6 +169,7 @@ void FlushJob::PickMemTable() {
   db_mutex_->AssertHeld();
   assert(!pick_memtable_called);
   pick_memtable_called = true;
+  flush_requested_ = cfd_->imm()->HasFlushRequested();
   // Save the contents of the earliest memtable as a new Table
   cfd_->imm()->PickMemtablesToFlush(max_memtable_id_, &mems_);
   if (mems_.empty()) {
@@ -223,8 +228,15 @@ Status FlushJob::Run(LogsWithPrepTracker* prep_tracker,
     prev_cpu_read_nanos = IOSTATS(cpu_read_nanos);
   }
 
-  // This will release and re-acquire the mutex.
-  Status s = WriteLevel0Table();
+  // These will release and re-acquire the mutex.
+  bool collected = false;
+  Status s = CollectMemTableGarbage(&collected);
+  if (collected) {
+    // The memtables now live on as their copy in the memtable list
+    base_->Unref();
+    return s;
+  }
+  s = WriteLevel0Table();
 
   if (s.ok() && cfd_->IsDropped()) {
     s = Status::ColumnFamilyDropped("Column family dropped during compaction");
@@ -310,6 +322,7 @@ Status FlushJob::WriteLevel0Table() {
   Status s;
 
   std::vector<BlobFileAddition> blob_file_additions;
+  size_t total_memory_usage = 0;
 
   {
     auto write_hint = cfd_->CalculateSSTWriteHint(0);
@@ -328,7 +341,6 @@ Status FlushJob::WriteLevel0Table() {
     Arena arena;
     uint64_t total_num_entries = 0, total_num_deletes = 0;
     uint64_t total_data_size = 0;
-    size_t total_memory_usage = 0;
     for (MemTable* m : mems_) {
       ROCKS_LOG_INFO(
           db_options_.info_log,
@@ -474,6 +486,10 @@ Status FlushJob::WriteLevel0Table() {
     }
 
     stats.num_output_files = static_cast<int>(blobs.size()) + 1;
+
+    if (s.ok()) {
+      cfd_->RecordFlushOutputRatio(total_memory_usage, stats.bytes_written);
+    }
   }
 
   RecordTimeToHistogram(stats_, FLUSH_TIME, stats.micros);
@@ -484,6 +500,126 @@ Status FlushJob::WriteLevel0Table() {
   return s;
 }
 
+Status FlushJob::CollectMemTableGarbage(bool* collected) {
+  db_mutex_->AssertHeld();
+  assert(collected != nullptr);
+  *collected = false;
+  const double min_garbage_ratio =
+      mutable_cf_options_.memtable_gc_min_garbage_ratio;
+  const ImmutableCFOptions* ioptions = cfd_->ioptions();
+  // Only memtables that were switched for being full are collected; other
+  // flushes are asked for to release memory or WAL files, or to persist the
+  // data. The copy is inserted in key order rather than sequence number
+  // order, which only the concurrent insert path of the memtable supports.
+  // Range tombstones, prepared transactions and snapshot checkers would need
+  // more than the compaction iterator to be preserved, so these are flushed.
+  if (min_garbage_ratio <= 0 || !write_manifest_ || flush_requested_ ||
+      cfd_->GetFlushReason() != FlushReason::kWriteBufferFull ||
+      db_options_.allow_2pc || snapshot_checker_ != nullptr ||
+      !ioptions->memtable_factory->IsInsertConcurrentlySupported() ||
+      cfd_->user_comparator()->timestamp_size() > 0) {
+    return Status::OK();
+  }
+  ReadOptions ro;
+  ro.total_order_seek = true;
+  uint64_t input_bytes = 0;
+  for (MemTable* m : mems_) {
+    std::unique_ptr<FragmentedRangeTombstoneIterator> range_del_iter(
+        m->NewRangeTombstoneIterator(ro, kMaxSequenceNumber));
+    if (range_del_iter != nullptr) {
+      return Status::OK();
+    }
+    input_bytes += m->get_data_size();
+  }
+  if (!cfd_->ShouldTryMemTableGC()) {
+    return Status::OK();
+  }
+
+  MemTable* new_mem = cfd_->ConstructNewMemtable(
+      mutable_cf_options_, mems_.front()->GetEarliestSequenceNumber());
+  const uint64_t start_micros = db_options_.env->NowMicros();
+  db_mutex_->Unlock();
+  Status s;
+  {
+    Arena arena;
+    std::vector<InternalIterator*> memtables;
+    for (MemTable* m : mems_) {
+      memtables.push_back(m->NewIterator(ro, &arena));
+    }
+    ScopedArenaIterator iter(
+        NewMergingIterator(&cfd_->internal_comparator(), &memtables[0],
+                           static_cast<int>(memtables.size()), &arena));
+    MergeHelper merge(db_options_.env, cfd_->user_comparator(),
+                      ioptions->merge_operator,
+                      nullptr /* compaction_filter */, ioptions->info_log,
+                      true /* internal key corruption is not ok */,
+                      existing_snapshots_.empty() ? 0
+                                                  : existing_snapshots_.back());
+    CompactionRangeDelAggregator range_del_agg(&cfd_->internal_comparator(),
+                                               existing_snapshots_);
+    CompactionIterator c_iter(
+        iter.get(), cfd_->user_comparator(), &merge, kMaxSequenceNumber,
+        &existing_snapshots_, earliest_write_conflict_snapshot_,
+        nullptr /* snapshot_checker */, db_options_.env,
+        false /* report_detailed_time */,
+        true /* internal key corruption is not ok */, &range_del_agg,
+        nullptr /* blob_file_builder */, ioptions->allow_data_in_errors);
+    MemTablePostProcessInfo post_process_info;
+    for (c_iter.SeekToFirst(); c_iter.Valid(); c_iter.Next()) {
+      const ParsedInternalKey& ikey = c_iter.ikey();
+      if (!new_mem->Add(ikey.sequence, ikey.type, ikey.user_key,
+                        c_iter.value(), true /* allow_concurrent */,
+                        &post_process_info)) {
+        s = Status::Corruption("Duplicate entry in memtable",
+                               ikey.user_key.ToString(true));
+        break;
+      }
+    }
+    if (s.ok()) {
+      s = c_iter.status();
+    }
+    new_mem->BatchPostProcess(post_process_info);
+  }
+  const uint64_t output_bytes = new_mem->get_data_size();
+  db_mutex_->Lock();
+
+  if (!s.ok() || static_cast<double>(output_bytes) >
+                     static_cast<double>(input_bytes) * (1 - min_garbage_ratio)) {
+    if (!s.ok()) {
+      // Leave the error to the flush of the memtables
+      ROCKS_LOG_WARN(db_options_.info_log, "[%s] Memtable GC failed: %s",
+                     cfd_->GetName().c_str(), s.ToString().c_str());
+    }
+    delete new_mem;
+    cfd_->RecordMemTableGCResult(false);
+    return Status::OK();
+  }
+  new_mem->SetID(mems_.back()->GetID());
+  new_mem->SetNextLogNumber(mems_.back()->GetNextLogNumber());
+  new_mem->SetCreationSeq(mems_.front()->GetCreationSeq());
+  if (!cfd_->imm()->TryReplaceFlushedMemTables(
+          mems_, new_mem, &job_context_->memtables_to_free)) {
+    // A concurrent flush of newer memtables is waiting for these
+    delete new_mem;
+    return Status::OK();
+  }
+
+  cfd_->RecordMemTableGCResult(true);
+  cfd_->internal_stats()->AddCFStats(InternalStats::MEMTABLE_GC_INPUT_BYTES,
+                                     input_bytes);
+  cfd_->internal_stats()->AddCFStats(InternalStats::MEMTABLE_GC_DROPPED_BYTES,
+                                     input_bytes - output_bytes);
+  ROCKS_LOG_BUFFER(log_buffer_,
+                   "[%s] [JOB %d] Memtable GC kept %" PRIu64 " of %" PRIu64
+                   " bytes of %zu memtables in %" PRIu64
+                   " us instead of flushing",
+                   cfd_->GetName().c_str(), job_context_->job_id, output_bytes,
+                   input_bytes, mems_.size(),
+                   db_options_.env->NowMicros() - start_micros);
+  *collected = true;
+  return Status::OK();
+}
+
 #ifndef ROCKSDB_LITE
 std::unique_ptr<FlushJobInfo> FlushJob::GetFlushJobInfo() const {
   db_mutex_->AssertHeld();
@@ -100,6 +100,11 @@ class FlushJob {
   void ReportFlushInputSize(const autovector<MemTable*>& mems);
   void RecordFlushIOStats();
   Status WriteLevel0Table();
+  // Copies the live data of the picked memtables into a new memtable, see
+  // memtable_gc_min_garbage_ratio. If enough was dropped, the copy replaces
+  // them in the memtable list, *collected is set to true and nothing has to
+  // be written. Releases and re-acquires the db mutex.
+  Status CollectMemTableGarbage(bool* collected);
 #ifndef ROCKSDB_LITE
   std::unique_ptr<FlushJobInfo> GetFlushJobInfo() const;
 #endif  // !ROCKSDB_LITE
@@ -160,6 +165,9 @@ class FlushJob {
   VersionEdit* edit_;
   Version* base_;
   bool pick_memtable_called;
+  // Whether the flush was explicitly requested, to free memory or to flush
+  // everything up to some memtable
+  bool flush_requested_;
   Env::Priority thread_pri_;
   IOStatus io_status_;
 
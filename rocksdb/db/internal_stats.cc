@@ -259,6 +259,7 @@ static const std::string block_cache_capacity = "block-cache-capacity";
 static const std::string block_cache_usage = "block-cache-usage";
 static const std::string block_cache_pinned_usage = "block-cache-pinned-usage";
 static const std::string options_statistics = "options-statistics";
+static const std::string write_stage_stats = "write-stage-stats";
 
 const std::string DB::Properties::kNumFilesAtLevelPrefix =
     rocksdb_prefix + num_files_at_level_prefix;
@@ -348,6 +349,8 @@ const std::string DB::Properties::kBlockCachePinnedUsage =
     rocksdb_prefix + block_cache_pinned_usage;
 const std::string DB::Properties::kOptionsStatistics =
     rocksdb_prefix + options_statistics;
+const std::string DB::Properties::kWriteStageStats =
+    rocksdb_prefix + write_stage_stats;
 
 const std::unordered_map<std::string, DBPropertyInfo>
     InternalStats::ppt_name_to_info = {
@@ -487,6 +490,9 @@ const std::unordered_map<std::string, DBPropertyInfo>
         {DB::Properties::kOptionsStatistics,
          {false, nullptr, nullptr, nullptr,
           &DBImpl::GetPropertyHandleOptionsStatistics}},
+        {DB::Properties::kWriteStageStats,
+         {false, &InternalStats::HandleWriteStageStats, nullptr,
+          &InternalStats::HandleWriteStageMapStats, nullptr}},
 };
 
 const DBPropertyInfo* GetPropertyInfo(const Slice& property) {
@@ -615,6 +621,66 @@ bool InternalStats::HandleDBStats(std::string* value, Slice /*suffix*/) {
   return true;
 }
 
+namespace {
+// Histograms of the write path stages and their names in
+// DB::Properties::kWriteStageStats
+const std::pair<Histograms, const char*> kWriteStages[] = {
+    {DB_WRITE, "write"},
+    {WRITE_THREAD_JOIN_WAIT_MICROS, "join_wait"},
+    {WRITE_GROUP_FORMATION_MICROS, "group_formation"},
+    {WRITE_WAL_MICROS, "wal"},
+    {WAL_FILE_SYNC_MICROS, "wal_sync"},
+    {WRITE_MEMTABLE_MICROS, "memtable"},
+    {WRITE_MEMTABLE_BARRIER_WAIT_MICROS, "memtable_barrier_wait"},
+    {WRITE_THREAD_SPIN_MICROS, "spin"},
+    {WRITE_THREAD_YIELD_MICROS, "yield"},
+    {WRITE_THREAD_BLOCK_MICROS, "block"},
+};
+}  // namespace
+
+bool InternalStats::HandleWriteStageMapStats(
+    std::map<std::string, std::string>* stage_stats) {
+  Statistics* statistics = cfd_->ioptions()->statistics;
+  if (statistics == nullptr) {
+    return false;
+  }
+  for (const auto& stage : kWriteStages) {
+    HistogramData data;
+    statistics->histogramData(stage.first, &data);
+    std::string prefix = std::string(stage.second) + ".";
+    (*stage_stats)[prefix + "count"] = ToString(data.count);
+    (*stage_stats)[prefix + "sum"] = ToString(data.sum);
+    (*stage_stats)[prefix + "avg"] = ToString(data.average);
+    (*stage_stats)[prefix + "p50"] = ToString(data.median);
+    (*stage_stats)[prefix + "p95"] = ToString(data.percentile95);
+    (*stage_stats)[prefix + "p99"] = ToString(data.percentile99);
+    (*stage_stats)[prefix + "max"] = ToString(data.max);
+  }
+  return true;
+}
+
+bool InternalStats::HandleWriteStageStats(std::string* value,
+                                          Slice /*suffix*/) {
+  Statistics* statistics = cfd_->ioptions()->statistics;
+  if (statistics == nullptr) {
+    return false;
+  }
+  char buf[200];
+  snprintf(buf, sizeof(buf), "%-22s %12s %10s %10s %10s %10s %10s\n",
+           "Stage (micros)", "Count", "Avg", "P50", "P95", "P99", "Max");
+  value->append(buf);
+  for (const auto& stage : kWriteStages) {
+    HistogramData data;
+    statistics->histogramData(stage.first, &data);
+    snprintf(buf, sizeof(buf),
+             "%-22s %12" PRIu64 " %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+             stage.second, data.count, data.average, data.median,
+             data.percentile95, data.percentile99, data.max);
+    value->append(buf);
+  }
+  return true;
+}
+
 bool InternalStats::HandleSsTables(std::string* value, Slice /*suffix*/) {
   auto* current = cfd_->current();
   *value = current->DebugString(true, true);
@@ -1306,6 +1372,13 @@ void InternalStats::DumpCFStatsNoFileHistogram(std::string* value) {
            ingest_keys_addfile, interval_ingest_keys_addfile);
   value->append(buf);
 
+  snprintf(buf, sizeof(buf),
+           "Memtable GC: %" PRIu64 " passes, %.3f GB input, %.3f GB dropped\n",
+           cf_stats_count_[MEMTABLE_GC_DROPPED_BYTES],
+           cf_stats_value_[MEMTABLE_GC_INPUT_BYTES] / kGB,
+           cf_stats_value_[MEMTABLE_GC_DROPPED_BYTES] / kGB);
+  value->append(buf);
+
   // Compact
   uint64_t compact_bytes_read = 0;
   uint64_t compact_bytes_write = 0;
@@ -105,6 +105,10 @@ class InternalStats {
     INGESTED_NUM_FILES_TOTAL,
     INGESTED_LEVEL0_NUM_FILES_TOTAL,
     INGESTED_NUM_KEYS_TOTAL,
+    // Memtable data collapsed by memtable_gc_min_garbage_ratio, and the part
+    // of it that was dropped and so never flushed
+    MEMTABLE_GC_INPUT_BYTES,
+    MEMTABLE_GC_DROPPED_BYTES,
     INTERNAL_CF_STATS_ENUM_MAX,
   };
 
@@ -526,10 +530,13 @@ class InternalStats {
   bool HandleLevelStats(std::string* value, Slice suffix);
   bool HandleStats(std::string* value, Slice suffix);
   bool HandleCFMapStats(std::map<std::string, std::string>* compaction_stats);
+  bool HandleWriteStageMapStats(
+      std::map<std::string, std::string>* stage_stats);
   bool HandleCFStats(std::string* value, Slice suffix);
   bool HandleCFStatsNoFileHistogram(std::string* value, Slice suffix);
   bool HandleCFFileHistogram(std::string* value, Slice suffix);
   bool HandleDBStats(std::string* value, Slice suffix);
+  bool HandleWriteStageStats(std::string* value, Slice suffix);
   bool HandleSsTables(std::string* value, Slice suffix);
   bool HandleAggregatedTableProperties(std::string* value, Slice suffix);
   bool HandleAggregatedTablePropertiesAtLevel(std::string* value, Slice suffix);
@@ -619,6 +626,10 @@ class InternalStats {
     INGESTED_NUM_FILES_TOTAL,
     INGESTED_LEVEL0_NUM_FILES_TOTAL,
     INGESTED_NUM_KEYS_TOTAL,
+    // Memtable data collapsed by memtable_gc_min_garbage_ratio, and the part
+    // of it that was dropped and so never flushed
+    MEMTABLE_GC_INPUT_BYTES,
+    MEMTABLE_GC_DROPPED_BYTES,
     INTERNAL_CF_STATS_ENUM_MAX,
   };
 
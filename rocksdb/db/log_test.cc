@@ -194,6 +194,10 @@ class LogTest : public ::testing::TestWithParam<std::tuple<int, bool>> {
     writer_.AddRecord(Slice(msg));
   }
 
+  IOStatus WriteGathered(const std::vector<Slice>& parts) {
+    return writer_.AddRecord(parts.data(), parts.size());
+  }
+
   size_t WrittenBytes() const {
     return dest_contents().size();
   }
@@ -699,6 +703,41 @@ TEST_P(LogTest, Recycle) {
   ASSERT_EQ("EOF", Read());
 }
 
+TEST_P(LogTest, GatheredRecord) {
+  bool recyclable_log = (std::get<0>(GetParam()) != 0);
+  std::unique_ptr<WritableFileWriter> dest_holder(test::GetWritableFileWriter(
+      new test::StringSink(), "" /* don't care */));
+  Writer expected_writer(std::move(dest_holder), 123, recyclable_log);
+
+  Random rnd(301);
+  std::vector<std::string> records;
+  for (int i = 0; i < 50; i++) {
+    // A record gathered from up to 8 parts, some of them empty, that may span
+    // several blocks
+    std::vector<std::string> pieces(rnd.Uniform(8) + 1);
+    std::vector<Slice> parts;
+    std::string record;
+    for (auto& piece : pieces) {
+      if (!rnd.OneIn(4)) {
+        piece = RandomSkewedString(i, &rnd);
+      }
+      parts.emplace_back(piece);
+      record += piece;
+    }
+    ASSERT_OK(WriteGathered(parts));
+    ASSERT_OK(expected_writer.AddRecord(Slice(record)));
+    records.push_back(record);
+  }
+
+  // Same bytes as when the parts are concatenated first
+  auto expected = test::GetStringSinkFromLegacyWriter(expected_writer.file());
+  ASSERT_EQ(expected->contents_, get_reader_contents()->ToString());
+  for (const auto& record : records) {
+    ASSERT_EQ(record, Read());
+  }
+  ASSERT_EQ("EOF", Read());
+}
+
 INSTANTIATE_TEST_CASE_P(bool, LogTest,
                         ::testing::Values(std::make_tuple(0, false),
                                           std::make_tuple(0, true),
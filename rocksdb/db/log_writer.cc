@@ -10,6 +10,9 @@
 #include "db/log_writer.h"
 
 #include <stdint.h>
+
+#include <algorithm>
+
 #include "file/writable_file_writer.h"
 #include "rocksdb/env.h"
 #include "util/coding.h"
@@ -48,18 +51,34 @@ IOStatus Writer::Close() {
   return s;
 }
 
-IOStatus Writer::AddRecord(const Slice& slice) {
-  const char* ptr = slice.data();
-  size_t left = slice.size();
+IOStatus Writer::AddRecord(const Slice& slice) { return AddRecord(&slice, 1); }
+
+IOStatus Writer::AddRecord(const Slice* parts, size_t num_parts) {
+  size_t left = 0;
+  for (size_t i = 0; i < num_parts; i++) {
+    left += parts[i].size();
+  }
 
   // Header size varies depending on whether we are recycling or not.
   const int header_size =
       recycle_log_files_ ? kRecyclableHeaderSize : kHeaderSize;
 
-  // Fragment the record if necessary and emit it.  Note that if slice
+  // The headers of the physical records are formatted into headers_, and the
+  // headers, block trailers and payload fragments are handed to dest_ in a
+  // single Appendv(), so the parts are never copied into a contiguous record.
+  // Every fragment but the first one fills a block, which bounds the number
+  // of headers.
+  const size_t max_fragments = left / (kBlockSize - header_size) + 2;
+  headers_.resize(max_fragments * header_size);
+  iov_.clear();
+
+  size_t part = 0;
+  size_t part_offset = 0;
+  char* header = &headers_[0];
+
+  // Fragment the record if necessary and emit it.  Note that if the record
   // is empty, we still want to iterate once to emit a single
   // zero-length record
-  IOStatus s;
   bool begin = true;
   do {
     const int64_t leftover = kBlockSize - block_offset_;
@@ -70,11 +89,8 @@ IOStatus Writer::AddRecord(const Slice& slice) {
         // Fill the trailer (literal below relies on kHeaderSize and
         // kRecyclableHeaderSize being <= 11)
         assert(header_size <= 11);
-        s = dest_->Append(Slice("\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00",
-                                static_cast<size_t>(leftover)));
-        if (!s.ok()) {
-          break;
-        }
+        iov_.emplace_back("\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00",
+                          static_cast<size_t>(leftover));
       }
       block_offset_ = 0;
     }
@@ -97,12 +113,42 @@ IOStatus Writer::AddRecord(const Slice& slice) {
       type = recycle_log_files_ ? kRecyclableMiddleType : kMiddleType;
     }
 
-    s = EmitPhysicalRecord(type, ptr, fragment_length);
-    ptr += fragment_length;
+    assert(header + header_size <= &headers_[0] + headers_.size());
+    EncodePhysicalRecord(type, fragment_length, header);
+    iov_.emplace_back(header, header_size);
+
+    // Compute the crc of the record type and the payload.
+    uint32_t crc = type_crc_[type];
+    if (recycle_log_files_) {
+      crc = crc32c::Extend(crc, header + 7, 4);
+    }
+    for (size_t n = fragment_length; n > 0;) {
+      assert(part < num_parts);
+      const size_t take = std::min(n, parts[part].size() - part_offset);
+      if (take > 0) {
+        const char* ptr = parts[part].data() + part_offset;
+        iov_.emplace_back(ptr, take);
+        crc = crc32c::Extend(crc, ptr, take);
+        part_offset += take;
+        n -= take;
+      }
+      if (part_offset == parts[part].size()) {
+        part++;
+        part_offset = 0;
+      }
+    }
+    crc = crc32c::Mask(crc);  // Adjust for storage
+    TEST_SYNC_POINT_CALLBACK(
+        "LogWriter::EmitPhysicalRecord:BeforeEncodeChecksum", &crc);
+    EncodeFixed32(header, crc);
+
+    block_offset_ += header_size + fragment_length;
+    header += header_size;
     left -= fragment_length;
     begin = false;
-  } while (s.ok() && left > 0);
+  } while (left > 0);
 
+  IOStatus s = dest_->Appendv(iov_.data(), iov_.size());
   if (s.ok()) {
     if (!manual_flush_) {
       s = dest_->Flush();
@@ -114,26 +160,20 @@ IOStatus Writer::AddRecord(const Slice& slice) {
 
 bool Writer::TEST_BufferIsEmpty() { return dest_->TEST_BufferIsEmpty(); }
 
-IOStatus Writer::EmitPhysicalRecord(RecordType t, const char* ptr, size_t n) {
+void Writer::EncodePhysicalRecord(RecordType t, size_t n, char* buf) {
   assert(n <= 0xffff);  // Must fit in two bytes
 
-  size_t header_size;
-  char buf[kRecyclableHeaderSize];
-
-  // Format the header
+  // Format the header. The crc is filled in by the caller.
   buf[4] = static_cast<char>(n & 0xff);
   buf[5] = static_cast<char>(n >> 8);
   buf[6] = static_cast<char>(t);
 
-  uint32_t crc = type_crc_[t];
   if (t < kRecyclableFullType) {
     // Legacy record format
     assert(block_offset_ + kHeaderSize + n <= kBlockSize);
-    header_size = kHeaderSize;
   } else {
     // Recyclable record format
     assert(block_offset_ + kRecyclableHeaderSize + n <= kBlockSize);
-    header_size = kRecyclableHeaderSize;
 
     // Only encode low 32-bits of the 64-bit log number.  This means
     // we will fail to detect an old record if we recycled a log from
@@ -141,23 +181,7 @@ IOStatus Writer::EmitPhysicalRecord(RecordType t, const char* ptr, size_t n) {
     // even if it were we'dbe far more likely to see a false positive
     // on the 32-bit CRC.
     EncodeFixed32(buf + 7, static_cast<uint32_t>(log_number_));
-    crc = crc32c::Extend(crc, buf + 7, 4);
   }
-
-  // Compute the crc of the record type and the payload.
-  crc = crc32c::Extend(crc, ptr, n);
-  crc = crc32c::Mask(crc);  // Adjust for storage
-  TEST_SYNC_POINT_CALLBACK("LogWriter::EmitPhysicalRecord:BeforeEncodeChecksum",
-                           &crc);
-  EncodeFixed32(buf, crc);
-
-  // Write the header and the payload
-  IOStatus s = dest_->Append(Slice(buf, header_size));
-  if (s.ok()) {
-    s = dest_->Append(Slice(ptr, n));
-  }
-  block_offset_ += header_size + n;
-  return s;
 }
 
 }  // namespace log
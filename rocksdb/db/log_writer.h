@@ -9,8 +9,9 @@
 #pragma once
 
 #include <stdint.h>
-
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "db/log_format.h"
 #include "rocksdb/io_status.h"
@@ -82,6 +83,12 @@ class Writer {
 
   IOStatus AddRecord(const Slice& slice);
 
+  // Adds a single record whose payload is the concatenation of
+  // parts[0..num_parts-1]. The record is identical to the one AddRecord()
+  // writes for the concatenated slice, but the parts are handed to the file
+  // as a gathered write instead of being copied together first.
+  IOStatus AddRecord(const Slice* parts, size_t num_parts);
+
   WritableFileWriter* file() { return dest_.get(); }
   const WritableFileWriter* file() const { return dest_.get(); }
 
@@ -104,7 +111,13 @@ class Writer {
   // record type stored in the header.
   uint32_t type_crc_[kMaxRecordType + 1];
 
-  IOStatus EmitPhysicalRecord(RecordType type, const char* ptr, size_t length);
+  // Formats the header of a physical record of the given type and payload
+  // length into buf, except for the crc.
+  void EncodePhysicalRecord(RecordType type, size_t length, char* buf);
+
+  // Scratch space for the record being added
+  std::string headers_;
+  std::vector<Slice> iov_;
 
   // If true, it does not flush after each write. Instead it relies on the upper
   // layer to manually does the flush by calling ::WriteBuffer()
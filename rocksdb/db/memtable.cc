@@ -49,10 +49,19 @@ ImmutableMemTableOptions::ImmutableMemTableOptions(
               static_cast<double>(mutable_cf_options.write_buffer_size) *
               mutable_cf_options.memtable_prefix_bloom_size_ratio) *
           8u),
+      memtable_hash_index_buckets(static_cast<size_t>(
+          static_cast<double>(mutable_cf_options.write_buffer_size) *
+          mutable_cf_options.memtable_hash_index_size_ratio /
+          sizeof(void*))),
       memtable_huge_page_size(mutable_cf_options.memtable_huge_page_size),
       memtable_whole_key_filtering(
           mutable_cf_options.memtable_whole_key_filtering),
       inplace_update_support(ioptions.inplace_update_support),
+      inplace_merge_support(ioptions.inplace_update_support &&
+                            ioptions.inplace_merge_support &&
+                            ioptions.merge_operator != nullptr &&
+                            ioptions.merge_operator
+                                ->IsAssociativeAndCommutative()),
       inplace_update_num_locks(mutable_cf_options.inplace_update_num_locks),
       inplace_callback(ioptions.inplace_callback),
       max_successive_merges(mutable_cf_options.max_successive_merges),
@@ -61,6 +70,106 @@ ImmutableMemTableOptions::ImmutableMemTableOptions(
       info_log(ioptions.info_log),
       allow_data_in_errors(ioptions.allow_data_in_errors) {}
 
+// MemTablePointIndex maps each user key of a memtable to its newest point
+// entry in the MemTableRep, so that Get() can resolve a lookup with a hash
+// probe instead of a search of the rep. It is a fixed size chained hash table
+// whose buckets and nodes are allocated from the memtable arena. Nodes are
+// only ever added and their entry only ever replaced by a newer one, which
+// allows concurrent inserts and lock-free reads.
+class MemTablePointIndex {
+ public:
+  MemTablePointIndex(Allocator* allocator, size_t num_buckets,
+                     size_t huge_page_tlb_size, Logger* logger)
+      : allocator_(allocator), num_buckets_(num_buckets) {
+    assert(num_buckets_ > 0);
+    char* mem = allocator_->AllocateAligned(
+        sizeof(std::atomic<Node*>) * num_buckets_, huge_page_tlb_size, logger);
+    buckets_ = new (mem) std::atomic<Node*>[num_buckets_];
+    for (size_t i = 0; i < num_buckets_; i++) {
+      buckets_[i].store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  // Records entry, which has sequence number seq, as the newest entry of
+  // user_key unless a newer one was already recorded. Thread-safe.
+  void Insert(const Slice& user_key, SequenceNumber seq, const char* entry) {
+    std::atomic<Node*>& bucket = Bucket(user_key);
+    Node* head = bucket.load(std::memory_order_acquire);
+    Node* stop = nullptr;
+    Node* node = nullptr;
+    while (true) {
+      // Only the nodes added since the last attempt need to be checked
+      for (Node* x = head; x != stop; x = x->next) {
+        const char* cur = x->entry.load(std::memory_order_acquire);
+        if (UserKey(cur) == user_key) {
+          while (Sequence(cur) < seq &&
+                 !x->entry.compare_exchange_weak(cur, entry,
+                                                 std::memory_order_release,
+                                                 std::memory_order_acquire)) {
+          }
+          return;
+        }
+      }
+      if (node == nullptr) {
+        char* mem = allocator_->AllocateAligned(sizeof(Node));
+        node = new (mem) Node(entry);
+      }
+      node->next = head;
+      stop = head;
+      if (bucket.compare_exchange_strong(head, node, std::memory_order_release,
+                                         std::memory_order_acquire)) {
+        return;
+      }
+    }
+  }
+
+  // Returns the newest entry of user_key, or nullptr if the memtable has no
+  // point entry for it.
+  const char* Get(const Slice& user_key) const {
+    for (Node* x = Bucket(user_key).load(std::memory_order_acquire);
+         x != nullptr; x = x->next) {
+      const char* entry = x->entry.load(std::memory_order_acquire);
+      if (UserKey(entry) == user_key) {
+        return entry;
+      }
+    }
+    return nullptr;
+  }
+
+  static Slice UserKey(const char* entry) {
+    uint32_t key_length = 0;
+    const char* key_ptr = GetVarint32Ptr(entry, entry + 5, &key_length);
+    assert(key_length >= 8);
+    return Slice(key_ptr, key_length - 8);
+  }
+
+  static uint64_t Tag(const char* entry) {
+    Slice user_key = UserKey(entry);
+    return DecodeFixed64(user_key.data() + user_key.size());
+  }
+
+ private:
+  struct Node {
+    explicit Node(const char* e) : entry(e), next(nullptr) {}
+
+    std::atomic<const char*> entry;
+    // Immutable once the node is published in its bucket
+    Node* next;
+  };
+
+  static SequenceNumber Sequence(const char* entry) {
+    return Tag(entry) >> 8;
+  }
+
+  std::atomic<Node*>& Bucket(const Slice& user_key) const {
+    return buckets_[GetSliceRangedNPHash(user_key, num_buckets_)];
+  }
+
+  Allocator* const allocator_;
+  const size_t num_buckets_;
+  std::atomic<Node*>* buckets_;
+};
+
 MemTable::MemTable(const InternalKeyComparator& cmp,
                    const ImmutableCFOptions& ioptions,
                    const MutableCFOptions& mutable_cf_options,
@@ -70,6 +179,11 @@ MemTable::MemTable(const InternalKeyComparator& cmp,
       moptions_(ioptions, mutable_cf_options),
       refs_(0),
       kArenaBlockSize(OptimizeBlockSize(moptions_.arena_block_size)),
+      borrow_from_((ioptions.cost_based_write_buffer_flush &&
+                    write_buffer_manager != nullptr &&
+                    write_buffer_manager->enabled())
+                       ? write_buffer_manager
+                       : nullptr),
       mem_tracker_(write_buffer_manager),
       arena_(moptions_.arena_block_size,
              (write_buffer_manager != nullptr &&
@@ -77,7 +191,8 @@ MemTable::MemTable(const InternalKeyComparator& cmp,
                write_buffer_manager->cost_to_cache()))
                  ? &mem_tracker_
                  : nullptr,
-             mutable_cf_options.memtable_huge_page_size),
+             mutable_cf_options.memtable_huge_page_size,
+             ioptions.memtable_memory_allocator),
       table_(ioptions.memtable_factory->CreateMemTableRep(
           comparator_, &arena_, mutable_cf_options.prefix_extractor.get(),
           ioptions.info_log, column_family_id)),
@@ -120,6 +235,16 @@ MemTable::MemTable(const InternalKeyComparator& cmp,
                          6 /* hard coded 6 probes */,
                          moptions_.memtable_huge_page_size, ioptions.info_log));
   }
+
+  // The index relies on equal user keys having equal bytes
+  const Comparator* ucmp = cmp.user_comparator();
+  if (moptions_.memtable_hash_index_buckets > 0 &&
+      !ucmp->CanKeysWithDifferentByteContentsBeEqual() &&
+      ucmp->timestamp_size() == 0) {
+    point_index_.reset(new MemTablePointIndex(
+        &arena_, moptions_.memtable_hash_index_buckets,
+        moptions_.memtable_huge_page_size, ioptions.info_log));
+  }
 }
 
 MemTable::~MemTable() {
@@ -148,6 +273,12 @@ size_t MemTable::ApproximateMemoryUsage() {
 
 bool MemTable::ShouldFlushNow() {
   size_t write_buffer_size = write_buffer_size_.load(std::memory_order_relaxed);
+  if (borrow_from_ != nullptr && !borrow_from_->ShouldFlush()) {
+    // The write buffer manager has memory to spare. Grow up to twice the
+    // configured size; once the manager fills up, it picks the memtables to
+    // flush.
+    write_buffer_size *= 2;
+  }
   // In a lot of times, we cannot allocate arena blocks that exactly matches the
   // buffer size. Thus we have to decide if we should over-allocate or
   // under-allocate.
@@ -513,9 +644,14 @@ bool MemTable::Add(SequenceNumber s, ValueType type,
   size_t ts_sz = GetInternalKeyComparator().user_comparator()->timestamp_size();
 
   if (!allow_concurrent) {
-    // Extract prefix for insert with hint.
-    if (insert_with_hint_prefix_extractor_ != nullptr &&
-        insert_with_hint_prefix_extractor_->InDomain(key_slice)) {
+    if (hint != nullptr) {
+      bool res = table->InsertKeyWithHint(handle, hint);
+      if (UNLIKELY(!res)) {
+        return res;
+      }
+    } else if (insert_with_hint_prefix_extractor_ != nullptr &&
+               insert_with_hint_prefix_extractor_->InDomain(key_slice)) {
+      // Extract prefix for insert with hint.
       Slice prefix = insert_with_hint_prefix_extractor_->Transform(key_slice);
       bool res = table->InsertKeyWithHint(handle, &insert_hints_[prefix]);
       if (UNLIKELY(!res)) {
@@ -528,6 +664,10 @@ bool MemTable::Add(SequenceNumber s, ValueType type,
       }
     }
 
+    if (point_index_ && type != kTypeRangeDeletion) {
+      point_index_->Insert(key, s, buf);
+    }
+
     // this is a bit ugly, but is the way to avoid locked instructions
     // when incrementing an atomic
     num_entries_.store(num_entries_.load(std::memory_order_relaxed) + 1,
@@ -568,6 +708,10 @@ bool MemTable::Add(SequenceNumber s, ValueType type,
       return res;
     }
 
+    if (point_index_ && type != kTypeRangeDeletion) {
+      point_index_->Insert(key, s, buf);
+    }
+
     assert(post_process_info != nullptr);
     post_process_info->num_entries++;
     post_process_info->data_size += encoded_len;
@@ -764,10 +908,17 @@ static bool SaveValue(void* arg, const char* entry) {
           *(s->found_final_value) = true;
           return false;
         }
+        if (s->inplace_update_support) {
+          // Operands are folded in place with inplace_merge_support
+          s->mem->GetLock(s->key->user_key())->ReadLock();
+        }
         Slice v = GetLengthPrefixedSlice(key_ptr + key_length);
         *(s->merge_in_progress) = true;
         merge_context->PushOperand(
             v, s->inplace_update_support == false /* operand_pinned */);
+        if (s->inplace_update_support) {
+          s->mem->GetLock(s->key->user_key())->ReadUnlock();
+        }
         if (s->do_merge && merge_operator->ShouldMerge(
                                merge_context->GetOperandsDirectionBackward())) {
           *(s->status) = MergeHelper::TimedFullMerge(
@@ -887,6 +1038,30 @@ void MemTable::GetFromTable(const LookupKey& key,
   saver.is_blob_index = is_blob_index;
   saver.do_merge = do_merge;
   saver.allow_data_in_errors = moptions_.allow_data_in_errors;
+  if (point_index_) {
+    const char* entry = point_index_->Get(key.user_key());
+    if (entry == nullptr) {
+      // The key has no point entry in this memtable
+      PERF_COUNTER_ADD(memtable_hash_index_hit_count, 1);
+      *seq = kMaxSequenceNumber;
+      return;
+    }
+    // Answer from the newest entry unless the lookup needs older entries:
+    // it is not visible to the reader, or it is a merge operand
+    SequenceNumber entry_seq;
+    ValueType type;
+    UnPackSequenceAndType(MemTablePointIndex::Tag(entry), &entry_seq, &type);
+    if (callback == nullptr &&
+        entry_seq <= GetInternalKeySeqno(key.internal_key()) &&
+        (type == kTypeValue || type == kTypeDeletion ||
+         type == kTypeSingleDeletion || type == kTypeBlobIndex)) {
+      PERF_COUNTER_ADD(memtable_hash_index_hit_count, 1);
+      SaveValue(&saver, entry);
+      *seq = saver.seq;
+      return;
+    }
+    PERF_COUNTER_ADD(memtable_hash_index_miss_count, 1);
+  }
   table_->Get(key, &saver, SaveValue);
   *seq = saver.seq;
 }
@@ -1107,6 +1282,72 @@ bool MemTable::UpdateCallback(SequenceNumber seq,
   return false;
 }
 
+bool MemTable::MergeInPlace(SequenceNumber seq, const Slice& key,
+                            const Slice& operand) {
+  assert(moptions_.inplace_merge_support);
+  // The entry found below may be covered by a range tombstone, in which case
+  // folding the operand into it would resurrect deleted data
+  if (!is_range_del_table_empty_.load(std::memory_order_relaxed)) {
+    return false;
+  }
+  LookupKey lkey(key, seq);
+  Slice memkey = lkey.memtable_key();
+
+  std::unique_ptr<MemTableRep::Iterator> iter(
+      table_->GetDynamicPrefixIterator());
+  iter->Seek(lkey.internal_key(), memkey.data());
+  if (!iter->Valid()) {
+    return false;
+  }
+  // See Update() for the entry format
+  const char* entry = iter->key();
+  uint32_t key_length = 0;
+  const char* key_ptr = GetVarint32Ptr(entry, entry + 5, &key_length);
+  if (!comparator_.comparator.user_comparator()->Equal(
+          Slice(key_ptr, key_length - 8), lkey.user_key())) {
+    return false;
+  }
+  const uint64_t tag = DecodeFixed64(key_ptr + key_length - 8);
+  ValueType type;
+  SequenceNumber existing_seq;
+  UnPackSequenceAndType(tag, &existing_seq, &type);
+  assert(existing_seq != seq);
+  if (type != kTypeValue && type != kTypeMerge) {
+    return false;
+  }
+
+  Slice prev_value = GetLengthPrefixedSlice(key_ptr + key_length);
+  std::string new_value;
+  if (type == kTypeValue) {
+    Status s = MergeHelper::TimedFullMerge(
+        moptions_.merge_operator, key, &prev_value, {operand}, &new_value,
+        moptions_.info_log, moptions_.statistics, env_);
+    if (!s.ok()) {
+      return false;
+    }
+  } else if (!moptions_.merge_operator->PartialMerge(
+                 key, prev_value, operand, &new_value, moptions_.info_log)) {
+    return false;
+  }
+
+  if (new_value.size() <= prev_value.size()) {
+    char* p = EncodeVarint32(const_cast<char*>(key_ptr) + key_length,
+                             static_cast<uint32_t>(new_value.size()));
+    WriteLock wl(GetLock(lkey.user_key()));
+    memcpy(p, new_value.data(), new_value.size());
+    RecordTick(moptions_.statistics, NUMBER_KEYS_UPDATED);
+    return true;
+  } else if (type == kTypeValue) {
+    bool add_res __attribute__((__unused__));
+    add_res = Add(seq, kTypeValue, key, new_value);
+    assert(add_res);
+    return true;
+  }
+  // The combined operand does not fit, and cannot be added as a new entry
+  // without applying the old operand twice.
+  return false;
+}
+
 size_t MemTable::CountSuccessiveMergeEntries(const LookupKey& key) {
   Slice memkey = key.memtable_key();
 
@@ -35,6 +35,7 @@ namespace ROCKSDB_NAMESPACE {
 struct FlushJobInfo;
 class Mutex;
 class MemTableIterator;
+class MemTablePointIndex;
 class MergeContext;
 
 struct ImmutableMemTableOptions {
@@ -42,9 +43,11 @@ struct ImmutableMemTableOptions {
                                     const MutableCFOptions& mutable_cf_options);
   size_t arena_block_size;
   uint32_t memtable_prefix_bloom_bits;
+  size_t memtable_hash_index_buckets;
   size_t memtable_huge_page_size;
   bool memtable_whole_key_filtering;
   bool inplace_update_support;
+  bool inplace_merge_support;
   size_t inplace_update_num_locks;
   UpdateStatus (*inplace_callback)(char* existing_value,
                                    uint32_t* existing_value_size,
@@ -182,6 +185,12 @@ class MemTable {
   // REQUIRES: if allow_concurrent = false, external synchronization to prevent
   // simultaneous operations on the same MemTable.
   //
+  // If hint is not null, the insert resumes the search from the position
+  // *hint records, and *hint is updated to this insert's position. *hint must
+  // start out null. In concurrent mode *hint is heap-allocated and must be
+  // freed by the caller with delete[]; otherwise it is allocated from the
+  // memtable's arena.
+  //
   // Returns false if MemTableRepFactory::CanHandleDuplicatedKey() is true and
   // the <key, seq> already exists.
   bool Add(SequenceNumber seq, ValueType type, const Slice& key,
@@ -269,6 +278,28 @@ class MemTable {
                       const Slice& key,
                       const Slice& delta);
 
+  // If the newest entry for key in this memtable is a value or a merge
+  // operand, applies the merge operand to it and returns true, else returns
+  // false. See ColumnFamilyOptions::inplace_merge_support.
+  // Pseudocode
+  //   if prev_value is of type kTypeValue
+  //     new_value = FullMerge(prev_value, operand)
+  //     if sizeof(new_value) <= sizeof(prev_value)
+  //       update inplace
+  //     else add(key, new_value)
+  //   else if prev_value is of type kTypeMerge
+  //     new_operand = PartialMerge(prev_value, operand)
+  //     if sizeof(new_operand) <= sizeof(prev_value)
+  //       update inplace
+  //     else return false
+  //   else return false
+  //
+  // REQUIRES: GetImmutableMemTableOptions()->inplace_merge_support
+  // REQUIRES: external synchronization to prevent simultaneous
+  // operations on the same MemTable.
+  bool MergeInPlace(SequenceNumber seq, const Slice& key,
+                    const Slice& operand);
+
   // Returns the number of successive merge entries starting from the newest
   // entry for the key up to the last non-merge entry or last entry for the
   // key in the memtable.
@@ -457,6 +488,9 @@ class MemTable {
   const ImmutableMemTableOptions moptions_;
   int refs_;
   const size_t kArenaBlockSize;
+  // Set if the memtable may borrow spare write buffer manager memory, see
+  // DBOptions::cost_based_write_buffer_flush
+  WriteBufferManager* const borrow_from_;
   AllocTracker mem_tracker_;
   ConcurrentArena arena_;
   std::unique_ptr<MemTableRep> table_;
@@ -501,6 +535,8 @@ class MemTable {
 
   const SliceTransform* const prefix_extractor_;
   std::unique_ptr<DynamicBloom> bloom_filter_;
+  // Maps user keys to their newest entry in table_, if enabled
+  std::unique_ptr<MemTablePointIndex> point_index_;
 
   std::atomic<FlushStateEnum> flush_state_;
 
@@ -5,6 +5,7 @@
 //
 #include "db/memtable_list.h"
 
+#include <algorithm>
 #include <cinttypes>
 #include <limits>
 #include <queue>
@@ -278,6 +279,23 @@ void MemTableListVersion::Remove(MemTable* m,
   }
 }
 
+void MemTableListVersion::Replace(const autovector<MemTable*>& mems,
+                                  MemTable* new_mem,
+                                  autovector<MemTable*>* to_delete) {
+  assert(refs_ == 1);  // only when refs_ == 1 is MemTableListVersion mutable
+  assert(!mems.empty());
+  // memlist_ is ordered from newest to oldest, so new_mem goes right in front
+  // of the newest memtable it replaces
+  auto pos = std::find(memlist_.begin(), memlist_.end(), mems.back());
+  assert(pos != memlist_.end());
+  memlist_.insert(pos, new_mem);
+  *parent_memtable_list_memory_usage_ += new_mem->ApproximateMemoryUsage();
+  for (MemTable* m : mems) {
+    memlist_.remove(m);
+    UnrefMemTable(to_delete, m);
+  }
+}
+
 // return the total memory usage assuming the oldest flushed memtable is dropped
 size_t MemTableListVersion::ApproximateMemoryUsageExcludingLast() const {
   size_t total_memtable_size = 0;
@@ -383,6 +401,29 @@ void MemTableList::RollbackMemtableFlush(const autovector<MemTable*>& mems,
   imm_flush_needed.store(true, std::memory_order_release);
 }
 
+bool MemTableList::TryReplaceFlushedMemTables(
+    const autovector<MemTable*>& mems, MemTable* new_mem,
+    autovector<MemTable*>* to_delete) {
+  assert(!mems.empty());
+  for (MemTable* m : current_->memlist_) {
+    if (m->flush_in_progress_ &&
+        std::find(mems.begin(), mems.end(), m) == mems.end()) {
+      return false;
+    }
+  }
+
+  InstallNewVersion();
+  new_mem->Ref();
+  new_mem->MarkImmutable();
+  current_->Replace(mems, new_mem, to_delete);
+  num_flush_not_started_++;
+  if (num_flush_not_started_ == 1) {
+    imm_flush_needed.store(true, std::memory_order_release);
+  }
+  UpdateCachedValuesFromMemTableListVersion();
+  return true;
+}
+
 // Try record a successful flush in the manifest file. It might just return
 // Status::OK letting a concurrent flush to do actual the recording..
 Status MemTableList::TryInstallMemtableFlushResults(
@@ -147,6 +147,10 @@ class MemTableListVersion {
   void Add(MemTable* m, autovector<MemTable*>* to_delete);
   // REQUIRE: m is an immutable memtable
   void Remove(MemTable* m, autovector<MemTable*>* to_delete);
+  // Puts new_mem where the consecutive memtables mems are and drops them
+  // without moving them to the history. Caller should reference new_mem.
+  void Replace(const autovector<MemTable*>& mems, MemTable* new_mem,
+               autovector<MemTable*>* to_delete);
 
   // Return true if memtable is trimmed
   bool TrimHistory(autovector<MemTable*>* to_delete, size_t usage);
@@ -259,6 +263,15 @@ class MemTableList {
   void RollbackMemtableFlush(const autovector<MemTable*>& mems,
                              uint64_t file_number);
 
+  // Replaces the memtables picked by a flush with new_mem, which holds their
+  // live data, instead of committing the flush. new_mem is then waiting to be
+  // flushed again. Returns false and changes nothing if another flush of the
+  // list is in progress, as its result could only be committed once new_mem
+  // is flushed. Takes a reference to new_mem if it returns true.
+  bool TryReplaceFlushedMemTables(const autovector<MemTable*>& mems,
+                                  MemTable* new_mem,
+                                  autovector<MemTable*>* to_delete);
+
   // Try commit a successful flush in the manifest file. It might just return
   // Status::OK letting a concurrent flush to do the actual the recording.
   Status TryInstallMemtableFlushResults(
@@ -33,9 +33,14 @@ class OutputValidator {
     return GetHash() == other_validator.GetHash();
   }
 
- private:
   uint64_t GetHash() const { return paranoid_hash_; }
 
+  // Sets the hash of a file whose key/values were added by another validator,
+  // e.g. one of a file produced by DBOptions::compaction_service.
+  void SetHash(uint64_t hash) { paranoid_hash_ = hash; }
+
+ private:
+
   const InternalKeyComparator& icmp_;
   std::string prev_key_;
   uint64_t paranoid_hash_ = 0;
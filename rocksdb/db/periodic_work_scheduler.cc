@@ -15,9 +15,10 @@ PeriodicWorkScheduler::PeriodicWorkScheduler(Env* env) {
   timer = std::unique_ptr<Timer>(new Timer(env));
 }
 
-void PeriodicWorkScheduler::Register(DBImpl* dbi,
-                                     unsigned int stats_dump_period_sec,
-                                     unsigned int stats_persist_period_sec) {
+void PeriodicWorkScheduler::Register(
+    DBImpl* dbi, unsigned int stats_dump_period_sec,
+    unsigned int stats_persist_period_sec,
+    unsigned int block_cache_manifest_period_sec) {
   static std::atomic<uint64_t> initial_delay(0);
   timer->Start();
   if (stats_dump_period_sec > 0) {
@@ -34,6 +35,15 @@ void PeriodicWorkScheduler::Register(DBImpl* dbi,
             static_cast<uint64_t>(stats_persist_period_sec) * kMicrosInSecond,
         static_cast<uint64_t>(stats_persist_period_sec) * kMicrosInSecond);
   }
+  if (block_cache_manifest_period_sec > 0) {
+    timer->Add([dbi]() { dbi->DumpBlockCacheManifest(); },
+               GetTaskName(dbi, "dump_bc_mf"),
+               initial_delay.fetch_add(1) %
+                   static_cast<uint64_t>(block_cache_manifest_period_sec) *
+                   kMicrosInSecond,
+               static_cast<uint64_t>(block_cache_manifest_period_sec) *
+                   kMicrosInSecond);
+  }
   timer->Add([dbi]() { dbi->FlushInfoLog(); },
              GetTaskName(dbi, "flush_info_log"),
              initial_delay.fetch_add(1) % kDefaultFlushInfoLogPeriodSec *
@@ -44,6 +54,7 @@ void PeriodicWorkScheduler::Register(DBImpl* dbi,
 void PeriodicWorkScheduler::Unregister(DBImpl* dbi) {
   timer->Cancel(GetTaskName(dbi, "dump_st"));
   timer->Cancel(GetTaskName(dbi, "pst_st"));
+  timer->Cancel(GetTaskName(dbi, "dump_bc_mf"));
   timer->Cancel(GetTaskName(dbi, "flush_info_log"));
   if (!timer->HasPendingTask()) {
     timer->Shutdown();
@@ -30,7 +30,8 @@ class PeriodicWorkScheduler {
   PeriodicWorkScheduler& operator=(PeriodicWorkScheduler&&) = delete;
 
   void Register(DBImpl* dbi, unsigned int stats_dump_period_sec,
-                unsigned int stats_persist_period_sec);
+                unsigned int stats_persist_period_sec,
+                unsigned int block_cache_manifest_period_sec);
 
   void Unregister(DBImpl* dbi);
 
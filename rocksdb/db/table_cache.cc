@@ -9,6 +9,7 @@
 
 #include "db/table_cache.h"
 
+#include "db/blob/blob_file_reader.h"
 #include "db/dbformat.h"
 #include "db/range_tombstone_fragmenter.h"
 #include "db/snapshot_impl.h"
@@ -25,6 +26,7 @@
 #include "table/multiget_context.h"
 #include "table/table_builder.h"
 #include "table/table_reader.h"
+#include "table/table_slice_iterator.h"
 #include "test_util/sync_point.h"
 #include "util/cast_util.h"
 #include "util/coding.h"
@@ -90,6 +92,11 @@ TableReader* TableCache::GetTableReaderFromHandle(Cache::Handle* handle) {
   return reinterpret_cast<TableReader*>(cache_->Value(handle));
 }
 
+BlobFileReader* TableCache::GetBlobFileReaderFromHandle(
+    Cache::Handle* handle) {
+  return reinterpret_cast<BlobFileReader*>(cache_->Value(handle));
+}
+
 void TableCache::ReleaseHandle(Cache::Handle* handle) {
   cache_->Release(handle);
 }
@@ -102,8 +109,8 @@ Status TableCache::GetTableReader(
     const SliceTransform* prefix_extractor, bool skip_filters, int level,
     bool prefetch_index_and_filter_in_cache,
     size_t max_file_size_for_l0_meta_pin) {
-  std::string fname =
-      TableFileName(ioptions_.cf_paths, fd.GetNumber(), fd.GetPathId());
+  std::string fname = TableFileName(ioptions_.cf_paths, fd.GetPhysicalNumber(),
+                                    fd.GetPathId());
   std::unique_ptr<FSRandomAccessFile> file;
   FileOptions fopts = file_options;
   Status s = PrepareIOFromReadOptions(ro, ioptions_.env, fopts.io_options);
@@ -138,7 +145,7 @@ Status TableCache::GetTableReader(
                            false /* force_direct_prefetch */, level,
                            fd.largest_seqno, block_cache_tracer_,
                            max_file_size_for_l0_meta_pin),
-        std::move(file_reader), fd.GetFileSize(), table_reader,
+        std::move(file_reader), fd.GetPhysicalFileSize(), table_reader,
         prefetch_index_and_filter_in_cache);
     TEST_SYNC_POINT("TableCache::GetTableReader:0");
   }
@@ -147,7 +154,7 @@ Status TableCache::GetTableReader(
 
 void TableCache::EraseHandle(const FileDescriptor& fd, Cache::Handle* handle) {
   ReleaseHandle(handle);
-  uint64_t number = fd.GetNumber();
+  uint64_t number = fd.GetPhysicalNumber();
   Slice key = GetSliceForFileNumber(&number);
   cache_->Erase(key);
 }
@@ -162,7 +169,8 @@ Status TableCache::FindTable(const ReadOptions& ro,
                              int level, bool prefetch_index_and_filter_in_cache,
                              size_t max_file_size_for_l0_meta_pin) {
   PERF_TIMER_GUARD_WITH_ENV(find_table_nanos, ioptions_.env);
-  uint64_t number = fd.GetNumber();
+  // Table slices share the reader of their physical file
+  uint64_t number = fd.GetPhysicalNumber();
   Slice key = GetSliceForFileNumber(&number);
   *handle = cache_->Lookup(key);
   TEST_SYNC_POINT_CALLBACK("TableCache::FindTable:0",
@@ -203,6 +211,41 @@ Status TableCache::FindTable(const ReadOptions& ro,
   return Status::OK();
 }
 
+Status TableCache::FindBlobFileReader(uint32_t column_family_id,
+                                      uint64_t blob_file_number,
+                                      Cache::Handle** handle) {
+  // Blob files and table files get their numbers from the same counter
+  Slice key = GetSliceForFileNumber(&blob_file_number);
+  *handle = cache_->Lookup(key);
+  if (*handle != nullptr) {
+    return Status::OK();
+  }
+
+  MutexLock load_lock(loader_mutex_.get(key));
+  // We check the cache again under loading mutex
+  *handle = cache_->Lookup(key);
+  if (*handle != nullptr) {
+    return Status::OK();
+  }
+
+  std::unique_ptr<BlobFileReader> reader;
+  Status s = BlobFileReader::Create(ioptions_, file_options_, column_family_id,
+                                    /*blob_file_read_hist=*/nullptr,
+                                    blob_file_number, &reader);
+  if (!s.ok()) {
+    assert(reader == nullptr);
+    RecordTick(ioptions_.statistics, NO_FILE_ERRORS);
+    return s;
+  }
+  s = cache_->Insert(key, reader.get(), 1, &DeleteEntry<BlobFileReader>,
+                     handle);
+  if (s.ok()) {
+    // Release ownership of blob file reader.
+    reader.release();
+  }
+  return s;
+}
+
 InternalIterator* TableCache::NewIterator(
     const ReadOptions& options, const FileOptions& file_options,
     const InternalKeyComparator& icomparator, const FileMetaData& file_meta,
@@ -244,6 +287,10 @@ InternalIterator* TableCache::NewIterator(
                                    skip_filters, caller,
                                    file_options.compaction_readahead_size,
                                    allow_unprepared_value);
+      if (fd.IsTableSlice()) {
+        result = NewTableSliceIterator(result, &icomparator, file_meta.smallest,
+                                       file_meta.largest, arena);
+      }
     }
     if (handle != nullptr) {
       result->RegisterCleanup(&UnrefEntry, cache_, handle);
@@ -309,6 +356,10 @@ Status TableCache::GetRangeTombstoneIterator(
     out_iter->reset(t->NewRangeTombstoneIterator(options));
     assert(out_iter);
   }
+  if (handle != nullptr) {
+    // The iterator shares ownership of the fragmented tombstones
+    ReleaseHandle(handle);
+  }
   return s;
 }
 
@@ -701,4 +752,29 @@ uint64_t TableCache::ApproximateSize(
 
   return result;
 }
+
+Status TableCache::ApproximateKeyAnchors(
+    const ReadOptions& ro, const InternalKeyComparator& internal_comparator,
+    const FileDescriptor& fd, std::vector<TableReader::Anchor>* anchors,
+    const SliceTransform* prefix_extractor) {
+  Status s;
+  TableReader* table_reader = fd.table_reader;
+  Cache::Handle* table_handle = nullptr;
+  if (table_reader == nullptr) {
+    s = FindTable(ro, file_options_, internal_comparator, fd, &table_handle,
+                  prefix_extractor, false /* no_io */,
+                  false /* record_read_stats */);
+    if (s.ok()) {
+      table_reader = GetTableReaderFromHandle(table_handle);
+    }
+  }
+
+  if (s.ok() && table_reader != nullptr) {
+    s = table_reader->ApproximateKeyAnchors(ro, anchors);
+  }
+  if (table_handle != nullptr) {
+    ReleaseHandle(table_handle);
+  }
+  return s;
+}
 }  // namespace ROCKSDB_NAMESPACE
@@ -29,6 +29,7 @@ namespace ROCKSDB_NAMESPACE {
 
 class Env;
 class Arena;
+class BlobFileReader;
 struct FileDescriptor;
 class GetContext;
 class HistogramImpl;
@@ -144,6 +145,15 @@ class TableCache {
   // Get TableReader from a cache handle.
   TableReader* GetTableReaderFromHandle(Cache::Handle* handle);
 
+  // Find the reader of a blob file. Blob file readers are kept in the same
+  // cache as the table readers, under their file number, so they count
+  // against max_open_files as well.
+  Status FindBlobFileReader(uint32_t column_family_id,
+                            uint64_t blob_file_number, Cache::Handle** handle);
+
+  // Get BlobFileReader from a cache handle.
+  BlobFileReader* GetBlobFileReaderFromHandle(Cache::Handle* handle);
+
   // Get the table properties of a given table.
   // @no_io: indicates if we should load table to the cache if it is not present
   //         in table cache yet.
@@ -178,6 +188,14 @@ class TableCache {
                            const InternalKeyComparator& internal_comparator,
                            const SliceTransform* prefix_extractor = nullptr);
 
+  // Samples keys that split the file represented by fd into ranges of
+  // similar size. See TableReader::ApproximateKeyAnchors().
+  Status ApproximateKeyAnchors(const ReadOptions& ro,
+                               const InternalKeyComparator& internal_comparator,
+                               const FileDescriptor& fd,
+                               std::vector<TableReader::Anchor>* anchors,
+                               const SliceTransform* prefix_extractor = nullptr);
+
   // Release the handle from a cache
   void ReleaseHandle(Cache::Handle* handle);
 
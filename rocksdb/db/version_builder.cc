@@ -270,6 +270,35 @@ class VersionBuilder::Rep {
     (*expected_linked_ssts)[blob_file_number].emplace(table_file_number);
   }
 
+  // Make sure that no two files of a sorted run in L0 overlap. The files of
+  // a run are adjacent in L0 but ordered by file number, not by key.
+  static Status CheckL0SortedRuns(VersionStorageInfo* vstorage,
+                                  const std::vector<FileMetaData*>& files) {
+    const InternalKeyComparator* const icmp = vstorage->InternalComparator();
+    std::vector<const FileMetaData*> run;
+    for (size_t i = 0; i < files.size();) {
+      run.clear();
+      run.push_back(files[i]);
+      for (++i; i < files.size() && InSameL0SortedRun(files[i - 1], files[i]);
+           ++i) {
+        run.push_back(files[i]);
+      }
+      std::sort(run.begin(), run.end(),
+                [icmp](const FileMetaData* a, const FileMetaData* b) {
+                  return icmp->Compare(a->smallest, b->smallest) < 0;
+                });
+      for (size_t j = 1; j < run.size(); j++) {
+        if (icmp->Compare(run[j - 1]->largest, run[j]->smallest) >= 0) {
+          return Status::Corruption(
+              "L0 files of a sorted run have overlapping ranges " +
+              NumberToString(run[j - 1]->fd.GetNumber()) + " vs. " +
+              NumberToString(run[j]->fd.GetNumber()));
+        }
+      }
+    }
+    return Status::OK();
+  }
+
   Status CheckConsistencyDetails(VersionStorageInfo* vstorage) {
     // Make sure the files are sorted correctly and that the links between
     // table files and blob files are consistent. The latter is checked using
@@ -306,7 +335,9 @@ class VersionBuilder::Rep {
             return Status::Corruption("L0 files are not sorted properly");
           }
 
-          if (f2->fd.smallest_seqno == f2->fd.largest_seqno) {
+          if (InSameL0SortedRun(f1, f2)) {
+            // Checked by CheckL0SortedRuns() below
+          } else if (f2->fd.smallest_seqno == f2->fd.largest_seqno) {
             // This is an external file that we ingested
             SequenceNumber external_file_seqno = f2->fd.smallest_seqno;
             if (!(external_file_seqno < f1->fd.largest_seqno ||
@@ -348,6 +379,13 @@ class VersionBuilder::Rep {
           }
         }
       }
+
+      if (level == 0) {
+        const Status s = CheckL0SortedRuns(vstorage, level_files);
+        if (!s.ok()) {
+          return s;
+        }
+      }
     }
 
     // Make sure that all blob files in the version have non-garbage data.
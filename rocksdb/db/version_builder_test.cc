@@ -1522,6 +1522,50 @@ TEST_F(VersionBuilderTest, CheckConsistencyForFileDeletedTwice) {
   UnrefFilesInVersion(&new_vstorage2);
 }
 
+TEST_F(VersionBuilderTest, CheckConsistencyForL0SortedRun) {
+  // Three L0 files written by the subcompactions of one compaction share a
+  // sequence number range. They are ordered by file number, so the two files
+  // that overlap are not adjacent in L0.
+  Add(/* level */ 0, /* file_number */ 3, /* smallest */ "100",
+      /* largest */ "150", /* file_size */ 100, /* path_id */ 0,
+      /* smallest_seq */ 100, /* largest_seq */ 200, /* num_entries */ 0,
+      /* num_deletions */ 0, /* sampled */ false, /* smallest_seqno */ 100,
+      /* largest_seqno */ 200);
+  Add(/* level */ 0, /* file_number */ 2, /* smallest */ "300",
+      /* largest */ "350", /* file_size */ 100, /* path_id */ 0,
+      /* smallest_seq */ 100, /* largest_seq */ 200, /* num_entries */ 0,
+      /* num_deletions */ 0, /* sampled */ false, /* smallest_seqno */ 100,
+      /* largest_seqno */ 200);
+  Add(/* level */ 0, /* file_number */ 1, /* smallest */ "140",
+      /* largest */ "200", /* file_size */ 100, /* path_id */ 0,
+      /* smallest_seq */ 100, /* largest_seq */ 200, /* num_entries */ 0,
+      /* num_deletions */ 0, /* sampled */ false, /* smallest_seqno */ 100,
+      /* largest_seqno */ 200);
+
+  UpdateVersionStorageInfo();
+
+  EnvOptions env_options;
+  constexpr TableCache* table_cache = nullptr;
+  constexpr VersionSet* version_set = nullptr;
+
+  VersionBuilder builder(env_options, &ioptions_, table_cache, &vstorage_,
+                         version_set);
+
+  // Save to a new version in order to trigger consistency checks.
+  constexpr bool force_consistency_checks = true;
+  VersionStorageInfo new_vstorage(&icmp_, ucmp_, options_.num_levels,
+                                  kCompactionStyleLevel, &vstorage_,
+                                  force_consistency_checks);
+
+  const Status s = builder.SaveTo(&new_vstorage);
+  ASSERT_TRUE(s.IsCorruption());
+  ASSERT_TRUE(std::strstr(s.getState(),
+                          "L0 files of a sorted run have overlapping ranges "
+                          "3 vs. 1"));
+
+  UnrefFilesInVersion(&new_vstorage);
+}
+
 TEST_F(VersionBuilderTest, EstimatedActiveKeys) {
   const uint32_t kTotalSamples = 20;
   const uint32_t kNumLevels = 5;
@@ -164,6 +164,8 @@ bool VersionEdit::EncodeTo(std::string* dst) const {
     //   tag kPathId: 1 byte as path_id
     //   tag kNeedCompaction:
     //        now only can take one char value 1 indicating need-compaction
+    //   tag kPhysicalFile: varint64 number and varint64 size of the table
+    //        file a table slice is stored in
     //
     PutVarint32(dst, NewFileCustomTag::kOldestAncesterTime);
     std::string varint_oldest_ancester_time;
@@ -190,6 +192,13 @@ bool VersionEdit::EncodeTo(std::string* dst) const {
       char p = static_cast<char>(f.fd.GetPathId());
       PutLengthPrefixedSlice(dst, Slice(&p, 1));
     }
+    if (f.fd.IsTableSlice()) {
+      PutVarint32(dst, NewFileCustomTag::kPhysicalFile);
+      std::string physical_file;
+      PutVarint64Varint64(&physical_file, f.fd.physical_number,
+                          f.fd.physical_file_size);
+      PutLengthPrefixedSlice(dst, Slice(physical_file));
+    }
     if (f.marked_for_compaction) {
       PutVarint32(dst, NewFileCustomTag::kNeedCompaction);
       char p = static_cast<char>(1);
@@ -287,6 +296,8 @@ const char* VersionEdit::DecodeNewFile4From(Slice* input) {
   uint64_t file_size = 0;
   SequenceNumber smallest_seqno = 0;
   SequenceNumber largest_seqno = kMaxSequenceNumber;
+  uint64_t physical_number = 0;
+  uint64_t physical_file_size = 0;
   if (GetLevel(input, &level, &msg) && GetVarint64(input, &number) &&
       GetVarint64(input, &file_size) && GetInternalKey(input, &f.smallest) &&
       GetInternalKey(input, &f.largest) &&
@@ -315,6 +326,13 @@ const char* VersionEdit::DecodeNewFile4From(Slice* input) {
             return "path_id wrong vaue";
           }
           break;
+        case kPhysicalFile:
+          if (!GetVarint64(&field, &physical_number) ||
+              !GetVarint64(&field, &physical_file_size) ||
+              physical_number == 0) {
+            return "invalid physical file";
+          }
+          break;
         case kOldestAncesterTime:
           if (!GetVarint64(&field, &f.oldest_ancester_time)) {
             return "invalid oldest ancester time";
@@ -363,6 +381,8 @@ const char* VersionEdit::DecodeNewFile4From(Slice* input) {
   }
   f.fd =
       FileDescriptor(number, path_id, file_size, smallest_seqno, largest_seqno);
+  f.fd.physical_number = physical_number;
+  f.fd.physical_file_size = physical_file_size;
   new_files_.push_back(std::make_pair(level, f));
   return nullptr;
 }
@@ -708,6 +728,12 @@ std::string VersionEdit::DebugString(bool hex_key) const {
     r.append(f.file_checksum);
     r.append(" file_checksum_func_name: ");
     r.append(f.file_checksum_func_name);
+    if (f.fd.IsTableSlice()) {
+      r.append(" physical_file:");
+      AppendNumberTo(&r, f.fd.physical_number);
+      r.append(" physical_file_size:");
+      AppendNumberTo(&r, f.fd.physical_file_size);
+    }
   }
 
   for (const auto& blob_file_addition : blob_file_additions_) {
@@ -806,6 +832,10 @@ std::string VersionEdit::DebugJSON(int edit_num, bool hex_key) const {
       if (f.oldest_blob_file_number != kInvalidBlobFileNumber) {
         jw << "OldestBlobFile" << f.oldest_blob_file_number;
       }
+      if (f.fd.IsTableSlice()) {
+        jw << "PhysicalFileNumber" << f.fd.physical_number;
+        jw << "PhysicalFileSize" << f.fd.physical_file_size;
+      }
       jw.EndArrayedObject();
     }
 
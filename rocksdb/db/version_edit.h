@@ -82,6 +82,7 @@ enum NewFileCustomTag : uint32_t {
 
   // Forward incompatible (aka unignorable) fields
   kPathId,
+  kPhysicalFile,
 };
 
 class VersionSet;
@@ -104,6 +105,13 @@ struct FileDescriptor {
   uint64_t file_size;  // File size in bytes
   SequenceNumber smallest_seqno;  // The smallest seqno in this file
   SequenceNumber largest_seqno;   // The largest seqno in this file
+  // Non-zero if this file is a table slice: it has no file of its own and
+  // refers to the entries between its smallest and largest keys in the
+  // table file physical_number, of physical_file_size bytes. file_size is
+  // then an estimate of the size of that part. The physical file is deleted
+  // once no live version has a file stored in it.
+  uint64_t physical_number = 0;
+  uint64_t physical_file_size = 0;
 
   FileDescriptor() : FileDescriptor(0, 0, 0) {}
 
@@ -126,6 +134,8 @@ struct FileDescriptor {
     file_size = fd.file_size;
     smallest_seqno = fd.smallest_seqno;
     largest_seqno = fd.largest_seqno;
+    physical_number = fd.physical_number;
+    physical_file_size = fd.physical_file_size;
     return *this;
   }
 
@@ -137,6 +147,15 @@ struct FileDescriptor {
         packed_number_and_path_id / (kFileNumberMask + 1));
   }
   uint64_t GetFileSize() const { return file_size; }
+
+  bool IsTableSlice() const { return physical_number != 0; }
+  // The number and size of the table file the entries are stored in
+  uint64_t GetPhysicalNumber() const {
+    return IsTableSlice() ? physical_number : GetNumber();
+  }
+  uint64_t GetPhysicalFileSize() const {
+    return IsTableSlice() ? physical_file_size : file_size;
+  }
 };
 
 struct FileSampledStats {
@@ -267,6 +286,14 @@ struct FileMetaData {
   }
 };
 
+// The L0 files written by the subcompactions of one compaction into L0 share
+// the same sequence number range and together form a single sorted run. See
+// DBOptions::enable_l0_subcompactions.
+inline bool InSameL0SortedRun(const FileMetaData* a, const FileMetaData* b) {
+  return a->fd.smallest_seqno == b->fd.smallest_seqno &&
+         a->fd.largest_seqno == b->fd.largest_seqno;
+}
+
 // A compressed copy of file meta data that just contain minimum data needed
 // to server read operations, while still keeping the pointer to full metadata
 // of the file in case it is needed.
@@ -401,6 +428,19 @@ class VersionEdit {
     new_files_.emplace_back(level, f);
   }
 
+  // Add f, a file of an existing version, e.g. to move it to another level.
+  // Only the metadata that is persisted in the MANIFEST is copied.
+  void AddExistingFile(int level, const FileMetaData& f) {
+    AddFile(level, f.fd.GetNumber(), f.fd.GetPathId(), f.fd.GetFileSize(),
+            f.smallest, f.largest, f.fd.smallest_seqno, f.fd.largest_seqno,
+            f.marked_for_compaction, f.oldest_blob_file_number,
+            f.oldest_ancester_time, f.file_creation_time, f.file_checksum,
+            f.file_checksum_func_name);
+    FileDescriptor& fd = new_files_.back().second.fd;
+    fd.physical_number = f.fd.physical_number;
+    fd.physical_file_size = f.fd.physical_file_size;
+  }
+
   // Retrieve the table files added as well as their associated levels.
   using NewFiles = std::vector<std::pair<int, FileMetaData>>;
   const NewFiles& GetNewFiles() const { return new_files_; }
@@ -22,6 +22,9 @@
 #include <vector>
 
 #include "compaction/compaction.h"
+#include "db/blob/blob_file_reader.h"
+#include "db/blob/blob_index.h"
+#include "db/compaction/compaction_input_coverage.h"
 #include "db/internal_stats.h"
 #include "db/log_reader.h"
 #include "db/log_writer.h"
@@ -885,7 +888,8 @@ class LevelIterator final : public InternalIterator {
                 bool skip_filters, int level, RangeDelAggregator* range_del_agg,
                 const std::vector<AtomicCompactionUnitBoundary>*
                     compaction_boundaries = nullptr,
-                bool allow_unprepared_value = false)
+                bool allow_unprepared_value = false,
+                const CompactionInputCoverage* input_coverage = nullptr)
       : table_cache_(table_cache),
         read_options_(read_options),
         file_options_(file_options),
@@ -902,7 +906,8 @@ class LevelIterator final : public InternalIterator {
         level_(level),
         range_del_agg_(range_del_agg),
         pinned_iters_mgr_(nullptr),
-        compaction_boundaries_(compaction_boundaries) {
+        compaction_boundaries_(compaction_boundaries),
+        input_coverage_(input_coverage) {
     // Empty level is not supported.
     assert(flevel_ != nullptr && flevel_->num_files > 0);
   }
@@ -966,6 +971,11 @@ class LevelIterator final : public InternalIterator {
            file_iter_.iter() && file_iter_.IsValuePinned();
   }
 
+  bool GetDataBlockPosition(DataBlockPosition* pos) const override {
+    assert(Valid());
+    return file_iter_.GetDataBlockPosition(pos);
+  }
+
  private:
   // Return true if at least one invalid file is seen and skipped.
   bool SkipEmptyFileForward();
@@ -999,13 +1009,22 @@ class LevelIterator final : public InternalIterator {
       largest_compaction_key = (*compaction_boundaries_)[file_index_].largest;
     }
     CheckMayBeOutOfLowerBound();
-    return table_cache_->NewIterator(
+    if (input_coverage_ != nullptr &&
+        input_coverage_->IsFileCovered(*file_meta.file_metadata)) {
+      return NewEmptyInternalIterator<Slice>();
+    }
+    InternalIterator* iter = table_cache_->NewIterator(
         read_options_, file_options_, icomparator_, *file_meta.file_metadata,
         range_del_agg_, prefix_extractor_,
         nullptr /* don't need reference to table */, file_read_hist_, caller_,
         /*arena=*/nullptr, skip_filters_, level_,
         /*max_file_size_for_l0_meta_pin=*/0, smallest_compaction_key,
         largest_compaction_key, allow_unprepared_value_);
+    if (input_coverage_ != nullptr) {
+      iter = input_coverage_->NewSkippingIterator(*file_meta.file_metadata,
+                                                  iter);
+    }
+    return iter;
   }
 
   // Check if current file being fully within iterate_lower_bound.
@@ -1049,6 +1068,9 @@ class LevelIterator final : public InternalIterator {
   // To be propagated to RangeDelAggregator in order to safely truncate range
   // tombstones.
   const std::vector<AtomicCompactionUnitBoundary>* compaction_boundaries_;
+
+  // For DBOptions::skip_range_deleted_compaction_input
+  const CompactionInputCoverage* input_coverage_;
 };
 
 void LevelIterator::Seek(const Slice& target) {
@@ -1269,7 +1291,7 @@ Status Version::GetTableProperties(std::shared_ptr<const TableProperties>* tp,
     file_name = *fname;
   } else {
     file_name =
-      TableFileName(ioptions->cf_paths, file_meta->fd.GetNumber(),
+      TableFileName(ioptions->cf_paths, file_meta->fd.GetPhysicalNumber(),
                     file_meta->fd.GetPathId());
   }
   s = ioptions->fs->NewRandomAccessFile(file_name, file_options_, &file,
@@ -1287,7 +1309,7 @@ Status Version::GetTableProperties(std::shared_ptr<const TableProperties>* tp,
           nullptr /* stats */, 0 /* hist_type */, nullptr /* file_read_hist */,
           nullptr /* rate_limiter */, ioptions->listeners));
   s = ReadTableProperties(
-      file_reader.get(), file_meta->fd.GetFileSize(),
+      file_reader.get(), file_meta->fd.GetPhysicalFileSize(),
       Footer::kInvalidTableMagicNumber /* table's magic number */, *ioptions,
       &raw_table_properties, false /* compression_type_missing */);
   if (!s.ok()) {
@@ -1323,7 +1345,8 @@ Status Version::TablesRangeTombstoneSummary(int max_entries_to_print,
   for (int level = 0; level < storage_info_.num_levels_; level++) {
     for (const auto& file_meta : storage_info_.files_[level]) {
       auto fname =
-          TableFileName(cfd_->ioptions()->cf_paths, file_meta->fd.GetNumber(),
+          TableFileName(cfd_->ioptions()->cf_paths,
+                        file_meta->fd.GetPhysicalNumber(),
                         file_meta->fd.GetPathId());
 
       ss << "=== file : " << fname << " ===\n";
@@ -1368,9 +1391,9 @@ Status Version::TablesRangeTombstoneSummary(int max_entries_to_print,
 Status Version::GetPropertiesOfAllTables(TablePropertiesCollection* props,
                                          int level) {
   for (const auto& file_meta : storage_info_.files_[level]) {
-    auto fname =
-        TableFileName(cfd_->ioptions()->cf_paths, file_meta->fd.GetNumber(),
-                      file_meta->fd.GetPathId());
+    auto fname = TableFileName(cfd_->ioptions()->cf_paths,
+                               file_meta->fd.GetPhysicalNumber(),
+                               file_meta->fd.GetPathId());
     // 1. If the table is already present in table cache, load table
     // properties from there.
     std::shared_ptr<const TableProperties> table_properties;
@@ -1398,7 +1421,8 @@ Status Version::GetPropertiesOfTablesInRange(
       for (const auto& file_meta : files) {
         auto fname =
             TableFileName(cfd_->ioptions()->cf_paths,
-                          file_meta->fd.GetNumber(), file_meta->fd.GetPathId());
+                          file_meta->fd.GetPhysicalNumber(),
+                          file_meta->fd.GetPathId());
         if (props->count(fname) == 0) {
           // 1. If the table is already present in table cache, load table
           // properties from there.
@@ -1802,12 +1826,17 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
       vset_->block_cache_tracer_->is_tracing_enabled()) {
     tracing_get_id = vset_->block_cache_tracer_->NextGetId();
   }
+  // Unless the caller asks for blob indexes, the values in blob files are
+  // read below
+  bool is_blob_index = false;
+  bool* const is_blob_to_use = is_blob ? is_blob : &is_blob_index;
+
   GetContext get_context(
       user_comparator(), merge_operator_, info_log_, db_statistics_,
       status->ok() ? GetContext::kNotFound : GetContext::kMerge, user_key,
       do_merge ? value : nullptr, do_merge ? timestamp : nullptr, value_found,
       merge_context, do_merge, max_covering_tombstone_seq, this->env_, seq,
-      merge_operator_ ? &pinned_iters_mgr : nullptr, callback, is_blob,
+      merge_operator_ ? &pinned_iters_mgr : nullptr, callback, is_blob_to_use,
       tracing_get_id);
 
   // Pin blocks that we read to hold merge operands
@@ -1874,6 +1903,9 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
         }
         PERF_COUNTER_BY_LEVEL_ADD(user_key_return_count, 1,
                                   fp.GetHitFileLevel());
+        if (is_blob_index && do_merge && value != nullptr) {
+          *status = GetBlob(read_options, user_key, *value, value);
+        }
         return;
       case GetContext::kDeleted:
         // Use empty error message for speed
@@ -1922,6 +1954,57 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
   }
 }
 
+Status Version::GetBlob(const ReadOptions& read_options, const Slice& user_key,
+                        const Slice& blob_index_slice,
+                        PinnableSlice* value) const {
+  assert(value);
+
+  BlobIndex blob_index;
+
+  {
+    Status s = blob_index.DecodeFrom(blob_index_slice);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  if (blob_index.HasTTL() || blob_index.IsInlined()) {
+    return Status::Corruption("Unexpected TTL/inlined blob index");
+  }
+
+  const uint64_t blob_file_number = blob_index.file_number();
+  const auto& blob_files = storage_info_.GetBlobFiles();
+  if (blob_files.find(blob_file_number) == blob_files.end()) {
+    return Status::Corruption("Invalid blob file number");
+  }
+
+  Cache::Handle* handle = nullptr;
+  Status s = table_cache_->FindBlobFileReader(cfd_->GetID(), blob_file_number,
+                                              &handle);
+  if (!s.ok()) {
+    return s;
+  }
+  assert(handle);
+
+  s = table_cache_->GetBlobFileReaderFromHandle(handle)->GetBlob(
+      read_options, user_key, blob_index.offset(), blob_index.size(),
+      blob_index.compression(), value);
+  table_cache_->ReleaseHandle(handle);
+  return s;
+}
+
+Status Version::NewBlobFileReader(
+    uint64_t blob_file_number, std::unique_ptr<BlobFileReader>* reader) const {
+  const auto& blob_files = storage_info_.GetBlobFiles();
+  if (blob_files.find(blob_file_number) == blob_files.end()) {
+    return Status::Corruption("Invalid blob file number");
+  }
+
+  return BlobFileReader::Create(*cfd_->ioptions(), file_options_,
+                                cfd_->GetID(), /*blob_file_read_hist=*/nullptr,
+                                blob_file_number, reader);
+}
+
 void Version::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
                        ReadCallback* callback, bool* is_blob) {
   PinnedIteratorsManager pinned_iters_mgr;
@@ -2199,6 +2282,20 @@ bool Version::MaybeInitializeFileMetaData(FileMetaData* file_meta) {
   file_meta->num_deletions = tp->num_deletions;
   file_meta->raw_value_size = tp->raw_value_size;
   file_meta->raw_key_size = tp->raw_key_size;
+  if (file_meta->fd.IsTableSlice() &&
+      file_meta->fd.GetPhysicalFileSize() > file_meta->fd.GetFileSize()) {
+    // The properties are those of the whole physical file
+    const double ratio = static_cast<double>(file_meta->fd.GetFileSize()) /
+                         file_meta->fd.GetPhysicalFileSize();
+    file_meta->num_entries =
+        static_cast<uint64_t>(file_meta->num_entries * ratio);
+    file_meta->num_deletions =
+        static_cast<uint64_t>(file_meta->num_deletions * ratio);
+    file_meta->raw_value_size =
+        static_cast<uint64_t>(file_meta->raw_value_size * ratio);
+    file_meta->raw_key_size =
+        static_cast<uint64_t>(file_meta->raw_key_size * ratio);
+  }
 
   return true;
 }
@@ -2459,10 +2556,14 @@ void VersionStorageInfo::ComputeCompactionScore(
       // overwrites/deletions).
       int num_sorted_runs = 0;
       uint64_t total_size = 0;
+      const FileMetaData* prev_file = nullptr;
       for (auto* f : files_[level]) {
         if (!f->being_compacted) {
           total_size += f->compensated_file_size;
-          num_sorted_runs++;
+          if (prev_file == nullptr || !InSameL0SortedRun(prev_file, f)) {
+            num_sorted_runs++;
+          }
+          prev_file = f;
         }
       }
       if (compaction_style_ == kCompactionStyleUniversal) {
@@ -2576,9 +2677,27 @@ void VersionStorageInfo::ComputeFilesMarkedForCompaction() {
     }
   }
 
+  // Table slices are rewritten once less than half of their physical file is
+  // still referenced, so that the rest of it can be deleted.
+  std::unordered_map<uint64_t, uint64_t> live_slice_bytes;
+  for (int level = 0; level < num_levels(); level++) {
+    for (auto* f : files_[level]) {
+      if (f->fd.IsTableSlice()) {
+        live_slice_bytes[f->fd.GetPhysicalNumber()] += f->fd.GetFileSize();
+      }
+    }
+  }
+
   for (int level = 0; level <= last_qualify_level; level++) {
     for (auto* f : files_[level]) {
-      if (!f->being_compacted && f->marked_for_compaction) {
+      if (f->being_compacted) {
+        continue;
+      }
+      if (f->marked_for_compaction) {
+        files_marked_for_compaction_.emplace_back(level, f);
+      } else if (f->fd.IsTableSlice() &&
+                 live_slice_bytes[f->fd.GetPhysicalNumber()] * 2 <
+                     f->fd.GetPhysicalFileSize()) {
         files_marked_for_compaction_.emplace_back(level, f);
       }
     }
@@ -2648,8 +2767,9 @@ void VersionStorageInfo::ComputeFilesMarkedForPeriodicCompaction(
           file_modification_time = f->TryGetOldestAncesterTime();
         }
         if (file_modification_time == kUnknownOldestAncesterTime) {
-          auto file_path = TableFileName(ioptions.cf_paths, f->fd.GetNumber(),
-                                         f->fd.GetPathId());
+          auto file_path =
+              TableFileName(ioptions.cf_paths, f->fd.GetPhysicalNumber(),
+                            f->fd.GetPathId());
           status = ioptions.env->GetFileModificationTime(
               file_path, &file_modification_time);
           if (!status.ok()) {
@@ -2768,14 +2888,26 @@ void VersionStorageInfo::UpdateNumNonEmptyLevels() {
 }
 
 namespace {
-// Sort `temp` based on ratio of overlapping size over file size
+// Sort `temp` based on ratio of overlapping size over file size. If
+// weigh_by_read_heat, the ratio of the bytes the compaction would write over
+// file size is divided by how much more the file is read than an average file
+// of the level, so that hot ranges are compacted first and cold ones last.
 void SortFileByOverlappingRatio(
     const InternalKeyComparator& icmp, const std::vector<FileMetaData*>& files,
     const std::vector<FileMetaData*>& next_level_files,
-    std::vector<Fsize>* temp) {
-  std::unordered_map<uint64_t, uint64_t> file_to_order;
+    bool weigh_by_read_heat, std::vector<Fsize>* temp) {
+  std::unordered_map<uint64_t, double> file_to_order;
   auto next_level_it = next_level_files.begin();
 
+  double mean_reads_sampled = 0;
+  if (weigh_by_read_heat && !files.empty()) {
+    for (auto* file : files) {
+      mean_reads_sampled +=
+          file->stats.num_reads_sampled.load(std::memory_order_relaxed);
+    }
+    mean_reads_sampled /= files.size();
+  }
+
   for (auto& file : files) {
     uint64_t overlapping_bytes = 0;
     // Skip files in next level that is smaller than current file
@@ -2796,8 +2928,18 @@ void SortFileByOverlappingRatio(
     }
 
     assert(file->compensated_file_size != 0);
-    file_to_order[file->fd.GetNumber()] =
-        overlapping_bytes * 1024u / file->compensated_file_size;
+    if (weigh_by_read_heat) {
+      const double reads_sampled =
+          file->stats.num_reads_sampled.load(std::memory_order_relaxed);
+      file_to_order[file->fd.GetNumber()] =
+          static_cast<double>(overlapping_bytes +
+                              file->compensated_file_size) /
+          file->compensated_file_size * (mean_reads_sampled + 1) /
+          (reads_sampled + mean_reads_sampled + 1);
+    } else {
+      file_to_order[file->fd.GetNumber()] = static_cast<double>(
+          overlapping_bytes * 1024u / file->compensated_file_size);
+    }
   }
 
   std::sort(temp->begin(), temp->end(),
@@ -2855,7 +2997,13 @@ void VersionStorageInfo::UpdateFilesByCompactionPri(
         break;
       case kMinOverlappingRatio:
         SortFileByOverlappingRatio(*internal_comparator_, files_[level],
-                                   files_[level + 1], &temp);
+                                   files_[level + 1],
+                                   false /* weigh_by_read_heat */, &temp);
+        break;
+      case kReadHeatWeightedOverlappingRatio:
+        SortFileByOverlappingRatio(*internal_comparator_, files_[level],
+                                   files_[level + 1],
+                                   true /* weigh_by_read_heat */, &temp);
         break;
       default:
         assert(false);
@@ -3510,7 +3658,8 @@ void Version::AddLiveFiles(std::vector<uint64_t>* live_table_files,
     for (const auto& meta : level_files) {
       assert(meta);
 
-      live_table_files->emplace_back(meta->fd.GetNumber());
+      // A table slice keeps its physical file alive
+      live_table_files->emplace_back(meta->fd.GetPhysicalNumber());
     }
   }
 
@@ -3687,7 +3836,7 @@ VersionSet::~VersionSet() {
   for (auto& file : obsolete_files_) {
     if (file.metadata->table_reader_handle) {
       table_cache->Release(file.metadata->table_reader_handle);
-      TableCache::Evict(table_cache, file.metadata->fd.GetNumber());
+      TableCache::Evict(table_cache, file.metadata->fd.GetPhysicalNumber());
     }
     file.DeleteMetadata();
   }
@@ -5096,7 +5245,7 @@ Status VersionSet::GetLiveFilesChecksumInfo(FileChecksumList* checksum_list) {
     for (int level = 0; level < cfd->NumberLevels(); level++) {
       for (const auto& file :
            cfd->current()->storage_info()->LevelFiles(level)) {
-        s = checksum_list->InsertOneFileChecksum(file->fd.GetNumber(),
+        s = checksum_list->InsertOneFileChecksum(file->fd.GetPhysicalNumber(),
                                                  file->file_checksum,
                                                  file->file_checksum_func_name);
         if (!s.ok()) {
@@ -5406,12 +5555,7 @@ Status VersionSet::WriteCurrentStateToManifest(
       for (int level = 0; level < cfd->NumberLevels(); level++) {
         for (const auto& f :
              cfd->current()->storage_info()->LevelFiles(level)) {
-          edit.AddFile(level, f->fd.GetNumber(), f->fd.GetPathId(),
-                       f->fd.GetFileSize(), f->smallest, f->largest,
-                       f->fd.smallest_seqno, f->fd.largest_seqno,
-                       f->marked_for_compaction, f->oldest_blob_file_number,
-                       f->oldest_ancester_time, f->file_creation_time,
-                       f->file_checksum, f->file_checksum_func_name);
+          edit.AddExistingFile(level, *f);
         }
       }
 
@@ -5720,7 +5864,8 @@ void VersionSet::AddLiveFiles(std::vector<uint64_t>* live_table_files,
 InternalIterator* VersionSet::MakeInputIterator(
     const ReadOptions& read_options, const Compaction* c,
     RangeDelAggregator* range_del_agg,
-    const FileOptions& file_options_compactions) {
+    const FileOptions& file_options_compactions,
+    const CompactionInputCoverage* input_coverage) {
   auto cfd = c->column_family_data();
   // Level-0 files have to be merged together.  For other levels,
   // we will make a concatenating iterator per level.
@@ -5735,10 +5880,15 @@ InternalIterator* VersionSet::MakeInputIterator(
       if (c->level(which) == 0) {
         const LevelFilesBrief* flevel = c->input_levels(which);
         for (size_t i = 0; i < flevel->num_files; i++) {
-          list[num++] = cfd->table_cache()->NewIterator(
+          const FileMetaData& file_meta = *flevel->files[i].file_metadata;
+          if (input_coverage != nullptr &&
+              input_coverage->IsFileCovered(file_meta)) {
+            continue;
+          }
+          list[num] = cfd->table_cache()->NewIterator(
               read_options, file_options_compactions,
-              cfd->internal_comparator(), *flevel->files[i].file_metadata,
-              range_del_agg, c->mutable_cf_options()->prefix_extractor.get(),
+              cfd->internal_comparator(), file_meta, range_del_agg,
+              c->mutable_cf_options()->prefix_extractor.get(),
               /*table_reader_ptr=*/nullptr,
               /*file_read_hist=*/nullptr, TableReaderCaller::kCompaction,
               /*arena=*/nullptr,
@@ -5748,6 +5898,11 @@ InternalIterator* VersionSet::MakeInputIterator(
               /*smallest_compaction_key=*/nullptr,
               /*largest_compaction_key=*/nullptr,
               /*allow_unprepared_value=*/false);
+          if (input_coverage != nullptr) {
+            list[num] = input_coverage->NewSkippingIterator(file_meta,
+                                                            list[num]);
+          }
+          num++;
         }
       } else {
         // Create concatenating iterator for the files from this level
@@ -5759,7 +5914,8 @@ InternalIterator* VersionSet::MakeInputIterator(
             /*no per level latency histogram=*/nullptr,
             TableReaderCaller::kCompaction, /*skip_filters=*/false,
             /*level=*/static_cast<int>(c->level(which)), range_del_agg,
-            c->boundaries(which));
+            c->boundaries(which), /*allow_unprepared_value=*/false,
+            input_coverage);
       }
     }
   }
@@ -5846,6 +6002,17 @@ Status VersionSet::GetMetadataForFile(uint64_t number, int* filelevel,
 }
 
 void VersionSet::GetLiveFilesMetaData(std::vector<LiveFileMetaData>* metadata) {
+  GetLiveFilesMetaData(metadata, false /* table_files */);
+}
+
+void VersionSet::GetLiveTableFilesMetaData(
+    std::vector<LiveFileMetaData>* metadata) {
+  GetLiveFilesMetaData(metadata, true /* table_files */);
+}
+
+void VersionSet::GetLiveFilesMetaData(std::vector<LiveFileMetaData>* metadata,
+                                      bool table_files) {
+  std::unordered_set<uint64_t> listed_table_files;
   for (auto cfd : *column_family_set_) {
     if (cfd->IsDropped() || !cfd->initialized()) {
       continue;
@@ -5862,11 +6029,19 @@ void VersionSet::GetLiveFilesMetaData(std::vector<LiveFileMetaData>* metadata) {
           assert(!cfd->ioptions()->cf_paths.empty());
           filemetadata.db_path = cfd->ioptions()->cf_paths.back().path;
         }
-        const uint64_t file_number = file->fd.GetNumber();
+        uint64_t file_number = file->fd.GetNumber();
+        filemetadata.size = static_cast<size_t>(file->fd.GetFileSize());
+        if (table_files) {
+          file_number = file->fd.GetPhysicalNumber();
+          filemetadata.size =
+              static_cast<size_t>(file->fd.GetPhysicalFileSize());
+          if (!listed_table_files.insert(file_number).second) {
+            continue;
+          }
+        }
         filemetadata.name = MakeTableFileName("", file_number);
         filemetadata.file_number = file_number;
         filemetadata.level = level;
-        filemetadata.size = static_cast<size_t>(file->fd.GetFileSize());
         filemetadata.smallestkey = file->smallest.user_key().ToString();
         filemetadata.largestkey = file->largest.user_key().ToString();
         filemetadata.smallest_seqno = file->fd.smallest_seqno;
@@ -5898,7 +6073,7 @@ void VersionSet::GetObsoleteFiles(std::vector<ObsoleteFileInfo>* files,
 
   std::vector<ObsoleteFileInfo> pending_files;
   for (auto& f : obsolete_files_) {
-    if (f.metadata->fd.GetNumber() < min_pending_output) {
+    if (f.metadata->fd.GetPhysicalNumber() < min_pending_output) {
       files->emplace_back(std::move(f));
     } else {
       pending_files.emplace_back(std::move(f));
@@ -5980,7 +6155,7 @@ Status VersionSet::VerifyFileMetadata(const std::string& fpath,
   uint64_t fsize = 0;
   Status status = fs_->GetFileSize(fpath, IOOptions(), &fsize, nullptr);
   if (status.ok()) {
-    if (fsize != meta.fd.GetFileSize()) {
+    if (fsize != meta.fd.GetPhysicalFileSize()) {
       status = Status::Corruption("File size mismatch: " + fpath);
     }
   }
@@ -58,7 +58,9 @@ namespace log {
 class Writer;
 }
 
+class BlobFileReader;
 class Compaction;
+class CompactionInputCoverage;
 class LogBuffer;
 class LookupKey;
 class MemTable;
@@ -681,6 +683,15 @@ class Version {
   void MultiGet(const ReadOptions&, MultiGetRange* range,
                 ReadCallback* callback = nullptr, bool* is_blob = nullptr);
 
+  // Reads the value of user_key from the blob file that blob_index_slice,
+  // a blob index of this version, refers to.
+  Status GetBlob(const ReadOptions& read_options, const Slice& user_key,
+                 const Slice& blob_index_slice, PinnableSlice* value) const;
+
+  // Opens a reader for a blob file of this version
+  Status NewBlobFileReader(uint64_t blob_file_number,
+                           std::unique_ptr<BlobFileReader>* reader) const;
+
   // Loads some stats information from files. Call without mutex held. It needs
   // to be called before applying the version to the version set.
   void PrepareApply(const MutableCFOptions& mutable_cf_options,
@@ -1116,10 +1127,13 @@ class VersionSet {
   // Create an iterator that reads over the compaction inputs for "*c".
   // The caller should delete the iterator when no longer needed.
   // @param read_options Must outlive the returned iterator.
+  // @param input_coverage If not nullptr, the parts of the input files that
+  //        it covers are skipped. Must outlive the returned iterator.
   InternalIterator* MakeInputIterator(
       const ReadOptions& read_options, const Compaction* c,
       RangeDelAggregator* range_del_agg,
-      const FileOptions& file_options_compactions);
+      const FileOptions& file_options_compactions,
+      const CompactionInputCoverage* input_coverage = nullptr);
 
   // Add all files listed in any live version to *live_table_files and
   // *live_blob_files. Note that these lists may contain duplicates.
@@ -1149,6 +1163,11 @@ class VersionSet {
   // This function doesn't support leveldb SST filenames
   void GetLiveFilesMetaData(std::vector<LiveFileMetaData> *metadata);
 
+  // Like GetLiveFilesMetaData(), but lists the table files on disk: table
+  // slices are reported once per table file their entries are stored in,
+  // with its number and size.
+  void GetLiveTableFilesMetaData(std::vector<LiveFileMetaData>* metadata);
+
   void AddObsoleteBlobFile(uint64_t blob_file_number, std::string path) {
     obsolete_blob_files_.emplace_back(blob_file_number, std::move(path));
   }
@@ -1212,6 +1231,11 @@ class VersionSet {
 
   void Reset();
 
+  // Lists table slices by their own number and size, or by those of the
+  // table file they are stored in if table_files
+  void GetLiveFilesMetaData(std::vector<LiveFileMetaData>* metadata,
+                            bool table_files);
+
   // Returns approximated offset of a key in a file for a given version.
   uint64_t ApproximateOffsetOf(Version* v, const FdWithKeyRange& f,
                                const Slice& key, TableReaderCaller caller);
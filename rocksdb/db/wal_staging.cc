@@ -0,0 +1,149 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/wal_staging.h"
+
+#include <thread>
+
+#include "db/write_batch_internal.h"
+#include "util/autovector.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+WalStaging::WalStaging(Env* env, WriteFn write_fn)
+    : write_fn_(std::move(write_fn)),
+      pending_(0),
+      waiting_(false),
+      stop_(false),
+      stopped_(false) {
+  env->StartThread(&WalStaging::BGThreadWrapper, this);
+}
+
+WalStaging::~WalStaging() {
+  std::unique_lock<std::mutex> lock(mu_);
+  stop_ = true;
+  cv_.notify_all();
+  cv_.wait(lock, [this] { return stopped_; });
+  assert(pending_.load() == 0);
+}
+
+Status WalStaging::Write(const WriteOptions& write_options,
+                         const WriteBatch* batch, SequenceNumber* seq) {
+  assert(WriteBatchInternal::Count(batch) > 0);
+  assert(batch->GetWalTerminationPoint().is_cleared());
+  StagedWrite w;
+  // Count the write before it is visible in a buffer, so the log thread
+  // does not go to sleep with it staged
+  pending_.fetch_add(1);
+  Buffer* buf = buffers_.Access();
+  {
+    std::lock_guard<SpinMutex> lock(buf->mutex);
+    w.offset = WriteBatchInternal::Count(&buf->batch);
+    WriteBatchInternal::Append(&buf->batch, batch);
+    if (buf->writers.empty()) {
+      buf->write_options = write_options;
+    } else {
+      buf->write_options.sync = buf->write_options.sync || write_options.sync;
+    }
+    buf->writers.push_back(&w);
+  }
+  if (waiting_.load()) {
+    std::lock_guard<std::mutex> lock(mu_);
+    cv_.notify_one();
+  }
+
+  std::unique_lock<std::mutex> lock(w.mu);
+  w.cv.wait(lock, [&w] { return w.done; });
+  *seq = w.sequence;
+  return w.status;
+}
+
+void WalStaging::BGThreadWrapper(void* arg) {
+  reinterpret_cast<WalStaging*>(arg)->BGThread();
+}
+
+void WalStaging::BGThread() {
+  while (true) {
+    if (pending_.load() == 0) {
+      std::unique_lock<std::mutex> lock(mu_);
+      waiting_.store(true);
+      cv_.wait(lock, [this] { return stop_ || pending_.load() > 0; });
+      waiting_.store(false);
+      if (pending_.load() == 0) {
+        assert(stop_);
+        break;
+      }
+    }
+    size_t completed = WriteRound();
+    if (completed == 0) {
+      // A writer has been counted but has not appended its batch yet
+      std::this_thread::yield();
+      continue;
+    }
+    pending_.fetch_sub(completed);
+  }
+  std::lock_guard<std::mutex> lock(mu_);
+  stopped_ = true;
+  cv_.notify_all();
+}
+
+size_t WalStaging::WriteRound() {
+  autovector<Buffer*> ready;
+  for (size_t i = 0; i < buffers_.Size(); ++i) {
+    Buffer* buf = buffers_.AccessAtCore(i);
+    {
+      std::lock_guard<SpinMutex> lock(buf->mutex);
+      if (buf->writers.empty()) {
+        continue;
+      }
+      std::swap(buf->batch, buf->writing);
+      buf->writers.swap(buf->writing_writers);
+      buf->writing_options = buf->write_options;
+    }
+    ready.push_back(buf);
+  }
+  if (ready.empty()) {
+    return 0;
+  }
+
+  // Gather the buffers into one record, written and synced once. The first
+  // buffer supplies the options; the record is synced if any write asked
+  // for it.
+  WriteOptions write_options = ready[0]->writing_options;
+  WriteBatch* record = &ready[0]->writing;
+  size_t completed = 0;
+  if (ready.size() > 1) {
+    record = &round_batch_;
+    record->Clear();
+  }
+  for (Buffer* buf : ready) {
+    if (record != &buf->writing) {
+      const uint32_t base = WriteBatchInternal::Count(record);
+      for (StagedWrite* w : buf->writing_writers) {
+        w->offset += base;
+      }
+      WriteBatchInternal::Append(record, &buf->writing);
+    }
+    write_options.sync = write_options.sync || buf->writing_options.sync;
+    completed += buf->writing_writers.size();
+  }
+  SequenceNumber seq = 0;
+  Status s = write_fn_(write_options, record, completed, &seq);
+
+  for (Buffer* buf : ready) {
+    for (StagedWrite* w : buf->writing_writers) {
+      std::lock_guard<std::mutex> lock(w->mu);
+      w->sequence = seq + w->offset;
+      w->status = s;
+      w->done = true;
+      w->cv.notify_one();
+    }
+    buf->writing.Clear();
+    buf->writing_writers.clear();
+  }
+  return completed;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
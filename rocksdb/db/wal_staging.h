@@ -0,0 +1,103 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/env.h"
+#include "rocksdb/options.h"
+#include "rocksdb/status.h"
+#include "rocksdb/types.h"
+#include "rocksdb/write_batch.h"
+#include "util/core_local.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// WalStaging implements the WAL side of DBOptions::enable_wal_staging_buffers.
+// Instead of joining the write thread, a writer appends its batch to the
+// staging buffer of the core it runs on. A dedicated log thread drains the
+// buffers and writes what they hold to the WAL as a single record, with a
+// single sync per round, and wakes the writers with the sequence number
+// assigned to their batch. The writers then insert into the memtables concurrently, as
+// unordered_write does.
+class WalStaging {
+ public:
+  // Writes batch to the WAL and publishes its sequence numbers. memtable_writes
+  // writers will insert parts of the batch into the memtables after this
+  // returns. On success *seq is the sequence number of the first entry.
+  using WriteFn = std::function<Status(
+      const WriteOptions& write_options, WriteBatch* batch,
+      size_t memtable_writes, SequenceNumber* seq)>;
+
+  // The log thread is started through env.
+  WalStaging(Env* env, WriteFn write_fn);
+
+  // Writes out everything that was staged and stops the log thread.
+  ~WalStaging();
+
+  WalStaging(const WalStaging&) = delete;
+  WalStaging& operator=(const WalStaging&) = delete;
+
+  // Stages batch and blocks until the log thread wrote it to the WAL. On
+  // success *seq is the sequence number of the first entry of batch.
+  // REQUIRES: batch is not empty and has no WAL termination point.
+  Status Write(const WriteOptions& write_options, const WriteBatch* batch,
+               SequenceNumber* seq);
+
+ private:
+  struct StagedWrite {
+    // Number of entries staged before this write in its buffer
+    uint32_t offset = 0;
+    SequenceNumber sequence = 0;
+    Status status;
+    bool done = false;
+    std::mutex mu;
+    std::condition_variable cv;
+  };
+
+  struct ALIGN_AS(CACHE_LINE_SIZE) Buffer {
+    SpinMutex mutex;
+    // Protected by mutex
+    WriteBatch batch;
+    std::vector<StagedWrite*> writers;
+    // Options of the first staged write, synced if any of the writes asked
+    // for it
+    WriteOptions write_options;
+
+    // Only accessed by the log thread
+    WriteBatch writing;
+    std::vector<StagedWrite*> writing_writers;
+    WriteOptions writing_options;
+  };
+
+  static void BGThreadWrapper(void* arg);
+  void BGThread();
+  // Writes out everything the buffers hold as one WAL record. Returns the
+  // number of writes that were completed.
+  size_t WriteRound();
+
+  const WriteFn write_fn_;
+  CoreLocalArray<Buffer> buffers_;
+  // Only accessed by the log thread
+  WriteBatch round_batch_;
+
+  // Writes staged but not yet completed
+  std::atomic<size_t> pending_;
+  // The log thread is blocked on cv_, or about to be
+  std::atomic<bool> waiting_;
+  bool stop_;     // protected by mu_
+  bool stopped_;  // protected by mu_, set when the log thread exits
+  std::mutex mu_;
+  std::condition_variable cv_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,53 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/wal_sync_coalescer.h"
+
+#include <algorithm>
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// Weight of the latest sync in the average sync latency
+const double kSyncLatencyWeight = 0.125;
+// The wait grows by this fraction of its bound while waiting pays off
+const uint64_t kWaitIncreaseDivisor = 8;
+}  // namespace
+
+WalSyncCoalescer::WalSyncCoalescer(uint64_t max_wait_us)
+    : max_wait_us_(max_wait_us), avg_sync_micros_(0), wait_us_(0) {}
+
+uint64_t WalSyncCoalescer::MaxWaitMicros() const {
+  return std::min(max_wait_us_, static_cast<uint64_t>(avg_sync_micros_ / 2));
+}
+
+uint64_t WalSyncCoalescer::WaitMicros() const {
+  return std::min(wait_us_, MaxWaitMicros());
+}
+
+void WalSyncCoalescer::RecordWait(bool gathered) {
+  if (gathered) {
+    uint64_t max_wait = MaxWaitMicros();
+    wait_us_ = std::min(
+        max_wait, wait_us_ + std::max<uint64_t>(max_wait / kWaitIncreaseDivisor,
+                                                1));
+  } else {
+    wait_us_ /= 2;
+  }
+}
+
+void WalSyncCoalescer::RecordSync(uint64_t sync_micros, size_t group_size) {
+  if (avg_sync_micros_ == 0) {
+    avg_sync_micros_ = static_cast<double>(sync_micros);
+  } else {
+    avg_sync_micros_ += kSyncLatencyWeight *
+                        (static_cast<double>(sync_micros) - avg_sync_micros_);
+  }
+  if (wait_us_ == 0 && group_size > 1) {
+    wait_us_ = std::max<uint64_t>(MaxWaitMicros() / kWaitIncreaseDivisor, 1);
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
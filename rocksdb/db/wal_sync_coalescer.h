@@ -0,0 +1,58 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "rocksdb/rocksdb_namespace.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// WalSyncCoalescer implements DBOptions::wal_sync_coalescing_max_wait_us. It
+// decides how long the leader of a write group that syncs the WAL waits for
+// more sync writes to join the group before it gathers it.
+//
+// The wait is bounded by the max wait and by half of the average WAL sync
+// latency, so waiting never costs more than a fraction of the sync it saves.
+// Within that bound it adapts: it grows additively while waiting gathers more
+// writers and is halved while it does not. Once it dropped to zero, it is
+// probed again as soon as a sync is shared by several writers, which shows
+// that sync writes are arriving concurrently.
+//
+// Not thread safe. Only the write group leader may call it, and there is only
+// one at a time.
+class WalSyncCoalescer {
+ public:
+  explicit WalSyncCoalescer(uint64_t max_wait_us);
+
+  // Returns how long the leader of a sync write group should wait before it
+  // gathers its group, zero if it should not wait.
+  uint64_t WaitMicros() const;
+
+  // Records that the leader waited WaitMicros() and whether new writers
+  // joined the write queue meanwhile.
+  void RecordWait(bool gathered);
+
+  // Records a WAL sync that took sync_micros and was shared by group_size
+  // writers.
+  void RecordSync(uint64_t sync_micros, size_t group_size);
+
+  uint64_t TEST_avg_sync_micros() const {
+    return static_cast<uint64_t>(avg_sync_micros_);
+  }
+
+ private:
+  // Upper bound of the wait given the observed sync latency
+  uint64_t MaxWaitMicros() const;
+
+  const uint64_t max_wait_us_;
+  // Moving average of the WAL sync latency, 0 until the first sync
+  double avg_sync_micros_;
+  uint64_t wait_us_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
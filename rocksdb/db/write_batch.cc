@@ -35,6 +35,7 @@
 
 #include "rocksdb/write_batch.h"
 
+#include <algorithm>
 #include <map>
 #include <stack>
 #include <stdexcept>
@@ -1197,6 +1198,54 @@ Status WriteBatch::AssignTimestamps(const std::vector<Slice>& ts_list) {
   return Iterate(&ts_assigner);
 }
 
+// Collects the entries of a write batch so that MemTableInserter can insert
+// them in internal key order. Only Put, Delete and SingleDelete are collected;
+// any other record makes Iterate() fail, and the batch is then inserted in
+// its original order.
+class SortedInsertCollector : public WriteBatch::Handler {
+ public:
+  struct Entry {
+    uint32_t column_family_id;
+    ValueType type;
+    Slice key;
+    Slice value;
+    SequenceNumber sequence;
+    const Comparator* ucmp;
+  };
+
+  SortedInsertCollector(SequenceNumber sequence, std::vector<Entry>* entries)
+      : sequence_(sequence), entries_(entries) {}
+  ~SortedInsertCollector() override {}
+
+  Status PutCF(uint32_t column_family_id, const Slice& key,
+               const Slice& value) override {
+    return Collect(column_family_id, kTypeValue, key, value);
+  }
+
+  Status DeleteCF(uint32_t column_family_id, const Slice& key) override {
+    return Collect(column_family_id, kTypeDeletion, key, Slice());
+  }
+
+  Status SingleDeleteCF(uint32_t column_family_id, const Slice& key) override {
+    return Collect(column_family_id, kTypeSingleDeletion, key, Slice());
+  }
+
+  Status MergeCF(uint32_t, const Slice&, const Slice&) override {
+    return Status::NotSupported();
+  }
+
+ private:
+  Status Collect(uint32_t column_family_id, ValueType type, const Slice& key,
+                 const Slice& value) {
+    entries_->push_back(
+        {column_family_id, type, key, value, sequence_++, nullptr});
+    return Status::OK();
+  }
+
+  SequenceNumber sequence_;
+  std::vector<Entry>* entries_;
+};
+
 class MemTableInserter : public WriteBatch::Handler {
 
   SequenceNumber sequence_;
@@ -1237,6 +1286,8 @@ class MemTableInserter : public WriteBatch::Handler {
   bool              dup_dectector_on_;
 
   bool hint_per_batch_;
+  // Whether a batch is being inserted in sorted order by InsertSorted()
+  bool sorted_insert_;
   bool hint_created_;
   // Hints for this batch
   using HintMap = std::unordered_map<MemTable*, void*>;
@@ -1244,7 +1295,7 @@ class MemTableInserter : public WriteBatch::Handler {
   HintMapType hint_;
 
   HintMap& GetHintMap() {
-    assert(hint_per_batch_);
+    assert(hint_per_batch_ || sorted_insert_);
     if (!hint_created_) {
       new (&hint_) HintMap();
       hint_created_ = true;
@@ -1252,6 +1303,10 @@ class MemTableInserter : public WriteBatch::Handler {
     return *reinterpret_cast<HintMap*>(&hint_);
   }
 
+  void** GetHint(MemTable* mem) {
+    return (hint_per_batch_ || sorted_insert_) ? &GetHintMap()[mem] : nullptr;
+  }
+
   MemPostInfoMap& GetPostMap() {
     assert(concurrent_memtable_writes_);
     if(!post_info_created_) {
@@ -1311,6 +1366,7 @@ class MemTableInserter : public WriteBatch::Handler {
         duplicate_detector_(),
         dup_dectector_on_(false),
         hint_per_batch_(hint_per_batch),
+        sorted_insert_(false),
         hint_created_(false) {
     assert(cf_mems_);
   }
@@ -1325,8 +1381,12 @@ class MemTableInserter : public WriteBatch::Handler {
         (&mem_post_info_map_)->~MemPostInfoMap();
     }
     if (hint_created_) {
-      for (auto iter : GetHintMap()) {
-        delete[] reinterpret_cast<char*>(iter.second);
+      // Hints used in non-concurrent mode are allocated from the memtable's
+      // arena.
+      if (concurrent_memtable_writes_) {
+        for (auto iter : *reinterpret_cast<HintMap*>(&hint_)) {
+          delete[] reinterpret_cast<char*>(iter.second);
+        }
       }
       reinterpret_cast<HintMap*>(&hint_)->~HintMap();
     }
@@ -1354,6 +1414,93 @@ class MemTableInserter : public WriteBatch::Handler {
 
   void set_log_number_ref(uint64_t log) { log_number_ref_ = log; }
 
+  // Inserts batch into the memtables. If the batch has at least
+  // sort_threshold entries, they are inserted in internal key order (see
+  // WriteOptions::memtable_insert_sort_threshold).
+  Status InsertBatch(const WriteBatch* batch, size_t sort_threshold) {
+    Status s;
+    if (sort_threshold == 0 || seq_per_batch_ ||
+        static_cast<size_t>(WriteBatchInternal::Count(batch)) <
+            sort_threshold ||
+        !InsertSorted(batch, &s)) {
+      s = batch->Iterate(this);
+    }
+    return s;
+  }
+
+  // Sorts the entries of batch by column family and internal key and inserts
+  // them, so that each insert into a memtable resumes the search from the
+  // position of the previous one. Returns false without inserting anything
+  // if the batch cannot be reordered.
+  bool InsertSorted(const WriteBatch* batch, Status* s) {
+    assert(!seq_per_batch_);
+    assert(recovering_log_number_ == 0);
+    assert(rebuilding_trx_ == nullptr);
+    std::vector<SortedInsertCollector::Entry> entries;
+    entries.reserve(WriteBatchInternal::Count(batch));
+    SortedInsertCollector collector(sequence_, &entries);
+    if (!batch->Iterate(&collector).ok()) {
+      return false;
+    }
+    // Entries are ordered with their column family's comparator, so every
+    // column family must exist. Leave missing ones to the unsorted path,
+    // which reports or ignores them.
+    uint32_t last_cf = 0;
+    const Comparator* last_ucmp = nullptr;
+    for (auto& e : entries) {
+      if (last_ucmp == nullptr || e.column_family_id != last_cf) {
+        if (!cf_mems_->Seek(e.column_family_id)) {
+          return false;
+        }
+        MemTable* mem = cf_mems_->GetMemTable();
+        if (mem->GetImmutableMemTableOptions()->inplace_update_support) {
+          return false;
+        }
+        last_cf = e.column_family_id;
+        last_ucmp = mem->GetInternalKeyComparator().user_comparator();
+      }
+      e.ucmp = last_ucmp;
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const SortedInsertCollector::Entry& a,
+                 const SortedInsertCollector::Entry& b) {
+                if (a.column_family_id != b.column_family_id) {
+                  return a.column_family_id < b.column_family_id;
+                }
+                int r = a.ucmp->Compare(a.key, b.key);
+                if (r != 0) {
+                  return r < 0;
+                }
+                return a.sequence > b.sequence;
+              });
+
+    const SequenceNumber end_sequence = sequence_ + entries.size();
+    sorted_insert_ = true;
+    for (const auto& e : entries) {
+      sequence_ = e.sequence;
+      switch (e.type) {
+        case kTypeValue:
+          *s = PutCF(e.column_family_id, e.key, e.value);
+          break;
+        case kTypeDeletion:
+          *s = DeleteCF(e.column_family_id, e.key);
+          break;
+        default:
+          assert(e.type == kTypeSingleDeletion);
+          *s = SingleDeleteCF(e.column_family_id, e.key);
+          break;
+      }
+      if (!s->ok()) {
+        break;
+      }
+    }
+    sorted_insert_ = false;
+    if (s->ok()) {
+      sequence_ = end_sequence;
+    }
+    return true;
+  }
+
   SequenceNumber sequence() const { return sequence_; }
 
   void PostProcess() {
@@ -1439,7 +1586,7 @@ class MemTableInserter : public WriteBatch::Handler {
       bool mem_res =
           mem->Add(sequence_, value_type, key, value,
                    concurrent_memtable_writes_, get_post_process_info(mem),
-                   hint_per_batch_ ? &GetHintMap()[mem] : nullptr);
+                   GetHint(mem));
       if (UNLIKELY(!mem_res)) {
         assert(seq_per_batch_);
         ret_status = Status::TryAgain("key+seq exists");
@@ -1523,7 +1670,7 @@ class MemTableInserter : public WriteBatch::Handler {
     bool mem_res =
         mem->Add(sequence_, delete_type, key, value,
                  concurrent_memtable_writes_, get_post_process_info(mem),
-                 hint_per_batch_ ? &GetHintMap()[mem] : nullptr);
+                 GetHint(mem));
     if (UNLIKELY(!mem_res)) {
       assert(seq_per_batch_);
       ret_status = Status::TryAgain("key+seq exists");
@@ -1766,6 +1913,13 @@ class MemTableInserter : public WriteBatch::Handler {
       }
     }
 
+    if (!perform_merge && moptions->inplace_merge_support) {
+      // inplace_merge_support is only enabled with inplace_update_support
+      assert(!concurrent_memtable_writes_);
+      assert(!seq_per_batch_);
+      perform_merge = mem->MergeInPlace(sequence_, key, value);
+    }
+
     if (!perform_merge) {
       // Add merge operator to memtable
       bool mem_res =
@@ -2014,7 +2168,8 @@ Status WriteBatchInternal::InsertInto(
     }
     SetSequence(w->batch, inserter.sequence());
     inserter.set_log_number_ref(w->log_ref);
-    w->status = w->batch->Iterate(&inserter);
+    w->status =
+        inserter.InsertBatch(w->batch, w->memtable_insert_sort_threshold);
     if (!w->status.ok()) {
       return w->status;
     }
@@ -2042,7 +2197,8 @@ Status WriteBatchInternal::InsertInto(
       batch_per_txn, hint_per_batch);
   SetSequence(writer->batch, sequence);
   inserter.set_log_number_ref(writer->log_ref);
-  Status s = writer->batch->Iterate(&inserter);
+  Status s = inserter.InsertBatch(writer->batch,
+                                  writer->memtable_insert_sort_threshold);
   assert(!seq_per_batch || batch_cnt != 0);
   assert(!seq_per_batch || inserter.sequence() - sequence == batch_cnt);
   if (concurrent_memtable_writes) {
@@ -2082,6 +2238,14 @@ Status WriteBatchInternal::SetContents(WriteBatch* b, const Slice& contents) {
 
 Status WriteBatchInternal::Append(WriteBatch* dst, const WriteBatch* src,
                                   const bool wal_only) {
+  Slice entries = AppendByReference(dst, src, wal_only);
+  dst->rep_.append(entries.data(), entries.size());
+  return Status::OK();
+}
+
+Slice WriteBatchInternal::AppendByReference(WriteBatch* dst,
+                                            const WriteBatch* src,
+                                            const bool wal_only) {
   size_t src_len;
   int src_count;
   uint32_t src_flags;
@@ -2100,11 +2264,10 @@ Status WriteBatchInternal::Append(WriteBatch* dst, const WriteBatch* src,
 
   SetCount(dst, Count(dst) + src_count);
   assert(src->rep_.size() >= WriteBatchInternal::kHeader);
-  dst->rep_.append(src->rep_.data() + WriteBatchInternal::kHeader, src_len);
   dst->content_flags_.store(
       dst->content_flags_.load(std::memory_order_relaxed) | src_flags,
       std::memory_order_relaxed);
-  return Status::OK();
+  return Slice(src->rep_.data() + WriteBatchInternal::kHeader, src_len);
 }
 
 size_t WriteBatchInternal::AppendedByteSize(size_t leftByteSize,
@@ -194,6 +194,12 @@ class WriteBatchInternal {
   static Status Append(WriteBatch* dst, const WriteBatch* src,
                        const bool WAL_only = false);
 
+  // Like Append(), but only adds the count and content flags of src to dst
+  // and returns the entries of src that Append() would have copied. The
+  // returned slice refers to src and is valid while src is unchanged.
+  static Slice AppendByReference(WriteBatch* dst, const WriteBatch* src,
+                                 const bool WAL_only = false);
+
   // Returns the byte size of appending a WriteBatch with ByteSize
   // leftByteSize and a WriteBatch with ByteSize rightByteSize
   static size_t AppendedByteSize(size_t leftByteSize, size_t rightByteSize);
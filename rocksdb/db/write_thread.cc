@@ -11,6 +11,7 @@
 #include "port/port.h"
 #include "test_util/sync_point.h"
 #include "util/random.h"
+#include "util/stop_watch.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -24,6 +25,8 @@ WriteThread::WriteThread(const ImmutableDBOptions& db_options)
       enable_pipelined_write_(db_options.enable_pipelined_write),
       max_write_batch_group_size_bytes(
           db_options.max_write_batch_group_size_bytes),
+      env_(db_options.env),
+      stats_(db_options.statistics.get()),
       newest_writer_(nullptr),
       newest_memtable_writer_(nullptr),
       last_sequence_(0),
@@ -67,6 +70,13 @@ uint8_t WriteThread::AwaitState(Writer* w, uint8_t goal_mask,
   // 2. Else SOMETIMES busy loop using "yield" for 100 micro sec (default)
   // 3. Else blocking wait
 
+  // Timing the busy loop costs two clock reads on every wait, including the
+  // ones that are over in a few nanoseconds, so it is a detailed timer.
+  const bool time_spin =
+      stats_ != nullptr &&
+      stats_->get_stats_level() > StatsLevel::kExceptDetailedTimers;
+  const uint64_t spin_start = time_spin ? env_->NowMicros() : 0;
+
   // On a modern Xeon each loop takes about 7 nanoseconds (most of which
   // is the effect of the pause instruction), so 200 iterations is a bit
   // more than a microsecond.  This is long enough that waits longer than
@@ -74,10 +84,18 @@ uint8_t WriteThread::AwaitState(Writer* w, uint8_t goal_mask,
   for (uint32_t tries = 0; tries < 200; ++tries) {
     state = w->state.load(std::memory_order_acquire);
     if ((state & goal_mask) != 0) {
+      if (time_spin) {
+        RecordTimeToHistogram(stats_, WRITE_THREAD_SPIN_MICROS,
+                              env_->NowMicros() - spin_start);
+      }
       return state;
     }
     port::AsmVolatilePause();
   }
+  if (time_spin) {
+    RecordTimeToHistogram(stats_, WRITE_THREAD_SPIN_MICROS,
+                          env_->NowMicros() - spin_start);
+  }
 
   // This is below the fast path, so that the stat is zero when all writes are
   // from the same thread.
@@ -146,6 +164,7 @@ uint8_t WriteThread::AwaitState(Writer* w, uint8_t goal_mask,
       // we're updating the adaptation statistics, or spinning has >
       // 50% chance of being shorter than max_yield_usec_ and causing no
       // involuntary context switches
+      StopWatch sw(env_, stats_, WRITE_THREAD_YIELD_MICROS);
       auto spin_begin = std::chrono::steady_clock::now();
 
       // this variable doesn't include the final yield (if any) that
@@ -184,6 +203,7 @@ uint8_t WriteThread::AwaitState(Writer* w, uint8_t goal_mask,
 
   if ((state & goal_mask) == 0) {
     TEST_SYNC_POINT_CALLBACK("WriteThread::AwaitState:BlockingWaiting", w);
+    StopWatch sw(env_, stats_, WRITE_THREAD_BLOCK_MICROS);
     state = BlockingAwaitState(w, goal_mask);
   }
 
@@ -403,6 +423,7 @@ void WriteThread::JoinBatchGroup(Writer* w) {
      *      writes in parallel.
      */
     TEST_SYNC_POINT_CALLBACK("WriteThread::JoinBatchGroup:BeganWaiting", w);
+    StopWatch sw(env_, stats_, WRITE_THREAD_JOIN_WAIT_MICROS);
     AwaitState(w, STATE_GROUP_LEADER | STATE_MEMTABLE_WRITER_LEADER |
                       STATE_PARALLEL_MEMTABLE_WRITER | STATE_COMPLETED,
                &jbg_ctx);
@@ -415,6 +436,7 @@ size_t WriteThread::EnterAsBatchGroupLeader(Writer* leader,
   assert(leader->link_older == nullptr);
   assert(leader->batch != nullptr);
   assert(write_group != nullptr);
+  StopWatch sw(env_, stats_, WRITE_GROUP_FORMATION_MICROS);
 
   size_t size = WriteBatchInternal::ByteSize(leader->batch);
 
@@ -603,6 +625,7 @@ bool WriteThread::CompleteParallelMemTableWriter(Writer* w) {
 
   if (write_group->running-- > 1) {
     // we're not the last one
+    StopWatch sw(env_, stats_, WRITE_MEMTABLE_BARRIER_WAIT_MICROS);
     AwaitState(w, STATE_COMPLETED, &cpmtw_ctx);
     return false;
   }
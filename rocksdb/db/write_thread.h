@@ -120,6 +120,10 @@ class WriteThread {
     bool disable_wal;
     bool disable_memtable;
     size_t batch_cnt;  // if non-zero, number of sub-batches in the write batch
+    size_t memtable_insert_sort_threshold;
+    // Number of memtable inserts other threads do for this WAL-only write
+    // once it completes (see WalStaging)
+    size_t deferred_memtable_writes;
     PreReleaseCallback* pre_release_callback;
     uint64_t log_used;  // log number that this batch was inserted into
     uint64_t log_ref;   // log number that memtable insert should reference
@@ -143,6 +147,8 @@ class WriteThread {
           disable_wal(false),
           disable_memtable(false),
           batch_cnt(0),
+          memtable_insert_sort_threshold(0),
+          deferred_memtable_writes(0),
           pre_release_callback(nullptr),
           log_used(0),
           log_ref(0),
@@ -164,6 +170,9 @@ class WriteThread {
           disable_wal(write_options.disableWAL),
           disable_memtable(_disable_memtable),
           batch_cnt(_batch_cnt),
+          memtable_insert_sort_threshold(
+              write_options.memtable_insert_sort_threshold),
+          deferred_memtable_writes(0),
           pre_release_callback(_pre_release_callback),
           log_used(0),
           log_ref(_log_ref),
@@ -338,6 +347,12 @@ class WriteThread {
   // write is enabled.
   void WaitForMemTableWriters();
 
+  // Returns the writer that most recently joined the write queue. Comparing
+  // the result of two calls tells whether writers joined in between.
+  Writer* NewestWriter() const {
+    return newest_writer_.load(std::memory_order_acquire);
+  }
+
   SequenceNumber UpdateLastSequence(SequenceNumber sequence) {
     if (sequence > last_sequence_) {
       last_sequence_ = sequence;
@@ -368,6 +383,10 @@ class WriteThread {
   // is larger than 1/8 of this limit.
   const uint64_t max_write_batch_group_size_bytes;
 
+  // For the write stage histograms
+  Env* const env_;
+  Statistics* const stats_;
+
   // Points to the newest pending writer. Only leader can remove
   // elements, adding can be done lock-free by anybody.
   std::atomic<Writer*> newest_writer_;
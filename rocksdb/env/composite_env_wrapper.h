@@ -115,6 +115,11 @@ class CompositeWritableFileWrapper : public WritableFile {
     IODebugContext dbg;
     return target_->Append(data, io_opts, &dbg);
   }
+  Status Appendv(const Slice* data, size_t num) override {
+    IOOptions io_opts;
+    IODebugContext dbg;
+    return target_->Appendv(data, num, io_opts, &dbg);
+  }
   Status PositionedAppend(const Slice& data, uint64_t offset) override {
     IOOptions io_opts;
     IODebugContext dbg;
@@ -732,6 +737,10 @@ class LegacyWritableFileWrapper : public FSWritableFile {
                   IODebugContext* /*dbg*/) override {
     return status_to_io_status(target_->Append(data));
   }
+  IOStatus Appendv(const Slice* data, size_t num, const IOOptions& /*options*/,
+                   IODebugContext* /*dbg*/) override {
+    return status_to_io_status(target_->Appendv(data, num));
+  }
   IOStatus PositionedAppend(const Slice& data, uint64_t offset,
                             const IOOptions& /*options*/,
                             IODebugContext* /*dbg*/) override {
@@ -258,6 +258,10 @@ Status EncryptedWritableFile::Append(const Slice& data) {
   return status;
 }
 
+Status EncryptedWritableFile::Appendv(const Slice* data, size_t num) {
+  return WritableFile::Appendv(data, num);
+}
+
 Status EncryptedWritableFile::PositionedAppend(const Slice& data,
                                                uint64_t offset) {
   AlignedBuffer buf;
@@ -935,6 +935,33 @@ class IoctlFriendlyTmpdir {
   std::string dir_;
 };
 
+TEST_F(EnvPosixTest, Appendv) {
+  const std::string fname = test::PerThreadDBPath(env_, "appendv");
+  std::shared_ptr<FileSystem> fs = env_->GetFileSystem();
+  std::unique_ptr<FSWritableFile> file;
+  ASSERT_OK(fs->NewWritableFile(fname, FileOptions(), &file, nullptr));
+
+  // More slices than a single writev() takes, some of them empty
+  Random rnd(301);
+  std::vector<std::string> pieces(2500);
+  std::string expected;
+  for (auto& piece : pieces) {
+    piece = rnd.RandomString(rnd.OneIn(5) ? 0 : rnd.Uniform(100));
+    expected += piece;
+  }
+  std::vector<Slice> data(pieces.begin(), pieces.end());
+  ASSERT_OK(file->Appendv(data.data(), data.size(), IOOptions(), nullptr));
+  ASSERT_OK(file->Appendv(data.data(), 1, IOOptions(), nullptr));
+  expected += pieces[0];
+  ASSERT_EQ(expected.size(), file->GetFileSize(IOOptions(), nullptr));
+  ASSERT_OK(file->Close(IOOptions(), nullptr));
+
+  std::string contents;
+  ASSERT_OK(ReadFileToString(env_, fname, &contents));
+  ASSERT_EQ(expected, contents);
+  ASSERT_OK(env_->DeleteFile(fname));
+}
+
 #ifndef ROCKSDB_LITE
 TEST_F(EnvPosixTest, PositionedAppend) {
   std::unique_ptr<WritableFile> writable_file;
@@ -1667,104 +1694,109 @@ TEST_P(EnvPosixTestWithParam, WritableFileWrapper) {
       return Status::OK();
     }
 
+    Status Appendv(const Slice* /*data*/, size_t /*num*/) override {
+      inc(2);
+      return Status::OK();
+    }
+
     Status PositionedAppend(const Slice& /*data*/,
                             uint64_t /*offset*/) override {
-      inc(2);
+      inc(3);
       return Status::OK();
     }
 
     Status Truncate(uint64_t /*size*/) override {
-      inc(3);
+      inc(4);
       return Status::OK();
     }
 
     Status Close() override {
-      inc(4);
+      inc(5);
       return Status::OK();
     }
 
     Status Flush() override {
-      inc(5);
+      inc(6);
       return Status::OK();
     }
 
     Status Sync() override {
-      inc(6);
+      inc(7);
       return Status::OK();
     }
 
     Status Fsync() override {
-      inc(7);
+      inc(8);
       return Status::OK();
     }
 
     bool IsSyncThreadSafe() const override {
-      inc(8);
+      inc(9);
       return true;
     }
 
     bool use_direct_io() const override {
-      inc(9);
+      inc(10);
       return true;
     }
 
     size_t GetRequiredBufferAlignment() const override {
-      inc(10);
+      inc(11);
       return 0;
     }
 
-    void SetIOPriority(Env::IOPriority /*pri*/) override { inc(11); }
+    void SetIOPriority(Env::IOPriority /*pri*/) override { inc(12); }
 
     Env::IOPriority GetIOPriority() override {
-      inc(12);
+      inc(13);
       return Env::IOPriority::IO_LOW;
     }
 
     void SetWriteLifeTimeHint(Env::WriteLifeTimeHint /*hint*/) override {
-      inc(13);
+      inc(14);
     }
 
     Env::WriteLifeTimeHint GetWriteLifeTimeHint() override {
-      inc(14);
+      inc(15);
       return Env::WriteLifeTimeHint::WLTH_NOT_SET;
     }
 
     uint64_t GetFileSize() override {
-      inc(15);
+      inc(16);
       return 0;
     }
 
-    void SetPreallocationBlockSize(size_t /*size*/) override { inc(16); }
+    void SetPreallocationBlockSize(size_t /*size*/) override { inc(17); }
 
     void GetPreallocationStatus(size_t* /*block_size*/,
                                 size_t* /*last_allocated_block*/) override {
-      inc(17);
+      inc(18);
     }
 
     size_t GetUniqueId(char* /*id*/, size_t /*max_size*/) const override {
-      inc(18);
+      inc(19);
       return 0;
     }
 
     Status InvalidateCache(size_t /*offset*/, size_t /*length*/) override {
-      inc(19);
+      inc(20);
       return Status::OK();
     }
 
     Status RangeSync(uint64_t /*offset*/, uint64_t /*nbytes*/) override {
-      inc(20);
+      inc(21);
       return Status::OK();
     }
 
-    void PrepareWrite(size_t /*offset*/, size_t /*len*/) override { inc(21); }
+    void PrepareWrite(size_t /*offset*/, size_t /*len*/) override { inc(22); }
 
     Status Allocate(uint64_t /*offset*/, uint64_t /*len*/) override {
-      inc(22);
+      inc(23);
       return Status::OK();
     }
 
    public:
-    ~Base() override { inc(23); }
+    ~Base() override { inc(24); }
   };
 
   class Wrapper : public WritableFileWrapper {
@@ -1778,6 +1810,7 @@ TEST_P(EnvPosixTestWithParam, WritableFileWrapper) {
     Base b(&step);
     Wrapper w(&b);
     ASSERT_OK(w.Append(Slice()));
+    ASSERT_OK(w.Appendv(nullptr, 0));
     ASSERT_OK(w.PositionedAppend(Slice(), 0));
     ASSERT_OK(w.Truncate(0));
     ASSERT_OK(w.Close());
@@ -1801,7 +1834,7 @@ TEST_P(EnvPosixTestWithParam, WritableFileWrapper) {
     ASSERT_OK(w.Allocate(0, 0));
   }
 
-  EXPECT_EQ(24, step);
+  EXPECT_EQ(25, step);
 }
 
 TEST_P(EnvPosixTestWithParam, PosixRandomRWFile) {
@@ -226,6 +226,23 @@ IOStatus FSWritableFileTracingWrapper::Append(const Slice& data,
   return s;
 }
 
+IOStatus FSWritableFileTracingWrapper::Appendv(const Slice* data, size_t num,
+                                               const IOOptions& options,
+                                               IODebugContext* dbg) {
+  StopWatchNano timer(Env::Default());
+  timer.Start();
+  IOStatus s = target()->Appendv(data, num, options, dbg);
+  uint64_t elapsed = timer.ElapsedNanos();
+  size_t len = 0;
+  for (size_t i = 0; i < num; i++) {
+    len += data[i].size();
+  }
+  IOTraceRecord io_record(env_->NowNanos(), TraceType::kIOLen, __func__,
+                          elapsed, s.ToString(), len);
+  io_tracer_->WriteIOOp(io_record);
+  return s;
+}
+
 IOStatus FSWritableFileTracingWrapper::PositionedAppend(
     const Slice& data, uint64_t offset, const IOOptions& options,
     IODebugContext* dbg) {
@@ -250,6 +250,9 @@ class FSWritableFileTracingWrapper : public FSWritableFileWrapper {
     return Append(data, options, dbg);
   }
 
+  IOStatus Appendv(const Slice* data, size_t num, const IOOptions& options,
+                   IODebugContext* dbg) override;
+
   IOStatus PositionedAppend(const Slice& data, uint64_t offset,
                             const IOOptions& options,
                             IODebugContext* dbg) override;
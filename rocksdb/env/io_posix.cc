@@ -12,6 +12,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <algorithm>
+#include <vector>
 #if defined(OS_LINUX)
 #include <linux/fs.h>
 #ifndef FALLOC_FL_KEEP_SIZE
@@ -25,6 +26,7 @@
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #ifdef OS_LINUX
 #include <sys/statfs.h>
 #include <sys/syscall.h>
@@ -117,6 +119,55 @@ bool PosixWrite(int fd, const char* buf, size_t nbyte) {
   return true;
 }
 
+// Gathered form of PosixWrite(). Each writev() covers at most IOV_MAX slices
+// and 1GB, and short writes resume from where they stopped.
+bool PosixWritev(int fd, const Slice* data, size_t num) {
+  const size_t kLimit1Gb = 1UL << 30;
+
+  std::vector<struct iovec> iov;
+  size_t next = 0;    // first slice not completely written
+  size_t offset = 0;  // bytes of data[next] already written
+
+  while (next < num) {
+    iov.clear();
+    size_t bytes_to_write = 0;
+    for (size_t i = next; i < num && iov.size() < static_cast<size_t>(IOV_MAX) &&
+                          bytes_to_write < kLimit1Gb;
+         i++) {
+      size_t skip = i == next ? offset : 0;
+      size_t len =
+          std::min(data[i].size() - skip, kLimit1Gb - bytes_to_write);
+      if (len == 0) {
+        continue;
+      }
+      struct iovec v;
+      v.iov_base = const_cast<char*>(data[i].data() + skip);
+      v.iov_len = len;
+      iov.push_back(v);
+      bytes_to_write += len;
+    }
+    if (iov.empty()) {
+      break;
+    }
+
+    ssize_t done = writev(fd, iov.data(), static_cast<int>(iov.size()));
+    if (done < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    size_t left = static_cast<size_t>(done);
+    while (next < num && left >= data[next].size() - offset) {
+      left -= data[next].size() - offset;
+      next++;
+      offset = 0;
+    }
+    offset += left;
+  }
+  return true;
+}
+
 bool PosixPositionedWrite(int fd, const char* buf, size_t nbyte, off_t offset) {
   const size_t kLimit1Gb = 1UL << 30;
 
@@ -1175,6 +1226,26 @@ IOStatus PosixWritableFile::Append(const Slice& data, const IOOptions& /*opts*/,
   return IOStatus::OK();
 }
 
+IOStatus PosixWritableFile::Appendv(const Slice* data, size_t num,
+                                    const IOOptions& /*opts*/,
+                                    IODebugContext* /*dbg*/) {
+  size_t nbytes = 0;
+  for (size_t i = 0; i < num; i++) {
+    if (use_direct_io()) {
+      assert(IsSectorAligned(data[i].size(), GetRequiredBufferAlignment()));
+      assert(IsSectorAligned(data[i].data(), GetRequiredBufferAlignment()));
+    }
+    nbytes += data[i].size();
+  }
+
+  if (!PosixWritev(fd_, data, num)) {
+    return IOError("While appending to file", filename_, errno);
+  }
+
+  filesize_ += nbytes;
+  return IOStatus::OK();
+}
+
 IOStatus PosixWritableFile::PositionedAppend(const Slice& data, uint64_t offset,
                                              const IOOptions& /*opts*/,
                                              IODebugContext* /*dbg*/) {
@@ -247,6 +247,9 @@ class PosixWritableFile : public FSWritableFile {
                           IODebugContext* dbg) override {
     return Append(data, opts, dbg);
   }
+  virtual IOStatus Appendv(const Slice* data, size_t num,
+                           const IOOptions& opts,
+                           IODebugContext* dbg) override;
   virtual IOStatus PositionedAppend(const Slice& data, uint64_t offset,
                                     const IOOptions& opts,
                                     IODebugContext* dbg) override;
@@ -24,6 +24,7 @@ namespace ROCKSDB_NAMESPACE {
 static const std::string kRocksDbTFileExt = "sst";
 static const std::string kLevelDbTFileExt = "ldb";
 static const std::string kRocksDBBlobFileExt = "blob";
+static const std::string kTableHeatFileExt = "heat";
 
 // Given a path, flatten the path name by replacing all chars not in
 // {[0-9,a-z,A-Z,-,_,.]} with _. And append '_LOG\0' at the end.
@@ -112,6 +113,12 @@ std::string MakeTableFileName(uint64_t number) {
   return MakeFileName(number, kRocksDbTFileExt.c_str());
 }
 
+std::string TableHeatFileName(const std::string& table_file_name) {
+  const size_t dot = table_file_name.find_last_of('.');
+  assert(dot != std::string::npos);
+  return table_file_name.substr(0, dot + 1) + kTableHeatFileExt;
+}
+
 std::string Rocks2LevelTableFileName(const std::string& fullname) {
   assert(fullname.size() > kRocksDbTFileExt.size() + 1);
   if (fullname.size() <= kRocksDbTFileExt.size() + 1) {
@@ -239,8 +246,13 @@ std::string IdentityFileName(const std::string& dbname) {
   return dbname + "/IDENTITY";
 }
 
+std::string BlockCacheManifestFileName(const std::string& dbname) {
+  return dbname + "/BLOCK_CACHE_MANIFEST";
+}
+
 // Owned filenames have the form:
 //    dbname/IDENTITY
+//    dbname/BLOCK_CACHE_MANIFEST
 //    dbname/CURRENT
 //    dbname/LOCK
 //    dbname/<info_log_name_prefix>
@@ -268,6 +280,9 @@ bool ParseFileName(const std::string& fname, uint64_t* number,
   if (rest == "IDENTITY") {
     *number = 0;
     *type = kIdentityFile;
+  } else if (rest == "BLOCK_CACHE_MANIFEST") {
+    *number = 0;
+    *type = kBlockCacheManifestFile;
   } else if (rest == "CURRENT") {
     *number = 0;
     *type = kCurrentFile;
@@ -363,6 +378,8 @@ bool ParseFileName(const std::string& fname, uint64_t* number,
       *type = kTableFile;
     } else if (suffix == Slice(kRocksDBBlobFileExt)) {
       *type = kBlobFile;
+    } else if (suffix == Slice(kTableHeatFileExt)) {
+      *type = kTableHeatFile;
     } else if (suffix == Slice(kTempFileNameSuffix)) {
       *type = kTempFile;
     } else {
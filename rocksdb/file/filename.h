@@ -46,7 +46,9 @@ enum FileType {
   kMetaDatabase,
   kIdentityFile,
   kOptionsFile,
-  kBlobFile
+  kBlobFile,
+  kTableHeatFile,
+  kBlockCacheManifestFile
 };
 
 // Return the name of the log file with the specified number
@@ -76,6 +78,10 @@ extern std::string MakeTableFileName(const std::string& name, uint64_t number);
 
 extern std::string MakeTableFileName(uint64_t number);
 
+// Return the name of the partition heat sidecar file of the given table file,
+// e.g. "/db/000123.sst" -> "/db/000123.heat".
+extern std::string TableHeatFileName(const std::string& table_file_name);
+
 // Return the name of sstable with LevelDB suffix
 // created from RocksDB sstable suffixed name
 extern std::string Rocks2LevelTableFileName(const std::string& fullname);
@@ -158,6 +164,10 @@ extern std::string MetaDatabaseName(const std::string& dbname,
 // either from a backup-image or empty
 extern std::string IdentityFileName(const std::string& dbname);
 
+// Return the name of the file listing the blocks that were in the block
+// cache when it was last written.
+extern std::string BlockCacheManifestFileName(const std::string& dbname);
+
 // If filename is a rocksdb file, store the type of the file in *type.
 // The number encoded in the filename is stored in *number.  If the
 // filename was successfully parsed, returns true.  Else return false.
@@ -11,6 +11,7 @@
 
 #include <algorithm>
 #include <mutex>
+#include <vector>
 
 #include "db/version_edit.h"
 #include "monitoring/histogram.h"
@@ -96,6 +97,48 @@ IOStatus WritableFileWriter::Append(const Slice& data) {
   return s;
 }
 
+IOStatus WritableFileWriter::Appendv(const Slice* data, size_t num) {
+  size_t size = 0;
+  for (size_t i = 0; i < num; i++) {
+    size += data[i].size();
+  }
+
+  // Direct I/O and rate limited writes go through the buffer, as do writes
+  // that fit in it without a flush
+  if (num <= 1 || use_direct_io() || rate_limiter_ != nullptr ||
+      buf_.Capacity() - buf_.CurrentSize() >= size) {
+    IOStatus s;
+    for (size_t i = 0; i < num && s.ok(); i++) {
+      s = Append(data[i]);
+    }
+    return s;
+  }
+
+  pending_sync_ = true;
+
+  TEST_KILL_RANDOM("WritableFileWriter::Append:0",
+                   rocksdb_kill_odds * REDUCE_ODDS2);
+
+  for (size_t i = 0; i < num; i++) {
+    UpdateFileChecksum(data[i]);
+  }
+
+  {
+    IOSTATS_TIMER_GUARD(prepare_write_nanos);
+    TEST_SYNC_POINT("WritableFileWriter::Append:BeforePrepareWrite");
+    writable_file_->PrepareWrite(static_cast<size_t>(GetFileSize()), size,
+                                 IOOptions(), nullptr);
+  }
+
+  IOStatus s = WriteBufferedv(data, num, size);
+
+  TEST_KILL_RANDOM("WritableFileWriter::Append:1", rocksdb_kill_odds);
+  if (s.ok()) {
+    filesize_ += size;
+  }
+  return s;
+}
+
 IOStatus WritableFileWriter::Pad(const size_t pad_bytes) {
   assert(pad_bytes < kDefaultPageSize);
   size_t left = pad_bytes;
@@ -431,6 +474,60 @@ IOStatus WritableFileWriter::WriteBuffered(const char* data, size_t size) {
   return s;
 }
 
+IOStatus WritableFileWriter::WriteBufferedv(const Slice* data, size_t num,
+                                            size_t size) {
+  IOStatus s;
+  assert(!use_direct_io());
+  assert(rate_limiter_ == nullptr);
+
+  std::vector<Slice> iov;
+  iov.reserve(num + 1);
+  if (buf_.CurrentSize() > 0) {
+    iov.emplace_back(buf_.BufferStart(), buf_.CurrentSize());
+  }
+  size_t total = buf_.CurrentSize() + size;
+  for (size_t i = 0; i < num; i++) {
+    if (!data[i].empty()) {
+      iov.push_back(data[i]);
+    }
+  }
+
+  {
+    IOSTATS_TIMER_GUARD(write_nanos);
+    TEST_SYNC_POINT("WritableFileWriter::Flush:BeforeAppend");
+
+#ifndef ROCKSDB_LITE
+    FileOperationInfo::StartTimePoint start_ts;
+    uint64_t old_size = writable_file_->GetFileSize(IOOptions(), nullptr);
+    if (ShouldNotifyListeners()) {
+      start_ts = FileOperationInfo::StartNow();
+      old_size = next_write_offset_;
+    }
+#endif
+    {
+      auto prev_perf_level = GetPerfLevel();
+      IOSTATS_CPU_TIMER_GUARD(cpu_write_nanos, env_);
+      s = writable_file_->Appendv(iov.data(), iov.size(), IOOptions(),
+                                  nullptr);
+      SetPerfLevel(prev_perf_level);
+    }
+#ifndef ROCKSDB_LITE
+    if (ShouldNotifyListeners()) {
+      auto finish_ts = std::chrono::steady_clock::now();
+      NotifyOnFileWriteFinish(old_size, total, start_ts, finish_ts, s);
+    }
+#endif
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  IOSTATS_ADD(bytes_written, total);
+  TEST_KILL_RANDOM("WritableFileWriter::WriteBuffered:0", rocksdb_kill_odds);
+  buf_.Size(0);
+  return s;
+}
+
 void WritableFileWriter::UpdateFileChecksum(const Slice& data) {
   if (checksum_generator_ != nullptr) {
     checksum_generator_->Update(data.data(), data.size());
@@ -203,6 +203,12 @@ class WritableFileWriter {
 
   IOStatus Append(const Slice& data);
 
+  // Appends the concatenation of data[0..num-1]. Small appends are copied into
+  // the buffer as with Append(). When they do not fit, the buffered data and
+  // the slices are handed to the file in a single gathered write instead of
+  // being copied and flushed piecewise.
+  IOStatus Appendv(const Slice* data, size_t num);
+
   IOStatus Pad(const size_t pad_bytes);
 
   IOStatus Flush();
@@ -245,6 +251,9 @@ class WritableFileWriter {
 #endif  // !ROCKSDB_LITE
   // Normal write
   IOStatus WriteBuffered(const char* data, size_t size);
+  // Writes the buffered data followed by data[0..num-1] with one
+  // FSWritableFile::Appendv(). REQUIRES: no rate limiter
+  IOStatus WriteBufferedv(const Slice* data, size_t num, size_t size);
   IOStatus RangeSync(uint64_t offset, uint64_t nbytes);
   IOStatus SyncInternal(bool use_fsync);
 };
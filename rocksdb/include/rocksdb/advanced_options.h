@@ -54,6 +54,14 @@ enum CompactionPri : char {
   // and its size is the smallest. It in many cases can optimize write
   // amplification.
   kMinOverlappingRatio = 0x3,
+  // Like kMinOverlappingRatio, but the ratio between the size the compaction
+  // writes and the file size is divided by how often reads are sampled to
+  // look into the file compared to the other files of its level. Files in
+  // ranges with many reads are compacted first to reduce read amplification,
+  // and those in rarely read ranges later. Files start cold after being
+  // written or after the DB is reopened, since read samples are not
+  // persisted.
+  kReadHeatWeightedOverlappingRatio = 0x4,
 };
 
 struct CompactionOptionsFIFO {
@@ -246,6 +254,23 @@ struct AdvancedColumnFamilyOptions {
   // Default: false.
   bool inplace_update_support = false;
 
+  // Only takes effect if inplace_update_support is true and the merge
+  // operator is associative and commutative (see
+  // MergeOperator::IsAssociativeAndCommutative(), e.g. uint64add).
+  // If true, Merge(key, operand) folds the operand into the newest entry of
+  // the key in the current memtable instead of appending it:
+  //   * a Put is replaced by the result of the merge, in place if it is not
+  //     larger
+  //   * a merge operand is combined with the new operand by PartialMerge(),
+  //     in place if the result is not larger, otherwise the operand is
+  //     appended as usual
+  // Reads then find one entry instead of a chain of operands. Like
+  // inplace_update_support, this gives up point-in-time consistency of
+  // snapshots and iterators for the key. Operands are appended as usual once
+  // the current memtable holds a range deletion.
+  // Default: false.
+  bool inplace_merge_support = false;
+
   // Number of locks used for inplace update
   // Default: 10000, if inplace_update_support = true, else 0.
   //
@@ -313,6 +338,44 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through SetOptions() API
   bool memtable_whole_key_filtering = false;
 
+  // If not 0, each memtable keeps a hash index from user key to the newest
+  // entry of the key, with write_buffer_size * memtable_hash_index_size_ratio
+  // bytes of buckets plus 16 bytes per distinct key, allocated from the
+  // memtable arena. Point lookups of keys whose newest entry is a Put or a
+  // Delete visible to the reader, and of keys that are not in the memtable,
+  // are then answered by the index without searching the memtable. The index
+  // is not used with comparators for which keys with different bytes can
+  // compare equal, or with user-defined timestamps.
+  // If it is larger than 0.25, it is sanitized to 0.25.
+  //
+  // Default: 0 (disable)
+  //
+  // Dynamically changeable through SetOptions() API
+  double memtable_hash_index_size_ratio = 0.0;
+
+  // If not 0, the flush of a memtable that was switched for being full
+  // first copies the entries that are still visible to the latest sequence
+  // number or to a snapshot into a new memtable, collapsing overwritten and
+  // deleted versions of the same key. The copy also takes in the immutable
+  // memtables waiting to be flushed, including earlier copies. If at least
+  // this fraction of their data was dropped, the copy replaces them as an
+  // immutable memtable and nothing is flushed; otherwise the copy is
+  // discarded and the memtables are flushed as usual. The copy is made in a
+  // flush thread, so writes only wait for it once max_write_buffer_number is
+  // reached. This helps workloads that overwrite a small set of keys at a
+  // high rate. Memtables with range deletions, flushes requested by the
+  // user, the write buffer manager or max_total_wal_size, and DBs using
+  // atomic_flush, two-phase commit or WritePrepared/WriteUnprepared
+  // transactions are always flushed. WAL files are kept until the data of
+  // the copy is flushed, which is bounded by max_total_wal_size.
+  // If it is larger than 0.9, it is sanitized to 0.9. If it is positive but
+  // smaller than 0.1, it is sanitized to 0.1.
+  //
+  // Default: 0 (disable)
+  //
+  // Dynamically changeable through SetOptions() API
+  double memtable_gc_min_garbage_ratio = 0.0;
+
   // Page size for huge page for the arena used by the memtable. If <=0, it
   // won't allocate from huge page but from malloc.
   // Users are responsible to reserve huge pages for it to be allocated. For
@@ -772,6 +835,31 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through the SetOptions() API
   CompressionType blob_compression_type = kNoCompression;
 
+  // UNDER CONSTRUCTION -- DO NOT USE
+  // When set, compactions relocate the valid blobs they encounter in the
+  // oldest blob files to new blob files, so that the old files become
+  // garbage as a whole and can be deleted. Which blob files count as old is
+  // determined by blob_garbage_collection_age_cutoff below. If
+  // enable_blob_files is not set, the relocated values are stored in the SST
+  // files again. Blobs whose references the compaction filter keeps are
+  // relocated as well; this includes any CompactionFilter that only filters
+  // plain values.
+  //
+  // Default: false
+  //
+  // Dynamically changeable through the SetOptions() API
+  bool enable_blob_garbage_collection = false;
+
+  // UNDER CONSTRUCTION -- DO NOT USE
+  // The fraction of the blob files, the oldest ones, whose valid blobs are
+  // relocated by compactions. Note that enable_blob_garbage_collection has to
+  // be set in order for this option to have any effect.
+  //
+  // Default: 0.25
+  //
+  // Dynamically changeable through the SetOptions() API
+  double blob_garbage_collection_age_cutoff = 0.25;
+
   // Create ColumnFamilyOptions with default values for all fields
   AdvancedColumnFamilyOptions();
   // Create ColumnFamilyOptions from Options
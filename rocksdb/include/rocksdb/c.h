@@ -1552,6 +1552,12 @@ rocksdb_writeoptions_set_memtable_insert_hint_per_batch(rocksdb_writeoptions_t*,
 extern ROCKSDB_LIBRARY_API unsigned char
 rocksdb_writeoptions_get_memtable_insert_hint_per_batch(
     rocksdb_writeoptions_t*);
+extern ROCKSDB_LIBRARY_API void
+rocksdb_writeoptions_set_memtable_insert_sort_threshold(rocksdb_writeoptions_t*,
+                                                        size_t);
+extern ROCKSDB_LIBRARY_API size_t
+rocksdb_writeoptions_get_memtable_insert_sort_threshold(
+    rocksdb_writeoptions_t*);
 
 /* Compact range options */
 
@@ -23,6 +23,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <functional>
 #include <memory>
 #include <string>
 #include "rocksdb/memory_allocator.h"
@@ -44,6 +45,18 @@ enum CacheMetadataChargePolicy {
 const CacheMetadataChargePolicy kDefaultCacheMetadataChargePolicy =
     kFullChargeCacheMetadata;
 
+// Decides whether a new entry may displace existing ones when the cache is
+// full.
+enum CacheAdmissionPolicy {
+  // Always insert, evicting least recently used entries as needed.
+  kAdmitAll,
+  // TinyLFU: keep an approximate count of recent lookups per key, and only
+  // insert a low priority entry into a full cache if its key was looked up
+  // more often than the key of the entry it would evict. This keeps blocks
+  // read once by long scans from pushing out frequently used blocks.
+  kAdmitByFrequency,
+};
+
 struct LRUCacheOptions {
   // Capacity of the cache.
   size_t capacity = 0;
@@ -87,6 +100,17 @@ struct LRUCacheOptions {
   CacheMetadataChargePolicy metadata_charge_policy =
       kDefaultCacheMetadataChargePolicy;
 
+  // Admission policy applied when the cache is full. With kAdmitByFrequency,
+  // an insert that is not admitted without a handle still returns OK, and the
+  // entry is dropped right away. If a handle was requested, the insert also
+  // returns OK, and the entry stays alive only until the handle is released
+  // and is not charged to the cache; with strict_capacity_limit, however, it
+  // fails with Status::Incomplete() and a null handle, like an insert into a
+  // cache that is full of pinned entries. An entry is admitted if it was
+  // looked up more often than all the entries that would be evicted to make
+  // room for it. High priority entries are always admitted.
+  CacheAdmissionPolicy admission_policy = kAdmitAll;
+
   LRUCacheOptions() {}
   LRUCacheOptions(size_t _capacity, int _num_shard_bits,
                   bool _strict_capacity_limit, double _high_pri_pool_ratio,
@@ -122,10 +146,10 @@ extern std::shared_ptr<Cache> NewLRUCache(
 extern std::shared_ptr<Cache> NewLRUCache(const LRUCacheOptions& cache_opts);
 
 // Similar to NewLRUCache, but create a cache based on CLOCK algorithm with
-// better concurrent performance in some cases. See util/clock_cache.cc for
-// more detail.
+// better concurrent performance in some cases. Lookups that hit do not take
+// the shard mutex. See cache/clock_cache.cc for more detail.
 //
-// Return nullptr if it is not supported.
+// Return nullptr if it is not supported (ROCKSDB_LITE).
 extern std::shared_ptr<Cache> NewClockCache(
     size_t capacity, int num_shard_bits = -1,
     bool strict_capacity_limit = false,
@@ -279,6 +303,17 @@ class Cache {
   virtual void ApplyToAllCacheEntries(void (*callback)(void*, size_t),
                                       bool thread_safe) = 0;
 
+  // Apply callback to the key of every entry in the cache. `hit` tells
+  // whether the entry has been looked up since it was inserted. The callback
+  // may run after the entry was erased, and must not call back into the
+  // cache.
+  // If thread_safe is true, it will also lock the accesses. Otherwise, it will
+  // access the cache without the lock held
+  // The default implementation does not visit any entry.
+  virtual void ApplyToAllCacheKeys(
+      const std::function<void(const Slice& key, bool hit)>& /*callback*/,
+      bool /*thread_safe*/) {}
+
   // Remove all entries.
   // Prerequisite: no entry is referenced.
   virtual void EraseUnRefEntries() = 0;
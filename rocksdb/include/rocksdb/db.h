@@ -221,6 +221,20 @@ class DB {
       const std::vector<ColumnFamilyDescriptor>& column_families,
       std::vector<ColumnFamilyHandle*>* handles, DB** dbptr);
 
+  // Runs a compaction job of DBOptions::compaction_service, described by
+  // input, on the DB name, which is opened as a secondary instance for it.
+  // The output files and the info log are written to output_directory. On
+  // return, *output holds the result to hand back to the DB, including when
+  // the compaction failed; the returned status only tells whether *output
+  // could be produced at all.
+  //
+  // Not supported in ROCKSDB_LITE, in which case the function will
+  // return Status::NotSupported.
+  static Status OpenAndCompact(
+      const std::string& name, const std::string& output_directory,
+      const std::string& input, std::string* output,
+      const CompactionServiceOptionsOverride& override_options);
+
   // Open DB with column families.
   // db_options specify database specific options
   // column_families is the vector of all column families in the database,
@@ -927,6 +941,17 @@ class DB {
     // "rocksdb.options-statistics" - returns multi-line string
     //      of options.statistics
     static const std::string kOptionsStatistics;
+
+    //  "rocksdb.write-stage-stats" - returns a table with the latency of
+    //      each stage of the write path, from the histograms of
+    //      options.statistics. As a map property, it returns "<stage>.count",
+    //      "<stage>.sum", "<stage>.avg", "<stage>.p50", "<stage>.p95",
+    //      "<stage>.p99" and "<stage>.max" in microseconds for the stages
+    //      "write" (the whole write), "join_wait", "group_formation", "wal",
+    //      "wal_sync", "memtable", "memtable_barrier_wait", and "spin",
+    //      "yield" and "block" (how waiting writers waited). Only available
+    //      when options.statistics is set.
+    static const std::string kWriteStageStats;
   };
 #endif /* ROCKSDB_LITE */
 
@@ -769,6 +769,19 @@ class WritableFile {
   // PositionedAppend, so the users cannot mix the two.
   virtual Status Append(const Slice& data) = 0;
 
+  // Append the concatenation of data[0..num-1] to the end of the file. The
+  // default implementation appends each slice in turn.
+  // Note: Only used with buffered (non-direct) I/O.
+  virtual Status Appendv(const Slice* data, size_t num) {
+    for (size_t i = 0; i < num; i++) {
+      Status s = Append(data[i]);
+      if (!s.ok()) {
+        return s;
+      }
+    }
+    return Status::OK();
+  }
+
   // PositionedAppend data to the specified offset. The new EOF after append
   // must be larger than the previous EOF. This is to be used when writes are
   // not backed by OS buffers and hence has to always start from the start of
@@ -1497,6 +1510,9 @@ class WritableFileWrapper : public WritableFile {
   explicit WritableFileWrapper(WritableFile* t) : target_(t) {}
 
   Status Append(const Slice& data) override { return target_->Append(data); }
+  Status Appendv(const Slice* data, size_t num) override {
+    return target_->Appendv(data, num);
+  }
   Status PositionedAppend(const Slice& data, uint64_t offset) override {
     return target_->PositionedAppend(data, offset);
   }
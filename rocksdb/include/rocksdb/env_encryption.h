@@ -312,6 +312,10 @@ class EncryptedWritableFile : public WritableFileWrapper {
 
   Status Append(const Slice& data) override;
 
+  // Encrypts and appends each slice in turn; the slices must not reach the
+  // wrapped file as they are.
+  Status Appendv(const Slice* data, size_t num) override;
+
   Status PositionedAppend(const Slice& data, uint64_t offset) override;
 
   // Indicates the upper layers if the current WritableFile implementation
@@ -746,6 +746,22 @@ class FSWritableFile {
     return Append(data, options, dbg);
   }
 
+  // Append the concatenation of data[0..num-1] to the end of the file. File
+  // systems that support gathered writes (e.g. writev()) can override this to
+  // issue a single request. The default implementation appends each slice in
+  // turn.
+  // Note: Only used with buffered (non-direct) I/O.
+  virtual IOStatus Appendv(const Slice* data, size_t num,
+                           const IOOptions& options, IODebugContext* dbg) {
+    for (size_t i = 0; i < num; i++) {
+      IOStatus s = Append(data[i], options, dbg);
+      if (!s.ok()) {
+        return s;
+      }
+    }
+    return IOStatus::OK();
+  }
+
   // PositionedAppend data to the specified offset. The new EOF after append
   // must be larger than the previous EOF. This is to be used when writes are
   // not backed by OS buffers and hence has to always start from the start of
@@ -1320,6 +1336,10 @@ class FSWritableFileWrapper : public FSWritableFile {
                   IODebugContext* dbg) override {
     return target_->Append(data, options, verification_info, dbg);
   }
+  IOStatus Appendv(const Slice* data, size_t num, const IOOptions& options,
+                   IODebugContext* dbg) override {
+    return target_->Appendv(data, num, options, dbg);
+  }
   IOStatus PositionedAppend(const Slice& data, uint64_t offset,
                             const IOOptions& options,
                             IODebugContext* dbg) override {
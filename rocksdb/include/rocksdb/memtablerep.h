@@ -349,6 +349,26 @@ class VectorRepFactory : public MemTableRepFactory {
   virtual const char* Name() const override { return "VectorRepFactory"; }
 };
 
+// This uses a B+-tree with nodes of a few cache lines to store keys. A
+// lookup or seek reads one node per level of the tree, where the skip list
+// follows a pointer to a different cache line for most of the keys it
+// compares against, so point lookups and seeks in large memtables are
+// faster. Supports concurrent inserts and detects duplicated keys like the
+// skip list.
+class BTreeRepFactory : public MemTableRepFactory {
+ public:
+  using MemTableRepFactory::CreateMemTableRep;
+  virtual MemTableRep* CreateMemTableRep(const MemTableRep::KeyComparator&,
+                                         Allocator*, const SliceTransform*,
+                                         Logger* logger) override;
+
+  virtual const char* Name() const override { return "BTreeRepFactory"; }
+
+  bool IsInsertConcurrentlySupported() const override { return true; }
+
+  bool CanHandleDuplicatedKey() const override { return true; }
+};
+
 // This class contains a fixed array of buckets, each
 // pointing to a skiplist (null if the bucket is empty).
 // bucket_count: number of fixed array buckets
@@ -220,6 +220,13 @@ class MergeOperator {
   virtual bool ShouldMerge(const std::vector<Slice>& /*operands*/) const {
     return false;
   }
+
+  // Override and return true if applying operands to a value, or combining
+  // them with PartialMerge(), gives the same result whichever way they are
+  // grouped or ordered, as for addition. Such operands can be folded into
+  // the memtable entry of the key at write time, see
+  // ColumnFamilyOptions::inplace_merge_support.
+  virtual bool IsAssociativeAndCommutative() const { return false; }
 };
 
 // The simpler, associative merge operator.
@@ -44,6 +44,7 @@ enum InfoLogLevel : unsigned char;
 class SstFileManager;
 class FilterPolicy;
 class Logger;
+class MemoryAllocator;
 class MergeOperator;
 class Snapshot;
 class MemTableRepFactory;
@@ -293,6 +294,14 @@ struct ColumnFamilyOptions : public AdvancedColumnFamilyOptions {
   // Default: nullptr
   std::shared_ptr<SstPartitionerFactory> sst_partitioner_factory = nullptr;
 
+  // If non-nullptr, memtable arena blocks are allocated from this allocator
+  // instead of with new[], and memtable_huge_page_size is ignored. With the
+  // allocator from NewHugePageSlabAllocator(), the blocks are backed by huge
+  // pages and placed on the NUMA node of the writer thread that needed them.
+  //
+  // Default: nullptr
+  std::shared_ptr<MemoryAllocator> memtable_memory_allocator = nullptr;
+
   // Create ColumnFamilyOptions with default values for all fields
   ColumnFamilyOptions();
   // Create ColumnFamilyOptions from Options
@@ -348,6 +357,40 @@ struct DbPath {
   DbPath(const std::string& p, uint64_t t) : path(p), target_size(t) {}
 };
 
+enum class CompactionServiceJobStatus : char {
+  kSuccess,
+  kFailure,
+  // Run the compaction in the DB process instead
+  kUseLocal,
+};
+
+// Runs compactions of a DB outside of it, e.g. in a worker process that is
+// isolated from the DB process with cgroups or bound to another NUMA node.
+// A compaction job is described by an opaque string that the worker passes
+// to DB::OpenAndCompact(), together with the path of the DB and a directory
+// to write the output files to. That directory must be on the same file
+// system as the DB, since the DB moves the output files into the DB
+// directory. The string that DB::OpenAndCompact() returns is handed back to
+// the DB, which then installs the output files as if it had written them.
+//
+// Both methods may be called concurrently from several compaction threads.
+class CompactionService {
+ public:
+  virtual ~CompactionService() {}
+
+  virtual const char* Name() const = 0;
+
+  // Starts the compaction job described by compaction_service_input. job_id
+  // identifies the job in the following WaitForComplete() call.
+  virtual CompactionServiceJobStatus Start(
+      const std::string& compaction_service_input, uint64_t job_id) = 0;
+
+  // Waits for the job job_id to complete. On kSuccess,
+  // *compaction_service_result is the result of DB::OpenAndCompact().
+  virtual CompactionServiceJobStatus WaitForComplete(
+      uint64_t job_id, std::string* compaction_service_result) = 0;
+};
+
 struct DBOptions {
   // The function recovers options to the option as in version 4.6.
   DBOptions* OldDefaults(int rocksdb_major_version = 4,
@@ -1166,6 +1209,158 @@ struct DBOptions {
   //
   // Default: false
   bool allow_data_in_errors = false;
+
+  // If not zero, record which table blocks are resident in the block cache
+  // every block_cache_manifest_period_sec seconds and when the DB is closed,
+  // in the BLOCK_CACHE_MANIFEST file of the DB directory. On the next
+  // DB::Open() the recorded blocks are read back into the block cache by
+  // background threads of the LOW priority pool, blocks that had been hit
+  // before the others, and each table file in offset order. Reads are
+  // throttled by `rate_limiter` if it is set to limit reads.
+  // Only block-based tables are warmed up.
+  //
+  // Default: 0 (disabled)
+  unsigned int block_cache_manifest_period_sec = 0;
+
+  // If true, writes do not join the write thread to write the WAL. Each
+  // writer appends its batch to a staging buffer of the CPU core it runs on,
+  // and a dedicated log thread writes what all the buffers hold to the WAL
+  // as one record, syncing it once if any of its writers asked for sync. The
+  // writers then insert into the memtables concurrently. This takes the copy
+  // of each batch into the WAL record off the write group leader and lets
+  // batches from many threads reach the WAL with one append.
+  // Requires unordered_write. Writes with a WriteCallback, with disableWAL or
+  // no_slowdown, empty batches and transaction writes use the regular write
+  // path.
+  //
+  // Default: false
+  bool enable_wal_staging_buffers = false;
+
+  // Only takes effect when the write buffer manager is enabled, see
+  // db_write_buffer_size and write_buffer_manager.
+  // If true, when the write buffer manager is full, the column family to
+  // flush is the one whose active memtable frees the most memory per unit of
+  // expected flush and compaction cost, instead of the one with the oldest
+  // memtable. The cost counts the bytes the flush is expected to write, from
+  // the ratio of output to memtable size of the column family's recent
+  // flushes (lower for overwrite-heavy column families), plus the share of an
+  // L0->L1 compaction each new L0 file costs. Memory freed from column
+  // families that write fast enough to refill their memtable before the
+  // whole write buffer would fill again counts only partially.
+  // In addition, a memtable may borrow memory the write buffer manager has to
+  // spare and grow up to twice its write_buffer_size before it is flushed,
+  // so that column families with high write rates produce fewer, larger L0
+  // files while the others are idle.
+  //
+  // Default: false
+  bool cost_based_write_buffer_flush = false;
+
+  // If non-zero, the leader of a write group with WriteOptions::sync set may
+  // wait up to this many microseconds before it gathers its group, so that
+  // sync writes arriving meanwhile share its WAL sync instead of each group
+  // waiting for a sync of its own. The actual wait adapts to the observed
+  // latency of WAL syncs: it never exceeds half of the average sync time,
+  // grows while waiting gathers more writers and shrinks while it does not.
+  // The writers per sync and the added latency are reported in the
+  // WAL_SYNC_COALESCED_WRITES and WAL_SYNC_COALESCING_WAIT_MICROS histograms.
+  // Has no effect with enable_pipelined_write, two_write_queues,
+  // unordered_write or enable_wal_staging_buffers.
+  //
+  // Default: 0 (disabled)
+  uint64_t wal_sync_coalescing_max_wait_us = 0;
+
+  // If true, each subcompaction reads its input ahead on a dedicated thread:
+  // reading, decrypting and decompressing input blocks and merging the input
+  // files overlap with processing the merged entries and building the output
+  // files. Set CompressionOptions::parallel_threads as well to also compress
+  // and write output blocks on separate threads. Subcompactions whose input
+  // files in levels other than L0 have range deletions are not pipelined.
+  // Pipelined subcompactions never copy input blocks as they are, see
+  // reuse_compaction_input_blocks.
+  //
+  // Default: false
+  bool enable_pipelined_compaction = false;
+
+  // If true, subcompaction boundaries are chosen from keys sampled from the
+  // indexes of the input files (only the top level of partitioned indexes),
+  // so that even a compaction of a few large files is split into
+  // max_subcompactions ranges of similar size. Otherwise they are chosen
+  // among the boundaries of the input files. With level style compaction,
+  // this also lets L0->L1 and manual compactions into an empty output level
+  // use subcompactions.
+  //
+  // Default: false
+  bool sample_subcompaction_boundaries = false;
+
+  // If true, compactions whose output level is L0, i.e. universal compactions
+  // with num_levels = 1 or into L0 and intra-L0 compactions, are also split
+  // into up to max_subcompactions key ranges that run in parallel. The ranges
+  // are chosen as with sample_subcompaction_boundaries, since the inputs of
+  // such compactions usually all cover the whole key range. The output files
+  // of the subcompactions get the same sequence number range and are treated
+  // as a single sorted run by the compaction pickers.
+  //
+  // Older versions of RocksDB may report such files as out of order when
+  // force_consistency_checks is set.
+  //
+  // Default: false
+  bool enable_l0_subcompactions = false;
+
+  // If true, a compaction that outputs every entry of an input data block
+  // unchanged and in a row, with nothing in between, writes the block as it
+  // is stored in the input file instead of building, compressing and
+  // encrypting a new one. The entries are still read and processed as usual.
+  // This mostly helps compactions into non-bottommost levels whose inputs
+  // overlap little. Only applies to block-based tables with the same
+  // checksum type, format version and compression as the input file, and
+  // not with a compression dictionary, block_align, parallel compression,
+  // a compressed block cache or enable_pipelined_compaction.
+  //
+  // Default: false
+  bool reuse_compaction_input_blocks = false;
+
+  // If true, when the only file a leveled compaction picks from L1 or below
+  // overlaps the next level with a part of its key range only, the parts
+  // before and after the overlapping files of the next level are moved down
+  // without rewriting them, as in a trivial move. The file is replaced with
+  // table slices: files that refer to a key range of the original table file
+  // instead of a table file of their own. The middle slice is compacted as
+  // usual afterwards. The table file is deleted once no slice refers to it,
+  // and slices that refer to less than half of their table file are
+  // compacted so that this happens. Files with range deletions and manual
+  // compactions are not split. GetLiveFilesMetaData() and
+  // GetColumnFamilyMetaData() list table slices under their own file numbers,
+  // which can be passed to CompactFiles() and DeleteFile() but have no file
+  // on disk; GetLiveFiles() lists the table files.
+  //
+  // Older versions of RocksDB cannot open a DB that contains table slices.
+  //
+  // Default: false
+  bool enable_partial_trivial_move = false;
+
+  // If set, the compactions of this DB are run by the compaction service
+  // instead of the compaction threads, which only wait for them. Each
+  // subcompaction is a job of its own. Compactions with a snapshot checker,
+  // i.e. of transaction DBs with WritePrepared or WriteUnprepared
+  // transactions, are always run locally. Not supported in ROCKSDB_LITE.
+  //
+  // Default: nullptr
+  std::shared_ptr<CompactionService> compaction_service = nullptr;
+
+  // If true, compactions skip the parts of their input files whose entries
+  // are all deleted by range deletions of the compaction, instead of reading
+  // the entries and dropping them one by one. Before reading the entries, a
+  // compaction compares the key range and the sequence number range of each
+  // input file with the range tombstones of the input files: an input file
+  // that is covered as a whole is not read at all, and within the others,
+  // the iterator seeks past the covered key ranges, so that the data blocks
+  // entirely inside them are not read, decrypted or decompressed. The
+  // compaction filter is not called for the skipped entries. Compactions
+  // with a snapshot checker, i.e. of transaction DBs with WritePrepared or
+  // WriteUnprepared transactions, do not skip anything.
+  //
+  // Default: false
+  bool skip_range_deleted_compaction_input = false;
 };
 
 // Options to control the behavior of a database (passed to DB::Open)
@@ -1457,6 +1652,19 @@ struct WriteOptions {
   // Default: false
   bool memtable_insert_hint_per_batch;
 
+  // If non-zero, a write batch with at least this many entries is sorted by
+  // key before it is inserted into the memtable, and each insert resumes the
+  // skip list search from the position of the previous one instead of
+  // searching from the head. Inserting a large batch then costs time linear
+  // in the distance between consecutive keys rather than logarithmic in the
+  // memtable size. Only batches consisting of Put, Delete and SingleDelete
+  // are sorted, and only into column families without
+  // inplace_update_support; other batches are inserted in order. Has no
+  // effect with seq_per_batch transactions (WritePrepared/WriteUnprepared).
+  //
+  // Default: 0 (disabled)
+  size_t memtable_insert_sort_threshold;
+
   // Timestamp of write operation, e.g. Put. All timestamps of the same
   // database must share the same length and format. The user is also
   // responsible for providing a customized compare function via Comparator to
@@ -1475,6 +1683,7 @@ struct WriteOptions {
         no_slowdown(false),
         low_pri(false),
         memtable_insert_hint_per_batch(false),
+        memtable_insert_sort_threshold(0),
         timestamp(nullptr) {}
 };
 
@@ -1653,6 +1862,24 @@ struct ImportColumnFamilyOptions {
   bool move_files = false;
 };
 
+// The options that DB::OpenAndCompact() cannot get from the compaction job
+// description, because they are not serializable. They should be the same as
+// those of the DB that started the job.
+struct CompactionServiceOptionsOverride {
+  Env* env = Env::Default();
+  std::shared_ptr<FileChecksumGenFactory> file_checksum_gen_factory = nullptr;
+
+  const Comparator* comparator = BytewiseComparator();
+  std::shared_ptr<MergeOperator> merge_operator = nullptr;
+  const CompactionFilter* compaction_filter = nullptr;
+  std::shared_ptr<CompactionFilterFactory> compaction_filter_factory = nullptr;
+  std::shared_ptr<const SliceTransform> prefix_extractor = nullptr;
+  // If not set, the table factory is built from the options of the job
+  // description, which only works for the built-in table formats.
+  std::shared_ptr<TableFactory> table_factory = nullptr;
+  std::shared_ptr<SstPartitionerFactory> sst_partitioner_factory = nullptr;
+};
+
 // Options used with DB::GetApproximateSizes()
 struct SizeApproximationOptions {
   // Defines whether the returned size should include the recently written
@@ -183,6 +183,12 @@ struct PerfContext {
   uint64_t bloom_memtable_hit_count;
   // total number of mem table bloom misses
   uint64_t bloom_memtable_miss_count;
+  // total number of mem table lookups answered by the hash index, see
+  // ColumnFamilyOptions::memtable_hash_index_size_ratio
+  uint64_t memtable_hash_index_hit_count;
+  // total number of mem table lookups that fell back to the memtable rep
+  // because the hash index could not answer them
+  uint64_t memtable_hash_index_miss_count;
   // total number of SST table bloom hits
   uint64_t bloom_sst_hit_count;
   // total number of SST table bloom misses
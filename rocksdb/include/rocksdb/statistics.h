@@ -374,6 +374,17 @@ enum Tickers : uint32_t {
   // # of files deleted immediately by sst file manger through delete scheduler.
   FILES_DELETED_IMMEDIATELY,
 
+  // # of data blocks that compactions copied from an input file to an output
+  // file without rebuilding them.
+  COMPACTION_DATA_BLOCKS_COPIED,
+
+  // # of input files that compactions dropped without reading them, because
+  // range deletions of the compaction cover them.
+  COMPACTION_RANGE_DEL_DROPPED_FILES,
+  // # of times compactions sought past a key range of an input file that
+  // range deletions of the compaction cover, instead of reading it.
+  COMPACTION_RANGE_DEL_SKIPS,
+
   TICKER_ENUM_MAX
 };
 
@@ -472,6 +483,32 @@ enum Histograms : uint32_t {
   // Num of sst files read from file system per level.
   NUM_SST_READ_PER_LEVEL,
 
+  // Number of writes whose WAL sync was done by a single sync.
+  WAL_SYNC_COALESCED_WRITES,
+  // Time sync write group leaders waited for more writes to share their WAL
+  // sync, see DBOptions::wal_sync_coalescing_max_wait_us.
+  WAL_SYNC_COALESCING_WAIT_MICROS,
+
+  // Write path stages, see also DB::Properties::kWriteStageStats.
+  // Time a writer waited in the write queue to become a write group leader or
+  // to have its write done by another leader.
+  WRITE_THREAD_JOIN_WAIT_MICROS,
+  // Time a write group leader spent gathering its group.
+  WRITE_GROUP_FORMATION_MICROS,
+  // Time spent writing (and syncing) write groups to the WAL.
+  WRITE_WAL_MICROS,
+  // Time spent inserting into memtables, by each thread that inserted.
+  WRITE_MEMTABLE_MICROS,
+  // Time a parallel memtable writer waited for the rest of its group.
+  WRITE_MEMTABLE_BARRIER_WAIT_MICROS,
+  // Time waiting writers spent busy looping. Only recorded with
+  // StatsLevel::kExceptTimeForMutex or above.
+  WRITE_THREAD_SPIN_MICROS,
+  // Time waiting writers spent yielding.
+  WRITE_THREAD_YIELD_MICROS,
+  // Time waiting writers spent blocked on a condition variable.
+  WRITE_THREAD_BLOCK_MICROS,
+
   HISTOGRAM_ENUM_MAX,
 };
 
@@ -21,6 +21,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "rocksdb/configurable.h"
 #include "rocksdb/env.h"
@@ -201,6 +202,20 @@ struct BlockBasedTableOptions {
   // incompatible with block-based filters.
   bool partition_filters = false;
 
+  // EXPERIMENTAL If true and kTwoLevelIndexSearch is used, the table reader
+  // remembers which index and filter partitions were read by foreground
+  // operations. When a read-write DB is closed, it persists that for the
+  // open readers of its live tables as a small bitmap in a sidecar file next
+  // to the SST ("<number>.heat"), without syncing it; read-only and
+  // secondary instances and standalone readers such as SstFileReader only
+  // use existing heat files. When the table is opened
+  // again, the partitions that were hot are loaded into the block cache in
+  // the background, on the low priority thread pool, with a few large
+  // coalesced reads, rather than one at a time on the first reads that need
+  // them. This has no effect on tables whose partitions are all prefetched
+  // anyway (see pin_l0_filter_and_index_blocks_in_cache).
+  bool prefetch_hot_partitions = false;
+
   // EXPERIMENTAL Option to generate Bloom filters that minimize memory
   // internal fragmentation.
   //
@@ -348,6 +363,50 @@ struct BlockBasedTableOptions {
 
   IndexShorteningMode index_shortening =
       IndexShorteningMode::kShortenSeparators;
+
+  // EXPERIMENTAL. Compression types that the table builder may use instead of
+  // the one configured for the level of a table file (compression or
+  // compression_per_level). If this or adaptive_block_size_multipliers is
+  // non-empty, the builder buffers the first 1MB of data blocks of each table
+  // file, compresses them with the configured type and each of these, and
+  // writes the file with the one that scores best by
+  // adaptive_compression_space_weight. The chosen type is recorded as the
+  // "rocksdb.compression" table property, and its level is part of
+  // "rocksdb.compression_options".
+  //
+  // Table files of levels configured with kNoCompression are not sampled.
+  // The options are ignored with CompressionOptions::parallel_threads > 1.
+  //
+  // Default: empty
+  std::vector<CompressionType> adaptive_compression_types;
+
+  // The levels tried for kZSTD, in addition to CompressionOptions::level,
+  // when kZSTD is the configured compression type or one of
+  // adaptive_compression_types.
+  //
+  // Default: empty
+  std::vector<int> adaptive_compression_zstd_levels;
+
+  // Multiples of block_size that the table builder may use as the size of
+  // the data blocks that follow the sampled ones, once it has chosen the
+  // compression type. The sampled blocks are concatenated to estimate the
+  // compression of larger blocks. The chosen size is recorded as the
+  // BlockBasedTablePropertyNames::kDataBlockSize table property. Ignored
+  // with block_align.
+  //
+  // Default: empty
+  std::vector<int> adaptive_block_size_multipliers;
+
+  // The objective by which the candidates of adaptive_compression_types and
+  // adaptive_block_size_multipliers are chosen, from 0 to 1. Each is scored
+  //   weight * size / max_size + (1 - weight) * cpu / max_cpu
+  // where size is the compressed size of the sampled blocks, and cpu is the
+  // time to compress block_size bytes plus the time to decompress one data
+  // block, as a point lookup does. The maxima are over all candidates, and
+  // the lowest score wins. 1 minimizes space, 0 minimizes CPU.
+  //
+  // Default: 1.0
+  double adaptive_compression_space_weight = 1.0;
 };
 
 // Table Properties that are specific to block-based table properties.
@@ -358,6 +417,9 @@ struct BlockBasedTablePropertyNames {
   static const std::string kWholeKeyFiltering;
   // value is "1" for true and "0" for false.
   static const std::string kPrefixFiltering;
+  // value is the size of the data blocks in decimal. Only written when
+  // BlockBasedTableOptions::adaptive_block_size_multipliers is used.
+  static const std::string kDataBlockSize;
 };
 
 // Create default block based table factory.
@@ -50,6 +50,8 @@ class Checkpoint {
   //   is in the same partition as the db directory, copied otherwise.
   // - export_dir should not already exist and will be created by this API.
   // - Always triggers a flush.
+  // - Fails with Status::NotSupported() while the column family has table
+  //   slices. See DBOptions::enable_partial_trivial_move.
   virtual Status ExportColumnFamily(ColumnFamilyHandle* handle,
                                     const std::string& export_dir,
                                     ExportImportFilesMetaData** metadata);
@@ -24,8 +24,13 @@ class WriteBufferManager {
   // memory_usage() won't be valid and ShouldFlush() will always return true.
   // if `cache` is provided, we'll put dummy entries in the cache and cost
   // the memory allocated to the cache. It can be used even if _buffer_size = 0.
+  // By default the memory costed to the cache shrinks by one dummy entry per
+  // freed memtable. If `shrink_cache_charge_with_usage` is true, the charge
+  // is released down to the actual usage as soon as memory is freed, so that
+  // the block cache gets the memory back right after a flush.
   explicit WriteBufferManager(size_t _buffer_size,
-                              std::shared_ptr<Cache> cache = {});
+                              std::shared_ptr<Cache> cache = {},
+                              bool shrink_cache_charge_with_usage = false);
   // No copying allowed
   WriteBufferManager(const WriteBufferManager&) = delete;
   WriteBufferManager& operator=(const WriteBufferManager&) = delete;
@@ -90,6 +95,7 @@ class WriteBufferManager {
  private:
   const size_t buffer_size_;
   const size_t mutable_limit_;
+  const bool shrink_cache_charge_with_usage_;
   std::atomic<size_t> memory_used_;
   // Memory that hasn't been scheduled to free.
   std::atomic<size_t> memory_active_;
@@ -98,5 +104,7 @@ class WriteBufferManager {
 
   void ReserveMemWithCache(size_t mem);
   void FreeMemWithCache(size_t mem);
+  // REQUIRES: cache_rep_->cache_mutex_ held
+  void ReleaseDummyEntry();
 };
 }  // namespace ROCKSDB_NAMESPACE
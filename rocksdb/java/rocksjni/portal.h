@@ -4547,6 +4547,8 @@ class CompactionPriorityJni {
         return 0x2;
       case ROCKSDB_NAMESPACE::CompactionPri::kMinOverlappingRatio:
         return 0x3;
+      case ROCKSDB_NAMESPACE::CompactionPri::kReadHeatWeightedOverlappingRatio:
+        return 0x4;
       default:
         return 0x0;  // undefined
     }
@@ -4565,6 +4567,9 @@ class CompactionPriorityJni {
         return ROCKSDB_NAMESPACE::CompactionPri::kOldestSmallestSeqFirst;
       case 0x3:
         return ROCKSDB_NAMESPACE::CompactionPri::kMinOverlappingRatio;
+      case 0x4:
+        return ROCKSDB_NAMESPACE::CompactionPri::
+            kReadHeatWeightedOverlappingRatio;
       default:
         // undefined/default
         return ROCKSDB_NAMESPACE::CompactionPri::kByCompensatedSize;
@@ -4961,6 +4966,12 @@ class TickerTypeJni {
         return -0x14;
       case ROCKSDB_NAMESPACE::Tickers::COMPACT_WRITE_BYTES_TTL:
         return -0x15;
+      case ROCKSDB_NAMESPACE::Tickers::COMPACTION_DATA_BLOCKS_COPIED:
+        return -0x16;
+      case ROCKSDB_NAMESPACE::Tickers::COMPACTION_RANGE_DEL_DROPPED_FILES:
+        return -0x17;
+      case ROCKSDB_NAMESPACE::Tickers::COMPACTION_RANGE_DEL_SKIPS:
+        return -0x18;
 
       case ROCKSDB_NAMESPACE::Tickers::TICKER_ENUM_MAX:
         // 0x5F for backwards compatibility on current minor version.
@@ -5273,6 +5284,12 @@ class TickerTypeJni {
         return ROCKSDB_NAMESPACE::Tickers::COMPACT_WRITE_BYTES_PERIODIC;
       case -0x15:
         return ROCKSDB_NAMESPACE::Tickers::COMPACT_WRITE_BYTES_TTL;
+      case -0x16:
+        return ROCKSDB_NAMESPACE::Tickers::COMPACTION_DATA_BLOCKS_COPIED;
+      case -0x17:
+        return ROCKSDB_NAMESPACE::Tickers::COMPACTION_RANGE_DEL_DROPPED_FILES;
+      case -0x18:
+        return ROCKSDB_NAMESPACE::Tickers::COMPACTION_RANGE_DEL_SKIPS;
       case 0x5F:
         // 0x5F for backwards compatibility on current minor version.
         return ROCKSDB_NAMESPACE::Tickers::TICKER_ENUM_MAX;
@@ -5392,6 +5409,26 @@ class HistogramTypeJni {
         return 0x30;
       case ROCKSDB_NAMESPACE::Histograms::NUM_SST_READ_PER_LEVEL:
         return 0x31;
+      case ROCKSDB_NAMESPACE::Histograms::WAL_SYNC_COALESCED_WRITES:
+        return 0x32;
+      case ROCKSDB_NAMESPACE::Histograms::WAL_SYNC_COALESCING_WAIT_MICROS:
+        return 0x33;
+      case ROCKSDB_NAMESPACE::Histograms::WRITE_THREAD_JOIN_WAIT_MICROS:
+        return 0x34;
+      case ROCKSDB_NAMESPACE::Histograms::WRITE_GROUP_FORMATION_MICROS:
+        return 0x35;
+      case ROCKSDB_NAMESPACE::Histograms::WRITE_WAL_MICROS:
+        return 0x36;
+      case ROCKSDB_NAMESPACE::Histograms::WRITE_MEMTABLE_MICROS:
+        return 0x37;
+      case ROCKSDB_NAMESPACE::Histograms::WRITE_MEMTABLE_BARRIER_WAIT_MICROS:
+        return 0x38;
+      case ROCKSDB_NAMESPACE::Histograms::WRITE_THREAD_SPIN_MICROS:
+        return 0x39;
+      case ROCKSDB_NAMESPACE::Histograms::WRITE_THREAD_YIELD_MICROS:
+        return 0x3A;
+      case ROCKSDB_NAMESPACE::Histograms::WRITE_THREAD_BLOCK_MICROS:
+        return 0x3B;
       case ROCKSDB_NAMESPACE::Histograms::HISTOGRAM_ENUM_MAX:
         // 0x1F for backwards compatibility on current minor version.
         return 0x1F;
@@ -5506,6 +5543,27 @@ class HistogramTypeJni {
         return ROCKSDB_NAMESPACE::Histograms::NUM_DATA_BLOCKS_READ_PER_LEVEL;
       case 0x31:
         return ROCKSDB_NAMESPACE::Histograms::NUM_SST_READ_PER_LEVEL;
+      case 0x32:
+        return ROCKSDB_NAMESPACE::Histograms::WAL_SYNC_COALESCED_WRITES;
+      case 0x33:
+        return ROCKSDB_NAMESPACE::Histograms::WAL_SYNC_COALESCING_WAIT_MICROS;
+      case 0x34:
+        return ROCKSDB_NAMESPACE::Histograms::WRITE_THREAD_JOIN_WAIT_MICROS;
+      case 0x35:
+        return ROCKSDB_NAMESPACE::Histograms::WRITE_GROUP_FORMATION_MICROS;
+      case 0x36:
+        return ROCKSDB_NAMESPACE::Histograms::WRITE_WAL_MICROS;
+      case 0x37:
+        return ROCKSDB_NAMESPACE::Histograms::WRITE_MEMTABLE_MICROS;
+      case 0x38:
+        return ROCKSDB_NAMESPACE::Histograms::
+            WRITE_MEMTABLE_BARRIER_WAIT_MICROS;
+      case 0x39:
+        return ROCKSDB_NAMESPACE::Histograms::WRITE_THREAD_SPIN_MICROS;
+      case 0x3A:
+        return ROCKSDB_NAMESPACE::Histograms::WRITE_THREAD_YIELD_MICROS;
+      case 0x3B:
+        return ROCKSDB_NAMESPACE::Histograms::WRITE_THREAD_BLOCK_MICROS;
       case 0x1F:
         // 0x1F for backwards compatibility on current minor version.
         return ROCKSDB_NAMESPACE::Histograms::HISTOGRAM_ENUM_MAX;
@@ -33,7 +33,14 @@ public enum CompactionPriority {
    * and its size is the smallest. It in many cases can optimize write
    * amplification.
    */
-  MinOverlappingRatio((byte)0x3);
+  MinOverlappingRatio((byte)0x3),
+
+  /**
+   * Like {@link #MinOverlappingRatio}, but files whose key range is read
+   * more often than the rest of their level are compacted first, and rarely
+   * read ones last.
+   */
+  ReadHeatWeightedOverlappingRatio((byte)0x4);
 
 
   private final byte value;
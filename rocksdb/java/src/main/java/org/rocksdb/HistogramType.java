@@ -175,6 +175,58 @@ public enum HistogramType {
    */
   NUM_SST_READ_PER_LEVEL((byte) 0x31),
 
+  /**
+   * Number of writes whose WAL sync was done by a single sync.
+   */
+  WAL_SYNC_COALESCED_WRITES((byte) 0x32),
+
+  /**
+   * Time sync write group leaders waited for more writes to share their WAL
+   * sync.
+   */
+  WAL_SYNC_COALESCING_WAIT_MICROS((byte) 0x33),
+
+  /**
+   * Time a writer waited in the write queue to become a write group leader
+   * or to have its write done by another leader.
+   */
+  WRITE_THREAD_JOIN_WAIT_MICROS((byte) 0x34),
+
+  /**
+   * Time a write group leader spent gathering its group.
+   */
+  WRITE_GROUP_FORMATION_MICROS((byte) 0x35),
+
+  /**
+   * Time spent writing (and syncing) write groups to the WAL.
+   */
+  WRITE_WAL_MICROS((byte) 0x36),
+
+  /**
+   * Time spent inserting into memtables.
+   */
+  WRITE_MEMTABLE_MICROS((byte) 0x37),
+
+  /**
+   * Time a parallel memtable writer waited for the rest of its group.
+   */
+  WRITE_MEMTABLE_BARRIER_WAIT_MICROS((byte) 0x38),
+
+  /**
+   * Time writers waiting for their state to change spent busy looping.
+   */
+  WRITE_THREAD_SPIN_MICROS((byte) 0x39),
+
+  /**
+   * Time writers waiting for their state to change spent yielding.
+   */
+  WRITE_THREAD_YIELD_MICROS((byte) 0x3A),
+
+  /**
+   * Time writers waiting for their state to change spent blocked.
+   */
+  WRITE_THREAD_BLOCK_MICROS((byte) 0x3B),
+
   // 0x1F for backwards compatibility on current minor version.
   HISTOGRAM_ENUM_MAX((byte) 0x1F);
 
@@ -742,6 +742,24 @@ public enum TickerType {
     COMPACT_WRITE_BYTES_PERIODIC((byte) -0x14),
     COMPACT_WRITE_BYTES_TTL((byte) -0x15),
 
+    /**
+     * # of data blocks that compactions copied from an input file to an
+     * output file without rebuilding them.
+     */
+    COMPACTION_DATA_BLOCKS_COPIED((byte) -0x16),
+
+    /**
+     * # of input files that compactions dropped without reading them,
+     * because range deletions of the compaction cover them.
+     */
+    COMPACTION_RANGE_DEL_DROPPED_FILES((byte) -0x17),
+
+    /**
+     * # of times compactions sought past a key range of an input file that
+     * range deletions of the compaction cover, instead of reading it.
+     */
+    COMPACTION_RANGE_DEL_SKIPS((byte) -0x18),
+
     TICKER_ENUM_MAX((byte) 0x5F);
 
     private final byte value;
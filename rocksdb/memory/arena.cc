@@ -42,8 +42,11 @@ size_t OptimizeBlockSize(size_t block_size) {
   return block_size;
 }
 
-Arena::Arena(size_t block_size, AllocTracker* tracker, size_t huge_page_size)
-    : kBlockSize(OptimizeBlockSize(block_size)), tracker_(tracker) {
+Arena::Arena(size_t block_size, AllocTracker* tracker, size_t huge_page_size,
+             std::shared_ptr<MemoryAllocator> memory_allocator)
+    : kBlockSize(OptimizeBlockSize(block_size)),
+      memory_allocator_(std::move(memory_allocator)),
+      tracker_(tracker) {
   assert(kBlockSize >= kMinBlockSize && kBlockSize <= kMaxBlockSize &&
          kBlockSize % kAlignUnit == 0);
   TEST_SYNC_POINT_CALLBACK("Arena::Arena:0", const_cast<size_t*>(&kBlockSize));
@@ -52,7 +55,8 @@ Arena::Arena(size_t block_size, AllocTracker* tracker, size_t huge_page_size)
   aligned_alloc_ptr_ = inline_block_;
   unaligned_alloc_ptr_ = inline_block_ + alloc_bytes_remaining_;
 #ifdef MAP_HUGETLB
-  hugetlb_size_ = huge_page_size;
+  // The memory allocator decides about huge pages itself
+  hugetlb_size_ = memory_allocator_ ? 0 : huge_page_size;
   if (hugetlb_size_ && kBlockSize > hugetlb_size_) {
     hugetlb_size_ = ((kBlockSize - 1U) / hugetlb_size_ + 1U) * hugetlb_size_;
   }
@@ -70,7 +74,11 @@ Arena::~Arena() {
     tracker_->FreeMem();
   }
   for (const auto& block : blocks_) {
-    delete[] block;
+    if (memory_allocator_) {
+      memory_allocator_->Deallocate(block);
+    } else {
+      delete[] block;
+    }
   }
 
 #ifdef MAP_HUGETLB
@@ -209,19 +217,25 @@ char* Arena::AllocateNewBlock(size_t block_bytes) {
   //   via RAII.
   blocks_.emplace_back(nullptr);
 
-  char* block = new char[block_bytes];
+  char* block;
   size_t allocated_size;
+  if (memory_allocator_) {
+    block = static_cast<char*>(memory_allocator_->Allocate(block_bytes));
+    allocated_size = memory_allocator_->UsableSize(block, block_bytes);
+  } else {
+    block = new char[block_bytes];
 #ifdef ROCKSDB_MALLOC_USABLE_SIZE
-  allocated_size = malloc_usable_size(block);
+    allocated_size = malloc_usable_size(block);
 #ifndef NDEBUG
-  // It's hard to predict what malloc_usable_size() returns.
-  // A callback can allow users to change the costed size.
-  std::pair<size_t*, size_t*> pair(&allocated_size, &block_bytes);
-  TEST_SYNC_POINT_CALLBACK("Arena::AllocateNewBlock:0", &pair);
+    // It's hard to predict what malloc_usable_size() returns.
+    // A callback can allow users to change the costed size.
+    std::pair<size_t*, size_t*> pair(&allocated_size, &block_bytes);
+    TEST_SYNC_POINT_CALLBACK("Arena::AllocateNewBlock:0", &pair);
 #endif  // NDEBUG
 #else
-  allocated_size = block_bytes;
+    allocated_size = block_bytes;
 #endif  // ROCKSDB_MALLOC_USABLE_SIZE
+  }
   blocks_memory_ += allocated_size;
   if (tracker_ != nullptr) {
     tracker_->Allocate(allocated_size);
@@ -19,8 +19,10 @@
 #include <stdint.h>
 #include <cerrno>
 #include <cstddef>
+#include <memory>
 #include <vector>
 #include "memory/allocator.h"
+#include "rocksdb/memory_allocator.h"
 #include "util/mutexlock.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -38,8 +40,11 @@ class Arena : public Allocator {
   // huge_page_size: if 0, don't use huge page TLB. If > 0 (should set to the
   // supported hugepage size of the system), block allocation will try huge
   // page TLB first. If allocation fails, will fall back to normal case.
+  // memory_allocator: if non-null, blocks are allocated from it instead of
+  // with new[], and huge_page_size is ignored for blocks.
   explicit Arena(size_t block_size = kMinBlockSize,
-                 AllocTracker* tracker = nullptr, size_t huge_page_size = 0);
+                 AllocTracker* tracker = nullptr, size_t huge_page_size = 0,
+                 std::shared_ptr<MemoryAllocator> memory_allocator = nullptr);
   ~Arena();
 
   char* Allocate(size_t bytes) override;
@@ -85,9 +90,10 @@ class Arena : public Allocator {
   char inline_block_[kInlineSize] __attribute__((__aligned__(alignof(max_align_t))));
   // Number of bytes allocated in one block
   const size_t kBlockSize;
-  // Array of new[] allocated memory blocks
+  // Array of new[] (or memory_allocator_) allocated memory blocks
   typedef std::vector<char*> Blocks;
   Blocks blocks_;
+  std::shared_ptr<MemoryAllocator> memory_allocator_;
 
   struct MmapInfo {
     void* addr_;
@@ -40,13 +40,14 @@ class Logger;
 // shard blocks are allocated from the underlying main arena.
 class ConcurrentArena : public Allocator {
  public:
-  // block_size and huge_page_size are the same as for Arena (and are
-  // in fact just passed to the constructor of arena_.  The core-local
-  // shards compute their shard_block_size as a fraction of block_size
-  // that varies according to the hardware concurrency level.
-  explicit ConcurrentArena(size_t block_size = Arena::kMinBlockSize,
-                           AllocTracker* tracker = nullptr,
-                           size_t huge_page_size = 0);
+  // block_size, huge_page_size and memory_allocator are the same as for
+  // Arena (and are in fact just passed to the constructor of arena_.  The
+  // core-local shards compute their shard_block_size as a fraction of
+  // block_size that varies according to the hardware concurrency level.
+  explicit ConcurrentArena(
+      size_t block_size = Arena::kMinBlockSize,
+      AllocTracker* tracker = nullptr, size_t huge_page_size = 0,
+      std::shared_ptr<MemoryAllocator> memory_allocator = nullptr);
 
   char* Allocate(size_t bytes) override {
     return AllocateImpl(bytes, false /*force_arena*/,
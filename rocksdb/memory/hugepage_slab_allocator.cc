@@ -0,0 +1,255 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "memory/hugepage_slab_allocator.h"
+
+#ifndef OS_WIN
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <new>
+
+#ifdef NUMA
+#include <numa.h>
+#endif
+
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// Slab size when huge pages are disabled
+const size_t kDefaultSlabSize = 2 << 20;
+// Smallest object, header included
+const size_t kMinClassSize = 64;
+}  // namespace
+
+HugePageSlabAllocator::HugePageSlabAllocator(
+    const HugePageSlabAllocatorOptions& options)
+    : huge_page_size_(options.huge_page_size),
+      slab_size_(options.huge_page_size > 0 ? options.huge_page_size
+                                            : kDefaultSlabSize),
+      num_nodes_(1),
+      bind_to_node_(false) {
+  // Four size classes per power of two bound the internal fragmentation to
+  // 25%, as in jemalloc.
+  const size_t max_class_size =
+      std::min(options.max_slab_object_size, slab_size_ / 4) + sizeof(Header);
+  size_t class_size = kMinClassSize;
+  while (true) {
+    class_sizes_.push_back(class_size);
+    if (class_size >= max_class_size) {
+      break;
+    }
+    size_t power = kMinClassSize;
+    while (power * 2 <= class_size) {
+      power *= 2;
+    }
+    class_size += std::max(sizeof(Header), power / 4);
+  }
+#ifdef NUMA
+  if (options.numa_aware && numa_available() >= 0) {
+    num_nodes_ = numa_max_node() + 1;
+    bind_to_node_ = num_nodes_ > 1;
+    const int num_cpus = numa_num_configured_cpus();
+    cpu_to_node_.resize(std::max(num_cpus, 0), 0);
+    for (int cpu = 0; cpu < num_cpus; cpu++) {
+      const int node = numa_node_of_cpu(cpu);
+      if (node >= 0 && node < num_nodes_) {
+        cpu_to_node_[cpu] = node;
+      }
+    }
+  }
+#endif
+  nodes_.reset(new NodePool[num_nodes_]);
+  for (int node = 0; node < num_nodes_; node++) {
+    nodes_[node].classes.reset(new SizeClassPool[class_sizes_.size()]);
+  }
+}
+
+HugePageSlabAllocator::~HugePageSlabAllocator() {
+  for (int node = 0; node < num_nodes_; node++) {
+    for (void* slab : nodes_[node].slabs) {
+      munmap(slab, slab_size_);
+    }
+  }
+}
+
+int HugePageSlabAllocator::CurrentNode() const {
+  if (num_nodes_ == 1) {
+    return 0;
+  }
+  const int cpu = port::PhysicalCoreID();
+  if (cpu < 0 || static_cast<size_t>(cpu) >= cpu_to_node_.size()) {
+    return 0;
+  }
+  return cpu_to_node_[cpu];
+}
+
+uint32_t HugePageSlabAllocator::SizeClassOf(size_t size) const {
+  auto it = std::lower_bound(class_sizes_.begin(), class_sizes_.end(), size);
+  if (it == class_sizes_.end()) {
+    return kLargeClass;
+  }
+  return static_cast<uint32_t>(it - class_sizes_.begin());
+}
+
+void* HugePageSlabAllocator::Map(size_t length, int node,
+                                 bool huge_pages) const {
+  void* addr = MAP_FAILED;
+#ifdef MAP_HUGETLB
+  if (huge_pages) {
+    addr = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  }
+#endif
+  if (addr == MAP_FAILED) {
+    addr = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED) {
+      return nullptr;
+    }
+#ifdef MADV_HUGEPAGE
+    if (huge_pages) {
+      // No reserved huge pages; let transparent huge pages back the range
+      madvise(addr, length, MADV_HUGEPAGE);
+    }
+#endif
+  }
+#ifdef NUMA
+  if (bind_to_node_) {
+    // Before the first touch, so that the pages are faulted in on the node
+    numa_tonode_memory(addr, length, node);
+  }
+#else
+  (void)node;
+#endif
+  return addr;
+}
+
+char* HugePageSlabAllocator::NewSlab(int node) {
+  NodePool& pool = nodes_[node];
+  void* slab = Map(slab_size_, node, huge_page_size_ > 0);
+  if (slab == nullptr) {
+    return nullptr;
+  }
+  {
+    MutexLock l(&pool.slabs_mutex);
+    pool.slabs.push_back(slab);
+  }
+  pool.mapped_bytes.fetch_add(slab_size_, std::memory_order_relaxed);
+  return static_cast<char*>(slab);
+}
+
+void* HugePageSlabAllocator::Allocate(size_t size) {
+  const int node = CurrentNode();
+  const size_t total = size + sizeof(Header);
+  const uint32_t size_class = SizeClassOf(total);
+  Header* header = nullptr;
+  if (size_class == kLargeClass) {
+    // Use huge pages only if that does not more than double the footprint
+    const bool huge_pages = huge_page_size_ > 0 && total >= huge_page_size_;
+    const size_t unit = huge_pages ? huge_page_size_ : port::kPageSize;
+    const size_t length = (total + unit - 1) / unit * unit;
+    header = static_cast<Header*>(Map(length, node, huge_pages));
+    if (header == nullptr) {
+      throw std::bad_alloc();
+    }
+    nodes_[node].mapped_bytes.fetch_add(length, std::memory_order_relaxed);
+    header->mapped_length = length;
+  } else {
+    SizeClassPool& pool = nodes_[node].classes[size_class];
+    const size_t class_size = class_sizes_[size_class];
+    MutexLock l(&pool.mutex);
+    if (pool.free_list != nullptr) {
+      header = reinterpret_cast<Header*>(pool.free_list);
+      pool.free_list = pool.free_list->next;
+    } else {
+      if (static_cast<size_t>(pool.end - pool.next) < class_size) {
+        // The rest of the old slab, if any, is too small for an object
+        char* slab = NewSlab(node);
+        if (slab == nullptr) {
+          throw std::bad_alloc();
+        }
+        pool.next = slab;
+        pool.end = slab + slab_size_;
+      }
+      header = reinterpret_cast<Header*>(pool.next);
+      pool.next += class_size;
+    }
+    header->mapped_length = 0;
+  }
+  header->size_class = size_class;
+  header->node = static_cast<uint32_t>(node);
+  return header + 1;
+}
+
+void HugePageSlabAllocator::Deallocate(void* p) {
+  if (p == nullptr) {
+    return;
+  }
+  Header* header = static_cast<Header*>(p) - 1;
+  NodePool& node_pool = nodes_[header->node];
+  if (header->size_class == kLargeClass) {
+    const size_t length = header->mapped_length;
+    node_pool.mapped_bytes.fetch_sub(length, std::memory_order_relaxed);
+    munmap(header, length);
+    return;
+  }
+  SizeClassPool& pool = node_pool.classes[header->size_class];
+  FreeObject* object = reinterpret_cast<FreeObject*>(header);
+  MutexLock l(&pool.mutex);
+  object->next = pool.free_list;
+  pool.free_list = object;
+}
+
+size_t HugePageSlabAllocator::UsableSize(void* p,
+                                         size_t /*allocation_size*/) const {
+  const Header* header = static_cast<const Header*>(p) - 1;
+  if (header->size_class == kLargeClass) {
+    return header->mapped_length - sizeof(Header);
+  }
+  return class_sizes_[header->size_class] - sizeof(Header);
+}
+
+int HugePageSlabAllocator::GetNode(void* p) {
+  return static_cast<int>((static_cast<const Header*>(p) - 1)->node);
+}
+
+Status NewHugePageSlabAllocator(
+    const HugePageSlabAllocatorOptions& options,
+    std::shared_ptr<MemoryAllocator>* memory_allocator) {
+  if (memory_allocator == nullptr) {
+    return Status::InvalidArgument("memory_allocator must be non-null.");
+  }
+  if (options.huge_page_size > 0 &&
+      (options.huge_page_size < port::kPageSize ||
+       (options.huge_page_size & (options.huge_page_size - 1)) != 0)) {
+    return Status::InvalidArgument(
+        "huge_page_size must be 0 or a power of two no smaller than a page.");
+  }
+  memory_allocator->reset(new HugePageSlabAllocator(options));
+  return Status::OK();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+#else  // OS_WIN
+
+#include "rocksdb/memory_allocator.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+Status NewHugePageSlabAllocator(
+    const HugePageSlabAllocatorOptions& /*options*/,
+    std::shared_ptr<MemoryAllocator>* /*memory_allocator*/) {
+  return Status::NotSupported(
+      "HugePageSlabAllocator is not supported on this platform.");
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+#endif  // OS_WIN
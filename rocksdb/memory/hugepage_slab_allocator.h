@@ -0,0 +1,105 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#ifndef OS_WIN
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/memory_allocator.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// See NewHugePageSlabAllocator() in rocksdb/memory_allocator.h.
+//
+// Every NUMA node has a pool per size class. A pool hands out objects from
+// its free list, or else from the unused tail of its current slab; a new slab
+// of huge_page_size bytes is mapped and bound to the node when the tail runs
+// out. Each object is preceded by a small header recording its size class
+// and node, so Deallocate() can put it back on the free list it came from.
+// Allocations too large for the slabs are mapped individually, and unmapped
+// on Deallocate().
+class HugePageSlabAllocator : public MemoryAllocator {
+ public:
+  explicit HugePageSlabAllocator(const HugePageSlabAllocatorOptions& options);
+  ~HugePageSlabAllocator() override;
+
+  const char* Name() const override { return "HugePageSlabAllocator"; }
+  void* Allocate(size_t size) override;
+  void Deallocate(void* p) override;
+  size_t UsableSize(void* p, size_t allocation_size) const override;
+
+  int num_nodes() const { return num_nodes_; }
+
+  // Bytes currently mapped for the node, for slabs and large allocations.
+  size_t GetMappedBytes(int node) const {
+    return nodes_[node].mapped_bytes.load(std::memory_order_relaxed);
+  }
+
+  // NUMA node the block returned by Allocate() was placed on.
+  static int GetNode(void* p);
+
+ private:
+  // Precedes every object. Keeps the objects aligned to 16 bytes.
+  struct Header {
+    uint32_t size_class;
+    uint32_t node;
+    // Length of the mapping for large allocations, 0 for slab objects
+    size_t mapped_length;
+  };
+  static_assert(sizeof(Header) == 16, "Header must keep 16 byte alignment");
+
+  static const uint32_t kLargeClass = UINT32_MAX;
+
+  struct FreeObject {
+    FreeObject* next;
+  };
+
+  struct SizeClassPool {
+    port::Mutex mutex;
+    FreeObject* free_list = nullptr;
+    // Unused tail of the current slab
+    char* next = nullptr;
+    char* end = nullptr;
+  };
+
+  struct NodePool {
+    std::unique_ptr<SizeClassPool[]> classes;
+    port::Mutex slabs_mutex;
+    std::vector<void*> slabs;
+    std::atomic<size_t> mapped_bytes{0};
+  };
+
+  int CurrentNode() const;
+
+  // Smallest size class holding `size` bytes including the header, or
+  // kLargeClass.
+  uint32_t SizeClassOf(size_t size) const;
+
+  // mmap() `length` bytes, preferring huge pages, and bind them to `node`.
+  // Return nullptr on failure.
+  void* Map(size_t length, int node, bool huge_pages) const;
+
+  char* NewSlab(int node);
+
+  const size_t huge_page_size_;
+  // Size of a slab, and of the unit in which large allocations are mapped
+  const size_t slab_size_;
+  // Object size of every size class, including the header, ascending
+  std::vector<size_t> class_sizes_;
+  int num_nodes_;
+  bool bind_to_node_;
+  std::vector<int> cpu_to_node_;
+  std::unique_ptr<NodePool[]> nodes_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
+
+#endif  // !OS_WIN
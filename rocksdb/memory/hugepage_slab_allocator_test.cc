@@ -0,0 +1,176 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include <cstdio>
+
+#ifndef OS_WIN
+
+#include "memory/arena.h"
+#include "memory/hugepage_slab_allocator.h"
+#include "rocksdb/cache.h"
+#include "rocksdb/db.h"
+#include "rocksdb/options.h"
+#include "rocksdb/table.h"
+#include "test_util/testharness.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class HugePageSlabAllocatorTest : public testing::Test {
+ protected:
+  size_t GetMappedBytes(const HugePageSlabAllocator& allocator) {
+    size_t total = 0;
+    for (int node = 0; node < allocator.num_nodes(); node++) {
+      total += allocator.GetMappedBytes(node);
+    }
+    return total;
+  }
+};
+
+TEST_F(HugePageSlabAllocatorTest, InvalidOptions) {
+  std::shared_ptr<MemoryAllocator> allocator;
+  HugePageSlabAllocatorOptions options;
+  options.huge_page_size = 3 << 20;
+  ASSERT_TRUE(
+      NewHugePageSlabAllocator(options, &allocator).IsInvalidArgument());
+  options.huge_page_size = 0;
+  ASSERT_OK(NewHugePageSlabAllocator(options, &allocator));
+  ASSERT_NE(allocator, nullptr);
+  ASSERT_STREQ(allocator->Name(), "HugePageSlabAllocator");
+}
+
+TEST_F(HugePageSlabAllocatorTest, AllocateAndReuse) {
+  HugePageSlabAllocatorOptions options;
+  HugePageSlabAllocator allocator(options);
+  Random rnd(301);
+
+  std::vector<std::pair<char*, size_t>> objects;
+  for (int i = 0; i < 1000; i++) {
+    const size_t size = 1 + rnd.Uniform(64 << 10);
+    char* p = static_cast<char*>(allocator.Allocate(size));
+    ASSERT_NE(p, nullptr);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(p) % 16, 0);
+    ASSERT_GE(allocator.UsableSize(p, size), size);
+    // No more than 25% wasted for objects served from the slabs
+    ASSERT_LE(allocator.UsableSize(p, size), size + size / 4 + 64);
+    ASSERT_GE(HugePageSlabAllocator::GetNode(p), 0);
+    ASSERT_LT(HugePageSlabAllocator::GetNode(p), allocator.num_nodes());
+    memset(p, static_cast<char>(i), size);
+    objects.emplace_back(p, size);
+  }
+  for (size_t i = 0; i < objects.size(); i++) {
+    const char expected = static_cast<char>(i);
+    ASSERT_EQ(objects[i].first[0], expected);
+    ASSERT_EQ(objects[i].first[objects[i].second - 1], expected);
+  }
+
+  // Freed objects are handed out again instead of mapping more slabs
+  const size_t mapped = GetMappedBytes(allocator);
+  ASSERT_GT(mapped, 0);
+  for (auto& object : objects) {
+    allocator.Deallocate(object.first);
+  }
+  for (auto& object : objects) {
+    object.first = static_cast<char*>(allocator.Allocate(object.second));
+  }
+  ASSERT_EQ(GetMappedBytes(allocator), mapped);
+  for (auto& object : objects) {
+    allocator.Deallocate(object.first);
+  }
+  allocator.Deallocate(nullptr);
+}
+
+TEST_F(HugePageSlabAllocatorTest, LargeAllocation) {
+  HugePageSlabAllocatorOptions options;
+  options.max_slab_object_size = 4 << 10;
+  HugePageSlabAllocator allocator(options);
+
+  const size_t mapped = GetMappedBytes(allocator);
+  for (size_t size : {size_t{8} << 10, size_t{3} << 20}) {
+    char* p = static_cast<char*>(allocator.Allocate(size));
+    ASSERT_NE(p, nullptr);
+    ASSERT_GE(allocator.UsableSize(p, size), size);
+    ASSERT_GT(GetMappedBytes(allocator), mapped + size);
+    memset(p, 'x', size);
+    allocator.Deallocate(p);
+    // Large allocations are unmapped right away
+    ASSERT_EQ(GetMappedBytes(allocator), mapped);
+  }
+}
+
+TEST_F(HugePageSlabAllocatorTest, Arena) {
+  auto allocator = std::make_shared<HugePageSlabAllocator>(
+      HugePageSlabAllocatorOptions());
+  {
+    Arena arena(Arena::kMinBlockSize, nullptr, 0, allocator);
+    for (int i = 0; i < 100; i++) {
+      char* p = arena.Allocate(1000);
+      memset(p, 'a', 1000);
+    }
+    ASSERT_GE(arena.MemoryAllocatedBytes(), 100 * 1000);
+    ASSERT_GT(GetMappedBytes(*allocator), 0);
+  }
+}
+
+TEST_F(HugePageSlabAllocatorTest, Database) {
+  std::shared_ptr<MemoryAllocator> allocator;
+  ASSERT_OK(NewHugePageSlabAllocator(HugePageSlabAllocatorOptions(),
+                                     &allocator));
+
+  Options options;
+  std::string dbname = test::PerThreadDBPath("hugepage_slab_allocator_test");
+  ASSERT_OK(DestroyDB(dbname, options));
+
+  options.create_if_missing = true;
+  options.memtable_memory_allocator = allocator;
+  LRUCacheOptions cache_options;
+  cache_options.capacity = 1024 * 1024;
+  cache_options.memory_allocator = allocator;
+  std::shared_ptr<Cache> cache = NewLRUCache(cache_options);
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = cache;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  DB* db = nullptr;
+  ASSERT_OK(DB::Open(options, dbname, &db));
+  ASSERT_NE(db, nullptr);
+
+  const int kNumKeys = 200;
+  std::string val = "0123456789";
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(db->Put(WriteOptions(), std::to_string(i), val));
+  }
+  ASSERT_GT(GetMappedBytes(*static_cast<HugePageSlabAllocator*>(
+                allocator.get())),
+            0);
+  // Flush so that the reads below go through the block cache
+  ASSERT_OK(db->Flush(FlushOptions()));
+
+  std::string result;
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(db->Get(ReadOptions(), std::to_string(i), &result));
+    ASSERT_EQ(result, val);
+  }
+  ASSERT_GT(cache->GetUsage(), 2000);
+
+  ASSERT_OK(db->Close());
+  delete db;
+  ASSERT_OK(DestroyDB(dbname, options));
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+#else
+
+int main(int /*argc*/, char** /*argv*/) {
+  printf("Skip hugepage_slab_allocator_test as it is not supported on Windows");
+}
+
+#endif  // !OS_WIN
@@ -0,0 +1,590 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+//
+#ifndef ROCKSDB_LITE
+#include <atomic>
+
+#include "db/memtable.h"
+#include "memory/allocator.h"
+#include "memory/arena.h"
+#include "port/port.h"
+#include "rocksdb/memtablerep.h"
+
+namespace ROCKSDB_NAMESPACE {
+namespace {
+
+// A B+-tree of memtable entries. Each node is four cache lines holding a
+// sorted array of entry pointers, so a lookup reads a handful of contiguous
+// nodes instead of chasing one pointer per skip list level.
+//
+// Concurrency follows optimistic lock coupling: every node has a version
+// that is odd while a writer holds the node. Readers never write to shared
+// memory; they read a node, then check that its version did not change and
+// start over from the root if it did. Writers lock only the leaf they insert
+// into, plus its parent when the leaf has to be split. Full inner nodes are
+// split on the way down, so a split never has to go up more than one level.
+//
+// Nodes and entries are never freed before the whole tree, so a stale
+// pointer read by a reader always points to valid memory. Every slot below
+// a node's count always holds a valid entry (or child), which makes it safe
+// to compare against entries before the read is validated.
+class BTree {
+ public:
+  typedef const char* Key;
+
+  // Where the key last returned by a search was found, for cheap Next() and
+  // Prev(). leaf is nullptr if unknown.
+  struct Position {
+    const void* leaf = nullptr;
+    uint32_t index = 0;
+    uint64_t version = 0;
+  };
+
+  enum SearchMode { kGreaterOrEqual, kGreater, kLessOrEqual, kLess };
+
+  BTree(const MemTableRep::KeyComparator& compare, Allocator* allocator)
+      : compare_(compare), allocator_(allocator) {
+    root_.store(NewLeaf(), std::memory_order_release);
+  }
+
+  // Return false if an entry comparing equal to key is already in the tree.
+  bool Insert(Key key);
+
+  // Return the first entry at or after (kGreater*) or the last entry at or
+  // before (kLess*) key, or nullptr if there is none. A nullptr key stands
+  // for the first or the last entry of the tree.
+  Key Search(Key key, SearchMode mode, Position* pos) const;
+
+  // Entry following or preceding key, which was returned together with pos
+  // by an earlier call.
+  Key Next(Key key, Position* pos) const;
+  Key Prev(Key key, Position* pos) const;
+
+  bool Contains(Key key) const {
+    Position pos;
+    Key found = Search(key, kGreaterOrEqual, &pos);
+    return found != nullptr && compare_(found, key) == 0;
+  }
+
+ private:
+  static const size_t kNodeBytes = 256;
+
+  struct Node {
+    std::atomic<uint64_t> version;
+    std::atomic<uint32_t> count;
+    bool is_leaf;
+  };
+
+  struct Leaf : public Node {
+    static const uint32_t kCapacity =
+        (kNodeBytes - sizeof(Node) - sizeof(void*)) / sizeof(Key);
+    std::atomic<Leaf*> next;
+    std::atomic<Key> keys[kCapacity];
+  };
+
+  struct Inner : public Node {
+    static const uint32_t kCapacity =
+        (kNodeBytes - sizeof(Node) - sizeof(void*)) / (2 * sizeof(void*));
+    std::atomic<Key> keys[kCapacity];
+    // Child i holds the entries in (keys[i - 1], keys[i]].
+    std::atomic<Node*> children[kCapacity + 1];
+  };
+
+  static_assert(sizeof(Leaf) <= kNodeBytes, "Leaf must fit in a node");
+  static_assert(sizeof(Inner) <= kNodeBytes, "Inner must fit in a node");
+
+  static uint64_t ReadLock(const Node* node) {
+    uint64_t version = node->version.load(std::memory_order_acquire);
+    while (version & 1) {
+      port::AsmVolatilePause();
+      version = node->version.load(std::memory_order_acquire);
+    }
+    return version;
+  }
+
+  // Return true if node did not change since its version was read.
+  static bool Validate(const Node* node, uint64_t version) {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return node->version.load(std::memory_order_relaxed) == version;
+  }
+
+  static bool TryLock(Node* node, uint64_t version) {
+    if (!node->version.compare_exchange_strong(version, version + 1,
+                                               std::memory_order_acquire)) {
+      return false;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    return true;
+  }
+
+  static void Unlock(Node* node) {
+    node->version.fetch_add(1, std::memory_order_release);
+  }
+
+  // Number of keys in keys[0, count) that are less than key, or not greater
+  // than key if upper.
+  uint32_t Bound(const std::atomic<Key>* keys, uint32_t count, Key key,
+                 bool upper) const {
+    uint32_t lo = 0;
+    uint32_t hi = count;
+    while (lo < hi) {
+      uint32_t mid = (lo + hi) / 2;
+      int c = compare_(keys[mid].load(std::memory_order_acquire), key);
+      if (c < 0 || (upper && c == 0)) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  void* AllocateNode() {
+    char* mem = allocator_->AllocateAligned(kNodeBytes + CACHE_LINE_SIZE - 1);
+    uintptr_t addr = reinterpret_cast<uintptr_t>(mem);
+    addr = (addr + CACHE_LINE_SIZE - 1) & ~uintptr_t{CACHE_LINE_SIZE - 1};
+    return reinterpret_cast<void*>(addr);
+  }
+
+  Leaf* NewLeaf() {
+    Leaf* leaf = new (AllocateNode()) Leaf();
+    leaf->version.store(0, std::memory_order_relaxed);
+    leaf->count.store(0, std::memory_order_relaxed);
+    leaf->is_leaf = true;
+    leaf->next.store(nullptr, std::memory_order_relaxed);
+    return leaf;
+  }
+
+  Inner* NewInner() {
+    Inner* inner = new (AllocateNode()) Inner();
+    inner->version.store(0, std::memory_order_relaxed);
+    inner->count.store(0, std::memory_order_relaxed);
+    inner->is_leaf = false;
+    return inner;
+  }
+
+  // Split node, which is full, and add the new right half to parent, or to
+  // a new root if node is the root. Does nothing if either node changed
+  // since their versions were read; the caller restarts either way.
+  void Split(Inner* parent, uint64_t parent_version, Node* node,
+             uint64_t version, Key key);
+
+  const MemTableRep::KeyComparator& compare_;
+  Allocator* const allocator_;
+  std::atomic<Node*> root_;
+};
+
+bool BTree::Insert(Key key) {
+restart:
+  Node* node = root_.load(std::memory_order_acquire);
+  uint64_t version = ReadLock(node);
+  if (node != root_.load(std::memory_order_acquire)) {
+    goto restart;
+  }
+  Inner* parent = nullptr;
+  uint64_t parent_version = 0;
+  while (!node->is_leaf) {
+    Inner* inner = static_cast<Inner*>(node);
+    const uint32_t count = inner->count.load(std::memory_order_acquire);
+    if (count == Inner::kCapacity) {
+      Split(parent, parent_version, node, version, key);
+      goto restart;
+    }
+    if (parent != nullptr && !Validate(parent, parent_version)) {
+      goto restart;
+    }
+    parent = inner;
+    parent_version = version;
+    node = inner->children[Bound(inner->keys, count, key, false)].load(
+        std::memory_order_acquire);
+    if (!Validate(inner, version)) {
+      goto restart;
+    }
+    version = ReadLock(node);
+  }
+
+  Leaf* leaf = static_cast<Leaf*>(node);
+  const uint32_t count = leaf->count.load(std::memory_order_acquire);
+  if (count == Leaf::kCapacity) {
+    Split(parent, parent_version, node, version, key);
+    goto restart;
+  }
+  if (!TryLock(leaf, version)) {
+    goto restart;
+  }
+  if (parent != nullptr && !Validate(parent, parent_version)) {
+    Unlock(leaf);
+    goto restart;
+  }
+  const uint32_t pos = Bound(leaf->keys, count, key, false);
+  if (pos < count &&
+      compare_(leaf->keys[pos].load(std::memory_order_relaxed), key) == 0) {
+    Unlock(leaf);
+    return false;
+  }
+  // Shift from the end, so that every slot below the new count holds an
+  // entry at all times.
+  for (uint32_t i = count; i > pos; i--) {
+    leaf->keys[i].store(leaf->keys[i - 1].load(std::memory_order_relaxed),
+                        std::memory_order_release);
+  }
+  leaf->keys[pos].store(key, std::memory_order_release);
+  leaf->count.store(count + 1, std::memory_order_release);
+  Unlock(leaf);
+  return true;
+}
+
+void BTree::Split(Inner* parent, uint64_t parent_version, Node* node,
+                  uint64_t version, Key key) {
+  if (parent != nullptr && !TryLock(parent, parent_version)) {
+    return;
+  }
+  if (!TryLock(node, version)) {
+    if (parent != nullptr) {
+      Unlock(parent);
+    }
+    return;
+  }
+  if (parent == nullptr && node != root_.load(std::memory_order_relaxed)) {
+    // Someone else split the root
+    Unlock(node);
+    return;
+  }
+
+  const uint32_t count = node->count.load(std::memory_order_relaxed);
+  Key separator;
+  Node* right;
+  if (node->is_leaf) {
+    Leaf* leaf = static_cast<Leaf*>(node);
+    // Keys inserted in order would leave every leaf half empty; when the new
+    // key goes past the end, leave the full leaf as it is instead.
+    const bool append =
+        compare_(leaf->keys[count - 1].load(std::memory_order_relaxed), key) <
+        0;
+    const uint32_t split = append ? count - 1 : count / 2;
+    Leaf* new_leaf = NewLeaf();
+    for (uint32_t i = split; i < count; i++) {
+      new_leaf->keys[i - split].store(
+          leaf->keys[i].load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+    }
+    new_leaf->count.store(count - split, std::memory_order_relaxed);
+    new_leaf->next.store(leaf->next.load(std::memory_order_relaxed),
+                         std::memory_order_relaxed);
+    leaf->next.store(new_leaf, std::memory_order_release);
+    leaf->count.store(split, std::memory_order_release);
+    separator = leaf->keys[split - 1].load(std::memory_order_relaxed);
+    right = new_leaf;
+  } else {
+    Inner* inner = static_cast<Inner*>(node);
+    const uint32_t split = count / 2;
+    Inner* new_inner = NewInner();
+    for (uint32_t i = split + 1; i < count; i++) {
+      new_inner->keys[i - split - 1].store(
+          inner->keys[i].load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+    }
+    for (uint32_t i = split + 1; i <= count; i++) {
+      new_inner->children[i - split - 1].store(
+          inner->children[i].load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+    }
+    new_inner->count.store(count - split - 1, std::memory_order_relaxed);
+    inner->count.store(split, std::memory_order_release);
+    separator = inner->keys[split].load(std::memory_order_relaxed);
+    right = new_inner;
+  }
+
+  if (parent != nullptr) {
+    const uint32_t parent_count = parent->count.load(std::memory_order_relaxed);
+    assert(parent_count < Inner::kCapacity);
+    const uint32_t pos = Bound(parent->keys, parent_count, separator, false);
+    for (uint32_t i = parent_count; i > pos; i--) {
+      parent->keys[i].store(parent->keys[i - 1].load(std::memory_order_relaxed),
+                            std::memory_order_release);
+      parent->children[i + 1].store(
+          parent->children[i].load(std::memory_order_relaxed),
+          std::memory_order_release);
+    }
+    parent->keys[pos].store(separator, std::memory_order_release);
+    parent->children[pos + 1].store(right, std::memory_order_release);
+    parent->count.store(parent_count + 1, std::memory_order_release);
+  } else {
+    Inner* root = NewInner();
+    root->keys[0].store(separator, std::memory_order_relaxed);
+    root->children[0].store(node, std::memory_order_relaxed);
+    root->children[1].store(right, std::memory_order_relaxed);
+    root->count.store(1, std::memory_order_relaxed);
+    root_.store(root, std::memory_order_release);
+  }
+  Unlock(node);
+  if (parent != nullptr) {
+    Unlock(parent);
+  }
+}
+
+BTree::Key BTree::Search(Key key, SearchMode mode, Position* pos) const {
+  const bool forward = mode == kGreaterOrEqual || mode == kGreater;
+  const bool upper = mode == kGreater || mode == kLessOrEqual;
+restart:
+  const Node* node = root_.load(std::memory_order_acquire);
+  uint64_t version = ReadLock(node);
+  if (node != root_.load(std::memory_order_acquire)) {
+    goto restart;
+  }
+  // When searching backward, the separator to the left of the path taken.
+  // It is the largest entry of the subtrees to the left of the leaf.
+  Key fence = nullptr;
+  while (!node->is_leaf) {
+    const Inner* inner = static_cast<const Inner*>(node);
+    const uint32_t count = inner->count.load(std::memory_order_acquire);
+    uint32_t i;
+    if (key == nullptr) {
+      i = forward ? 0 : count;
+    } else {
+      i = Bound(inner->keys, count, key, upper);
+    }
+    if (!forward && i > 0) {
+      fence = inner->keys[i - 1].load(std::memory_order_acquire);
+    }
+    const Node* child = inner->children[i].load(std::memory_order_acquire);
+    if (!Validate(inner, version)) {
+      goto restart;
+    }
+    const uint64_t child_version = ReadLock(child);
+    // Make sure child was not split before it was read
+    if (!Validate(inner, version)) {
+      goto restart;
+    }
+    node = child;
+    version = child_version;
+  }
+
+  const Leaf* leaf = static_cast<const Leaf*>(node);
+  const uint32_t count = leaf->count.load(std::memory_order_acquire);
+  uint32_t i;
+  if (key == nullptr) {
+    i = forward ? 0 : count;
+  } else {
+    i = Bound(leaf->keys, count, key, upper);
+  }
+  Key result;
+  if (forward) {
+    if (i < count) {
+      result = leaf->keys[i].load(std::memory_order_acquire);
+      if (!Validate(leaf, version)) {
+        goto restart;
+      }
+      pos->leaf = leaf;
+      pos->index = i;
+      pos->version = version;
+      return result;
+    }
+    // Every entry of the leaf is before key; the answer is the first entry
+    // of the next leaf.
+    const Leaf* next = leaf->next.load(std::memory_order_acquire);
+    if (!Validate(leaf, version)) {
+      goto restart;
+    }
+    if (next == nullptr) {
+      pos->leaf = nullptr;
+      return nullptr;
+    }
+    const uint64_t next_version = ReadLock(next);
+    // Only the leaf of an empty tree is empty
+    result = next->keys[0].load(std::memory_order_acquire);
+    if (!Validate(next, next_version)) {
+      goto restart;
+    }
+    pos->leaf = next;
+    pos->index = 0;
+    pos->version = next_version;
+    return result;
+  }
+  if (i > 0) {
+    result = leaf->keys[i - 1].load(std::memory_order_acquire);
+    if (!Validate(leaf, version)) {
+      goto restart;
+    }
+    pos->leaf = leaf;
+    pos->index = i - 1;
+    pos->version = version;
+    return result;
+  }
+  if (!Validate(leaf, version)) {
+    goto restart;
+  }
+  pos->leaf = nullptr;
+  return fence;
+}
+
+BTree::Key BTree::Next(Key key, Position* pos) const {
+  const Leaf* leaf = static_cast<const Leaf*>(pos->leaf);
+  if (leaf != nullptr) {
+    const uint32_t i = pos->index + 1;
+    if (i < leaf->count.load(std::memory_order_acquire)) {
+      Key result = leaf->keys[i].load(std::memory_order_acquire);
+      if (Validate(leaf, pos->version)) {
+        pos->index = i;
+        return result;
+      }
+    } else {
+      const Leaf* next = leaf->next.load(std::memory_order_acquire);
+      if (Validate(leaf, pos->version)) {
+        if (next == nullptr) {
+          pos->leaf = nullptr;
+          return nullptr;
+        }
+        const uint64_t next_version = ReadLock(next);
+        Key result = next->keys[0].load(std::memory_order_acquire);
+        if (Validate(next, next_version)) {
+          pos->leaf = next;
+          pos->index = 0;
+          pos->version = next_version;
+          return result;
+        }
+      }
+    }
+  }
+  // The leaf changed; look the successor up from the root
+  return Search(key, kGreater, pos);
+}
+
+BTree::Key BTree::Prev(Key key, Position* pos) const {
+  const Leaf* leaf = static_cast<const Leaf*>(pos->leaf);
+  if (leaf != nullptr && pos->index > 0) {
+    const uint32_t i = pos->index - 1;
+    Key result = leaf->keys[i].load(std::memory_order_acquire);
+    if (Validate(leaf, pos->version)) {
+      pos->index = i;
+      return result;
+    }
+  }
+  return Search(key, kLess, pos);
+}
+
+class BTreeRep : public MemTableRep {
+ public:
+  BTreeRep(const MemTableRep::KeyComparator& compare, Allocator* allocator)
+      : MemTableRep(allocator), tree_(compare, allocator) {}
+
+  void Insert(KeyHandle handle) override {
+    tree_.Insert(static_cast<char*>(handle));
+  }
+
+  bool InsertKey(KeyHandle handle) override {
+    return tree_.Insert(static_cast<char*>(handle));
+  }
+
+  void InsertConcurrently(KeyHandle handle) override {
+    tree_.Insert(static_cast<char*>(handle));
+  }
+
+  bool InsertKeyConcurrently(KeyHandle handle) override {
+    return tree_.Insert(static_cast<char*>(handle));
+  }
+
+  // The tree has no use for hints, but still reports duplicates
+  bool InsertKeyWithHint(KeyHandle handle, void** /*hint*/) override {
+    return tree_.Insert(static_cast<char*>(handle));
+  }
+
+  bool InsertKeyWithHintConcurrently(KeyHandle handle,
+                                     void** /*hint*/) override {
+    return tree_.Insert(static_cast<char*>(handle));
+  }
+
+  bool Contains(const char* key) const override {
+    return tree_.Contains(key);
+  }
+
+  size_t ApproximateMemoryUsage() override {
+    // All memory is allocated through allocator; nothing to report here
+    return 0;
+  }
+
+  void Get(const LookupKey& k, void* callback_args,
+           bool (*callback_func)(void* arg, const char* entry)) override {
+    BTreeRep::Iterator iter(&tree_);
+    Slice dummy_slice;
+    for (iter.Seek(dummy_slice, k.memtable_key().data());
+         iter.Valid() && callback_func(callback_args, iter.key());
+         iter.Next()) {
+    }
+  }
+
+  ~BTreeRep() override {}
+
+  class Iterator : public MemTableRep::Iterator {
+   public:
+    explicit Iterator(const BTree* tree) : tree_(tree), key_(nullptr) {}
+
+    ~Iterator() override {}
+
+    bool Valid() const override { return key_ != nullptr; }
+
+    const char* key() const override {
+      assert(Valid());
+      return key_;
+    }
+
+    void Next() override {
+      assert(Valid());
+      key_ = tree_->Next(key_, &pos_);
+    }
+
+    void Prev() override {
+      assert(Valid());
+      key_ = tree_->Prev(key_, &pos_);
+    }
+
+    void Seek(const Slice& user_key, const char* memtable_key) override {
+      const char* encoded_key = (memtable_key != nullptr)
+                                    ? memtable_key
+                                    : EncodeKey(&tmp_, user_key);
+      key_ = tree_->Search(encoded_key, BTree::kGreaterOrEqual, &pos_);
+    }
+
+    void SeekForPrev(const Slice& user_key, const char* memtable_key) override {
+      const char* encoded_key = (memtable_key != nullptr)
+                                    ? memtable_key
+                                    : EncodeKey(&tmp_, user_key);
+      key_ = tree_->Search(encoded_key, BTree::kLessOrEqual, &pos_);
+    }
+
+    void SeekToFirst() override {
+      key_ = tree_->Search(nullptr, BTree::kGreaterOrEqual, &pos_);
+    }
+
+    void SeekToLast() override {
+      key_ = tree_->Search(nullptr, BTree::kLessOrEqual, &pos_);
+    }
+
+   private:
+    const BTree* tree_;
+    const char* key_;
+    BTree::Position pos_;
+    std::string tmp_;  // For passing to EncodeKey
+  };
+
+  MemTableRep::Iterator* GetIterator(Arena* arena = nullptr) override {
+    void* mem = arena ? arena->AllocateAligned(sizeof(BTreeRep::Iterator))
+                      : operator new(sizeof(BTreeRep::Iterator));
+    return new (mem) BTreeRep::Iterator(&tree_);
+  }
+
+ private:
+  BTree tree_;
+};
+}  // namespace
+
+MemTableRep* BTreeRepFactory::CreateMemTableRep(
+    const MemTableRep::KeyComparator& compare, Allocator* allocator,
+    const SliceTransform* /*transform*/, Logger* /*logger*/) {
+  return new BTreeRep(compare, allocator);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+#endif  // ROCKSDB_LITE
@@ -0,0 +1,238 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "db/dbformat.h"
+#include "db/memtable.h"
+#include "memory/concurrent_arena.h"
+#include "rocksdb/memtablerep.h"
+#include "test_util/testharness.h"
+#include "util/coding.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+#ifndef ROCKSDB_LITE
+class BTreeRepTest : public testing::Test {
+ public:
+  BTreeRepTest()
+      : internal_comparator_(BytewiseComparator()),
+        key_comparator_(internal_comparator_) {}
+
+  MemTableRep* NewRep() {
+    return factory_.CreateMemTableRep(key_comparator_, &arena_, nullptr,
+                                      nullptr);
+  }
+
+  // Memtable entry for user key `key`, which is encoded so that the
+  // bytewise order is the numeric order, and sequence number 1.
+  static KeyHandle NewEntry(MemTableRep* rep, uint64_t key, char** buf) {
+    const uint32_t internal_key_size = 16;
+    KeyHandle handle =
+        rep->Allocate(VarintLength(internal_key_size) + internal_key_size, buf);
+    char* p = EncodeVarint32(*buf, internal_key_size);
+    EncodeFixed64(p, EndianSwapValue(key));
+    EncodeFixed64(p + 8, PackSequenceAndType(1, kTypeValue));
+    return handle;
+  }
+
+  static uint64_t DecodeEntry(const char* entry) {
+    uint32_t len;
+    const char* p = GetVarint32Ptr(entry, entry + 5, &len);
+    return EndianSwapValue(DecodeFixed64(p));
+  }
+
+  static std::string SeekKey(uint64_t key) {
+    std::string user_key;
+    PutFixed64(&user_key, EndianSwapValue(key));
+    std::string internal_key;
+    AppendInternalKey(&internal_key, ParsedInternalKey(user_key, 1,
+                                                       kTypeValue));
+    return internal_key;
+  }
+
+  static bool Insert(MemTableRep* rep, uint64_t key) {
+    char* buf;
+    return rep->InsertKey(NewEntry(rep, key, &buf));
+  }
+
+  void Verify(MemTableRep* rep, const std::set<uint64_t>& model) {
+    std::unique_ptr<MemTableRep::Iterator> iter(rep->GetIterator());
+    auto it = model.begin();
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++it) {
+      ASSERT_TRUE(it != model.end());
+      ASSERT_EQ(*it, DecodeEntry(iter->key()));
+    }
+    ASSERT_TRUE(it == model.end());
+
+    auto rit = model.rbegin();
+    for (iter->SeekToLast(); iter->Valid(); iter->Prev(), ++rit) {
+      ASSERT_TRUE(rit != model.rend());
+      ASSERT_EQ(*rit, DecodeEntry(iter->key()));
+    }
+    ASSERT_TRUE(rit == model.rend());
+  }
+
+ protected:
+  InternalKeyComparator internal_comparator_;
+  MemTable::KeyComparator key_comparator_;
+  ConcurrentArena arena_;
+  BTreeRepFactory factory_;
+};
+
+TEST_F(BTreeRepTest, Empty) {
+  std::unique_ptr<MemTableRep> rep(NewRep());
+  std::unique_ptr<MemTableRep::Iterator> iter(rep->GetIterator());
+  ASSERT_FALSE(iter->Valid());
+  iter->SeekToFirst();
+  ASSERT_FALSE(iter->Valid());
+  iter->SeekToLast();
+  ASSERT_FALSE(iter->Valid());
+  iter->Seek(SeekKey(100), nullptr);
+  ASSERT_FALSE(iter->Valid());
+  iter->SeekForPrev(SeekKey(100), nullptr);
+  ASSERT_FALSE(iter->Valid());
+}
+
+TEST_F(BTreeRepTest, InsertAndLookup) {
+  const int kNumKeys = 20000;
+  const uint64_t kRange = 100000;
+  std::unique_ptr<MemTableRep> rep(NewRep());
+  Random rnd(301);
+  std::set<uint64_t> model;
+  for (int i = 0; i < kNumKeys; i++) {
+    const uint64_t key = rnd.Uniform(kRange);
+    // Duplicates are rejected
+    ASSERT_EQ(model.insert(key).second, Insert(rep.get(), key));
+  }
+  Verify(rep.get(), model);
+
+  // The hinted inserts that MemTable uses with
+  // memtable_insert_with_hint_prefix_extractor reject duplicates too
+  {
+    const uint64_t key = *model.begin();
+    char* buf;
+    void* hint = nullptr;
+    ASSERT_FALSE(rep->InsertKeyWithHint(NewEntry(rep.get(), key, &buf), &hint));
+    ASSERT_FALSE(rep->InsertKeyWithHintConcurrently(
+        NewEntry(rep.get(), key, &buf), &hint));
+    ASSERT_EQ(nullptr, hint);
+  }
+  Verify(rep.get(), model);
+
+  std::unique_ptr<MemTableRep::Iterator> iter(rep->GetIterator());
+  for (uint64_t key = 0; key < kRange; key += 7) {
+    char* buf;
+    NewEntry(rep.get(), key, &buf);
+    ASSERT_EQ(model.count(key) > 0, rep->Contains(buf));
+
+    iter->Seek(SeekKey(key), nullptr);
+    auto it = model.lower_bound(key);
+    if (it == model.end()) {
+      ASSERT_FALSE(iter->Valid());
+    } else {
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(*it, DecodeEntry(iter->key()));
+      // Step back and forth around the found entry
+      iter->Prev();
+      if (it == model.begin()) {
+        ASSERT_FALSE(iter->Valid());
+      } else {
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ(*std::prev(it), DecodeEntry(iter->key()));
+        iter->Next();
+        ASSERT_EQ(*it, DecodeEntry(iter->key()));
+        iter->Next();
+        if (std::next(it) == model.end()) {
+          ASSERT_FALSE(iter->Valid());
+        } else {
+          ASSERT_EQ(*std::next(it), DecodeEntry(iter->key()));
+        }
+      }
+    }
+
+    iter->SeekForPrev(SeekKey(key), nullptr);
+    it = model.upper_bound(key);
+    if (it == model.begin()) {
+      ASSERT_FALSE(iter->Valid());
+    } else {
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(*std::prev(it), DecodeEntry(iter->key()));
+    }
+  }
+}
+
+TEST_F(BTreeRepTest, SequentialInsert) {
+  std::unique_ptr<MemTableRep> rep(NewRep());
+  std::set<uint64_t> model;
+  for (uint64_t key = 0; key < 10000; key++) {
+    ASSERT_TRUE(Insert(rep.get(), key));
+    model.insert(key);
+  }
+  for (uint64_t key = 20000; key > 10000; key--) {
+    ASSERT_TRUE(Insert(rep.get(), key));
+    model.insert(key);
+  }
+  Verify(rep.get(), model);
+}
+
+TEST_F(BTreeRepTest, ConcurrentInsert) {
+  const int kNumWriters = 4;
+  const uint64_t kKeysPerWriter = 20000;
+  std::unique_ptr<MemTableRep> rep(NewRep());
+
+  std::atomic<int> writers_done{0};
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < kNumWriters; t++) {
+    threads.emplace_back([&, t]() {
+      std::vector<uint64_t> keys;
+      for (uint64_t i = 0; i < kKeysPerWriter; i++) {
+        keys.push_back(i * kNumWriters + t);
+      }
+      RandomShuffle(keys.begin(), keys.end(), t + 1);
+      for (uint64_t key : keys) {
+        char* buf;
+        KeyHandle handle = NewEntry(rep.get(), key, &buf);
+        ASSERT_TRUE(rep->InsertKeyConcurrently(handle));
+      }
+      writers_done.fetch_add(1);
+    });
+  }
+  // Scans running alongside the writers must always see sorted entries
+  threads.emplace_back([&]() {
+    while (writers_done.load() < kNumWriters) {
+      std::unique_ptr<MemTableRep::Iterator> iter(rep->GetIterator());
+      uint64_t last = 0;
+      bool first = true;
+      for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+        const uint64_t key = DecodeEntry(iter->key());
+        ASSERT_TRUE(first || key > last);
+        last = key;
+        first = false;
+      }
+    }
+  });
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::set<uint64_t> model;
+  for (uint64_t key = 0; key < kNumWriters * kKeysPerWriter; key++) {
+    model.insert(key);
+  }
+  Verify(rep.get(), model);
+}
+#endif  // ROCKSDB_LITE
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -15,7 +15,9 @@ int main() {
 }
 #else
 
+#include <algorithm>
 #include <atomic>
+#include <cstring>
 #include <iostream>
 #include <memory>
 #include <thread>
@@ -25,6 +27,7 @@ int main() {
 #include "db/dbformat.h"
 #include "db/memtable.h"
 #include "memory/arena.h"
+#include "memory/concurrent_arena.h"
 #include "port/port.h"
 #include "port/stack_trace.h"
 #include "rocksdb/comparator.h"
@@ -45,6 +48,11 @@ DEFINE_string(benchmarks, "fillrandom",
               "Comma-separated list of benchmarks to run. Options:\n"
               "\tfillrandom             -- write N random values\n"
               "\tfillseq                -- write N values in sequential order\n"
+              "\tfillrandomconcurrent   -- N threads concurrently write random\n"
+              "\t                          values\n"
+              "\tfillrandombatch        -- write N random values in sorted\n"
+              "\t                          batches of --batch_size, each insert\n"
+              "\t                          resuming from the previous one\n"
               "\treadrandom             -- read N values in random order\n"
               "\treadseq                -- scan the DB\n"
               "\treadwrite              -- 1 thread writes while N - 1 threads "
@@ -61,6 +69,7 @@ DEFINE_string(memtablerep, "skiplist",
               "\tvector              -- backed by an std::vector\n"
               "\thashskiplist        -- backed by a hash skip list\n"
               "\thashlinklist        -- backed by a hash linked list\n"
+              "\tbtree               -- backed by a B+-tree\n"
               "\tcuckoo              -- backed by a cuckoo hash table");
 
 DEFINE_int64(bucket_count, 1000000,
@@ -109,6 +118,9 @@ DEFINE_int32(num_scans, 10,
 
 DEFINE_int32(item_size, 100, "Number of bytes each item should be");
 
+DEFINE_int32(batch_size, 1000,
+             "Number of keys sorted and inserted together by fillrandombatch");
+
 DEFINE_int32(prefix_length, 8,
              "Prefix length to pass into NewFixedPrefixTransform");
 
@@ -260,6 +272,103 @@ class FillBenchmarkThread : public BenchmarkThread {
   }
 };
 
+// Inserts with InsertConcurrently() alongside other threads of this type.
+// Each thread writes the keys congruent to its index modulo the number of
+// threads, in random order, so no two threads write the same key.
+class MultiWriterFillBenchmarkThread : public BenchmarkThread {
+ public:
+  MultiWriterFillBenchmarkThread(MemTableRep* table, uint64_t* bytes_written,
+                                 uint64_t num_ops, uint32_t index,
+                                 uint32_t num_threads)
+      : BenchmarkThread(table, nullptr, bytes_written, nullptr, nullptr,
+                        num_ops, nullptr),
+        index_(index),
+        num_threads_(num_threads) {}
+
+  void operator()() override {
+    std::vector<uint64_t> keys(num_ops_);
+    for (uint64_t i = 0; i < num_ops_; ++i) {
+      keys[i] = i * num_threads_ + index_;
+    }
+    RandomShuffle(keys.begin(), keys.end(),
+                  static_cast<uint32_t>(FLAGS_seed + index_));
+    auto internal_key_size = 16;
+    auto encoded_len =
+        FLAGS_item_size + VarintLength(internal_key_size) + internal_key_size;
+    uint64_t bytes_written = 0;
+    for (uint64_t key : keys) {
+      char* buf = nullptr;
+      KeyHandle handle = table_->Allocate(encoded_len, &buf);
+      char* p = EncodeVarint32(buf, internal_key_size);
+      EncodeFixed64(p, key);
+      p += 8;
+      // Sequence numbers only need to be unique per key here
+      EncodeFixed64(p, 1);
+      p += 8;
+      Slice bytes = generator_.Generate(FLAGS_item_size);
+      memcpy(p, bytes.data(), FLAGS_item_size);
+      table_->InsertConcurrently(handle);
+      bytes_written += encoded_len;
+    }
+    *bytes_written_ = bytes_written;
+  }
+
+ private:
+  const uint32_t index_;
+  const uint32_t num_threads_;
+};
+
+// Writes keys in batches of --batch_size. Each batch is sorted in memtable
+// order, like MemTableInserter does for large write batches, and inserted with
+// InsertKeyWithHint() so that each insert resumes from the previous one.
+class BatchFillBenchmarkThread : public BenchmarkThread {
+ public:
+  BatchFillBenchmarkThread(MemTableRep* table, KeyGenerator* key_gen,
+                           uint64_t* bytes_written, uint64_t* sequence,
+                           uint64_t num_ops)
+      : BenchmarkThread(table, key_gen, bytes_written, nullptr, sequence,
+                        num_ops, nullptr) {}
+
+  void operator()() override {
+    auto internal_key_size = 16;
+    auto encoded_len =
+        FLAGS_item_size + VarintLength(internal_key_size) + internal_key_size;
+    std::vector<uint64_t> keys;
+    void* hint = nullptr;
+    uint64_t done = 0;
+    while (done < num_ops_) {
+      keys.clear();
+      uint64_t n = std::min(static_cast<uint64_t>(FLAGS_batch_size),
+                            num_ops_ - done);
+      for (uint64_t i = 0; i < n; ++i) {
+        keys.push_back(key_gen_->Next());
+      }
+      // Keys are encoded with EncodeFixed64, so order them bytewise
+      std::sort(keys.begin(), keys.end(), [](uint64_t a, uint64_t b) {
+        char abuf[8];
+        char bbuf[8];
+        EncodeFixed64(abuf, a);
+        EncodeFixed64(bbuf, b);
+        return memcmp(abuf, bbuf, sizeof(abuf)) < 0;
+      });
+      for (uint64_t key : keys) {
+        char* buf = nullptr;
+        KeyHandle handle = table_->Allocate(encoded_len, &buf);
+        char* p = EncodeVarint32(buf, internal_key_size);
+        EncodeFixed64(p, key);
+        p += 8;
+        EncodeFixed64(p, ++(*sequence_));
+        p += 8;
+        Slice bytes = generator_.Generate(FLAGS_item_size);
+        memcpy(p, bytes.data(), FLAGS_item_size);
+        table_->InsertKeyWithHint(handle, &hint);
+        *bytes_written_ += encoded_len;
+      }
+      done += n;
+    }
+  }
+};
+
 class ConcurrentFillBenchmarkThread : public FillBenchmarkThread {
  public:
   ConcurrentFillBenchmarkThread(MemTableRep* table, KeyGenerator* key_gen,
@@ -473,6 +582,49 @@ class FillBenchmark : public Benchmark {
   }
 };
 
+class BatchFillBenchmark : public Benchmark {
+ public:
+  explicit BatchFillBenchmark(MemTableRep* table, KeyGenerator* key_gen,
+                              uint64_t* sequence)
+      : Benchmark(table, key_gen, sequence, 1) {
+    num_write_ops_per_thread_ = FLAGS_num_operations;
+  }
+
+  void RunThreads(std::vector<port::Thread>* /*threads*/,
+                  uint64_t* bytes_written, uint64_t* /*bytes_read*/,
+                  bool /*write*/, uint64_t* /*read_hits*/) override {
+    BatchFillBenchmarkThread(table_, key_gen_, bytes_written, sequence_,
+                             num_write_ops_per_thread_)();
+  }
+};
+
+class ConcurrentFillBenchmark : public Benchmark {
+ public:
+  explicit ConcurrentFillBenchmark(MemTableRep* table, uint64_t* sequence)
+      : Benchmark(table, nullptr, sequence, FLAGS_num_threads) {
+    num_write_ops_per_thread_ = FLAGS_num_operations / FLAGS_num_threads;
+  }
+
+  void RunThreads(std::vector<port::Thread>* threads, uint64_t* bytes_written,
+                  uint64_t* /*bytes_read*/, bool /*write*/,
+                  uint64_t* /*read_hits*/) override {
+    std::vector<uint64_t> thread_bytes_written(FLAGS_num_threads);
+    for (int i = 0; i < FLAGS_num_threads; ++i) {
+      threads->emplace_back(MultiWriterFillBenchmarkThread(
+          table_, &thread_bytes_written[i], num_write_ops_per_thread_, i,
+          FLAGS_num_threads));
+    }
+    for (auto& thread : *threads) {
+      thread.join();
+    }
+    for (uint64_t bytes : thread_bytes_written) {
+      *bytes_written += bytes;
+    }
+    // Let the read benchmarks that follow see every entry
+    *sequence_ = 1;
+  }
+};
+
 class ReadBenchmark : public Benchmark {
  public:
   explicit ReadBenchmark(MemTableRep* table, KeyGenerator* key_gen,
@@ -580,6 +732,8 @@ int main(int argc, char** argv) {
 #ifndef ROCKSDB_LITE
   } else if (FLAGS_memtablerep == "vector") {
     factory.reset(new ROCKSDB_NAMESPACE::VectorRepFactory);
+  } else if (FLAGS_memtablerep == "btree") {
+    factory.reset(new ROCKSDB_NAMESPACE::BTreeRepFactory);
   } else if (FLAGS_memtablerep == "hashskiplist") {
     factory.reset(ROCKSDB_NAMESPACE::NewHashSkipListRepFactory(
         FLAGS_bucket_count, FLAGS_hashskiplist_height,
@@ -602,7 +756,8 @@ int main(int argc, char** argv) {
   ROCKSDB_NAMESPACE::InternalKeyComparator internal_key_comp(
       ROCKSDB_NAMESPACE::BytewiseComparator());
   ROCKSDB_NAMESPACE::MemTable::KeyComparator key_comp(internal_key_comp);
-  ROCKSDB_NAMESPACE::Arena arena;
+  // Thread-safe, for fillrandomconcurrent
+  ROCKSDB_NAMESPACE::ConcurrentArena arena;
   ROCKSDB_NAMESPACE::WriteBufferManager wb(FLAGS_write_buffer_size);
   uint64_t sequence;
   auto createMemtableRep = [&] {
@@ -638,6 +793,21 @@ int main(int argc, char** argv) {
           &rng, ROCKSDB_NAMESPACE::UNIQUE_RANDOM, FLAGS_num_operations));
       benchmark.reset(new ROCKSDB_NAMESPACE::FillBenchmark(
           memtablerep.get(), key_gen.get(), &sequence));
+    } else if (name == ROCKSDB_NAMESPACE::Slice("fillrandombatch")) {
+      memtablerep.reset(createMemtableRep());
+      key_gen.reset(new ROCKSDB_NAMESPACE::KeyGenerator(
+          &rng, ROCKSDB_NAMESPACE::UNIQUE_RANDOM, FLAGS_num_operations));
+      benchmark.reset(new ROCKSDB_NAMESPACE::BatchFillBenchmark(
+          memtablerep.get(), key_gen.get(), &sequence));
+    } else if (name == ROCKSDB_NAMESPACE::Slice("fillrandomconcurrent")) {
+      memtablerep.reset(createMemtableRep());
+      if (!factory->IsInsertConcurrentlySupported()) {
+        fprintf(stdout, "%s does not support concurrent inserts\n",
+                factory->Name());
+        exit(1);
+      }
+      benchmark.reset(new ROCKSDB_NAMESPACE::ConcurrentFillBenchmark(
+          memtablerep.get(), &sequence));
     } else if (name == ROCKSDB_NAMESPACE::Slice("readrandom")) {
       key_gen.reset(new ROCKSDB_NAMESPACE::KeyGenerator(
           &rng, ROCKSDB_NAMESPACE::RANDOM, FLAGS_num_operations));
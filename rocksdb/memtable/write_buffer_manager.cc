@@ -49,9 +49,11 @@ struct WriteBufferManager::CacheRep {};
 #endif  // ROCKSDB_LITE
 
 WriteBufferManager::WriteBufferManager(size_t _buffer_size,
-                                       std::shared_ptr<Cache> cache)
+                                       std::shared_ptr<Cache> cache,
+                                       bool shrink_cache_charge_with_usage)
     : buffer_size_(_buffer_size),
       mutable_limit_(buffer_size_ * 7 / 8),
+      shrink_cache_charge_with_usage_(shrink_cache_charge_with_usage),
       memory_used_(0),
       memory_active_(0),
       cache_rep_(nullptr) {
@@ -126,20 +128,34 @@ void WriteBufferManager::FreeMemWithCache(size_t mem) {
   // 2. eventually, if we walk away from a temporary memtable size increase,
   //    we make sure shrink the memory costed in block cache over time.
   // In this way, we only shrink costed memory showly even there is enough
-  // margin.
-  if (new_mem_used < cache_rep_->cache_allocated_size_ / 4 * 3 &&
-      cache_rep_->cache_allocated_size_ - kSizeDummyEntry > new_mem_used) {
-    assert(!cache_rep_->dummy_handles_.empty());
-    auto* handle = cache_rep_->dummy_handles_.back();
-    // If insert failed, handle is null so we should not release.
-    if (handle != nullptr) {
-      cache_rep_->cache_->Release(handle, true);
+  // margin. With shrink_cache_charge_with_usage_, we instead release every
+  // dummy entry that is no longer backed by memtable memory.
+  if (shrink_cache_charge_with_usage_) {
+    while (cache_rep_->cache_allocated_size_ >= kSizeDummyEntry &&
+           cache_rep_->cache_allocated_size_ - kSizeDummyEntry >=
+               new_mem_used) {
+      ReleaseDummyEntry();
     }
-    cache_rep_->dummy_handles_.pop_back();
-    cache_rep_->cache_allocated_size_ -= kSizeDummyEntry;
+  } else if (new_mem_used < cache_rep_->cache_allocated_size_ / 4 * 3 &&
+             cache_rep_->cache_allocated_size_ - kSizeDummyEntry >
+                 new_mem_used) {
+    ReleaseDummyEntry();
   }
 #else
   (void)mem;
 #endif  // ROCKSDB_LITE
 }
+
+void WriteBufferManager::ReleaseDummyEntry() {
+#ifndef ROCKSDB_LITE
+  assert(!cache_rep_->dummy_handles_.empty());
+  auto* handle = cache_rep_->dummy_handles_.back();
+  // If insert failed, handle is null so we should not release.
+  if (handle != nullptr) {
+    cache_rep_->cache_->Release(handle, true);
+  }
+  cache_rep_->dummy_handles_.pop_back();
+  cache_rep_->cache_allocated_size_ -= kSizeDummyEntry;
+#endif  // ROCKSDB_LITE
+}
 }  // namespace ROCKSDB_NAMESPACE
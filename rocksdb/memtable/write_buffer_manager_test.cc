@@ -175,6 +175,25 @@ TEST_F(WriteBufferManagerTest, CacheFull) {
   ASSERT_LT(cache->GetPinnedUsage(), 20 * 1024 * 1024);
 }
 
+TEST_F(WriteBufferManagerTest, ShrinkCacheChargeWithUsage) {
+  // 1GB cache
+  std::shared_ptr<Cache> cache = NewLRUCache(1024 * 1024 * 1024, 4);
+  std::unique_ptr<WriteBufferManager> wbf(
+      new WriteBufferManager(50 * 1024 * 1024, cache,
+                             true /* shrink_cache_charge_with_usage */));
+  wbf->ReserveMem(10 * 1024 * 1024);
+  ASSERT_GE(cache->GetPinnedUsage(), 10 * 1024 * 1024);
+  ASSERT_LT(cache->GetPinnedUsage(), 10 * 1024 * 1024 + 10000);
+
+  // A single free gives back everything that is no longer used
+  wbf->FreeMem(9 * 1024 * 1024);
+  ASSERT_GE(cache->GetPinnedUsage(), 1024 * 1024);
+  ASSERT_LT(cache->GetPinnedUsage(), 1024 * 1024 + 256 * 1024 + 10000);
+
+  wbf->FreeMem(1024 * 1024);
+  ASSERT_LT(cache->GetPinnedUsage(), 10000);
+}
+
 #endif  // ROCKSDB_LITE
 }  // namespace ROCKSDB_NAMESPACE
 
@@ -92,6 +92,8 @@ PerfContext::PerfContext(const PerfContext& other) {
   find_table_nanos = other.find_table_nanos;
   bloom_memtable_hit_count = other.bloom_memtable_hit_count;
   bloom_memtable_miss_count = other.bloom_memtable_miss_count;
+  memtable_hash_index_hit_count = other.memtable_hash_index_hit_count;
+  memtable_hash_index_miss_count = other.memtable_hash_index_miss_count;
   bloom_sst_hit_count = other.bloom_sst_hit_count;
   bloom_sst_miss_count = other.bloom_sst_miss_count;
   key_lock_wait_time = other.key_lock_wait_time;
@@ -189,6 +191,8 @@ PerfContext::PerfContext(PerfContext&& other) noexcept {
   find_table_nanos = other.find_table_nanos;
   bloom_memtable_hit_count = other.bloom_memtable_hit_count;
   bloom_memtable_miss_count = other.bloom_memtable_miss_count;
+  memtable_hash_index_hit_count = other.memtable_hash_index_hit_count;
+  memtable_hash_index_miss_count = other.memtable_hash_index_miss_count;
   bloom_sst_hit_count = other.bloom_sst_hit_count;
   bloom_sst_miss_count = other.bloom_sst_miss_count;
   key_lock_wait_time = other.key_lock_wait_time;
@@ -288,6 +292,8 @@ PerfContext& PerfContext::operator=(const PerfContext& other) {
   find_table_nanos = other.find_table_nanos;
   bloom_memtable_hit_count = other.bloom_memtable_hit_count;
   bloom_memtable_miss_count = other.bloom_memtable_miss_count;
+  memtable_hash_index_hit_count = other.memtable_hash_index_hit_count;
+  memtable_hash_index_miss_count = other.memtable_hash_index_miss_count;
   bloom_sst_hit_count = other.bloom_sst_hit_count;
   bloom_sst_miss_count = other.bloom_sst_miss_count;
   key_lock_wait_time = other.key_lock_wait_time;
@@ -384,6 +390,8 @@ void PerfContext::Reset() {
   find_table_nanos = 0;
   bloom_memtable_hit_count = 0;
   bloom_memtable_miss_count = 0;
+  memtable_hash_index_hit_count = 0;
+  memtable_hash_index_miss_count = 0;
   bloom_sst_hit_count = 0;
   bloom_sst_miss_count = 0;
   key_lock_wait_time = 0;
@@ -503,6 +511,8 @@ std::string PerfContext::ToString(bool exclude_zero_counters) const {
   PERF_CONTEXT_OUTPUT(find_table_nanos);
   PERF_CONTEXT_OUTPUT(bloom_memtable_hit_count);
   PERF_CONTEXT_OUTPUT(bloom_memtable_miss_count);
+  PERF_CONTEXT_OUTPUT(memtable_hash_index_hit_count);
+  PERF_CONTEXT_OUTPUT(memtable_hash_index_miss_count);
   PERF_CONTEXT_OUTPUT(bloom_sst_hit_count);
   PERF_CONTEXT_OUTPUT(bloom_sst_miss_count);
   PERF_CONTEXT_OUTPUT(key_lock_wait_time);
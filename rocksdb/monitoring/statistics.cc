@@ -192,6 +192,10 @@ const std::vector<std::pair<Tickers, std::string>> TickersNameMap = {
      "rocksdb.block.cache.compression.dict.add.redundant"},
     {FILES_MARKED_TRASH, "rocksdb.files.marked.trash"},
     {FILES_DELETED_IMMEDIATELY, "rocksdb.files.deleted.immediately"},
+    {COMPACTION_DATA_BLOCKS_COPIED, "rocksdb.compaction.data.blocks.copied"},
+    {COMPACTION_RANGE_DEL_DROPPED_FILES,
+     "rocksdb.compaction.range.del.dropped.files"},
+    {COMPACTION_RANGE_DEL_SKIPS, "rocksdb.compaction.range.del.skips"},
 };
 
 const std::vector<std::pair<Histograms, std::string>> HistogramsNameMap = {
@@ -247,6 +251,18 @@ const std::vector<std::pair<Histograms, std::string>> HistogramsNameMap = {
      "rocksdb.num.index.and.filter.blocks.read.per.level"},
     {NUM_DATA_BLOCKS_READ_PER_LEVEL, "rocksdb.num.data.blocks.read.per.level"},
     {NUM_SST_READ_PER_LEVEL, "rocksdb.num.sst.read.per.level"},
+    {WAL_SYNC_COALESCED_WRITES, "rocksdb.wal.sync.coalesced.writes"},
+    {WAL_SYNC_COALESCING_WAIT_MICROS,
+     "rocksdb.wal.sync.coalescing.wait.micros"},
+    {WRITE_THREAD_JOIN_WAIT_MICROS, "rocksdb.write.thread.join.wait.micros"},
+    {WRITE_GROUP_FORMATION_MICROS, "rocksdb.write.group.formation.micros"},
+    {WRITE_WAL_MICROS, "rocksdb.write.wal.micros"},
+    {WRITE_MEMTABLE_MICROS, "rocksdb.write.memtable.micros"},
+    {WRITE_MEMTABLE_BARRIER_WAIT_MICROS,
+     "rocksdb.write.memtable.barrier.wait.micros"},
+    {WRITE_THREAD_SPIN_MICROS, "rocksdb.write.thread.spin.micros"},
+    {WRITE_THREAD_YIELD_MICROS, "rocksdb.write.thread.yield.micros"},
+    {WRITE_THREAD_BLOCK_MICROS, "rocksdb.write.thread.block.micros"},
 };
 
 std::shared_ptr<Statistics> CreateDBStatistics() {
@@ -47,6 +47,8 @@ struct ImmutableCFOptions {
 
   bool inplace_update_support;
 
+  bool inplace_merge_support;
+
   UpdateStatus (*inplace_callback)(char* existing_value,
                                    uint32_t* existing_value_size,
                                    Slice delta_value,
@@ -123,7 +125,17 @@ struct ImmutableCFOptions {
 
   std::shared_ptr<SstPartitionerFactory> sst_partitioner_factory;
 
+  std::shared_ptr<MemoryAllocator> memtable_memory_allocator;
+
   bool allow_data_in_errors;
+
+  bool cost_based_write_buffer_flush;
+
+  bool sample_subcompaction_boundaries;
+
+  bool enable_l0_subcompactions;
+
+  bool enable_partial_trivial_move;
 };
 
 struct MutableCFOptions {
@@ -135,6 +147,8 @@ struct MutableCFOptions {
         memtable_prefix_bloom_size_ratio(
             options.memtable_prefix_bloom_size_ratio),
         memtable_whole_key_filtering(options.memtable_whole_key_filtering),
+        memtable_hash_index_size_ratio(options.memtable_hash_index_size_ratio),
+        memtable_gc_min_garbage_ratio(options.memtable_gc_min_garbage_ratio),
         memtable_huge_page_size(options.memtable_huge_page_size),
         max_successive_merges(options.max_successive_merges),
         inplace_update_num_locks(options.inplace_update_num_locks),
@@ -163,6 +177,9 @@ struct MutableCFOptions {
         min_blob_size(options.min_blob_size),
         blob_file_size(options.blob_file_size),
         blob_compression_type(options.blob_compression_type),
+        enable_blob_garbage_collection(options.enable_blob_garbage_collection),
+        blob_garbage_collection_age_cutoff(
+            options.blob_garbage_collection_age_cutoff),
         max_sequential_skip_in_iterations(
             options.max_sequential_skip_in_iterations),
         check_flush_compaction_key_order(
@@ -184,6 +201,8 @@ struct MutableCFOptions {
         arena_block_size(0),
         memtable_prefix_bloom_size_ratio(0),
         memtable_whole_key_filtering(false),
+        memtable_hash_index_size_ratio(0),
+        memtable_gc_min_garbage_ratio(0),
         memtable_huge_page_size(0),
         max_successive_merges(0),
         inplace_update_num_locks(0),
@@ -206,6 +225,8 @@ struct MutableCFOptions {
         min_blob_size(0),
         blob_file_size(0),
         blob_compression_type(kNoCompression),
+        enable_blob_garbage_collection(false),
+        blob_garbage_collection_age_cutoff(0.0),
         max_sequential_skip_in_iterations(0),
         check_flush_compaction_key_order(true),
         paranoid_file_checks(false),
@@ -239,6 +260,8 @@ struct MutableCFOptions {
   size_t arena_block_size;
   double memtable_prefix_bloom_size_ratio;
   bool memtable_whole_key_filtering;
+  double memtable_hash_index_size_ratio;
+  double memtable_gc_min_garbage_ratio;
   size_t memtable_huge_page_size;
   size_t max_successive_merges;
   size_t inplace_update_num_locks;
@@ -267,6 +290,8 @@ struct MutableCFOptions {
   uint64_t min_blob_size;
   uint64_t blob_file_size;
   CompressionType blob_compression_type;
+  bool enable_blob_garbage_collection;
+  double blob_garbage_collection_age_cutoff;
 
   // Misc options
   uint64_t max_sequential_skip_in_iterations;
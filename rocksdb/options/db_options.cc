@@ -419,6 +419,47 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct ImmutableDBOptions, allow_data_in_errors),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"block_cache_manifest_period_sec",
+         {offsetof(struct ImmutableDBOptions, block_cache_manifest_period_sec),
+          OptionType::kUInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"enable_wal_staging_buffers",
+         {offsetof(struct ImmutableDBOptions, enable_wal_staging_buffers),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"cost_based_write_buffer_flush",
+         {offsetof(struct ImmutableDBOptions, cost_based_write_buffer_flush),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"wal_sync_coalescing_max_wait_us",
+         {offsetof(struct ImmutableDBOptions, wal_sync_coalescing_max_wait_us),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"enable_pipelined_compaction",
+         {offsetof(struct ImmutableDBOptions, enable_pipelined_compaction),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"sample_subcompaction_boundaries",
+         {offsetof(struct ImmutableDBOptions, sample_subcompaction_boundaries),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"enable_l0_subcompactions",
+         {offsetof(struct ImmutableDBOptions, enable_l0_subcompactions),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"reuse_compaction_input_blocks",
+         {offsetof(struct ImmutableDBOptions, reuse_compaction_input_blocks),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"enable_partial_trivial_move",
+         {offsetof(struct ImmutableDBOptions, enable_partial_trivial_move),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"skip_range_deleted_compaction_input",
+         {offsetof(struct ImmutableDBOptions,
+                   skip_range_deleted_compaction_input),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
 };
 
 const std::string OptionsHelper::kDBOptionsName = "DBOptions";
@@ -569,7 +610,19 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       best_efforts_recovery(options.best_efforts_recovery),
       max_bgerror_resume_count(options.max_bgerror_resume_count),
       bgerror_resume_retry_interval(options.bgerror_resume_retry_interval),
-      allow_data_in_errors(options.allow_data_in_errors) {
+      allow_data_in_errors(options.allow_data_in_errors),
+      block_cache_manifest_period_sec(options.block_cache_manifest_period_sec),
+      enable_wal_staging_buffers(options.enable_wal_staging_buffers),
+      cost_based_write_buffer_flush(options.cost_based_write_buffer_flush),
+      wal_sync_coalescing_max_wait_us(options.wal_sync_coalescing_max_wait_us),
+      enable_pipelined_compaction(options.enable_pipelined_compaction),
+      sample_subcompaction_boundaries(options.sample_subcompaction_boundaries),
+      enable_l0_subcompactions(options.enable_l0_subcompactions),
+      reuse_compaction_input_blocks(options.reuse_compaction_input_blocks),
+      enable_partial_trivial_move(options.enable_partial_trivial_move),
+      compaction_service(options.compaction_service),
+      skip_range_deleted_compaction_input(
+          options.skip_range_deleted_compaction_input) {
 }
 
 void ImmutableDBOptions::Dump(Logger* log) const {
@@ -727,6 +780,29 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    bgerror_resume_retry_interval);
   ROCKS_LOG_HEADER(log, "            Options.allow_data_in_errors: %d",
                    allow_data_in_errors);
+  ROCKS_LOG_HEADER(log, " Options.block_cache_manifest_period_sec: %u",
+                   block_cache_manifest_period_sec);
+  ROCKS_LOG_HEADER(log, "      Options.enable_wal_staging_buffers: %d",
+                   enable_wal_staging_buffers);
+  ROCKS_LOG_HEADER(log, "   Options.cost_based_write_buffer_flush: %d",
+                   cost_based_write_buffer_flush);
+  ROCKS_LOG_HEADER(log,
+                   " Options.wal_sync_coalescing_max_wait_us: %" PRIu64,
+                   wal_sync_coalescing_max_wait_us);
+  ROCKS_LOG_HEADER(log, "     Options.enable_pipelined_compaction: %d",
+                   enable_pipelined_compaction);
+  ROCKS_LOG_HEADER(log, " Options.sample_subcompaction_boundaries: %d",
+                   sample_subcompaction_boundaries);
+  ROCKS_LOG_HEADER(log, " Options.enable_l0_subcompactions: %d",
+                   enable_l0_subcompactions);
+  ROCKS_LOG_HEADER(log, " Options.reuse_compaction_input_blocks: %d",
+                   reuse_compaction_input_blocks);
+  ROCKS_LOG_HEADER(log, " Options.enable_partial_trivial_move: %d",
+                   enable_partial_trivial_move);
+  ROCKS_LOG_HEADER(log, " Options.compaction_service: %s",
+                   compaction_service ? compaction_service->Name() : "None");
+  ROCKS_LOG_HEADER(log, " Options.skip_range_deleted_compaction_input: %d",
+                   skip_range_deleted_compaction_input);
 }
 
 MutableDBOptions::MutableDBOptions()
@@ -91,6 +91,17 @@ struct ImmutableDBOptions {
   int max_bgerror_resume_count;
   uint64_t bgerror_resume_retry_interval;
   bool allow_data_in_errors;
+  unsigned int block_cache_manifest_period_sec;
+  bool enable_wal_staging_buffers;
+  bool cost_based_write_buffer_flush;
+  uint64_t wal_sync_coalescing_max_wait_us;
+  bool enable_pipelined_compaction;
+  bool sample_subcompaction_boundaries;
+  bool enable_l0_subcompactions;
+  bool reuse_compaction_input_blocks;
+  bool enable_partial_trivial_move;
+  std::shared_ptr<CompactionService> compaction_service;
+  bool skip_range_deleted_compaction_input;
 };
 
 struct MutableDBOptions {
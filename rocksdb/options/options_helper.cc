@@ -164,6 +164,27 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
       immutable_db_options.max_bgerror_resume_count;
   options.bgerror_resume_retry_interval =
       immutable_db_options.bgerror_resume_retry_interval;
+  options.block_cache_manifest_period_sec =
+      immutable_db_options.block_cache_manifest_period_sec;
+  options.enable_wal_staging_buffers =
+      immutable_db_options.enable_wal_staging_buffers;
+  options.cost_based_write_buffer_flush =
+      immutable_db_options.cost_based_write_buffer_flush;
+  options.wal_sync_coalescing_max_wait_us =
+      immutable_db_options.wal_sync_coalescing_max_wait_us;
+  options.enable_pipelined_compaction =
+      immutable_db_options.enable_pipelined_compaction;
+  options.sample_subcompaction_boundaries =
+      immutable_db_options.sample_subcompaction_boundaries;
+  options.enable_l0_subcompactions =
+      immutable_db_options.enable_l0_subcompactions;
+  options.reuse_compaction_input_blocks =
+      immutable_db_options.reuse_compaction_input_blocks;
+  options.enable_partial_trivial_move =
+      immutable_db_options.enable_partial_trivial_move;
+  options.compaction_service = immutable_db_options.compaction_service;
+  options.skip_range_deleted_compaction_input =
+      immutable_db_options.skip_range_deleted_compaction_input;
   return options;
 }
 
@@ -180,6 +201,10 @@ ColumnFamilyOptions BuildColumnFamilyOptions(
       mutable_cf_options.memtable_prefix_bloom_size_ratio;
   cf_opts.memtable_whole_key_filtering =
       mutable_cf_options.memtable_whole_key_filtering;
+  cf_opts.memtable_hash_index_size_ratio =
+      mutable_cf_options.memtable_hash_index_size_ratio;
+  cf_opts.memtable_gc_min_garbage_ratio =
+      mutable_cf_options.memtable_gc_min_garbage_ratio;
   cf_opts.memtable_huge_page_size = mutable_cf_options.memtable_huge_page_size;
   cf_opts.max_successive_merges = mutable_cf_options.max_successive_merges;
   cf_opts.inplace_update_num_locks =
@@ -226,6 +251,10 @@ ColumnFamilyOptions BuildColumnFamilyOptions(
   cf_opts.min_blob_size = mutable_cf_options.min_blob_size;
   cf_opts.blob_file_size = mutable_cf_options.blob_file_size;
   cf_opts.blob_compression_type = mutable_cf_options.blob_compression_type;
+  cf_opts.enable_blob_garbage_collection =
+      mutable_cf_options.enable_blob_garbage_collection;
+  cf_opts.blob_garbage_collection_age_cutoff =
+      mutable_cf_options.blob_garbage_collection_age_cutoff;
 
   // Misc options
   cf_opts.max_sequential_skip_in_iterations =
@@ -259,7 +288,8 @@ std::map<CompactionPri, std::string> OptionsHelper::compaction_pri_to_string = {
     {kByCompensatedSize, "kByCompensatedSize"},
     {kOldestLargestSeqFirst, "kOldestLargestSeqFirst"},
     {kOldestSmallestSeqFirst, "kOldestSmallestSeqFirst"},
-    {kMinOverlappingRatio, "kMinOverlappingRatio"}};
+    {kMinOverlappingRatio, "kMinOverlappingRatio"},
+    {kReadHeatWeightedOverlappingRatio, "kReadHeatWeightedOverlappingRatio"}};
 
 std::map<CompactionStopStyle, std::string>
     OptionsHelper::compaction_stop_style_to_string = {
@@ -877,7 +907,9 @@ std::unordered_map<std::string, CompactionPri>
         {"kByCompensatedSize", kByCompensatedSize},
         {"kOldestLargestSeqFirst", kOldestLargestSeqFirst},
         {"kOldestSmallestSeqFirst", kOldestSmallestSeqFirst},
-        {"kMinOverlappingRatio", kMinOverlappingRatio}};
+        {"kMinOverlappingRatio", kMinOverlappingRatio},
+        {"kReadHeatWeightedOverlappingRatio",
+         kReadHeatWeightedOverlappingRatio}};
 
 std::unordered_map<std::string, CompactionStopStyle>
     OptionsHelper::compaction_stop_style_string_map = {
@@ -116,6 +116,14 @@ TEST_F(OptionsSettableTest, BlockBasedTableOptionsAllFieldsSettable) {
        sizeof(std::shared_ptr<Cache>)},
       {offsetof(struct BlockBasedTableOptions, filter_policy),
        sizeof(std::shared_ptr<const FilterPolicy>)},
+      {offsetof(struct BlockBasedTableOptions, adaptive_compression_types),
+       sizeof(std::vector<CompressionType>)},
+      {offsetof(struct BlockBasedTableOptions,
+                adaptive_compression_zstd_levels),
+       sizeof(std::vector<int>)},
+      {offsetof(struct BlockBasedTableOptions,
+                adaptive_block_size_multipliers),
+       sizeof(std::vector<int>)},
   };
 
   // In this test, we catch a new option of BlockBasedTableOptions that is not
@@ -169,6 +177,7 @@ TEST_F(OptionsSettableTest, BlockBasedTableOptionsAllFieldsSettable) {
       "block_size_deviation=8;block_restart_interval=4; "
       "metadata_block_size=1024;"
       "partition_filters=false;"
+      "prefetch_hot_partitions=true;"
       "optimize_filters_for_memory=true;"
       "index_block_restart_interval=4;"
       "filter_policy=bloomfilter:4:true;whole_key_filtering=1;"
@@ -176,6 +185,10 @@ TEST_F(OptionsSettableTest, BlockBasedTableOptionsAllFieldsSettable) {
       "hash_index_allow_collision=false;"
       "verify_compression=true;read_amp_bytes_per_bit=0;"
       "enable_index_compression=false;"
+      "adaptive_compression_types=kZSTD:kLZ4Compression;"
+      "adaptive_compression_zstd_levels=1:3;"
+      "adaptive_block_size_multipliers=2:4;"
+      "adaptive_compression_space_weight=0.5;"
       "block_align=true",
       new_bbto));
 
@@ -223,6 +236,8 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
       {offsetof(struct DBOptions, wal_filter), sizeof(const WalFilter*)},
       {offsetof(struct DBOptions, file_checksum_gen_factory),
        sizeof(std::shared_ptr<FileChecksumGenFactory>)},
+      {offsetof(struct DBOptions, compaction_service),
+       sizeof(std::shared_ptr<CompactionService>)},
   };
 
   char* options_ptr = new char[sizeof(DBOptions)];
@@ -328,7 +343,17 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "write_dbid_to_manifest=false;"
                              "best_efforts_recovery=false;"
                              "max_bgerror_resume_count=2;"
-                             "bgerror_resume_retry_interval=1000000",
+                             "bgerror_resume_retry_interval=1000000;"
+                             "block_cache_manifest_period_sec=37;"
+                             "enable_wal_staging_buffers=false;"
+                             "cost_based_write_buffer_flush=false;"
+                             "wal_sync_coalescing_max_wait_us=200;"
+                             "enable_pipelined_compaction=false;"
+                             "sample_subcompaction_boundaries=false;"
+                             "enable_l0_subcompactions=false;"
+                             "reuse_compaction_input_blocks=false;"
+                             "enable_partial_trivial_move=false;"
+                             "skip_range_deleted_compaction_input=false",
                              new_options));
 
   ASSERT_EQ(unset_bytes_base, NumUnsetBytes(new_options_ptr, sizeof(DBOptions),
@@ -391,6 +416,8 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
        sizeof(std::shared_ptr<ConcurrentTaskLimiter>)},
       {offset_of(&ColumnFamilyOptions::sst_partitioner_factory),
        sizeof(std::shared_ptr<SstPartitionerFactory>)},
+      {offset_of(&ColumnFamilyOptions::memtable_memory_allocator),
+       sizeof(std::shared_ptr<MemoryAllocator>)},
   };
 
   char* options_ptr = new char[sizeof(ColumnFamilyOptions)];
@@ -431,6 +458,7 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
   options->max_mem_compaction_level = 0;
   options->compaction_filter = nullptr;
   options->sst_partitioner_factory = nullptr;
+  options->memtable_memory_allocator = nullptr;
 
   char* new_options_ptr = new char[sizeof(ColumnFamilyOptions)];
   ColumnFamilyOptions* new_options =
@@ -478,6 +506,8 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       "merge_operator=aabcxehazrMergeOperator;"
       "memtable_prefix_bloom_size_ratio=0.4642;"
       "memtable_whole_key_filtering=true;"
+      "memtable_hash_index_size_ratio=0.0625;"
+      "memtable_gc_min_garbage_ratio=0.5;"
       "memtable_insert_with_hint_prefix_extractor=rocksdb.CappedPrefix.13;"
       "check_flush_compaction_key_order=false;"
       "paranoid_file_checks=true;"
@@ -486,6 +516,7 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       "optimize_filters_for_hits=false;"
       "level_compaction_dynamic_level_bytes=false;"
       "inplace_update_support=false;"
+      "inplace_merge_support=false;"
       "compaction_style=kCompactionStyleFIFO;"
       "compaction_pri=kMinOverlappingRatio;"
       "hard_pending_compaction_bytes_limit=0;"
@@ -498,6 +529,8 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       "min_blob_size=256;"
       "blob_file_size=1000000;"
       "blob_compression_type=kBZip2Compression;"
+      "enable_blob_garbage_collection=true;"
+      "blob_garbage_collection_age_cutoff=0.5;"
       "compaction_options_fifo={max_table_files_size=3;allow_"
       "compaction=false;};",
       new_options));
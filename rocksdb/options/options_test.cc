@@ -102,6 +102,8 @@ TEST_F(OptionsTest, GetOptionsFromMapTest) {
       {"min_blob_size", "1K"},
       {"blob_file_size", "1G"},
       {"blob_compression_type", "kZSTD"},
+      {"enable_blob_garbage_collection", "true"},
+      {"blob_garbage_collection_age_cutoff", "0.5"},
   };
 
   std::unordered_map<std::string, std::string> db_options_map = {
@@ -230,6 +232,8 @@ TEST_F(OptionsTest, GetOptionsFromMapTest) {
   ASSERT_EQ(new_cf_opt.min_blob_size, 1ULL << 10);
   ASSERT_EQ(new_cf_opt.blob_file_size, 1ULL << 30);
   ASSERT_EQ(new_cf_opt.blob_compression_type, kZSTD);
+  ASSERT_EQ(new_cf_opt.enable_blob_garbage_collection, true);
+  ASSERT_EQ(new_cf_opt.blob_garbage_collection_age_cutoff, 0.5);
 
   cf_options_map["write_buffer_size"] = "hello";
   ASSERT_NOK(GetColumnFamilyOptionsFromMap(exact, base_cf_opt, cf_options_map,
@@ -867,6 +871,20 @@ TEST_F(OptionsTest, GetBlockBasedTableOptionsFromString) {
   // new_opt.read_amp_bytes_per_bit.
   EXPECT_EQ(1U, new_opt.read_amp_bytes_per_bit);
 
+  ASSERT_OK(GetBlockBasedTableOptionsFromString(
+      config_options, table_opt,
+      "adaptive_compression_types=kZSTD:kLZ4Compression;"
+      "adaptive_compression_zstd_levels=1:-1;"
+      "adaptive_block_size_multipliers=2:4;"
+      "adaptive_compression_space_weight=0.25;",
+      &new_opt));
+  ASSERT_EQ(new_opt.adaptive_compression_types,
+            std::vector<CompressionType>({kZSTD, kLZ4Compression}));
+  ASSERT_EQ(new_opt.adaptive_compression_zstd_levels,
+            std::vector<int>({1, -1}));
+  ASSERT_EQ(new_opt.adaptive_block_size_multipliers, std::vector<int>({2, 4}));
+  ASSERT_EQ(new_opt.adaptive_compression_space_weight, 0.25);
+
   // unknown option
   Status s = GetBlockBasedTableOptionsFromString(
       config_options, table_opt,
@@ -1097,6 +1115,10 @@ TEST_F(OptionsTest, GetMemTableRepFactoryFromString) {
   ASSERT_NOK(GetMemTableRepFactoryFromString("vector:1024:invalid_opt",
                                              &new_mem_factory));
 
+  ASSERT_OK(GetMemTableRepFactoryFromString("btree", &new_mem_factory));
+  ASSERT_EQ(std::string(new_mem_factory->Name()), "BTreeRepFactory");
+  ASSERT_NOK(GetMemTableRepFactoryFromString("btree:1024", &new_mem_factory));
+
   ASSERT_NOK(GetMemTableRepFactoryFromString("cuckoo", &new_mem_factory));
   // CuckooHash memtable is already removed.
   ASSERT_NOK(GetMemTableRepFactoryFromString("cuckoo:1024", &new_mem_factory));
@@ -1338,6 +1360,17 @@ TEST_F(OptionsTest, CheckBlockBasedTableOptions) {
                                                        "no_block_cache=0;"));
   ASSERT_NE(bbto->block_cache.get(), nullptr);
   ASSERT_OK(cf_opts.table_factory->ValidateOptions(db_opts, cf_opts));
+
+  ASSERT_OK(cf_opts.table_factory->ConfigureFromString(
+      config_opts, "adaptive_block_size_multipliers=0;"));
+  ASSERT_TRUE(cf_opts.table_factory->ValidateOptions(db_opts, cf_opts)
+                  .IsInvalidArgument());
+  ASSERT_OK(cf_opts.table_factory->ConfigureFromString(
+      config_opts,
+      "adaptive_block_size_multipliers=2;"
+      "adaptive_compression_space_weight=1.5;"));
+  ASSERT_TRUE(cf_opts.table_factory->ValidateOptions(db_opts, cf_opts)
+                  .IsInvalidArgument());
 }
 
 TEST_F(OptionsTest, MutableTableOptions) {
@@ -1653,6 +1686,8 @@ TEST_F(OptionsOldApiTest, GetOptionsFromMapTest) {
       {"min_blob_size", "1K"},
       {"blob_file_size", "1G"},
       {"blob_compression_type", "kZSTD"},
+      {"enable_blob_garbage_collection", "true"},
+      {"blob_garbage_collection_age_cutoff", "0.5"},
   };
 
   std::unordered_map<std::string, std::string> db_options_map = {
@@ -1773,6 +1808,8 @@ TEST_F(OptionsOldApiTest, GetOptionsFromMapTest) {
   ASSERT_EQ(new_cf_opt.min_blob_size, 1ULL << 10);
   ASSERT_EQ(new_cf_opt.blob_file_size, 1ULL << 30);
   ASSERT_EQ(new_cf_opt.blob_compression_type, kZSTD);
+  ASSERT_EQ(new_cf_opt.enable_blob_garbage_collection, true);
+  ASSERT_EQ(new_cf_opt.blob_garbage_collection_age_cutoff, 0.5);
 
   cf_options_map["write_buffer_size"] = "hello";
   ASSERT_NOK(GetColumnFamilyOptionsFromMap(
@@ -67,8 +67,9 @@ void Encryption(Slice data, unsigned char* key, unsigned char* iv,
 
 // data, key, iv, aad, tags : Input
 // data : Output
-void Decryption(Slice data, unsigned char* key, unsigned char* iv,
+bool Decryption(Slice data, unsigned char* key, unsigned char* iv,
                 unsigned char* aad, unsigned char* tags) {
+  bool verified = true;
   unsigned char* outbuf = (unsigned char*)data.data();
   int outlen;
   EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
@@ -86,11 +87,13 @@ void Decryption(Slice data, unsigned char* key, unsigned char* iv,
     int rv = EVP_DecryptFinal_ex(ctx, outbuf, &outlen);
     if (rv <= 0) {
       fprintf(stdout, "tags verification fail \n");
+      verified = false;
     }
   } else {
     EVP_DecryptFinal_ex(ctx, outbuf, &outlen);
   }
   EVP_CIPHER_CTX_free(ctx);
+  return verified;
 }
 
 void digest(unsigned char* hmac, const Slice block, const unsigned char* key) {
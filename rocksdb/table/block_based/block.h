@@ -48,7 +48,8 @@ void Encryption(Slice data, unsigned char* key, unsigned char* iv,
                 unsigned char* aad, unsigned char* tags = nullptr);
 // data, key, iv, aad, tags : Input
 // data : Output
-void Decryption(Slice data, unsigned char* key, unsigned char* iv,
+// Returns false if tags are given and do not authenticate data
+bool Decryption(Slice data, unsigned char* key, unsigned char* iv,
                 unsigned char* aad, unsigned char* tags = nullptr);
 void digest(unsigned char* hmac, const Slice block, const unsigned char* key);
 
@@ -461,6 +462,13 @@ class BlockIter : public InternalIteratorBase<TValue> {
     return static_cast<uint32_t>((value_.data() + value_.size()) - data_);
   }
 
+  // Return the offset in data_ of the current entry.
+  uint32_t CurrentEntryOffset() const { return current_; }
+
+  // Return the offset in data_ of the restart array, which is just past the
+  // end of the last entry.
+  uint32_t RestartArrayOffset() const { return restarts_; }
+
   uint32_t GetRestartPoint(uint32_t index) {
     assert(index < num_restarts_);
     return DecodeFixed32(data_ + restarts_ + index * sizeof(uint32_t));
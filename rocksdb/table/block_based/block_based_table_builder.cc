@@ -12,6 +12,7 @@
 #include <assert.h>
 #include <stdio.h>
 
+#include <algorithm>
 #include <atomic>
 #include <list>
 #include <map>
@@ -102,6 +103,9 @@ bool GoodCompressionRatio(size_t compressed_size, size_t raw_size) {
   return compressed_size < raw_size - (raw_size / 8u);
 }
 
+// The amount of data blocks sampled by adaptive compression
+constexpr size_t kAdaptiveCompressionSampleBytes = 1 << 20;
+
 }  // namespace
 
 // format_version is the block format as defined in include/rocksdb/table.h
@@ -195,12 +199,14 @@ const uint64_t kLegacyBlockBasedTableMagicNumber = 0xdb4775248b80fb57ull;
 class BlockBasedTableBuilder::BlockBasedTablePropertiesCollector
     : public IntTblPropCollector {
  public:
+  // data_block_size, if not null, is read when the table is finished
   explicit BlockBasedTablePropertiesCollector(
       BlockBasedTableOptions::IndexType index_type, bool whole_key_filtering,
-      bool prefix_filtering)
+      bool prefix_filtering, const size_t* data_block_size)
       : index_type_(index_type),
         whole_key_filtering_(whole_key_filtering),
-        prefix_filtering_(prefix_filtering) {}
+        prefix_filtering_(prefix_filtering),
+        data_block_size_(data_block_size) {}
 
   Status InternalAdd(const Slice& /*key*/, const Slice& /*value*/,
                      uint64_t /*file_size*/) override {
@@ -225,6 +231,10 @@ class BlockBasedTableBuilder::BlockBasedTablePropertiesCollector
                         whole_key_filtering_ ? kPropTrue : kPropFalse});
     properties->insert({BlockBasedTablePropertyNames::kPrefixFiltering,
                         prefix_filtering_ ? kPropTrue : kPropFalse});
+    if (data_block_size_ != nullptr) {
+      properties->insert({BlockBasedTablePropertyNames::kDataBlockSize,
+                          ToString(*data_block_size_)});
+    }
     return Status::OK();
   }
 
@@ -242,6 +252,7 @@ class BlockBasedTableBuilder::BlockBasedTablePropertiesCollector
   BlockBasedTableOptions::IndexType index_type_;
   bool whole_key_filtering_;
   bool prefix_filtering_;
+  const size_t* data_block_size_;
 };
 
 struct BlockBasedTableBuilder::Rep {
@@ -280,6 +291,11 @@ struct BlockBasedTableBuilder::Rep {
   std::vector<std::unique_ptr<CompressionContext>> compression_ctxs;
   std::vector<std::unique_ptr<UncompressionContext>> verify_ctxs;
   std::unique_ptr<UncompressionDict> verify_dict;
+  // Whether the compression type and the data block size of the file are
+  // chosen from samples of its first data blocks
+  const bool adaptive_compression;
+  // The size of the data blocks cut by flush_block_policy
+  size_t data_block_size;
 
   size_t data_begin_offset = 0;
 
@@ -316,6 +332,13 @@ struct BlockBasedTableBuilder::Rep {
   size_t compressed_cache_key_prefix_size;
 
   BlockHandle pending_handle;  // Handle to add to index block
+  // The block at pending_handle was written by FlushDataBlock() or
+  // CopyDataBlock() and its index entry is added with the next key.
+  bool pending_index_entry = false;
+  // The current data block was started by FlushDataBlock() when
+  // num_data_blocks_at_cut data blocks had been written.
+  bool data_block_cut = false;
+  uint64_t num_data_blocks_at_cut = 0;
 
   std::string compressed_output;
   std::unique_ptr<FlushBlockPolicy> flush_block_policy;
@@ -432,8 +455,15 @@ struct BlockBasedTableBuilder::Rep {
         compression_ctxs(_compression_opts.parallel_threads),
         verify_ctxs(_compression_opts.parallel_threads),
         verify_dict(),
-        state((_compression_opts.max_dict_bytes > 0) ? State::kBuffered
-                                                     : State::kUnbuffered),
+        adaptive_compression(
+            (!table_opt.adaptive_compression_types.empty() ||
+             !table_opt.adaptive_block_size_multipliers.empty()) &&
+            _compression_type != kNoCompression &&
+            _compression_opts.parallel_threads == 1),
+        data_block_size(table_opt.block_size),
+        state((_compression_opts.max_dict_bytes > 0 || adaptive_compression)
+                  ? State::kBuffered
+                  : State::kUnbuffered),
         use_delta_encoding_for_index_values(table_opt.format_version >= 4 &&
                                             !table_opt.block_align),
         compressed_cache_key_prefix_size(0),
@@ -481,10 +511,15 @@ struct BlockBasedTableBuilder::Rep {
       table_properties_collectors.emplace_back(
           collector_factories->CreateIntTblPropCollector(column_family_id));
     }
+    const bool adaptive_block_size =
+        adaptive_compression &&
+        !table_options.adaptive_block_size_multipliers.empty() &&
+        !table_options.block_align;
     table_properties_collectors.emplace_back(
         new BlockBasedTablePropertiesCollector(
             table_options.index_type, table_options.whole_key_filtering,
-            _moptions.prefix_extractor != nullptr));
+            _moptions.prefix_extractor != nullptr,
+            adaptive_block_size ? &data_block_size : nullptr));
     if (table_options.verify_compression) {
       for (uint32_t i = 0; i < compression_opts.parallel_threads; i++) {
         verify_ctxs[i].reset(new UncompressionContext(compression_type));
@@ -727,8 +762,13 @@ void BlockBasedTableBuilder::Add(const Slice& key, const Slice& value) {
       r->first_key_in_next_block = &key;
       Flush();
 
-      if (r->state == Rep::State::kBuffered && r->target_file_size != 0 &&
-          r->data_begin_offset > r->target_file_size) {
+      // Without a compression dictionary, the blocks are buffered only to
+      // be sampled by adaptive compression
+      if (r->state == Rep::State::kBuffered &&
+          ((r->target_file_size != 0 &&
+            r->data_begin_offset > r->target_file_size) ||
+           (r->compression_opts.max_dict_bytes == 0 &&
+            r->data_begin_offset >= kAdaptiveCompressionSampleBytes))) {
         EnterUnbuffered();
       }
 
@@ -748,7 +788,10 @@ void BlockBasedTableBuilder::Add(const Slice& key, const Slice& value) {
                                           r->pending_handle);
         }
       }
+    } else if (r->pending_index_entry) {
+      r->index_builder->AddIndexEntry(&r->last_key, &key, r->pending_handle);
     }
+    r->pending_index_entry = false;
 
     // Note: PartitionedFilterBlockBuilder requires key being added to filter
     // builder after being added to index builder.
@@ -806,6 +849,75 @@ void BlockBasedTableBuilder::Add(const Slice& key, const Slice& value) {
   }
 }
 
+bool BlockBasedTableBuilder::CanCopyDataBlocks() const {
+  const Rep* r = rep_;
+  return r->state == Rep::State::kUnbuffered &&
+         r->compression_opts.parallel_threads == 1 &&
+         !r->table_options.block_align &&
+         r->table_options.block_cache_compressed == nullptr;
+}
+
+void BlockBasedTableBuilder::FlushDataBlock() {
+  Rep* r = rep_;
+  assert(rep_->state != Rep::State::kClosed);
+  if (!ok() || !CanCopyDataBlocks()) return;
+  if (!r->data_block.empty()) {
+    Flush();
+    r->pending_index_entry = true;
+  }
+  r->data_block_cut = true;
+  r->num_data_blocks_at_cut = r->props.num_data_blocks;
+}
+
+bool BlockBasedTableBuilder::CopyDataBlock(const DataBlockPosition& source) {
+  Rep* r = rep_;
+  assert(rep_->state != Rep::State::kClosed);
+  // The entries of source must have gone into a block of their own: no block
+  // was flushed by the flush block policy since the cut.
+  if (!ok() || !CanCopyDataBlocks() || source.table == nullptr ||
+      !r->data_block_cut ||
+      r->props.num_data_blocks != r->num_data_blocks_at_cut ||
+      r->data_block.empty()) {
+    return false;
+  }
+  std::string contents;
+  std::string tag;
+  Status s = source.table->ReadRawDataBlock(
+      source.handle, r->table_options.checksum,
+      r->table_options.format_version,
+      CompressionTypeToString(r->compression_type), &contents, &tag);
+  if (!s.ok()) {
+    return false;
+  }
+  assert(contents.size() == source.handle.size() + kBlockTrailerSize);
+
+  const size_t raw_block_size = r->data_block.CurrentSizeEstimate();
+  r->data_block.Reset();
+  r->data_block_cut = false;
+
+  r->pending_handle.set_offset(r->get_offset());
+  r->pending_handle.set_size(source.handle.size());
+  r->hmacs.push_back(std::move(tag));
+  r->pending_handle.set_hmac(static_cast<uint64_t>(r->hmacs.size()) - 1);
+  IOStatus io_s = r->file->Append(contents);
+  if (!io_s.ok()) {
+    r->SetIOStatus(io_s);
+    return false;
+  }
+  r->set_offset(r->get_offset() + contents.size());
+  r->pending_index_entry = true;
+
+  NotifyCollectTableCollectorsOnBlockAdd(r->table_properties_collectors,
+                                         raw_block_size, 0 /* fast */,
+                                         0 /* slow */);
+  if (r->filter_builder != nullptr) {
+    r->filter_builder->StartBlock(r->get_offset());
+  }
+  r->props.data_size = r->get_offset();
+  ++r->props.num_data_blocks;
+  return true;
+}
+
 void BlockBasedTableBuilder::Flush() {
   Rep* r = rep_;
   assert(rep_->state != Rep::State::kClosed);
@@ -1526,41 +1638,47 @@ void BlockBasedTableBuilder::WriteFooter(BlockHandle& metaindex_block_handle,
 void BlockBasedTableBuilder::EnterUnbuffered() {
   Rep* r = rep_;
   assert(r->state == Rep::State::kBuffered);
+  if (r->adaptive_compression) {
+    SelectAdaptiveCompression();
+  }
   r->state = Rep::State::kUnbuffered;
-  const size_t kSampleBytes = r->compression_opts.zstd_max_train_bytes > 0
-                                  ? r->compression_opts.zstd_max_train_bytes
-                                  : r->compression_opts.max_dict_bytes;
-  Random64 generator{r->creation_time};
-  std::string compression_dict_samples;
-  std::vector<size_t> compression_dict_sample_lens;
-  if (!r->data_block_and_keys_buffers.empty()) {
-    while (compression_dict_samples.size() < kSampleBytes) {
-      size_t rand_idx = static_cast<size_t>(
-          generator.Uniform(r->data_block_and_keys_buffers.size()));
-      size_t copy_len =
-          std::min(kSampleBytes - compression_dict_samples.size(),
-                   r->data_block_and_keys_buffers[rand_idx].first.size());
-      compression_dict_samples.append(
-          r->data_block_and_keys_buffers[rand_idx].first, 0, copy_len);
-      compression_dict_sample_lens.emplace_back(copy_len);
-    }
-  }
-
-  // final data block flushed, now we can generate dictionary from the samples.
-  // OK if compression_dict_samples is empty, we'll just get empty dictionary.
-  std::string dict;
-  if (r->compression_opts.zstd_max_train_bytes > 0) {
-    dict = ZSTD_TrainDictionary(compression_dict_samples,
-                                compression_dict_sample_lens,
-                                r->compression_opts.max_dict_bytes);
-  } else {
-    dict = std::move(compression_dict_samples);
+  if (r->compression_opts.max_dict_bytes > 0) {
+    const size_t kSampleBytes = r->compression_opts.zstd_max_train_bytes > 0
+                                    ? r->compression_opts.zstd_max_train_bytes
+                                    : r->compression_opts.max_dict_bytes;
+    Random64 generator{r->creation_time};
+    std::string compression_dict_samples;
+    std::vector<size_t> compression_dict_sample_lens;
+    if (!r->data_block_and_keys_buffers.empty()) {
+      while (compression_dict_samples.size() < kSampleBytes) {
+        size_t rand_idx = static_cast<size_t>(
+            generator.Uniform(r->data_block_and_keys_buffers.size()));
+        size_t copy_len =
+            std::min(kSampleBytes - compression_dict_samples.size(),
+                     r->data_block_and_keys_buffers[rand_idx].first.size());
+        compression_dict_samples.append(
+            r->data_block_and_keys_buffers[rand_idx].first, 0, copy_len);
+        compression_dict_sample_lens.emplace_back(copy_len);
+      }
+    }
+
+    // final data block flushed, now we can generate dictionary from the
+    // samples. OK if compression_dict_samples is empty, we'll just get empty
+    // dictionary.
+    std::string dict;
+    if (r->compression_opts.zstd_max_train_bytes > 0) {
+      dict = ZSTD_TrainDictionary(compression_dict_samples,
+                                  compression_dict_sample_lens,
+                                  r->compression_opts.max_dict_bytes);
+    } else {
+      dict = std::move(compression_dict_samples);
+    }
+    r->compression_dict.reset(new CompressionDict(dict, r->compression_type,
+                                                  r->compression_opts.level));
+    r->verify_dict.reset(new UncompressionDict(
+        dict, r->compression_type == kZSTD ||
+                  r->compression_type == kZSTDNotFinalCompression));
   }
-  r->compression_dict.reset(new CompressionDict(dict, r->compression_type,
-                                                r->compression_opts.level));
-  r->verify_dict.reset(new UncompressionDict(
-      dict, r->compression_type == kZSTD ||
-                r->compression_type == kZSTDNotFinalCompression));
 
   for (size_t i = 0; ok() && i < r->data_block_and_keys_buffers.size(); ++i) {
     auto& data_block = r->data_block_and_keys_buffers[i].first;
@@ -1647,6 +1765,224 @@ void BlockBasedTableBuilder::EnterUnbuffered() {
   r->data_block_and_keys_buffers.clear();
 }
 
+namespace {
+
+// A compression type and level tried by adaptive compression
+struct AdaptiveCompressionCandidate {
+  CompressionType type;
+  int level;
+};
+
+// How a candidate of adaptive compression did on the sampled blocks
+struct AdaptiveCompressionResult {
+  uint64_t compressed_bytes;
+  // The time to compress block_size bytes plus the time to decompress one
+  // block
+  double cpu_nanos;
+};
+
+// Compresses each of blocks with candidate and decompresses it again, as the
+// table builder and reader would, without a compression dictionary.
+AdaptiveCompressionResult SampleAdaptiveCompression(
+    const std::vector<Slice>& blocks,
+    const AdaptiveCompressionCandidate& candidate,
+    const CompressionOptions& compression_opts, size_t block_size,
+    uint32_t format_version, const ImmutableCFOptions& ioptions) {
+  CompressionOptions opts = compression_opts;
+  opts.level = candidate.level;
+  CompressionContext compression_ctx(candidate.type);
+  CompressionInfo compression_info(
+      opts, compression_ctx, CompressionDict::GetEmptyDict(), candidate.type,
+      0 /* sample_for_compression */);
+  UncompressionContext uncompression_ctx(candidate.type);
+  UncompressionInfo uncompression_info(
+      uncompression_ctx, UncompressionDict::GetEmptyDict(), candidate.type);
+
+  uint64_t raw_bytes = 0;
+  uint64_t compressed_bytes = 0;
+  uint64_t compress_nanos = 0;
+  uint64_t decompress_nanos = 0;
+  std::string compressed_output;
+  StopWatchNano timer(ioptions.env);
+  for (const Slice& block : blocks) {
+    CompressionType type = candidate.type;
+    compressed_output.clear();
+    timer.Start();
+    Slice contents = CompressBlock(block, compression_info, &type,
+                                   format_version, false /* do_sample */,
+                                   &compressed_output, nullptr, nullptr);
+    compress_nanos += timer.ElapsedNanos(true /* reset */);
+    if (type != kNoCompression) {
+      BlockContents uncompressed;
+      Status s = UncompressBlockContentsForCompressionType(
+          uncompression_info, contents.data(), contents.size(), &uncompressed,
+          format_version, ioptions);
+      decompress_nanos += timer.ElapsedNanos();
+      if (!s.ok()) {
+        // The block would be written uncompressed
+        contents = block;
+      }
+    }
+    raw_bytes += block.size();
+    compressed_bytes += contents.size();
+  }
+
+  AdaptiveCompressionResult result;
+  result.compressed_bytes = compressed_bytes;
+  result.cpu_nanos = 0;
+  if (raw_bytes > 0) {
+    result.cpu_nanos = static_cast<double>(compress_nanos) *
+                           static_cast<double>(block_size) /
+                           static_cast<double>(raw_bytes) +
+                       static_cast<double>(decompress_nanos) /
+                           static_cast<double>(blocks.size());
+  }
+  return result;
+}
+
+// Returns the index of the result with the lowest score, the first one on
+// ties. See BlockBasedTableOptions::adaptive_compression_space_weight.
+size_t ChooseAdaptiveCompressionResult(
+    const std::vector<AdaptiveCompressionResult>& results,
+    double space_weight) {
+  uint64_t max_bytes = 0;
+  double max_cpu_nanos = 0;
+  for (const auto& result : results) {
+    max_bytes = std::max(max_bytes, result.compressed_bytes);
+    max_cpu_nanos = std::max(max_cpu_nanos, result.cpu_nanos);
+  }
+  size_t best = 0;
+  double best_score = 0;
+  for (size_t i = 0; i < results.size(); i++) {
+    double score = 0;
+    if (max_bytes > 0) {
+      score += space_weight * static_cast<double>(results[i].compressed_bytes) /
+               static_cast<double>(max_bytes);
+    }
+    if (max_cpu_nanos > 0) {
+      score += (1 - space_weight) * results[i].cpu_nanos / max_cpu_nanos;
+    }
+    if (i == 0 || score < best_score) {
+      best = i;
+      best_score = score;
+    }
+  }
+  return best;
+}
+
+}  // namespace
+
+void BlockBasedTableBuilder::SelectAdaptiveCompression() {
+  Rep* r = rep_;
+  assert(r->state == Rep::State::kBuffered);
+  assert(r->adaptive_compression);
+  const BlockBasedTableOptions& table_options = r->table_options;
+
+  std::vector<Slice> samples;
+  size_t sample_bytes = 0;
+  for (const auto& data_block_and_keys : r->data_block_and_keys_buffers) {
+    if (sample_bytes >= kAdaptiveCompressionSampleBytes) {
+      break;
+    }
+    samples.emplace_back(data_block_and_keys.first);
+    sample_bytes += data_block_and_keys.first.size();
+  }
+  if (samples.empty()) {
+    return;
+  }
+
+  // The configured compression type comes first, so that it is kept on ties
+  std::vector<AdaptiveCompressionCandidate> candidates;
+  auto add_candidates = [&](CompressionType type) {
+    if (!CompressionTypeSupported(type)) {
+      return;
+    }
+    std::vector<int> levels = {r->compression_opts.level};
+    if (type == kZSTD || type == kZSTDNotFinalCompression) {
+      levels.insert(levels.end(),
+                    table_options.adaptive_compression_zstd_levels.begin(),
+                    table_options.adaptive_compression_zstd_levels.end());
+    }
+    for (int level : levels) {
+      auto same = [&](const AdaptiveCompressionCandidate& candidate) {
+        return candidate.type == type && candidate.level == level;
+      };
+      if (std::none_of(candidates.begin(), candidates.end(), same)) {
+        candidates.push_back({type, level});
+      }
+    }
+  };
+  add_candidates(r->compression_type);
+  for (CompressionType type : table_options.adaptive_compression_types) {
+    add_candidates(type);
+  }
+
+  std::vector<AdaptiveCompressionResult> results;
+  if (candidates.size() > 1) {
+    for (const auto& candidate : candidates) {
+      results.push_back(SampleAdaptiveCompression(
+          samples, candidate, r->compression_opts, table_options.block_size,
+          table_options.format_version, r->ioptions));
+    }
+    const AdaptiveCompressionCandidate& best =
+        candidates[ChooseAdaptiveCompressionResult(
+            results, table_options.adaptive_compression_space_weight)];
+    if (best.type != r->compression_type) {
+      r->compression_type = best.type;
+      r->compression_ctxs[0].reset(new CompressionContext(best.type));
+      if (table_options.verify_compression) {
+        r->verify_ctxs[0].reset(new UncompressionContext(best.type));
+      }
+    }
+    r->compression_opts.level = best.level;
+  }
+
+  if (table_options.adaptive_block_size_multipliers.empty() ||
+      table_options.block_align) {
+    return;
+  }
+  // Larger blocks are estimated by concatenating consecutive samples
+  std::vector<int> multipliers = {1};
+  for (int multiplier : table_options.adaptive_block_size_multipliers) {
+    if (std::find(multipliers.begin(), multipliers.end(), multiplier) ==
+        multipliers.end()) {
+      multipliers.push_back(multiplier);
+    }
+  }
+  const AdaptiveCompressionCandidate chosen = {r->compression_type,
+                                               r->compression_opts.level};
+  results.clear();
+  for (int multiplier : multipliers) {
+    std::vector<std::string> merged_blocks;
+    std::vector<Slice> blocks;
+    if (multiplier == 1) {
+      blocks = samples;
+    } else {
+      for (size_t i = 0; i < samples.size(); i += multiplier) {
+        merged_blocks.emplace_back();
+        for (size_t j = i; j < std::min(samples.size(), i + multiplier); j++) {
+          merged_blocks.back().append(samples[j].data(), samples[j].size());
+        }
+      }
+      blocks.assign(merged_blocks.begin(), merged_blocks.end());
+    }
+    results.push_back(SampleAdaptiveCompression(
+        blocks, chosen, r->compression_opts, table_options.block_size,
+        table_options.format_version, r->ioptions));
+  }
+  const int multiplier = multipliers[ChooseAdaptiveCompressionResult(
+      results, table_options.adaptive_compression_space_weight)];
+  if (multiplier != 1) {
+    BlockBasedTableOptions block_size_options = table_options;
+    block_size_options.block_size =
+        table_options.block_size * static_cast<size_t>(multiplier);
+    r->data_block_size = block_size_options.block_size;
+    r->flush_block_policy.reset(
+        table_options.flush_block_policy_factory->NewFlushBlockPolicy(
+            block_size_options, r->data_block));
+  }
+}
+
 Status BlockBasedTableBuilder::Finish() {
   Rep* r = rep_;
   assert(r->state != Rep::State::kClosed);
@@ -1672,7 +2008,8 @@ Status BlockBasedTableBuilder::Finish() {
   } else {
     // To make sure properties block is able to keep the accurate size of index
     // block, we will finish writing all index entries first.
-    if (ok() && !empty_data_block) {
+    if (ok() && (!empty_data_block || r->pending_index_entry)) {
+      r->pending_index_entry = false;
       r->index_builder->AddIndexEntry(
           &r->last_key, nullptr /* no next data block */, r->pending_handle);
     }
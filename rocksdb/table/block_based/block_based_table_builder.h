@@ -67,6 +67,10 @@ class BlockBasedTableBuilder : public TableBuilder {
   // REQUIRES: Finish(), Abandon() have not been called
   void Add(const Slice& key, const Slice& value) override;
 
+  void FlushDataBlock() override;
+
+  bool CopyDataBlock(const DataBlockPosition& source) override;
+
   // Return non-ok iff some error has been detected.
   Status status() const override;
 
@@ -113,11 +117,21 @@ class BlockBasedTableBuilder : public TableBuilder {
  private:
   bool ok() const { return status().ok(); }
 
+  // Whether data blocks can be cut by FlushDataBlock() and replaced by
+  // CopyDataBlock(), which write to the file outside of the compression path.
+  bool CanCopyDataBlocks() const;
+
   // Transition state from buffered to unbuffered. See `Rep::State` API comment
   // for details of the states.
   // REQUIRES: `rep_->state == kBuffered`
   void EnterUnbuffered();
 
+  // Chooses the compression type and the data block size of the file from
+  // samples of the buffered data blocks. See
+  // BlockBasedTableOptions::adaptive_compression_types.
+  // REQUIRES: `rep_->state == kBuffered`
+  void SelectAdaptiveCompression();
+
   // Call block's Finish() method
   // and then write the compressed block contents to file.
   void WriteBlock(BlockBuilder* block, BlockHandle* handle, bool is_data_block);
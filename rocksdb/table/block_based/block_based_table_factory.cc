@@ -24,6 +24,7 @@
 #include "table/block_based/block_based_table_builder.h"
 #include "table/block_based/block_based_table_reader.h"
 #include "table/format.h"
+#include "util/compression.h"
 #include "util/mutexlock.h"
 #include "util/string_util.h"
 
@@ -270,6 +271,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct BlockBasedTableOptions, partition_filters),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"prefetch_hot_partitions",
+         {offsetof(struct BlockBasedTableOptions, prefetch_hot_partitions),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"optimize_filters_for_memory",
          {offsetof(struct BlockBasedTableOptions, optimize_filters_for_memory),
           OptionType::kBoolean, OptionVerificationType::kNormal,
@@ -363,6 +368,29 @@ static std::unordered_map<std::string, OptionTypeInfo>
                    pin_top_level_index_and_filter),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"adaptive_compression_types",
+         OptionTypeInfo::Vector<CompressionType>(
+             offsetof(struct BlockBasedTableOptions,
+                      adaptive_compression_types),
+             OptionVerificationType::kNormal, OptionTypeFlags::kNone,
+             {0, OptionType::kCompressionType})},
+        {"adaptive_compression_zstd_levels",
+         OptionTypeInfo::Vector<int>(
+             offsetof(struct BlockBasedTableOptions,
+                      adaptive_compression_zstd_levels),
+             OptionVerificationType::kNormal, OptionTypeFlags::kNone,
+             {0, OptionType::kInt})},
+        {"adaptive_block_size_multipliers",
+         OptionTypeInfo::Vector<int>(
+             offsetof(struct BlockBasedTableOptions,
+                      adaptive_block_size_multipliers),
+             OptionVerificationType::kNormal, OptionTypeFlags::kNone,
+             {0, OptionType::kInt})},
+        {"adaptive_compression_space_weight",
+         {offsetof(struct BlockBasedTableOptions,
+                   adaptive_compression_space_weight),
+          OptionType::kDouble, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"block_cache",
          {offsetof(struct BlockBasedTableOptions, block_cache),
           OptionType::kUnknown, OptionVerificationType::kNormal,
@@ -516,6 +544,20 @@ Status BlockBasedTableFactory::ValidateOptions(
     return Status::InvalidArgument(
         "block size exceeds maximum number (4GiB) allowed");
   }
+  for (int multiplier : table_options_.adaptive_block_size_multipliers) {
+    if (multiplier < 1 ||
+        table_options_.block_size * static_cast<size_t>(multiplier) >
+            port::kMaxUint32) {
+      return Status::InvalidArgument(
+          "adaptive_block_size_multipliers must be positive and keep the "
+          "block size under 4GiB");
+    }
+  }
+  if (table_options_.adaptive_compression_space_weight < 0.0 ||
+      table_options_.adaptive_compression_space_weight > 1.0) {
+    return Status::InvalidArgument(
+        "adaptive_compression_space_weight must be between 0 and 1");
+  }
   if (table_options_.data_block_index_type ==
           BlockBasedTableOptions::kDataBlockBinaryAndHash &&
       table_options_.data_block_hash_table_util_ratio <= 0) {
@@ -629,6 +671,9 @@ std::string BlockBasedTableFactory::GetPrintableOptions() const {
   snprintf(buffer, kBufferSize, "  partition_filters: %d\n",
            table_options_.partition_filters);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  prefetch_hot_partitions: %d\n",
+           table_options_.prefetch_hot_partitions);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  use_delta_encoding: %d\n",
            table_options_.use_delta_encoding);
   ret.append(buffer);
@@ -655,6 +700,39 @@ std::string BlockBasedTableFactory::GetPrintableOptions() const {
   snprintf(buffer, kBufferSize, "  block_align: %d\n",
            table_options_.block_align);
   ret.append(buffer);
+  ret.append("  adaptive_compression_types: ");
+  for (size_t i = 0; i < table_options_.adaptive_compression_types.size();
+       ++i) {
+    if (i > 0) {
+      ret.append(":");
+    }
+    ret.append(CompressionTypeToString(
+        table_options_.adaptive_compression_types[i]));
+  }
+  ret.append("\n");
+  ret.append("  adaptive_compression_zstd_levels: ");
+  for (size_t i = 0;
+       i < table_options_.adaptive_compression_zstd_levels.size(); ++i) {
+    if (i > 0) {
+      ret.append(":");
+    }
+    ret.append(ROCKSDB_NAMESPACE::ToString(
+        table_options_.adaptive_compression_zstd_levels[i]));
+  }
+  ret.append("\n");
+  ret.append("  adaptive_block_size_multipliers: ");
+  for (size_t i = 0; i < table_options_.adaptive_block_size_multipliers.size();
+       ++i) {
+    if (i > 0) {
+      ret.append(":");
+    }
+    ret.append(ROCKSDB_NAMESPACE::ToString(
+        table_options_.adaptive_block_size_multipliers[i]));
+  }
+  ret.append("\n");
+  snprintf(buffer, kBufferSize, "  adaptive_compression_space_weight: %f\n",
+           table_options_.adaptive_compression_space_weight);
+  ret.append(buffer);
   return ret;
 }
 
@@ -798,6 +876,8 @@ const std::string BlockBasedTablePropertyNames::kWholeKeyFiltering =
     "rocksdb.block.based.table.whole.key.filtering";
 const std::string BlockBasedTablePropertyNames::kPrefixFiltering =
     "rocksdb.block.based.table.prefix.filtering";
+const std::string BlockBasedTablePropertyNames::kDataBlockSize =
+    "rocksdb.block.based.table.data.block.size";
 const std::string kHashIndexPrefixesBlock = "rocksdb.hashindex.prefixes";
 const std::string kHashIndexPrefixesMetadataBlock =
     "rocksdb.hashindex.metadata";
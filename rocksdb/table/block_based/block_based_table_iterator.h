@@ -130,6 +130,19 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
            block_iter_points_to_real_block_;
   }
 
+  bool GetDataBlockPosition(DataBlockPosition* pos) const override {
+    assert(Valid());
+    if (is_at_first_key_from_index_ || !block_iter_points_to_real_block_) {
+      return false;
+    }
+    pos->table = table_;
+    pos->handle = index_iter_->value().handle;
+    pos->entry_offset = block_iter_.CurrentEntryOffset();
+    pos->next_entry_offset = block_iter_.NextEntryOffset();
+    pos->entries_end = block_iter_.RestartArrayOffset();
+    return true;
+  }
+
   void ResetDataIter() {
     if (block_iter_points_to_real_block_) {
       if (pinned_iters_mgr_ != nullptr && pinned_iters_mgr_->PinningEnabled()) {
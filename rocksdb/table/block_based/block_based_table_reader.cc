@@ -31,6 +31,7 @@
 #include "rocksdb/filter_policy.h"
 #include "rocksdb/iterator.h"
 #include "rocksdb/options.h"
+#include "rocksdb/rate_limiter.h"
 #include "rocksdb/statistics.h"
 #include "rocksdb/table.h"
 #include "rocksdb/table_properties.h"
@@ -57,6 +58,7 @@
 #include "test_util/sync_point.h"
 #include "util/coding.h"
 #include "util/crc32c.h"
+#include "util/mutexlock.h"
 #include "util/stop_watch.h"
 #include "util/string_util.h"
 #include "util/xxhash.h"
@@ -73,7 +75,10 @@ typedef BlockBasedTable::IndexReader IndexReader;
 // experiments, for auto readahead. Experiment data is in PR #3282.
 const size_t BlockBasedTable::kMaxAutoReadaheadSize = 256 * 1024;
 
-BlockBasedTable::~BlockBasedTable() { delete rep_; }
+BlockBasedTable::~BlockBasedTable() {
+  CancelHotPartitionWarmUp();
+  delete rep_;
+}
 
 std::atomic<uint64_t> BlockBasedTable::next_cache_key_id_(0);
 
@@ -1043,6 +1048,13 @@ Status BlockBasedTable::PrefetchIndexAndFilterBlocks(
     }
   }
 
+  // Partitions that were all prefetched above need no warm-up, but their heat
+  // is still tracked so that it survives a reopen with a different setting.
+  if (table_options.prefetch_hot_partitions &&
+      index_type == BlockBasedTableOptions::kTwoLevelIndexSearch) {
+    TrackPartitionHeat(!prefetch_all);
+  }
+
   if (!rep_->compression_dict_handle.IsNull()) {
     std::unique_ptr<UncompressionDictReader> uncompression_dict_reader;
     s = UncompressionDictReader::Create(this, ro, prefetch_buffer, use_cache,
@@ -1059,6 +1071,114 @@ Status BlockBasedTable::PrefetchIndexAndFilterBlocks(
   return s;
 }
 
+void BlockBasedTable::TrackPartitionHeat(bool warm_up) {
+  std::unique_ptr<PartitionHeat> heat(new PartitionHeat());
+  Status s = rep_->index_reader->TrackPartitionHeat(heat.get());
+  if (!s.ok()) {
+    ROCKS_LOG_WARN(rep_->ioptions.info_log,
+                   "Failed to track heat of index partitions of %s: %s",
+                   rep_->file->file_name().c_str(), s.ToString().c_str());
+    return;
+  }
+  if (rep_->filter_type == Rep::FilterType::kPartitionedFilter &&
+      rep_->filter != nullptr) {
+    s = rep_->filter->TrackPartitionHeat(heat.get());
+    if (!s.ok()) {
+      ROCKS_LOG_WARN(rep_->ioptions.info_log,
+                     "Failed to track heat of filter partitions of %s: %s",
+                     rep_->file->file_name().c_str(), s.ToString().c_str());
+    }
+  }
+  rep_->partition_heat = std::move(heat);
+
+  // Reading the heat file and the hot partitions would delay the table open,
+  // which DB::Open() or the first read of the table waits for.
+  if (warm_up) {
+    {
+      MutexLock l(&rep_->warm_up_mutex);
+      rep_->warm_up_pending = true;
+    }
+    rep_->ioptions.env->Schedule(
+        &BlockBasedTable::BGWorkWarmUpHotPartitions, this, Env::Priority::LOW,
+        this, &BlockBasedTable::UnscheduleWarmUpHotPartitions);
+  }
+}
+
+void BlockBasedTable::WarmUpHotPartitions() {
+  PartitionHeat* heat = rep_->partition_heat.get();
+  assert(heat != nullptr);
+  const std::string fname = TableHeatFileName(rep_->file->file_name());
+  std::string contents;
+  // A missing heat file is the common case for a table that was never read
+  IOStatus io_s = ReadFileToString(rep_->ioptions.fs, fname, &contents);
+  if (!io_s.ok()) {
+    io_s.PermitUncheckedError();
+    return;
+  }
+  Status s = heat->DecodeFrom(contents);
+  if (!s.ok()) {
+    ROCKS_LOG_WARN(rep_->ioptions.info_log,
+                   "Ignoring partition heat file %s: %s", fname.c_str(),
+                   s.ToString().c_str());
+    return;
+  }
+
+  ReadOptions ro;
+  s = rep_->index_reader->CacheHotDependencies(ro, *heat);
+  if (!s.ok()) {
+    ROCKS_LOG_WARN(rep_->ioptions.info_log,
+                   "Failed to warm up hot index partitions of %s: %s",
+                   rep_->file->file_name().c_str(), s.ToString().c_str());
+    return;
+  }
+  if (rep_->filter_type == Rep::FilterType::kPartitionedFilter &&
+      rep_->filter != nullptr) {
+    rep_->filter->CacheHotDependencies(ro, *heat);
+  }
+}
+
+void BlockBasedTable::BGWorkWarmUpHotPartitions(void* arg) {
+  BlockBasedTable* table = static_cast<BlockBasedTable*>(arg);
+  table->WarmUpHotPartitions();
+  TEST_SYNC_POINT("BlockBasedTable::WarmUpHotPartitions:Done");
+  Rep* rep = table->rep_;
+  MutexLock l(&rep->warm_up_mutex);
+  rep->warm_up_pending = false;
+  rep->warm_up_cv.SignalAll();
+}
+
+void BlockBasedTable::UnscheduleWarmUpHotPartitions(void* arg) {
+  Rep* rep = static_cast<BlockBasedTable*>(arg)->rep_;
+  MutexLock l(&rep->warm_up_mutex);
+  rep->warm_up_pending = false;
+  rep->warm_up_cv.SignalAll();
+}
+
+void BlockBasedTable::CancelHotPartitionWarmUp() {
+  {
+    MutexLock l(&rep_->warm_up_mutex);
+    if (!rep_->warm_up_pending) {
+      return;
+    }
+  }
+  // Table readers are also destroyed on the read path, by table cache
+  // evictions, so don't wait for more than the one read in flight.
+  rep_->partition_heat->Cancel();
+  rep_->ioptions.env->UnSchedule(this, Env::Priority::LOW);
+  MutexLock l(&rep_->warm_up_mutex);
+  while (rep_->warm_up_pending) {
+    rep_->warm_up_cv.Wait();
+  }
+}
+
+bool BlockBasedTable::EncodePartitionHeat(std::string* dst) const {
+  if (rep_->partition_heat == nullptr || !rep_->partition_heat->dirty()) {
+    return false;
+  }
+  rep_->partition_heat->EncodeTo(dst);
+  return true;
+}
+
 void BlockBasedTable::SetupForCompaction() {
   switch (rep_->ioptions.access_hint_on_compaction_start) {
     case Options::NONE:
@@ -2820,6 +2940,176 @@ Status BlockBasedTable::Prefetch(const Slice* const begin,
   return Status::OK();
 }
 
+Cache* BlockBasedTable::GetBlockCache(Slice* cache_key_prefix) const {
+  Cache* block_cache = rep_->table_options.block_cache.get();
+  if (block_cache != nullptr) {
+    *cache_key_prefix =
+        Slice(rep_->cache_key_prefix, rep_->cache_key_prefix_size);
+  }
+  return block_cache;
+}
+
+Status BlockBasedTable::WarmUpBlockCache(
+    const ReadOptions& read_options, const std::vector<uint64_t>& block_offsets,
+    RateLimiter* rate_limiter, size_t* num_loaded) {
+  // Upper bound of the bytes read by one MultiRead() call
+  const size_t kWarmUpBatchSize = 1 << 20;
+
+  *num_loaded = 0;
+  Cache* block_cache = rep_->table_options.block_cache.get();
+  if (block_cache == nullptr || block_offsets.empty()) {
+    return Status::OK();
+  }
+  BlockCacheLookupContext lookup_context{TableReaderCaller::kPrefetch};
+  IndexBlockIter iiter_on_stack;
+  auto iiter = NewIndexIterator(read_options, /*need_upper_bound_check=*/false,
+                                &iiter_on_stack, /*get_context=*/nullptr,
+                                &lookup_context);
+  std::unique_ptr<InternalIteratorBase<IndexValue>> iiter_unique_ptr;
+  if (iiter != &iiter_on_stack) {
+    iiter_unique_ptr = std::unique_ptr<InternalIteratorBase<IndexValue>>(iiter);
+  }
+
+  // Data blocks are laid out in index order, so the requested offsets are
+  // matched against the index in a single pass.
+  std::vector<BlockHandle> handles;
+  auto wanted = block_offsets.begin();
+  for (iiter->SeekToFirst(); iiter->Valid() && wanted != block_offsets.end();
+       iiter->Next()) {
+    const BlockHandle handle = iiter->value().handle;
+    while (wanted != block_offsets.end() && *wanted < handle.offset()) {
+      ++wanted;
+    }
+    if (wanted == block_offsets.end() || *wanted != handle.offset()) {
+      continue;
+    }
+    ++wanted;
+    char cache_key[kMaxCacheKeyPrefixSize + kMaxVarint64Length];
+    Slice key = GetCacheKey(rep_->cache_key_prefix, rep_->cache_key_prefix_size,
+                            handle, cache_key);
+    Cache::Handle* cache_handle = block_cache->Lookup(key);
+    if (cache_handle != nullptr) {
+      block_cache->Release(cache_handle);
+      continue;
+    }
+    handles.push_back(handle);
+  }
+  if (!iiter->status().ok()) {
+    return iiter->status();
+  }
+  if (handles.empty()) {
+    return Status::OK();
+  }
+
+  CachableEntry<UncompressionDict> uncompression_dict;
+  if (rep_->uncompression_dict_reader) {
+    Status s = rep_->uncompression_dict_reader->GetOrReadUncompressionDictionary(
+        /*prefetch_buffer=*/nullptr, /*no_io=*/false, /*get_context=*/nullptr,
+        &lookup_context, &uncompression_dict);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  const UncompressionDict& dict = uncompression_dict.GetValue()
+                                      ? *uncompression_dict.GetValue()
+                                      : UncompressionDict::GetEmptyDict();
+
+  RandomAccessFileReader* file = rep_->file.get();
+  IOOptions opts;
+  Status s = PrepareIOFromReadOptions(read_options, file->env(), opts);
+  size_t next = 0;
+  while (s.ok() && next < handles.size()) {
+    // Gather the next batch, merging adjacent blocks into one request
+    const size_t first = next;
+    autovector<FSReadRequest> read_reqs;
+    std::vector<size_t> req_idx_for_block;
+    size_t batch_bytes = 0;
+    for (; next < handles.size() && batch_bytes < kWarmUpBatchSize; ++next) {
+      const BlockHandle& handle = handles[next];
+      const size_t len = block_size(handle);
+      if (!read_reqs.empty() &&
+          read_reqs.back().offset + read_reqs.back().len == handle.offset()) {
+        read_reqs.back().len += len;
+      } else {
+        FSReadRequest req;
+        req.offset = handle.offset();
+        req.len = len;
+        req.scratch = nullptr;
+        read_reqs.push_back(req);
+      }
+      req_idx_for_block.push_back(read_reqs.size() - 1);
+      batch_bytes += len;
+    }
+    std::vector<std::unique_ptr<char[]>> scratches;
+    AlignedBuf direct_io_buf;
+    if (!file->use_direct_io()) {
+      for (FSReadRequest& req : read_reqs) {
+        scratches.emplace_back(new char[req.len]);
+        req.scratch = scratches.back().get();
+      }
+    }
+
+    if (rate_limiter != nullptr) {
+      size_t bytes_left = batch_bytes;
+      while (bytes_left > 0) {
+        const size_t bytes = std::min(
+            bytes_left, static_cast<size_t>(rate_limiter->GetSingleBurstBytes()));
+        rate_limiter->Request(bytes, Env::IO_LOW, rep_->ioptions.statistics,
+                              RateLimiter::OpType::kRead);
+        bytes_left -= bytes;
+      }
+    }
+    s = file->MultiRead(opts, &read_reqs[0], read_reqs.size(),
+                        file->use_direct_io() ? &direct_io_buf : nullptr);
+
+    for (size_t i = first; s.ok() && i < next; ++i) {
+      const BlockHandle& handle = handles[i];
+      const FSReadRequest& req = read_reqs[req_idx_for_block[i - first]];
+      s = req.status;
+      if (!s.ok()) {
+        break;
+      }
+      const size_t len = block_size(handle);
+      const size_t offset_in_req =
+          static_cast<size_t>(handle.offset() - req.offset);
+      if (req.result.size() < offset_in_req + len) {
+        s = Status::Corruption("truncated block read from " +
+                               file->file_name() + " offset " +
+                               ToString(handle.offset()));
+        break;
+      }
+      std::unique_ptr<char[]> raw_block(new char[len]);
+      memcpy(raw_block.get(), req.result.data() + offset_in_req, len);
+      // Blocks are stored encrypted together with their trailer
+      std::string tag = rep_->footer.get_hmacs(handle.hmac_offset());
+      Decryption(Slice(raw_block.get(), len), sst_key, gcm_iv, gcm_aad,
+                 reinterpret_cast<unsigned char*>(&tag[0]));
+      if (read_options.verify_checksums) {
+        PERF_TIMER_GUARD(block_checksum_time);
+        s = ROCKSDB_NAMESPACE::VerifyBlockChecksum(
+            rep_->footer.checksum(), raw_block.get(), handle.size(),
+            file->file_name(), handle.offset());
+        if (!s.ok()) {
+          break;
+        }
+      }
+      BlockContents raw_block_contents(std::move(raw_block), handle.size());
+#ifndef NDEBUG
+      raw_block_contents.is_raw_block = true;
+#endif
+      CachableEntry<Block> block_entry;
+      s = MaybeReadBlockAndLoadToCache(
+          /*prefetch_buffer=*/nullptr, read_options, handle, dict, &block_entry,
+          BlockType::kData, /*get_context=*/nullptr, &lookup_context,
+          &raw_block_contents);
+      if (s.ok() && block_entry.IsCached()) {
+        ++*num_loaded;
+      }
+    }
+  }
+  return s;
+}
+
 Status BlockBasedTable::VerifyChecksum(const ReadOptions& read_options,
                                        TableReaderCaller caller) {
   Status s;
@@ -3163,6 +3453,121 @@ uint64_t BlockBasedTable::ApproximateSize(const Slice& start, const Slice& end,
                                static_cast<double>(rep_->file_size));
 }
 
+Status BlockBasedTable::ApproximateKeyAnchors(const ReadOptions& read_options,
+                                              std::vector<Anchor>* anchors) {
+  assert(anchors != nullptr);
+  // Sampling every index entry of a large file would yield far more anchors
+  // than any compaction can use, so merge consecutive entries until there
+  // are at most this many anchors per file.
+  static const size_t kMaxAnchors = 128;
+
+  const uint64_t data_size = GetApproximateDataSize();
+  BlockCacheLookupContext context(TableReaderCaller::kCompaction);
+  ReadOptions ro = read_options;
+  ro.total_order_seek = true;
+
+  // With a partitioned index only the top level is read. Its entries point to
+  // the partitions, so assume the data is spread evenly across them.
+  std::unique_ptr<InternalIteratorBase<IndexValue>> top_level_iter(
+      rep_->index_reader->NewTopLevelIterator(ro, &context));
+  if (top_level_iter != nullptr) {
+    const uint64_t num_partitions =
+        rep_->table_properties ? rep_->table_properties->index_partitions : 0;
+    if (num_partitions == 0) {
+      return Status::NotSupported("Unknown number of index partitions");
+    }
+    const uint64_t step = (num_partitions + kMaxAnchors - 1) / kMaxAnchors;
+    const uint64_t partition_size = data_size / num_partitions;
+    uint64_t count = 0;
+    for (top_level_iter->SeekToFirst(); top_level_iter->Valid();
+         top_level_iter->Next()) {
+      if (++count % step == 0) {
+        anchors->emplace_back(top_level_iter->user_key(),
+                              static_cast<size_t>(step * partition_size));
+      }
+    }
+    if (top_level_iter->status().ok() && count % step != 0) {
+      top_level_iter->SeekToLast();
+      if (top_level_iter->Valid()) {
+        anchors->emplace_back(
+            top_level_iter->user_key(),
+            static_cast<size_t>((count % step) * partition_size));
+      }
+    }
+    return top_level_iter->status();
+  }
+
+  IndexBlockIter iiter_on_stack;
+  auto index_iter =
+      NewIndexIterator(ro, /*disable_prefix_seek=*/true,
+                       /*input_iter=*/&iiter_on_stack, /*get_context=*/nullptr,
+                       /*lookup_context=*/&context);
+  std::unique_ptr<InternalIteratorBase<IndexValue>> iiter_unique_ptr;
+  if (index_iter != &iiter_on_stack) {
+    iiter_unique_ptr.reset(index_iter);
+  }
+
+  const uint64_t target_range_size = std::max<uint64_t>(
+      data_size / kMaxAnchors, rep_->table_options.block_size);
+  uint64_t range_start = 0;
+  uint64_t prev_block_end = 0;
+  for (index_iter->SeekToFirst(); index_iter->Valid(); index_iter->Next()) {
+    const BlockHandle& handle = index_iter->value().handle;
+    prev_block_end = handle.offset() + handle.size();
+    if (prev_block_end - range_start >= target_range_size) {
+      anchors->emplace_back(index_iter->user_key(),
+                            static_cast<size_t>(prev_block_end - range_start));
+      range_start = prev_block_end;
+    }
+  }
+  if (index_iter->status().ok() && prev_block_end > range_start) {
+    index_iter->SeekToLast();
+    if (index_iter->Valid()) {
+      anchors->emplace_back(index_iter->user_key(),
+                            static_cast<size_t>(prev_block_end - range_start));
+    }
+  }
+  return index_iter->status();
+}
+
+Status BlockBasedTable::ReadRawDataBlock(const BlockHandle& handle,
+                                         ChecksumType checksum,
+                                         uint32_t format_version,
+                                         const std::string& compression_name,
+                                         std::string* contents,
+                                         std::string* tag) const {
+  // Keys of a file with a global sequence number are rewritten on read, and
+  // blocks compressed with a dictionary need the dictionary of this file.
+  if (rep_->footer.checksum() != checksum ||
+      rep_->footer.version() != format_version ||
+      rep_->table_properties == nullptr ||
+      rep_->table_properties->compression_name != compression_name ||
+      rep_->global_seqno != kDisableGlobalSequenceNumber ||
+      !rep_->compression_dict_handle.IsNull()) {
+    return Status::NotSupported("Data blocks are not in the requested format");
+  }
+  if (handle.hmac_offset() >= rep_->footer.num_hmacs()) {
+    return Status::Corruption("Data block has no authentication tag");
+  }
+
+  const size_t n = static_cast<size_t>(handle.size()) + kBlockTrailerSize;
+  std::unique_ptr<char[]> scratch(new char[n]);
+  Slice result;
+  Status s = rep_->file->Read(IOOptions(), handle.offset(), n, &result,
+                              scratch.get(), nullptr /* aligned_buf */,
+                              true /* for_compaction */);
+  if (!s.ok()) {
+    return s;
+  }
+  if (result.size() != n) {
+    return Status::Corruption("Truncated data block read from " +
+                              rep_->file->file_name());
+  }
+  contents->assign(result.data(), result.size());
+  *tag = rep_->footer.get_hmacs(handle.hmac_offset());
+  return Status::OK();
+}
+
 bool BlockBasedTable::TEST_FilterBlockInCache() const {
   assert(rep_ != nullptr);
   return TEST_BlockInCache(rep_->filter_handle);
@@ -11,10 +11,12 @@
 
 #include "db/range_tombstone_fragmenter.h"
 #include "file/filename.h"
+#include "port/port.h"
 #include "table/block_based/block_based_table_factory.h"
 #include "table/block_based/block_type.h"
 #include "table/block_based/cachable_entry.h"
 #include "table/block_based/filter_block.h"
+#include "table/block_based/partition_heat.h"
 #include "table/block_based/uncompression_dict_reader.h"
 #include "table/table_properties_internal.h"
 #include "table/table_reader.h"
@@ -142,6 +144,17 @@ class BlockBasedTable : public TableReader {
   // IO or iteration error.
   Status Prefetch(const Slice* begin, const Slice* end) override;
 
+  Cache* GetBlockCache(Slice* cache_key_prefix) const override;
+
+  // Read the requested data blocks with a few MultiRead() calls, merging
+  // adjacent blocks into one request, and insert them into the block cache.
+  Status WarmUpBlockCache(const ReadOptions& read_options,
+                          const std::vector<uint64_t>& block_offsets,
+                          RateLimiter* rate_limiter,
+                          size_t* num_loaded) override;
+
+  bool EncodePartitionHeat(std::string* dst) const override;
+
   // Given a key, return an approximate byte offset in the file where
   // the data for that key begins (or would begin if the key were
   // present in the file). The returned value is in terms of file
@@ -158,6 +171,15 @@ class BlockBasedTable : public TableReader {
   uint64_t ApproximateSize(const Slice& start, const Slice& end,
                            TableReaderCaller caller) override;
 
+  Status ApproximateKeyAnchors(const ReadOptions& read_options,
+                               std::vector<Anchor>* anchors) override;
+
+  Status ReadRawDataBlock(const BlockHandle& handle, ChecksumType checksum,
+                          uint32_t format_version,
+                          const std::string& compression_name,
+                          std::string* contents,
+                          std::string* tag) const override;
+
   bool TEST_BlockInCache(const BlockHandle& handle) const;
 
   // Returns true if the block for the specified key is in cache.
@@ -201,6 +223,15 @@ class BlockBasedTable : public TableReader {
         IndexBlockIter* iter, GetContext* get_context,
         BlockCacheLookupContext* lookup_context) = 0;
 
+    // Create an iterator over the top level of a two-level index, whose
+    // entries point to the index partitions rather than to data blocks.
+    // Returns nullptr if the index has a single level.
+    virtual InternalIteratorBase<IndexValue>* NewTopLevelIterator(
+        const ReadOptions& /*read_options*/,
+        BlockCacheLookupContext* /*lookup_context*/) {
+      return nullptr;
+    }
+
     // Report an approximation of how much memory has been used other than
     // memory that was allocated in block cache.
     virtual size_t ApproximateMemoryUsage() const = 0;
@@ -210,6 +241,17 @@ class BlockBasedTable : public TableReader {
                                      bool /* pin */) {
       return Status::OK();
     }
+    // Register the partitions of a partitioned index with `heat`, so that
+    // reads of them are recorded.
+    virtual Status TrackPartitionHeat(PartitionHeat* /*heat*/) {
+      return Status::OK();
+    }
+    // Load the partitions that were hot in the persisted `heat` into the
+    // block cache. REQUIRES: TrackPartitionHeat(heat) succeeded.
+    virtual Status CacheHotDependencies(const ReadOptions& /*ro*/,
+                                        const PartitionHeat& /*heat*/) {
+      return Status::OK();
+    }
   };
 
   class IndexReaderCommon;
@@ -433,6 +475,18 @@ class BlockBasedTable : public TableReader {
       bool prefetch_all, const BlockBasedTableOptions& table_options,
       const int level, size_t file_size, size_t max_file_size_for_l0_meta_pin,
       BlockCacheLookupContext* lookup_context);
+  // Set up partition heat tracking and, if `warm_up` is true, schedule
+  // WarmUpHotPartitions() on the low priority thread pool. Best effort:
+  // errors only disable the feature for this table.
+  void TrackPartitionHeat(bool warm_up);
+  // Load the partitions that the heat file of this table marks as hot into
+  // the block cache.
+  void WarmUpHotPartitions();
+  static void BGWorkWarmUpHotPartitions(void* arg);
+  static void UnscheduleWarmUpHotPartitions(void* arg);
+  // Unschedule WarmUpHotPartitions(), or have it stop after the read in
+  // flight if it is already running, and wait for that.
+  void CancelHotPartitionWarmUp();
 
   static BlockType GetBlockTypeForMetaBlockByName(const Slice& meta_block_name);
 
@@ -546,6 +600,15 @@ struct BlockBasedTable::Rep {
   std::unique_ptr<FilterBlockReader> filter;
   std::unique_ptr<UncompressionDictReader> uncompression_dict_reader;
 
+  // Non-null if BlockBasedTableOptions::prefetch_hot_partitions is set and
+  // the index is partitioned.
+  std::unique_ptr<PartitionHeat> partition_heat;
+  // Guards warm_up_pending, which is set while WarmUpHotPartitions() is
+  // scheduled or running
+  port::Mutex warm_up_mutex;
+  port::CondVar warm_up_cv{&warm_up_mutex};
+  bool warm_up_pending = false;
+
   enum class FilterType {
     kNoFilter,
     kFullFilter,
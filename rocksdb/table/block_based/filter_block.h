@@ -39,6 +39,7 @@ const uint64_t kNotValid = ULLONG_MAX;
 class FilterPolicy;
 
 class GetContext;
+class PartitionHeat;
 using MultiGetRange = MultiGetContext::Range;
 
 // A FilterBlockBuilder is used to construct all of the filters for a
@@ -155,6 +156,17 @@ class FilterBlockReader {
 
   virtual void CacheDependencies(const ReadOptions& /*ro*/, bool /*pin*/) {}
 
+  // Register the partitions of a partitioned filter with `heat`, so that
+  // reads of them are recorded.
+  virtual Status TrackPartitionHeat(PartitionHeat* /*heat*/) {
+    return Status::OK();
+  }
+
+  // Load the partitions that were hot in the persisted `heat` into the block
+  // cache. REQUIRES: TrackPartitionHeat(heat) succeeded.
+  virtual void CacheHotDependencies(const ReadOptions& /*ro*/,
+                                    const PartitionHeat& /*heat*/) {}
+
   virtual bool RangeMayExist(const Slice* /*iterate_upper_bound*/,
                              const Slice& user_key,
                              const SliceTransform* prefix_extractor,
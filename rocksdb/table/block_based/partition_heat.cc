@@ -0,0 +1,152 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/partition_heat.h"
+
+#include <algorithm>
+
+#include "util/coding.h"
+#include "util/crc32c.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// Heat file layout:
+//   magic                  : fixed32
+//   for each partition kind:
+//     num_partitions       : varint32
+//     bitmap               : (num_partitions + 7) / 8 bytes
+//   checksum               : fixed32, masked crc32c of everything above
+const uint32_t kPartitionHeatMagic = 0x74616568;  // "heat"
+}  // namespace
+
+const uint64_t PartitionHeat::kMaxCoalesceGap;
+
+Status PartitionHeat::DecodeFrom(const Slice& input) {
+  for (auto& bitmap : bitmaps_) {
+    bitmap.loaded.clear();
+    bitmap.loaded_num_partitions = 0;
+  }
+  if (input.size() < 2 * sizeof(uint32_t)) {
+    return Status::Corruption("Partition heat file too short");
+  }
+  const size_t body_size = input.size() - sizeof(uint32_t);
+  const uint32_t expected =
+      crc32c::Unmask(DecodeFixed32(input.data() + body_size));
+  if (crc32c::Value(input.data(), body_size) != expected) {
+    return Status::Corruption("Partition heat file checksum mismatch");
+  }
+  Slice body(input.data(), body_size);
+  if (DecodeFixed32(body.data()) != kPartitionHeatMagic) {
+    return Status::Corruption("Bad partition heat file magic");
+  }
+  body.remove_prefix(sizeof(uint32_t));
+
+  std::string loaded[kNumKinds];
+  uint32_t num_partitions[kNumKinds];
+  for (uint32_t kind = 0; kind < kNumKinds; ++kind) {
+    if (!GetVarint32(&body, &num_partitions[kind])) {
+      return Status::Corruption("Bad partition heat count");
+    }
+    const size_t num_bytes = (num_partitions[kind] + 7) / 8;
+    if (body.size() < num_bytes) {
+      return Status::Corruption("Truncated partition heat bitmap");
+    }
+    loaded[kind].assign(body.data(), num_bytes);
+    body.remove_prefix(num_bytes);
+  }
+  for (uint32_t kind = 0; kind < kNumKinds; ++kind) {
+    // Heat recorded against a different layout is meaningless
+    if (num_partitions[kind] != bitmaps_[kind].handles.size()) {
+      continue;
+    }
+    bitmaps_[kind].loaded = std::move(loaded[kind]);
+    bitmaps_[kind].loaded_num_partitions = num_partitions[kind];
+  }
+  return Status::OK();
+}
+
+void PartitionHeat::EncodeTo(std::string* dst) const {
+  const size_t start = dst->size();
+  PutFixed32(dst, kPartitionHeatMagic);
+  for (const auto& bitmap : bitmaps_) {
+    const uint32_t num_partitions =
+        static_cast<uint32_t>(bitmap.handles.size());
+    PutVarint32(dst, num_partitions);
+    std::string bits((num_partitions + 7) / 8, '\0');
+    for (uint32_t i = 0; i < num_partitions; ++i) {
+      if (bitmap.words[i / 64].load(std::memory_order_relaxed) &
+          (uint64_t{1} << (i % 64))) {
+        bits[i / 8] |= static_cast<char>(1 << (i % 8));
+      }
+    }
+    dst->append(bits);
+  }
+  PutFixed32(dst, crc32c::Mask(crc32c::Value(dst->data() + start,
+                                             dst->size() - start)));
+}
+
+void PartitionHeat::SetPartitions(Kind kind,
+                                  std::vector<BlockHandle>&& handles) {
+  Bitmap& bitmap = bitmaps_[kind];
+  bitmap.handles = std::move(handles);
+  bitmap.num_words = (bitmap.handles.size() + 63) / 64;
+  bitmap.words.reset(new std::atomic<uint64_t>[bitmap.num_words]);
+  for (size_t i = 0; i < bitmap.num_words; ++i) {
+    bitmap.words[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+void PartitionHeat::Record(Kind kind, uint64_t offset) {
+  const Bitmap& bitmap = bitmaps_[kind];
+  auto it = std::lower_bound(
+      bitmap.handles.begin(), bitmap.handles.end(), offset,
+      [](const BlockHandle& h, uint64_t off) { return h.offset() < off; });
+  if (it == bitmap.handles.end() || it->offset() != offset) {
+    return;
+  }
+  const size_t ordinal = static_cast<size_t>(it - bitmap.handles.begin());
+  const uint64_t mask = uint64_t{1} << (ordinal % 64);
+  std::atomic<uint64_t>& word = bitmap.words[ordinal / 64];
+  // Partitions are hit over and over again; avoid bouncing the cache line
+  // once the bit is set.
+  if ((word.load(std::memory_order_relaxed) & mask) == 0) {
+    word.fetch_or(mask, std::memory_order_relaxed);
+    dirty_.store(true, std::memory_order_relaxed);
+  }
+}
+
+bool PartitionHeat::WasHot(Kind kind, size_t ordinal) const {
+  const Bitmap& bitmap = bitmaps_[kind];
+  if (ordinal >= bitmap.loaded_num_partitions) {
+    return false;
+  }
+  return (static_cast<unsigned char>(bitmap.loaded[ordinal / 8]) >>
+          (ordinal % 8)) &
+         1;
+}
+
+void PartitionHeat::PlanPrefetch(Kind kind,
+                                 std::vector<PrefetchRun>* runs) const {
+  runs->clear();
+  const std::vector<BlockHandle>& handles = bitmaps_[kind].handles;
+  for (size_t i = 0; i < handles.size(); ++i) {
+    if (!WasHot(kind, i)) {
+      continue;
+    }
+    const uint64_t start = handles[i].offset();
+    const uint64_t end = start + block_size(handles[i]);
+    if (!runs->empty() &&
+        start <= runs->back().offset + runs->back().len + kMaxCoalesceGap) {
+      PrefetchRun& run = runs->back();
+      run.last = i;
+      run.len = end - run.offset;
+    } else {
+      runs->push_back({i, i, start, end - start});
+    }
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
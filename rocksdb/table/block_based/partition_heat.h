@@ -0,0 +1,103 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+#include "table/format.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// PartitionHeat records which partitions of a partitioned index and of a
+// partitioned filter were read by foreground operations while a table reader
+// was open. The result is persisted as one bit per partition in a small
+// sidecar file next to the table file (see TableHeatFileName()), so that the
+// next time the table is opened the hot partitions, and only those, can be
+// loaded into the block cache with a few large coalesced reads instead of
+// trickling in one partition at a time.
+//
+// SetPartitions() must be called for a partition kind before the table reader
+// is published; after that Record() is thread-safe. The persisted heat is
+// loaded afterwards, in the background, by DecodeFrom(); it and WasHot() are
+// only used by that one thread.
+class PartitionHeat {
+ public:
+  enum Kind : uint32_t { kIndex = 0, kFilter = 1, kNumKinds = 2 };
+
+  // A contiguous range of hot partitions [first, last] (ordinals in file
+  // order) that can be fetched with a single read.
+  struct PrefetchRun {
+    size_t first;
+    size_t last;
+    uint64_t offset;
+    uint64_t len;
+  };
+
+  // Maximum number of cold bytes between two hot partitions that are still
+  // fetched with one read.
+  static const uint64_t kMaxCoalesceGap = 64 * 1024;
+
+  PartitionHeat() = default;
+  PartitionHeat(const PartitionHeat&) = delete;
+  PartitionHeat& operator=(const PartitionHeat&) = delete;
+
+  // Parse the content of a heat file written by EncodeTo(). On corruption the
+  // previous heat is discarded and a non-OK status is returned. Heat recorded
+  // against a different number of partitions than SetPartitions() registered
+  // is dropped.
+  Status DecodeFrom(const Slice& input);
+
+  // Serialize the partitions accessed since SetPartitions().
+  void EncodeTo(std::string* dst) const;
+
+  // Register the handles of all partitions of `kind`, in file order.
+  void SetPartitions(Kind kind, std::vector<BlockHandle>&& handles);
+
+  // Mark the partition starting at `offset` as accessed.
+  void Record(Kind kind, uint64_t offset);
+
+  // True if the partition with the given ordinal was hot in the persisted
+  // heat file.
+  bool WasHot(Kind kind, size_t ordinal) const;
+
+  const std::vector<BlockHandle>& partitions(Kind kind) const {
+    return bitmaps_[kind].handles;
+  }
+
+  // True if any partition has been accessed since SetPartitions().
+  bool dirty() const { return dirty_.load(std::memory_order_relaxed); }
+
+  // Group the partitions of `kind` that WasHot() into runs whose cold gaps
+  // are at most kMaxCoalesceGap bytes.
+  void PlanPrefetch(Kind kind, std::vector<PrefetchRun>* runs) const;
+
+  // Ask the thread loading the hot partitions to stop before its next read.
+  void Cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+  bool cancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+
+ private:
+  struct Bitmap {
+    std::vector<BlockHandle> handles;
+    // Heat read from the heat file, one bit per partition
+    std::string loaded;
+    uint32_t loaded_num_partitions = 0;
+    // Partitions accessed during the lifetime of this object
+    std::unique_ptr<std::atomic<uint64_t>[]> words;
+    size_t num_words = 0;
+  };
+
+  Bitmap bitmaps_[kNumKinds];
+  std::atomic<bool> dirty_{false};
+  std::atomic<bool> cancelled_{false};
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -275,6 +275,11 @@ Status PartitionedFilterBlockReader::GetFilterPartitionBlock(
     }
   }
 
+  PartitionHeat* const heat = table()->get_rep()->partition_heat.get();
+  if (heat != nullptr) {
+    heat->Record(PartitionHeat::kFilter, fltr_blk_handle.offset());
+  }
+
   ReadOptions read_options;
   if (no_io) {
     read_options.read_tier = kBlockCacheTier;
@@ -490,6 +495,77 @@ void PartitionedFilterBlockReader::CacheDependencies(const ReadOptions& ro,
   }
 }
 
+Status PartitionedFilterBlockReader::TrackPartitionHeat(PartitionHeat* heat) {
+  assert(table());
+  assert(heat != nullptr);
+
+  const BlockBasedTable::Rep* const rep = table()->get_rep();
+  assert(rep);
+
+  BlockCacheLookupContext lookup_context{TableReaderCaller::kPrefetch};
+
+  CachableEntry<Block> filter_block;
+
+  Status s = GetOrReadFilterBlock(false /* no_io */, nullptr /* get_context */,
+                                  &lookup_context, &filter_block);
+  if (!s.ok()) {
+    return s;
+  }
+  assert(filter_block.GetValue());
+
+  IndexBlockIter biter;
+  const InternalKeyComparator* const comparator = internal_comparator();
+  Statistics* kNullStats = nullptr;
+  filter_block.GetValue()->NewIndexIterator(
+      comparator->user_comparator(), rep->get_global_seqno(BlockType::kFilter),
+      &biter, kNullStats, true /* total_order_seek */,
+      false /* have_first_key */, index_key_includes_seq(),
+      index_value_is_full());
+  std::vector<BlockHandle> handles;
+  for (biter.SeekToFirst(); biter.Valid(); biter.Next()) {
+    handles.push_back(biter.value().handle);
+  }
+  if (!biter.status().ok()) {
+    return biter.status();
+  }
+  heat->SetPartitions(PartitionHeat::kFilter, std::move(handles));
+  return Status::OK();
+}
+
+void PartitionedFilterBlockReader::CacheHotDependencies(
+    const ReadOptions& ro, const PartitionHeat& heat) {
+  assert(table());
+
+  const BlockBasedTable::Rep* const rep = table()->get_rep();
+  assert(rep);
+
+  BlockCacheLookupContext lookup_context{TableReaderCaller::kPrefetch};
+
+  std::vector<PartitionHeat::PrefetchRun> runs;
+  heat.PlanPrefetch(PartitionHeat::kFilter, &runs);
+  const std::vector<BlockHandle>& partitions =
+      heat.partitions(PartitionHeat::kFilter);
+  IOOptions opts;
+  Status s = PrepareIOFromReadOptions(ro, rep->file->env(), opts);
+  for (size_t r = 0; s.ok() && r < runs.size() && !heat.cancelled(); ++r) {
+    std::unique_ptr<FilePrefetchBuffer> prefetch_buffer(
+        new FilePrefetchBuffer());
+    s = prefetch_buffer->Prefetch(opts, rep->file.get(), runs[r].offset,
+                                  static_cast<size_t>(runs[r].len));
+    for (size_t i = runs[r].first; s.ok() && i <= runs[r].last; ++i) {
+      if (!heat.WasHot(PartitionHeat::kFilter, i)) {
+        continue;
+      }
+      CachableEntry<ParsedFullFilterBlock> block;
+      s = table()->MaybeReadBlockAndLoadToCache(
+          prefetch_buffer.get(), ro, partitions[i],
+          UncompressionDict::GetEmptyDict(), &block, BlockType::kFilter,
+          nullptr /* get_context */, &lookup_context, nullptr /* contents */);
+    }
+  }
+  IGNORE_STATUS_IF_ERROR(s);
+}
+
 const InternalKeyComparator* PartitionedFilterBlockReader::internal_comparator()
     const {
   assert(table());
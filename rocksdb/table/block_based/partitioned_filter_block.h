@@ -131,6 +131,9 @@ class PartitionedFilterBlockReader : public FilterBlockReaderCommon<Block> {
                          bool no_io, BlockCacheLookupContext* lookup_context,
                          FilterManyFunction filter_function) const;
   void CacheDependencies(const ReadOptions& ro, bool pin) override;
+  Status TrackPartitionHeat(PartitionHeat* heat) override;
+  void CacheHotDependencies(const ReadOptions& ro,
+                            const PartitionHeat& heat) override;
 
   const InternalKeyComparator* internal_comparator() const;
   bool index_key_includes_seq() const;
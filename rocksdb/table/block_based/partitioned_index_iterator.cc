@@ -84,6 +84,10 @@ void PartitionedIndexIterator::InitPartitionedIndexBlock() {
     auto* rep = table_->get_rep();
     bool is_for_compaction =
         lookup_context_.caller == TableReaderCaller::kCompaction;
+    if (rep->partition_heat != nullptr && !is_for_compaction) {
+      rep->partition_heat->Record(PartitionHeat::kIndex,
+                                  partitioned_index_handle.offset());
+    }
     // Prefetch additional data for range scans (iterators).
     // Implicit auto readahead:
     //   Enabled after 2 sequential IOs when ReadOptions.readahead_size == 0.
@@ -104,6 +104,30 @@ InternalIteratorBase<IndexValue>* PartitionIndexReader::NewIterator(
   // the first level iter is always on heap and will attempt to delete it
   // in its destructor.
 }
+
+InternalIteratorBase<IndexValue>* PartitionIndexReader::NewTopLevelIterator(
+    const ReadOptions& read_options, BlockCacheLookupContext* lookup_context) {
+  const bool no_io = (read_options.read_tier == kBlockCacheTier);
+  CachableEntry<Block> index_block;
+  const Status s = GetOrReadIndexBlock(no_io, /*get_context=*/nullptr,
+                                       lookup_context, &index_block);
+  if (!s.ok()) {
+    return NewErrorInternalIterator<IndexValue>(s);
+  }
+
+  const BlockBasedTable::Rep* rep = table()->rep_;
+  Statistics* kNullStats = nullptr;
+  // The top level entries always have full block handles as values
+  InternalIteratorBase<IndexValue>* it =
+      index_block.GetValue()->NewIndexIterator(
+          internal_comparator()->user_comparator(),
+          rep->get_global_seqno(BlockType::kIndex), nullptr, kNullStats, true,
+          index_has_first_key(), index_key_includes_seq(),
+          index_value_is_full());
+  index_block.TransferTo(it);
+  return it;
+}
+
 Status PartitionIndexReader::CacheDependencies(const ReadOptions& ro,
                                                bool pin) {
   // Before read partitions, prefetch them to avoid lots of IOs
@@ -183,4 +207,66 @@ Status PartitionIndexReader::CacheDependencies(const ReadOptions& ro,
   return biter.status();
 }
 
+Status PartitionIndexReader::TrackPartitionHeat(PartitionHeat* heat) {
+  assert(heat != nullptr);
+  BlockCacheLookupContext lookup_context{TableReaderCaller::kPrefetch};
+  const BlockBasedTable::Rep* rep = table()->rep_;
+  IndexBlockIter biter;
+  Statistics* kNullStats = nullptr;
+
+  CachableEntry<Block> index_block;
+  Status s = GetOrReadIndexBlock(false /* no_io */, nullptr /* get_context */,
+                                 &lookup_context, &index_block);
+  if (!s.ok()) {
+    return s;
+  }
+
+  // We don't return pinned data from index blocks, so no need
+  // to set `block_contents_pinned`.
+  index_block.GetValue()->NewIndexIterator(
+      internal_comparator()->user_comparator(),
+      rep->get_global_seqno(BlockType::kIndex), &biter, kNullStats, true,
+      index_has_first_key(), index_key_includes_seq(), index_value_is_full());
+  std::vector<BlockHandle> handles;
+  for (biter.SeekToFirst(); biter.Valid(); biter.Next()) {
+    handles.push_back(biter.value().handle);
+  }
+  if (!biter.status().ok()) {
+    return biter.status();
+  }
+  heat->SetPartitions(PartitionHeat::kIndex, std::move(handles));
+  return Status::OK();
+}
+
+Status PartitionIndexReader::CacheHotDependencies(const ReadOptions& ro,
+                                                  const PartitionHeat& heat) {
+  BlockCacheLookupContext lookup_context{TableReaderCaller::kPrefetch};
+  const BlockBasedTable::Rep* rep = table()->rep_;
+  std::vector<PartitionHeat::PrefetchRun> runs;
+  heat.PlanPrefetch(PartitionHeat::kIndex, &runs);
+  const std::vector<BlockHandle>& partitions =
+      heat.partitions(PartitionHeat::kIndex);
+  IOOptions opts;
+  Status s = PrepareIOFromReadOptions(ro, rep->file->env(), opts);
+  // Read each run of hot partitions with one I/O, then load only the hot
+  // partitions of the run into the cache.
+  for (size_t r = 0; s.ok() && r < runs.size() && !heat.cancelled(); ++r) {
+    std::unique_ptr<FilePrefetchBuffer> prefetch_buffer;
+    rep->CreateFilePrefetchBuffer(0, 0, &prefetch_buffer);
+    s = prefetch_buffer->Prefetch(opts, rep->file.get(), runs[r].offset,
+                                  static_cast<size_t>(runs[r].len));
+    for (size_t i = runs[r].first; s.ok() && i <= runs[r].last; ++i) {
+      if (!heat.WasHot(PartitionHeat::kIndex, i)) {
+        continue;
+      }
+      CachableEntry<Block> block;
+      s = table()->MaybeReadBlockAndLoadToCache(
+          prefetch_buffer.get(), ro, partitions[i],
+          UncompressionDict::GetEmptyDict(), &block, BlockType::kIndex,
+          /*get_context=*/nullptr, &lookup_context, /*contents=*/nullptr);
+    }
+  }
+  return s;
+}
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -29,7 +29,14 @@ class PartitionIndexReader : public BlockBasedTable::IndexReaderCommon {
       IndexBlockIter* iter, GetContext* get_context,
       BlockCacheLookupContext* lookup_context) override;
 
+  InternalIteratorBase<IndexValue>* NewTopLevelIterator(
+      const ReadOptions& read_options,
+      BlockCacheLookupContext* lookup_context) override;
+
   Status CacheDependencies(const ReadOptions& ro, bool pin) override;
+  Status TrackPartitionHeat(PartitionHeat* heat) override;
+  Status CacheHotDependencies(const ReadOptions& ro,
+                              const PartitionHeat& heat) override;
   size_t ApproximateMemoryUsage() const override {
     size_t usage = ApproximateIndexBlockMemoryUsage();
 #ifdef ROCKSDB_MALLOC_USABLE_SIZE
@@ -193,6 +193,7 @@ class Footer {
   void set_hmac_offset(uint64_t offset) { hmac_offset_ = offset; }
   uint64_t hmac_offset() const { return hmac_offset_; }
   std::string get_hmacs(uint64_t offset) const { return hmacs.at(offset); }
+  size_t num_hmacs() const { return hmacs.size(); }
 
  private:
   // REQUIRES: magic number wasn't initialized.
@@ -271,6 +271,11 @@ bool GetContext::SaveValue(const ParsedInternalKey& parsed_key,
           }
         } else if (kMerge == state_) {
           assert(merge_operator_ != nullptr);
+          if (type == kTypeBlobIndex) {
+            // Merging into a value in a blob file is not supported
+            state_ = kBlobIndex;
+            return false;
+          }
           state_ = kFound;
           if (do_merge_) {
             if (LIKELY(pinnable_val_ != nullptr)) {
@@ -16,6 +16,7 @@
 namespace ROCKSDB_NAMESPACE {
 
 class PinnedIteratorsManager;
+class TableReader;
 
 enum class IterBoundCheck : char {
   kUnknown = 0,
@@ -23,6 +24,20 @@ enum class IterBoundCheck : char {
   kInbound,
 };
 
+// Where an iterator's current entry is stored in a table file: the data block
+// that holds it and the entry's extent within the block contents. Used by
+// compaction to find input data blocks that are copied to the output as-is.
+struct DataBlockPosition {
+  const TableReader* table = nullptr;
+  BlockHandle handle;
+  // Offset of the current entry in the block contents
+  uint32_t entry_offset = 0;
+  // Offset just past the end of the current entry
+  uint32_t next_entry_offset = 0;
+  // Offset just past the end of the last entry of the block
+  uint32_t entries_end = 0;
+};
+
 struct IterateResult {
   Slice key;
   IterBoundCheck bound_check_result = IterBoundCheck::kUnknown;
@@ -172,6 +187,13 @@ class InternalIteratorBase : public Cleanable {
     return Status::NotSupported("");
   }
 
+  // If the current entry was read from a data block of a table file, stores
+  // its position in *pos and returns true. Returns false if unknown.
+  // REQUIRES: Valid()
+  virtual bool GetDataBlockPosition(DataBlockPosition* /*pos*/) const {
+    return false;
+  }
+
  protected:
   void SeekForPrevImpl(const Slice& target, const Comparator* cmp) {
     Seek(target);
@@ -154,6 +154,11 @@ class IteratorWrapperBase {
     return iter_->user_key();
   }
 
+  bool GetDataBlockPosition(DataBlockPosition* pos) const {
+    assert(Valid());
+    return iter_->GetDataBlockPosition(pos);
+  }
+
  private:
   void Update() {
     valid_ = iter_->Valid();
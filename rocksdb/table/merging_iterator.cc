@@ -286,6 +286,11 @@ class MergingIterator : public InternalIterator {
            current_->IsValuePinned();
   }
 
+  bool GetDataBlockPosition(DataBlockPosition* pos) const override {
+    assert(Valid());
+    return current_->GetDataBlockPosition(pos);
+  }
+
  private:
   // Clears heaps for both directions, used when changing direction or seeking
   void ClearHeaps();
@@ -203,6 +203,15 @@ Status GetMemTableRepFactoryFromString(
     } else if (1 == len) {
       mem_factory = new VectorRepFactory();
     }
+  } else if (opts_list[0] == "btree" || opts_list[0] == "BTreeRepFactory") {
+    // Expecting format
+    // btree
+    if (1 == len) {
+      mem_factory = new BTreeRepFactory();
+    } else {
+      return Status::InvalidArgument("Can't parse memtable_factory option ",
+                                     opts_str);
+    }
   } else if (opts_list[0] == "cuckoo") {
     return Status::NotSupported(
         "cuckoo hash memtable is not supported anymore.");
@@ -25,6 +25,7 @@ namespace ROCKSDB_NAMESPACE {
 
 class Slice;
 class Status;
+struct DataBlockPosition;
 
 struct TableReaderOptions {
   // @param skip_filters Disables loading/accessing the filter block
@@ -152,6 +153,18 @@ class TableBuilder {
   // REQUIRES: Finish(), Abandon() have not been called
   virtual void Add(const Slice& key, const Slice& value) = 0;
 
+  // Ends the current data block, if any, so that the next key added starts
+  // a new one. Does nothing if the builder does not support CopyDataBlock().
+  virtual void FlushDataBlock() {}
+
+  // Called after the entries of the data block at source were added, in
+  // order, right after a FlushDataBlock(). If the current data block holds
+  // exactly those entries, writes the stored source block in its place and
+  // returns true. Otherwise returns false and the block is built as usual.
+  virtual bool CopyDataBlock(const DataBlockPosition& /*source*/) {
+    return false;
+  }
+
   // Return non-ok iff some error has been detected.
   virtual Status status() const = 0;
 
@@ -9,6 +9,9 @@
 
 #pragma once
 #include <memory>
+#include <string>
+#include <vector>
+
 #include "db/range_tombstone_fragmenter.h"
 #include "rocksdb/slice_transform.h"
 #include "table/get_context.h"
@@ -18,8 +21,10 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+class Cache;
 class Iterator;
 struct ParsedInternalKey;
+class RateLimiter;
 class Slice;
 class Arena;
 struct ReadOptions;
@@ -82,6 +87,38 @@ class TableReader {
   virtual uint64_t ApproximateSize(const Slice& start, const Slice& end,
                                    TableReaderCaller caller) = 0;
 
+  struct Anchor {
+    Anchor(const Slice& _user_key, size_t _range_size)
+        : user_key(_user_key.ToString()), range_size(_range_size) {}
+    std::string user_key;
+    size_t range_size;
+  };
+
+  // Sample user keys that split the file into ranges of roughly similar size,
+  // in ascending order. Each anchor is the upper bound of its range and
+  // range_size is the approximate number of bytes between it and the
+  // previous anchor. Only reads the index, or the top level of a two-level
+  // index.
+  virtual Status ApproximateKeyAnchors(const ReadOptions& /*read_options*/,
+                                       std::vector<Anchor>* /*anchors*/) {
+    return Status::NotSupported("ApproximateKeyAnchors() not supported.");
+  }
+
+  // Reads the data block at handle as it is stored in the file, trailer
+  // included, into *contents and its authentication tag into *tag, so that
+  // the block can be appended to another table file without being decoded.
+  // Returns NotSupported unless the file was written with the given checksum
+  // type, format version and compression, and its blocks do not depend on
+  // anything else stored in the file.
+  virtual Status ReadRawDataBlock(const BlockHandle& /*handle*/,
+                                  ChecksumType /*checksum*/,
+                                  uint32_t /*format_version*/,
+                                  const std::string& /*compression_name*/,
+                                  std::string* /*contents*/,
+                                  std::string* /*tag*/) const {
+    return Status::NotSupported("ReadRawDataBlock() not supported.");
+  }
+
   // Set up the table for Compaction. Might change some parameters with
   // posix_fadvise
   virtual void SetupForCompaction() = 0;
@@ -132,6 +169,36 @@ class TableReader {
     return Status::OK();
   }
 
+  // Return the block cache this table inserts its blocks into, and set
+  // *cache_key_prefix to the prefix shared by the cache keys of those blocks.
+  // The prefix is only valid while the table reader is alive. Returns
+  // nullptr if the table does not use a block cache.
+  virtual Cache* GetBlockCache(Slice* /*cache_key_prefix*/) const {
+    return nullptr;
+  }
+
+  // Load the data blocks starting at `block_offsets` (in increasing order)
+  // into the block cache, skipping offsets that are not the start of a data
+  // block and blocks that are already cached. Reads are charged to
+  // `rate_limiter` if it is not nullptr. *num_loaded is set to the number of
+  // blocks inserted into the block cache.
+  virtual Status WarmUpBlockCache(const ReadOptions& /*read_options*/,
+                                  const std::vector<uint64_t>& /*block_offsets*/,
+                                  RateLimiter* /*rate_limiter*/,
+                                  size_t* num_loaded) {
+    *num_loaded = 0;
+    return Status::NotSupported("WarmUpBlockCache() not supported");
+  }
+
+  // Append to *dst what the reader learned about which of its index and
+  // filter partitions foreground reads need, to be saved with
+  // TableHeatFileName() by the DB that owns the table file. Returns false if
+  // there is nothing new to save. See
+  // BlockBasedTableOptions::prefetch_hot_partitions.
+  virtual bool EncodePartitionHeat(std::string* /*dst*/) const {
+    return false;
+  }
+
   // convert db file to a human readable form
   virtual Status DumpTable(WritableFile* /*out_file*/) {
     return Status::NotSupported("DumpTable() not supported");
@@ -0,0 +1,172 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/table_slice_iterator.h"
+
+#include <string>
+
+#include "memory/arena.h"
+#include "table/internal_iterator.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+class TableSliceIterator : public InternalIterator {
+ public:
+  TableSliceIterator(InternalIterator* iter, const InternalKeyComparator* icmp,
+                     const InternalKey& smallest, const InternalKey& largest,
+                     bool is_arena_mode)
+      : iter_(iter),
+        icmp_(icmp),
+        smallest_(smallest.Encode().ToString()),
+        largest_(largest.Encode().ToString()),
+        is_arena_mode_(is_arena_mode),
+        valid_(false) {}
+
+  ~TableSliceIterator() override {
+    if (is_arena_mode_) {
+      iter_->~InternalIterator();
+    } else {
+      delete iter_;
+    }
+  }
+
+  bool Valid() const override { return valid_; }
+
+  void SeekToFirst() override {
+    iter_->Seek(smallest_);
+    CheckUpperBound();
+  }
+
+  void SeekToLast() override {
+    iter_->SeekForPrev(largest_);
+    CheckLowerBound();
+  }
+
+  void Seek(const Slice& target) override {
+    if (icmp_->Compare(target, smallest_) < 0) {
+      iter_->Seek(smallest_);
+    } else {
+      iter_->Seek(target);
+    }
+    CheckUpperBound();
+  }
+
+  void SeekForPrev(const Slice& target) override {
+    if (icmp_->Compare(target, largest_) > 0) {
+      iter_->SeekForPrev(largest_);
+    } else {
+      iter_->SeekForPrev(target);
+    }
+    CheckLowerBound();
+  }
+
+  void Next() override {
+    assert(valid_);
+    iter_->Next();
+    CheckUpperBound();
+  }
+
+  void Prev() override {
+    assert(valid_);
+    iter_->Prev();
+    CheckLowerBound();
+  }
+
+  Slice key() const override {
+    assert(valid_);
+    return iter_->key();
+  }
+
+  Slice user_key() const override {
+    assert(valid_);
+    return iter_->user_key();
+  }
+
+  Slice value() const override {
+    assert(valid_);
+    return iter_->value();
+  }
+
+  Status status() const override { return iter_->status(); }
+
+  bool PrepareValue() override {
+    assert(valid_);
+    if (iter_->PrepareValue()) {
+      return true;
+    }
+    valid_ = false;
+    return false;
+  }
+
+  // Also asked once the slice is exhausted, e.g. by
+  // LevelIterator::SkipEmptyFileForward(). The file's answer still holds:
+  // once it is past the upper bound, so are the slice and the files after it.
+  bool MayBeOutOfLowerBound() override {
+    return iter_->MayBeOutOfLowerBound();
+  }
+
+  IterBoundCheck UpperBoundCheckResult() override {
+    return iter_->UpperBoundCheckResult();
+  }
+
+  void SetPinnedItersMgr(PinnedIteratorsManager* pinned_iters_mgr) override {
+    iter_->SetPinnedItersMgr(pinned_iters_mgr);
+  }
+
+  bool IsKeyPinned() const override {
+    assert(valid_);
+    return iter_->IsKeyPinned();
+  }
+
+  bool IsValuePinned() const override {
+    assert(valid_);
+    return iter_->IsValuePinned();
+  }
+
+  Status GetProperty(std::string prop_name, std::string* prop) override {
+    return iter_->GetProperty(prop_name, prop);
+  }
+
+  // A data block of the physical file may hold entries outside the slice.
+  // Those are never returned, so such a block is never seen whole.
+  bool GetDataBlockPosition(DataBlockPosition* pos) const override {
+    assert(valid_);
+    return iter_->GetDataBlockPosition(pos);
+  }
+
+ private:
+  void CheckUpperBound() {
+    valid_ = iter_->Valid() && icmp_->Compare(iter_->key(), largest_) <= 0;
+  }
+
+  void CheckLowerBound() {
+    valid_ = iter_->Valid() && icmp_->Compare(iter_->key(), smallest_) >= 0;
+  }
+
+  InternalIterator* iter_;
+  const InternalKeyComparator* icmp_;
+  const std::string smallest_;
+  const std::string largest_;
+  const bool is_arena_mode_;
+  bool valid_;
+};
+}  // namespace
+
+InternalIterator* NewTableSliceIterator(InternalIterator* iter,
+                                        const InternalKeyComparator* icmp,
+                                        const InternalKey& smallest,
+                                        const InternalKey& largest,
+                                        Arena* arena) {
+  if (arena == nullptr) {
+    return new TableSliceIterator(iter, icmp, smallest, largest,
+                                  false /* is_arena_mode */);
+  }
+  auto mem = arena->AllocateAligned(sizeof(TableSliceIterator));
+  return new (mem) TableSliceIterator(iter, icmp, smallest, largest,
+                                      true /* is_arena_mode */);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,27 @@
+//  Copyright (c) 2011-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include "db/dbformat.h"
+#include "rocksdb/types.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class Arena;
+template <class TValue>
+class InternalIteratorBase;
+using InternalIterator = InternalIteratorBase<Slice>;
+
+// Return an iterator over the entries of iter between smallest and largest,
+// both included, for reading a table slice out of its physical table file
+// (see FileDescriptor::physical_number). Takes ownership of iter, which must
+// have been allocated from arena if arena is not nullptr.
+extern InternalIterator* NewTableSliceIterator(
+    InternalIterator* iter, const InternalKeyComparator* icmp,
+    const InternalKey& smallest, const InternalKey& largest,
+    Arena* arena = nullptr);
+
+}  // namespace ROCKSDB_NAMESPACE
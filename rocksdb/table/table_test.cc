@@ -12,6 +12,7 @@
 #include <iostream>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -4305,6 +4306,78 @@ TEST_P(BlockBasedTableTest, BlockAlignTest) {
   table_reader.reset();
 }
 
+TEST_P(BlockBasedTableTest, AdaptiveCompression) {
+  if (!Snappy_Supported() || !Zlib_Supported()) {
+    fprintf(stderr, "skipping adaptive compression test\n");
+    return;
+  }
+  Random rnd(301);
+  TableConstructor c(BytewiseComparator(), true /* convert_to_internal_key_ */);
+  // About 3MB of data, so that most of it follows the 1MB that is sampled
+  constexpr int kNumKeys = 30000;
+  // Well past the keys of the sampled blocks
+  constexpr int kFirstUnsampledKey = 12000;
+  std::string tmp;
+  uint64_t unsampled_raw_size = 0;
+  for (int i = 0; i < kNumKeys; i++) {
+    char key[16];
+    snprintf(key, sizeof(key), "k%06d", i);
+    Slice value = test::CompressibleString(&rnd, 0.25, 100, &tmp);
+    if (i >= kFirstUnsampledKey) {
+      unsampled_raw_size += strlen(key) + value.size();
+    }
+    c.Add(key, value);
+  }
+  std::vector<std::string> keys;
+  stl_wrappers::KVMap kvmap;
+  Options options;
+  options.compression = kSnappyCompression;
+  BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+  table_options.block_size = 1024;
+  table_options.adaptive_compression_types = {kZlibCompression};
+  table_options.adaptive_block_size_multipliers = {4};
+  table_options.adaptive_compression_space_weight = 1.0;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  const ImmutableCFOptions ioptions(options);
+  const MutableCFOptions moptions(options);
+  c.Finish(options, ioptions, moptions, table_options,
+           GetPlainInternalComparator(options.comparator), &keys, &kvmap);
+
+  // Only the compressed size counts: the better compressing type and the
+  // larger blocks are chosen
+  auto& props = *c.GetTableReader()->GetTableProperties();
+  ASSERT_EQ("Zlib", props.compression_name);
+  auto data_block_size = props.user_collected_properties.find(
+      BlockBasedTablePropertyNames::kDataBlockSize);
+  ASSERT_NE(data_block_size, props.user_collected_properties.end());
+  ASSERT_EQ(ToString(4 * 1024), data_block_size->second);
+
+  // The blocks after the sample are about 4KB each; count them by the
+  // distinct offsets their keys are found at
+  std::set<uint64_t> unsampled_block_offsets;
+  for (int i = kFirstUnsampledKey; i < kNumKeys; i++) {
+    char key[16];
+    snprintf(key, sizeof(key), "k%06d", i);
+    unsampled_block_offsets.insert(c.ApproximateOffsetOf(key));
+  }
+  ASSERT_LT(unsampled_block_offsets.size(), unsampled_raw_size / (2 * 1024));
+
+  std::unique_ptr<InternalIterator> iter(
+      c.NewIterator(moptions.prefix_extractor.get()));
+  iter->SeekToFirst();
+  for (const auto& kv : kvmap) {
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(kv.first, iter->key().ToString());
+    ASSERT_EQ(kv.second, iter->value().ToString());
+    iter->Next();
+  }
+  ASSERT_FALSE(iter->Valid());
+  ASSERT_OK(iter->status());
+  iter.reset();
+  c.ResetTableReader();
+}
+
 TEST_P(BlockBasedTableTest, PropertiesBlockRestartPointTest) {
   BlockBasedTableOptions bbto = GetBlockBasedTableOptions();
   bbto.block_align = true;
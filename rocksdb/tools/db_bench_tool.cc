@@ -195,6 +195,8 @@ DEFINE_string(
     "\tstats       -- Print DB stats\n"
     "\tresetstats  -- Reset DB stats\n"
     "\tlevelstats  -- Print the number of files and bytes per level\n"
+    "\twritestagestats -- Print the latency of each write path stage "
+    "(requires --statistics)\n"
     "\tsstables    -- Print sstable info\n"
     "\theapprofile -- Dump a heap profile (if supported by this port)\n"
     "\treplay      -- replay the trace file specified with trace_file\n"
@@ -324,6 +326,49 @@ DEFINE_int64(db_write_buffer_size,
 DEFINE_bool(cost_write_buffer_to_cache, false,
             "The usage of memtable is costed to the block cache");
 
+DEFINE_bool(cost_based_write_buffer_flush, false,
+            "When the write buffer manager is full, flush the column family "
+            "that frees the most memory per byte written");
+
+DEFINE_bool(shrink_write_buffer_cache_charge, false,
+            "With cost_write_buffer_to_cache, release the block cache charge "
+            "of flushed memtables right away instead of gradually");
+
+DEFINE_uint64(wal_sync_coalescing_max_wait_us,
+              ROCKSDB_NAMESPACE::Options().wal_sync_coalescing_max_wait_us,
+              "If non-zero, the leader of a sync write group waits up to "
+              "this many microseconds, adapted to the WAL sync latency, for "
+              "more sync writes to share its WAL sync");
+
+DEFINE_bool(enable_pipelined_compaction,
+            ROCKSDB_NAMESPACE::Options().enable_pipelined_compaction,
+            "Read the input of each subcompaction ahead on a separate thread");
+
+DEFINE_bool(sample_subcompaction_boundaries,
+            ROCKSDB_NAMESPACE::Options().sample_subcompaction_boundaries,
+            "Choose subcompaction boundaries from keys sampled from the "
+            "indexes of the input files");
+
+DEFINE_bool(enable_l0_subcompactions,
+            ROCKSDB_NAMESPACE::Options().enable_l0_subcompactions,
+            "Split compactions into L0 (universal and intra-L0) into "
+            "subcompactions");
+
+DEFINE_bool(reuse_compaction_input_blocks,
+            ROCKSDB_NAMESPACE::Options().reuse_compaction_input_blocks,
+            "Let compactions write input data blocks whose entries are all "
+            "output unchanged without rebuilding them");
+
+DEFINE_bool(enable_partial_trivial_move,
+            ROCKSDB_NAMESPACE::Options().enable_partial_trivial_move,
+            "Move the parts of a compaction input file that do not overlap "
+            "the next level down as table slices");
+
+DEFINE_bool(skip_range_deleted_compaction_input,
+            ROCKSDB_NAMESPACE::Options().skip_range_deleted_compaction_input,
+            "Let compactions skip the parts of their input files that range "
+            "deletions cover without reading them");
+
 DEFINE_int64(write_buffer_size, ROCKSDB_NAMESPACE::Options().write_buffer_size,
              "Number of bytes to buffer in memtable before compacting");
 
@@ -415,7 +460,8 @@ DEFINE_int32(compaction_style,
 static ROCKSDB_NAMESPACE::CompactionPri FLAGS_compaction_pri_e;
 DEFINE_int32(compaction_pri,
              (int32_t)ROCKSDB_NAMESPACE::Options().compaction_pri,
-             "priority of files to compaction: by size or by data age");
+             "priority of files to compaction: by size, by data age, by "
+             "overlapping ratio or by overlapping ratio and read heat");
 
 DEFINE_int32(universal_size_ratio, 0,
              "Percentage flexibility while comparing file size"
@@ -576,6 +622,13 @@ DEFINE_double(memtable_bloom_size_ratio, 0,
               "filter.");
 DEFINE_bool(memtable_whole_key_filtering, false,
             "Try to use whole key bloom filter in memtables.");
+DEFINE_double(memtable_hash_index_size_ratio, 0,
+              "Ratio of memtable size used for the buckets of the point lookup "
+              "hash index. 0 means no hash index.");
+DEFINE_double(memtable_gc_min_garbage_ratio, 0,
+              "Collapse obsolete versions of a full memtable into a new "
+              "memtable instead of flushing it if at least this fraction of "
+              "its data is dropped. 0 disables it.");
 DEFINE_bool(memtable_use_huge_page, false,
             "Try to use huge page in memtables.");
 
@@ -644,6 +697,10 @@ DEFINE_bool(use_fsync, false, "If true, issue fsync instead of fdatasync");
 
 DEFINE_bool(disable_wal, false, "If true, do not write WAL for write.");
 
+DEFINE_uint64(memtable_insert_sort_threshold, 0,
+              "Sort write batches with at least this many entries before "
+              "inserting them into the memtable. 0 disables sorting.");
+
 DEFINE_string(wal_dir, "", "If not empty, use the given dir for WAL");
 
 DEFINE_string(truth_db, "/dev/shm/truth_db/dbbench",
@@ -855,6 +912,32 @@ DEFINE_int32(secondary_update_interval, 5,
 
 #endif  // ROCKSDB_LITE
 
+// Integrated BlobDB options
+DEFINE_bool(enable_blob_files,
+            ROCKSDB_NAMESPACE::AdvancedColumnFamilyOptions().enable_blob_files,
+            "Store large values in blob files when flushing and compacting.");
+
+DEFINE_uint64(min_blob_size,
+              ROCKSDB_NAMESPACE::AdvancedColumnFamilyOptions().min_blob_size,
+              "Size of the smallest value to be stored separately in a blob "
+              "file.");
+
+DEFINE_uint64(blob_file_size,
+              ROCKSDB_NAMESPACE::AdvancedColumnFamilyOptions().blob_file_size,
+              "Size limit for blob files.");
+
+DEFINE_bool(enable_blob_garbage_collection,
+            ROCKSDB_NAMESPACE::AdvancedColumnFamilyOptions()
+                .enable_blob_garbage_collection,
+            "Relocate the valid blobs of the oldest blob files when "
+            "compacting.");
+
+DEFINE_double(blob_garbage_collection_age_cutoff,
+              ROCKSDB_NAMESPACE::AdvancedColumnFamilyOptions()
+                  .blob_garbage_collection_age_cutoff,
+              "The fraction of blob files, oldest first, whose blobs are "
+              "relocated when enable_blob_garbage_collection is set.");
+
 DEFINE_bool(report_bg_io_stats, false,
             "Measure times spents on I/Os while in compactions. ");
 
@@ -943,6 +1026,27 @@ DEFINE_int32(min_level_to_compress, -1, "If non-negative, compression starts"
 DEFINE_int32(compression_parallel_threads, 1,
              "Number of threads for parallel compression.");
 
+DEFINE_string(adaptive_compression_types, "",
+              "Comma-separated list of compression types (as in "
+              "--compression_type) that each table file may use instead of "
+              "--compression_type, chosen from samples of its data blocks");
+
+DEFINE_string(adaptive_compression_zstd_levels, "",
+              "Comma-separated list of zstd levels that each table file may "
+              "use instead of --compression_level");
+
+DEFINE_string(adaptive_block_size_multipliers, "",
+              "Comma-separated list of multiples of --block_size that each "
+              "table file may use as its data block size");
+
+DEFINE_double(
+    adaptive_compression_space_weight,
+    ROCKSDB_NAMESPACE::BlockBasedTableOptions()
+        .adaptive_compression_space_weight,
+    "Weight of the compressed size, against the compression and "
+    "decompression time, when choosing the compression type and block size "
+    "of a table file");
+
 static bool ValidateTableCacheNumshardbits(const char* flagname,
                                            int32_t value) {
   if (0 >= value || value > 20) {
@@ -1035,6 +1139,10 @@ DEFINE_bool(
     "Enable the unordered write feature, which provides higher throughput but "
     "relaxes the guarantees around atomic reads and immutable snapshots");
 
+DEFINE_bool(enable_wal_staging_buffers, false,
+            "With unordered_write, stage WAL records in per-core buffers that "
+            "a dedicated log thread writes out");
+
 DEFINE_bool(allow_concurrent_memtable_write, true,
             "Allow multi-writers to update mem tables in parallel.");
 
@@ -1042,6 +1150,11 @@ DEFINE_bool(inplace_update_support,
             ROCKSDB_NAMESPACE::Options().inplace_update_support,
             "Support in-place memtable update for smaller or same-size values");
 
+DEFINE_bool(inplace_merge_support,
+            ROCKSDB_NAMESPACE::Options().inplace_merge_support,
+            "With inplace_update_support and an associative and commutative "
+            "merge operator, fold merge operands into the memtable entry");
+
 DEFINE_uint64(inplace_update_num_locks,
               ROCKSDB_NAMESPACE::Options().inplace_update_num_locks,
               "Number of RW locks to protect in-place memtable updates");
@@ -1300,6 +1413,7 @@ enum RepFactory {
   kPrefixHash,
   kVectorRep,
   kHashLinkedList,
+  kBTree,
 };
 
 static enum RepFactory StringToRepFactory(const char* ctype) {
@@ -1313,6 +1427,8 @@ static enum RepFactory StringToRepFactory(const char* ctype) {
     return kVectorRep;
   else if (!strcasecmp(ctype, "hash_linkedlist"))
     return kHashLinkedList;
+  else if (!strcasecmp(ctype, "btree"))
+    return kBTree;
 
   fprintf(stdout, "Cannot parse memreptable %s\n", ctype);
   return kSkipList;
@@ -2513,6 +2629,9 @@ class Benchmark {
       case kHashLinkedList:
         fprintf(stdout, "Memtablerep: hash_linkedlist\n");
         break;
+      case kBTree:
+        fprintf(stdout, "Memtablerep: btree\n");
+        break;
     }
     fprintf(stdout, "Perf Level: %d\n", FLAGS_perf_level);
 
@@ -2941,6 +3060,8 @@ class Benchmark {
         write_options_.sync = true;
       }
       write_options_.disableWAL = FLAGS_disable_wal;
+      write_options_.memtable_insert_sort_threshold =
+          static_cast<size_t>(FLAGS_memtable_insert_sort_threshold);
 
       void (Benchmark::*method)(ThreadState*) = nullptr;
       void (Benchmark::*post_process_method)() = nullptr;
@@ -3163,6 +3284,8 @@ class Benchmark {
         VerifyDBFromDB(FLAGS_truth_db);
       } else if (name == "levelstats") {
         PrintStats("rocksdb.levelstats");
+      } else if (name == "writestagestats") {
+        PrintStats("rocksdb.write-stage-stats");
       } else if (name == "sstables") {
         PrintStats("rocksdb.sstables");
       } else if (name == "stats_history") {
@@ -3626,7 +3749,8 @@ class Benchmark {
     options.max_open_files = FLAGS_open_files;
     if (FLAGS_cost_write_buffer_to_cache || FLAGS_db_write_buffer_size != 0) {
       options.write_buffer_manager.reset(
-          new WriteBufferManager(FLAGS_db_write_buffer_size, cache_));
+          new WriteBufferManager(FLAGS_db_write_buffer_size, cache_,
+                                 FLAGS_shrink_write_buffer_cache_charge));
     }
     options.write_buffer_size = FLAGS_write_buffer_size;
     options.max_write_buffer_number = FLAGS_max_write_buffer_number;
@@ -3670,6 +3794,10 @@ class Benchmark {
     options.memtable_huge_page_size = FLAGS_memtable_use_huge_page ? 2048 : 0;
     options.memtable_prefix_bloom_size_ratio = FLAGS_memtable_bloom_size_ratio;
     options.memtable_whole_key_filtering = FLAGS_memtable_whole_key_filtering;
+    options.memtable_hash_index_size_ratio =
+        FLAGS_memtable_hash_index_size_ratio;
+    options.memtable_gc_min_garbage_ratio =
+        FLAGS_memtable_gc_min_garbage_ratio;
     if (FLAGS_memtable_insert_with_hint_prefix_size > 0) {
       options.memtable_insert_with_hint_prefix_extractor.reset(
           NewCappedPrefixTransform(
@@ -3717,6 +3845,9 @@ class Benchmark {
           new VectorRepFactory
         );
         break;
+      case kBTree:
+        options.memtable_factory.reset(new BTreeRepFactory());
+        break;
 #else
       default:
         fprintf(stderr, "Only skip list is supported in lite mode\n");
@@ -3846,6 +3977,23 @@ class Benchmark {
       block_based_options.enable_index_compression =
           FLAGS_enable_index_compression;
       block_based_options.block_align = FLAGS_block_align;
+      for (const auto& type :
+           StringSplit(FLAGS_adaptive_compression_types, ',')) {
+        block_based_options.adaptive_compression_types.push_back(
+            StringToCompressionType(type.c_str()));
+      }
+      for (const auto& level :
+           StringSplit(FLAGS_adaptive_compression_zstd_levels, ',')) {
+        block_based_options.adaptive_compression_zstd_levels.push_back(
+            std::stoi(level));
+      }
+      for (const auto& multiplier :
+           StringSplit(FLAGS_adaptive_block_size_multipliers, ',')) {
+        block_based_options.adaptive_block_size_multipliers.push_back(
+            std::stoi(multiplier));
+      }
+      block_based_options.adaptive_compression_space_weight =
+          FLAGS_adaptive_compression_space_weight;
       if (FLAGS_use_data_block_hash_index) {
         block_based_options.data_block_index_type =
             ROCKSDB_NAMESPACE::BlockBasedTableOptions::kDataBlockBinaryAndHash;
@@ -3940,11 +4088,32 @@ class Benchmark {
     options.allow_concurrent_memtable_write =
         FLAGS_allow_concurrent_memtable_write;
     options.inplace_update_support = FLAGS_inplace_update_support;
+    options.inplace_merge_support = FLAGS_inplace_merge_support;
     options.inplace_update_num_locks = FLAGS_inplace_update_num_locks;
     options.enable_write_thread_adaptive_yield =
         FLAGS_enable_write_thread_adaptive_yield;
     options.enable_pipelined_write = FLAGS_enable_pipelined_write;
     options.unordered_write = FLAGS_unordered_write;
+    options.enable_wal_staging_buffers = FLAGS_enable_wal_staging_buffers;
+    options.cost_based_write_buffer_flush =
+        FLAGS_cost_based_write_buffer_flush;
+    options.wal_sync_coalescing_max_wait_us =
+        FLAGS_wal_sync_coalescing_max_wait_us;
+    options.enable_pipelined_compaction = FLAGS_enable_pipelined_compaction;
+    options.sample_subcompaction_boundaries =
+        FLAGS_sample_subcompaction_boundaries;
+    options.enable_l0_subcompactions = FLAGS_enable_l0_subcompactions;
+    options.reuse_compaction_input_blocks = FLAGS_reuse_compaction_input_blocks;
+    options.enable_partial_trivial_move = FLAGS_enable_partial_trivial_move;
+    options.skip_range_deleted_compaction_input =
+        FLAGS_skip_range_deleted_compaction_input;
+    options.enable_blob_files = FLAGS_enable_blob_files;
+    options.min_blob_size = FLAGS_min_blob_size;
+    options.blob_file_size = FLAGS_blob_file_size;
+    options.enable_blob_garbage_collection =
+        FLAGS_enable_blob_garbage_collection;
+    options.blob_garbage_collection_age_cutoff =
+        FLAGS_blob_garbage_collection_age_cutoff;
     options.write_thread_max_yield_usec = FLAGS_write_thread_max_yield_usec;
     options.write_thread_slow_yield_usec = FLAGS_write_thread_slow_yield_usec;
     options.rate_limit_delay_max_milliseconds =
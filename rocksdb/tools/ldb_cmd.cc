@@ -3181,7 +3181,9 @@ void DBFileDumperCommand::DoCommand() {
   std::cout << "SST Files" << std::endl;
   std::cout << "==============================" << std::endl;
   std::vector<LiveFileMetaData> metadata;
-  db_->GetLiveFilesMetaData(&metadata);
+  // Table slices have no file of their own, so dump the table files on disk
+  DBImpl* db_impl = static_cast_with_check<DBImpl>(db_->GetRootDB());
+  db_impl->GetLiveTableFilesMetaData(&metadata);
   for (auto& fileMetadata : metadata) {
     std::string filename = fileMetadata.db_path + fileMetadata.name;
     std::cout << filename << " level:" << fileMetadata.level << std::endl;
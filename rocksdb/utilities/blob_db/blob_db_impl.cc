@@ -246,6 +246,8 @@ Status BlobDBImpl::Open(std::vector<ColumnFamilyHandle*>* handles) {
   // Initialize SST file <-> oldest blob file mapping if garbage collection
   // is enabled.
   if (bdb_options_.enable_garbage_collection) {
+    // Table slices are listed under their own numbers, like in the
+    // compaction and flush notifications that maintain the mapping
     std::vector<LiveFileMetaData> live_files;
     db_->GetLiveFilesMetaData(&live_files);
 
@@ -16,6 +16,7 @@
 #include <string>
 #include <vector>
 
+#include "db/db_impl/db_impl.h"
 #include "db/wal_manager.h"
 #include "file/file_util.h"
 #include "file/filename.h"
@@ -438,22 +439,42 @@ Status CheckpointImpl::ExportColumnFamily(
     // Export live sst files with file deletions disabled.
     s = db_->DisableFileDeletions();
     if (s.ok()) {
-      db_->GetColumnFamilyMetaData(handle, &db_metadata);
-
-      s = ExportFilesInMetaData(
-          db_options, db_metadata,
-          [&](const std::string& src_dirname, const std::string& fname) {
-            ROCKS_LOG_INFO(db_options.info_log, "[%s] HardLinking %s",
-                           cf_name.c_str(), fname.c_str());
-            return db_->GetEnv()->LinkFile(src_dirname + fname,
-                                           tmp_export_dir + fname);
-          } /*link_file_cb*/,
-          [&](const std::string& src_dirname, const std::string& fname) {
-            ROCKS_LOG_INFO(db_options.info_log, "[%s] Copying %s",
-                           cf_name.c_str(), fname.c_str());
-            return CopyFile(db_->GetFileSystem(), src_dirname + fname,
-                            tmp_export_dir + fname, 0, db_options.use_fsync);
-          } /*copy_file_cb*/);
+      // Importing a table file can't restrict it to the key range of a table
+      // slice, so column families that have slices can't be exported
+      auto* db_impl = static_cast_with_check<DBImpl>(db_->GetRootDB());
+      {
+        InstrumentedMutexLock l(db_impl->mutex());
+        Version* current = cfh->cfd()->current();
+        current->GetColumnFamilyMetaData(&db_metadata);
+        const auto* vstorage = current->storage_info();
+        for (int level = 0; s.ok() && level < vstorage->num_levels();
+             level++) {
+          for (const auto* f : vstorage->LevelFiles(level)) {
+            if (f->fd.IsTableSlice()) {
+              s = Status::NotSupported(
+                  "Column family has table slices; compact it first");
+              break;
+            }
+          }
+        }
+      }
+
+      if (s.ok()) {
+        s = ExportFilesInMetaData(
+            db_options, db_metadata,
+            [&](const std::string& src_dirname, const std::string& fname) {
+              ROCKS_LOG_INFO(db_options.info_log, "[%s] HardLinking %s",
+                             cf_name.c_str(), fname.c_str());
+              return db_->GetEnv()->LinkFile(src_dirname + fname,
+                                             tmp_export_dir + fname);
+            } /*link_file_cb*/,
+            [&](const std::string& src_dirname, const std::string& fname) {
+              ROCKS_LOG_INFO(db_options.info_log, "[%s] Copying %s",
+                             cf_name.c_str(), fname.c_str());
+              return CopyFile(db_->GetFileSystem(), src_dirname + fname,
+                              tmp_export_dir + fname, 0, db_options.use_fsync);
+            } /*copy_file_cb*/);
+      }
 
       const auto enable_status = db_->EnableFileDeletions(false /*force*/);
       if (s.ok()) {
@@ -28,6 +28,7 @@
 #include "test_util/sync_point.h"
 #include "test_util/testharness.h"
 #include "test_util/testutil.h"
+#include "util/cast_util.h"
 #include "utilities/fault_injection_env.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -416,6 +417,92 @@ TEST_F(CheckpointTest, ExportColumnFamilyNegativeTest) {
   delete checkpoint;
 }
 
+TEST_F(CheckpointTest, ExportColumnFamilyWithTableSlices) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.enable_partial_trivial_move = true;
+  options.disable_auto_compactions = true;
+  options.num_levels = 3;
+  options.max_bytes_for_level_base = 4096;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  auto key = [](int i) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "key%06d", i);
+    return std::string(buf);
+  };
+  auto move_l0_file_to_level = [&](int level) {
+    std::vector<LiveFileMetaData> files;
+    db_->GetLiveFilesMetaData(&files);
+    for (const auto& file : files) {
+      if (file.level == 0) {
+        ASSERT_OK(db_->CompactFiles(CompactionOptions(), {file.name}, level));
+      }
+    }
+  };
+
+  // An L2 file in the middle of the key range of a larger L1 file. The parts
+  // of the L1 file before and after the L2 file are moved as table slices.
+  const int kNumKeys = 400;
+  Random rnd(301);
+  std::vector<std::string> values(kNumKeys);
+  for (int i = 190; i < 210; i++) {
+    ASSERT_OK(Put(key(i), rnd.RandomString(100)));
+  }
+  ASSERT_OK(Flush());
+  move_l0_file_to_level(2);
+  for (int i = 0; i < kNumKeys; i++) {
+    values[i] = rnd.RandomString(100);
+    ASSERT_OK(Put(key(i), values[i]));
+  }
+  ASSERT_OK(Flush());
+  move_l0_file_to_level(1);
+  ASSERT_OK(db_->SetOptions({{"disable_auto_compactions", "false"}}));
+  ASSERT_OK(static_cast_with_check<DBImpl>(db_)->TEST_WaitForCompact());
+  std::vector<LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  ASSERT_EQ(3U, files.size());
+
+  Checkpoint* checkpoint;
+  ASSERT_OK(Checkpoint::Create(db_, &checkpoint));
+
+  // Importing the table file of a slice would bring back the keys of the
+  // other slices and of the compacted part
+  ASSERT_TRUE(checkpoint
+                  ->ExportColumnFamily(db_->DefaultColumnFamily(), export_path_,
+                                       &metadata_)
+                  .IsNotSupported());
+  ASSERT_EQ(nullptr, metadata_);
+  ASSERT_TRUE(env_->FileExists(export_path_).IsNotFound());
+
+  // Once the slices are compacted, the column family can be exported
+  CompactRangeOptions cro;
+  cro.bottommost_level_compaction = BottommostLevelCompaction::kForce;
+  ASSERT_OK(db_->CompactRange(cro, nullptr, nullptr));
+  ASSERT_OK(checkpoint->ExportColumnFamily(db_->DefaultColumnFamily(),
+                                           export_path_, &metadata_));
+  ASSERT_NE(nullptr, metadata_);
+
+  ColumnFamilyHandle* imported = nullptr;
+  ASSERT_OK(db_->CreateColumnFamilyWithImport(
+      options, "imported", ImportColumnFamilyOptions(), *metadata_,
+      &imported));
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions(), imported));
+  int i = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next(), i++) {
+    ASSERT_EQ(key(i), iter->key().ToString());
+    ASSERT_EQ(values[i], iter->value().ToString());
+  }
+  ASSERT_OK(iter->status());
+  ASSERT_EQ(kNumKeys, i);
+  iter.reset();
+  ASSERT_OK(db_->DestroyColumnFamilyHandle(imported));
+  delete checkpoint;
+}
+
 TEST_F(CheckpointTest, CheckpointCF) {
   Options options = CurrentOptions();
   CreateAndReopenWithCF({"one", "two", "three", "four", "five"}, options);
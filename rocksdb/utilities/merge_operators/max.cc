@@ -65,6 +65,8 @@ class MaxOperator : public MergeOperator {
   }
 
   const char* Name() const override { return "MaxOperator"; }
+
+  bool IsAssociativeAndCommutative() const override { return true; }
 };
 
 }  // end of anonymous namespace
@@ -38,6 +38,8 @@ class UInt64AddOperator : public AssociativeMergeOperator {
 
   const char* Name() const override { return "UInt64AddOperator"; }
 
+  bool IsAssociativeAndCommutative() const override { return true; }
+
  private:
   // Takes the string and decodes it into a uint64_t
   // On error, prints a message and returns 0
@@ -229,6 +229,13 @@ Status BlockCacheTraceSimulator::InitializeCaches() {
             NewLRUCache(simulate_cache_capacity, config.num_shard_bits,
                         /*strict_capacity_limit=*/false,
                         /*high_pri_pool_ratio=*/0));
+      } else if (cache_name == "lru_tinylfu") {
+        LRUCacheOptions co(simulate_cache_capacity, config.num_shard_bits,
+                           /*_strict_capacity_limit=*/false,
+                           /*_high_pri_pool_ratio=*/0);
+        co.admission_policy = kAdmitByFrequency;
+        sim_cache = std::make_shared<CacheSimulator>(std::move(ghost_cache),
+                                                     NewLRUCache(co));
       } else if (cache_name == "lru_priority") {
         sim_cache = std::make_shared<PrioritizedCacheSimulator>(
             std::move(ghost_cache),
@@ -256,6 +256,12 @@ class SimCacheImpl : public SimCache {
     cache_->ApplyToAllCacheEntries(callback, thread_safe);
   }
 
+  void ApplyToAllCacheKeys(
+      const std::function<void(const Slice& key, bool hit)>& callback,
+      bool thread_safe) override {
+    cache_->ApplyToAllCacheKeys(callback, thread_safe);
+  }
+
   void EraseUnRefEntries() override {
     cache_->EraseUnRefEntries();
     key_only_cache_->EraseUnRefEntries();